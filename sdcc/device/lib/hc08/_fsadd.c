@@ -0,0 +1,399 @@
+/*-------------------------------------------------------------------------
+   _fsadd.c - float addition and subtraction for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* These give the same results as ../_fsadd.c and ../_fssub.c, bit for bit:
+   the mantissas are scaled by 16 and added as signed longs, the arithmetic
+   right shift of the one with the smaller exponent truncates towards minus
+   infinity, and the result is truncated except when the sum overflows.
+   a1 - a2 is computed as -((-a1) + a2), as ../_fssub.c does.
+
+   The arguments are copied to page zero, so that the work can be done with
+   direct addressing. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+float
+__fsadd (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+fsadd_m1:
+	.ds	4
+fsadd_m2:
+	.ds	4
+fsadd_exp:
+	.ds	1
+fsadd_cnt:
+	.ds	1
+fsadd_sign:
+	.ds	1
+fsadd_flip:
+	.ds	1
+	.area	CSEG	(CODE)
+
+	ldhx	#___fsadd_PARM_1
+	clra
+fsadd_start:
+	sta	*fsadd_flip
+	eor	,x
+	sta	*fsadd_m1
+	lda	1,x
+	sta	*(fsadd_m1+1)
+	lda	2,x
+	sta	*(fsadd_m1+2)
+	lda	3,x
+	sta	*(fsadd_m1+3)
+	lda	4,x
+	sta	*fsadd_m2
+	lda	5,x
+	sta	*(fsadd_m2+1)
+	lda	6,x
+	sta	*(fsadd_m2+2)
+	lda	7,x
+	sta	*(fsadd_m2+3)
+
+	; a2 == 0: return a1.
+	ora	*fsadd_m2
+	ora	*(fsadd_m2+1)
+	ora	*(fsadd_m2+2)
+	beq	fsadd_ret_a1
+	; a1 == 0: return a2.
+	lda	*fsadd_m1
+	ora	*(fsadd_m1+1)
+	ora	*(fsadd_m1+2)
+	ora	*(fsadd_m1+3)
+	bne	00001$
+	lda	*fsadd_m2
+	eor	*fsadd_flip
+	sta	*___SDCC_hc08_ret3
+	mov	*(fsadd_m2+1),*___SDCC_hc08_ret2
+	ldx	*(fsadd_m2+2)
+	lda	*(fsadd_m2+3)
+	rts
+
+00001$:
+	; Make a1 the argument with the larger exponent.
+	lda	*(fsadd_m1+1)
+	lsla
+	lda	*fsadd_m1
+	rola
+	sta	*fsadd_exp
+	lda	*(fsadd_m2+1)
+	lsla
+	lda	*fsadd_m2
+	rola
+	sub	*fsadd_exp
+	bls	00002$
+	sta	*fsadd_cnt
+	add	*fsadd_exp
+	sta	*fsadd_exp
+	lda	*fsadd_m1
+	ldx	*fsadd_m2
+	sta	*fsadd_m2
+	stx	*fsadd_m1
+	lda	*(fsadd_m1+1)
+	ldx	*(fsadd_m2+1)
+	sta	*(fsadd_m2+1)
+	stx	*(fsadd_m1+1)
+	lda	*(fsadd_m1+2)
+	ldx	*(fsadd_m2+2)
+	sta	*(fsadd_m2+2)
+	stx	*(fsadd_m1+2)
+	lda	*(fsadd_m1+3)
+	ldx	*(fsadd_m2+3)
+	sta	*(fsadd_m2+3)
+	stx	*(fsadd_m1+3)
+	lda	*fsadd_cnt
+	bra	00003$
+00002$:
+	nega
+	sta	*fsadd_cnt
+00003$:
+	cmp	#26
+	bhs	fsadd_ret_a1
+
+	; Mantissa of a1 << 4, negated for a negative a1.
+	lda	*fsadd_m1
+	sta	*fsadd_sign
+	clr	*fsadd_m1
+	lda	*(fsadd_m1+1)
+	ora	#0x80
+	sta	*(fsadd_m1+1)
+	ldx	#4
+00004$:
+	lsl	*(fsadd_m1+3)
+	rol	*(fsadd_m1+2)
+	rol	*(fsadd_m1+1)
+	rol	*fsadd_m1
+	dbnzx	00004$
+	tst	*fsadd_sign
+	bpl	00005$
+	bsr	fsadd_neg_m1
+00005$:
+	bra	fsadd_m2_scale
+
+fsadd_ret_a1:
+	; Return a1.
+	lda	*fsadd_m1
+	eor	*fsadd_flip
+	sta	*___SDCC_hc08_ret3
+	mov	*(fsadd_m1+1),*___SDCC_hc08_ret2
+	ldx	*(fsadd_m1+2)
+	lda	*(fsadd_m1+3)
+	rts
+
+fsadd_neg_m1:
+	clra
+	sub	*(fsadd_m1+3)
+	sta	*(fsadd_m1+3)
+	clra
+	sbc	*(fsadd_m1+2)
+	sta	*(fsadd_m1+2)
+	clra
+	sbc	*(fsadd_m1+1)
+	sta	*(fsadd_m1+1)
+	clra
+	sbc	*fsadd_m1
+	sta	*fsadd_m1
+	rts
+
+fsadd_m2_scale:
+	; Mantissa of a2, negated for a negative a2,
+	; then shifted left by 4 - k (k = exponent difference).
+	lda	*(fsadd_m2+1)
+	ora	#0x80
+	sta	*(fsadd_m2+1)
+	lda	*fsadd_m2
+	clr	*fsadd_m2
+	tsta
+	bpl	00006$
+	clra
+	sub	*(fsadd_m2+3)
+	sta	*(fsadd_m2+3)
+	clra
+	sbc	*(fsadd_m2+2)
+	sta	*(fsadd_m2+2)
+	clra
+	sbc	*(fsadd_m2+1)
+	sta	*(fsadd_m2+1)
+	clra
+	sbc	*fsadd_m2
+	sta	*fsadd_m2
+00006$:
+	lda	*fsadd_cnt
+	sub	#4
+	bcc	00010$
+	nega
+	tax
+00007$:
+	lsl	*(fsadd_m2+3)
+	rol	*(fsadd_m2+2)
+	rol	*(fsadd_m2+1)
+	rol	*fsadd_m2
+	dbnzx	00007$
+	bra	00020$
+00010$:
+	cmp	#8
+	blo	00012$
+	sub	#8
+	sta	*fsadd_cnt
+	lda	*fsadd_m2
+	lsla
+	clra
+	sbc	#0
+	mov	*(fsadd_m2+2),*(fsadd_m2+3)
+	mov	*(fsadd_m2+1),*(fsadd_m2+2)
+	mov	*fsadd_m2,*(fsadd_m2+1)
+	sta	*fsadd_m2
+	lda	*fsadd_cnt
+	bra	00010$
+00012$:
+	tsta
+	beq	00020$
+	tax
+00013$:
+	asr	*fsadd_m2
+	ror	*(fsadd_m2+1)
+	ror	*(fsadd_m2+2)
+	ror	*(fsadd_m2+3)
+	dbnzx	00013$
+
+00020$:
+	; Add, and split the sum into sign and magnitude.
+	lda	*(fsadd_m1+3)
+	add	*(fsadd_m2+3)
+	sta	*(fsadd_m1+3)
+	lda	*(fsadd_m1+2)
+	adc	*(fsadd_m2+2)
+	sta	*(fsadd_m1+2)
+	lda	*(fsadd_m1+1)
+	adc	*(fsadd_m2+1)
+	sta	*(fsadd_m1+1)
+	lda	*fsadd_m1
+	adc	*fsadd_m2
+	sta	*fsadd_m1
+	clr	*fsadd_sign
+	tsta
+	bpl	00021$
+	jsr	fsadd_neg_m1
+	mov	#0x80,*fsadd_sign
+	bra	00024$
+00021$:
+	ora	*(fsadd_m1+1)
+	ora	*(fsadd_m1+2)
+	ora	*(fsadd_m1+3)
+	bne	00024$
+	jmp	fsadd_ret_0
+
+00024$:
+	; Normalize.
+	lda	*fsadd_m1
+	cmp	#0x08
+	bhs	fsadd_round
+	clrx
+00025$:
+	tst	*fsadd_m1
+	bne	00027$
+	lda	*(fsadd_m1+1)
+	cmp	#0x08
+	bhs	00027$
+	mov	*(fsadd_m1+1),*fsadd_m1
+	mov	*(fsadd_m1+2),*(fsadd_m1+1)
+	mov	*(fsadd_m1+3),*(fsadd_m1+2)
+	clr	*(fsadd_m1+3)
+	txa
+	add	#8
+	tax
+	bra	00025$
+00027$:
+	lda	*fsadd_m1
+	cmp	#0x08
+	bhs	00029$
+	lsl	*(fsadd_m1+3)
+	rol	*(fsadd_m1+2)
+	rol	*(fsadd_m1+1)
+	rol	*fsadd_m1
+	incx
+	bra	00027$
+00029$:
+	stx	*fsadd_cnt
+	lda	*fsadd_exp
+	sub	*fsadd_cnt
+	bcs	fsadd_ret_0
+	sta	*fsadd_exp
+	bra	fsadd_pack
+
+fsadd_round:
+	; Round off while the sum has overflowed.
+	lda	*fsadd_m1
+	cmp	#0x10
+	blo	fsadd_pack
+	brclr	#0,*(fsadd_m1+3),00031$
+	lda	*(fsadd_m1+3)
+	add	#2
+	sta	*(fsadd_m1+3)
+	bcc	00031$
+	inc	*(fsadd_m1+2)
+	bne	00031$
+	inc	*(fsadd_m1+1)
+	bne	00031$
+	inc	*fsadd_m1
+00031$:
+	lsr	*fsadd_m1
+	ror	*(fsadd_m1+1)
+	ror	*(fsadd_m1+2)
+	ror	*(fsadd_m1+3)
+	inc	*fsadd_exp
+	bne	fsadd_round
+
+	; Return infinity.
+	lda	*fsadd_sign
+	ora	#0x7f
+	eor	*fsadd_flip
+	sta	*___SDCC_hc08_ret3
+	mov	#0x80,*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+
+fsadd_pack:
+	; Drop the 4 extra bits and the hidden bit, pack.
+	ldx	#4
+00041$:
+	lsr	*fsadd_m1
+	ror	*(fsadd_m1+1)
+	ror	*(fsadd_m1+2)
+	ror	*(fsadd_m1+3)
+	dbnzx	00041$
+	lda	*(fsadd_m1+1)
+	lsla
+	lsr	*fsadd_exp
+	rora
+	sta	*___SDCC_hc08_ret2
+	lda	*fsadd_exp
+	ora	*fsadd_sign
+	eor	*fsadd_flip
+	sta	*___SDCC_hc08_ret3
+	ldx	*(fsadd_m1+2)
+	lda	*(fsadd_m1+3)
+	rts
+
+fsadd_ret_0:
+	; Return 0.
+	lda	*fsadd_flip
+	sta	*___SDCC_hc08_ret3
+	clr	*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+  __endasm;
+}
+
+float
+__fssub (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	ldhx	#___fssub_PARM_1
+	lda	#0x80
+	jmp	fsadd_start
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fsadd.c"
+#include "../_fssub.c"
+
+#endif
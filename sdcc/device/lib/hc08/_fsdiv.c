@@ -0,0 +1,269 @@
+/*-------------------------------------------------------------------------
+   _fsdiv.c - float division for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* This gives the same results as ../_fsdiv.c, bit for bit: a 25 bit
+   quotient of the mantissas is computed by restoring division and then
+   rounded. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+float
+__fsdiv (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+fsdiv_r:
+	.ds	4
+fsdiv_d:
+	.ds	4
+fsdiv_q:
+	.ds	4
+fsdiv_exp:
+	.ds	2
+fsdiv_sign:
+	.ds	1
+fsdiv_cnt:
+	.ds	1
+	.area	CSEG	(CODE)
+
+	ldhx	#___fsdiv_PARM_1
+	lda	,x
+	sta	*fsdiv_r
+	lda	1,x
+	sta	*(fsdiv_r+1)
+	lda	2,x
+	sta	*(fsdiv_r+2)
+	lda	3,x
+	sta	*(fsdiv_r+3)
+	lda	4,x
+	sta	*fsdiv_d
+	lda	5,x
+	sta	*(fsdiv_d+1)
+	lda	6,x
+	sta	*(fsdiv_d+2)
+	lda	7,x
+	sta	*(fsdiv_d+3)
+
+	; a2 == 0: return NaN for 0 / 0, otherwise infinity with the sign of a1.
+	ora	*(fsdiv_d+2)
+	ora	*(fsdiv_d+1)
+	bne	00002$
+	lda	*fsdiv_d
+	lsla
+	bne	00002$
+	clrx
+	clra
+	mov	#0x80,*___SDCC_hc08_ret2
+	lda	*fsdiv_r
+	lsla
+	ora	*(fsdiv_r+1)
+	ora	*(fsdiv_r+2)
+	ora	*(fsdiv_r+3)
+	beq	00001$
+	lda	*fsdiv_r
+	ora	#0x7f
+	sta	*___SDCC_hc08_ret3
+	clra
+	rts
+00001$:
+	mov	#0xff,*___SDCC_hc08_ret3
+	mov	#0xc0,*___SDCC_hc08_ret2
+	rts
+
+00002$:
+	; a1 == 0: return 0.
+	lda	*fsdiv_r
+	ora	*(fsdiv_r+1)
+	ora	*(fsdiv_r+2)
+	ora	*(fsdiv_r+3)
+	bne	00003$
+	jmp	fsdiv_ret_0
+
+00003$:
+	lda	*fsdiv_r
+	eor	*fsdiv_d
+	and	#0x80
+	sta	*fsdiv_sign
+
+	; Difference of the exponents.
+	lda	*(fsdiv_d+1)
+	lsla
+	lda	*fsdiv_d
+	rola
+	sta	*fsdiv_cnt
+	lda	*(fsdiv_r+1)
+	lsla
+	lda	*fsdiv_r
+	rola
+	sub	*fsdiv_cnt
+	tax
+	clra
+	sbc	#0
+	sta	*fsdiv_exp
+	txa
+	add	#126
+	sta	*(fsdiv_exp+1)
+	bcc	00004$
+	inc	*fsdiv_exp
+00004$:
+
+	; Mantissas.
+	clr	*fsdiv_r
+	bset	#7,*(fsdiv_r+1)
+	clr	*fsdiv_d
+	bset	#7,*(fsdiv_d+1)
+
+	; Make sure there are 25 bits of quotient.
+	lda	*(fsdiv_r+3)
+	sub	*(fsdiv_d+3)
+	lda	*(fsdiv_r+2)
+	sbc	*(fsdiv_d+2)
+	lda	*(fsdiv_r+1)
+	sbc	*(fsdiv_d+1)
+	bcc	00005$
+	lsl	*(fsdiv_r+3)
+	rol	*(fsdiv_r+2)
+	rol	*(fsdiv_r+1)
+	rol	*fsdiv_r
+	lda	*(fsdiv_exp+1)
+	sub	#1
+	sta	*(fsdiv_exp+1)
+	bcc	00005$
+	dec	*fsdiv_exp
+00005$:
+
+	; Restoring division, one quotient bit per round.
+	clr	*fsdiv_q
+	clr	*(fsdiv_q+1)
+	clr	*(fsdiv_q+2)
+	clr	*(fsdiv_q+3)
+	mov	#25,*fsdiv_cnt
+00006$:
+	lda	*(fsdiv_r+3)
+	sub	*(fsdiv_d+3)
+	sta	*(fsdiv_r+3)
+	lda	*(fsdiv_r+2)
+	sbc	*(fsdiv_d+2)
+	sta	*(fsdiv_r+2)
+	lda	*(fsdiv_r+1)
+	sbc	*(fsdiv_d+1)
+	sta	*(fsdiv_r+1)
+	lda	*fsdiv_r
+	sbc	#0
+	sta	*fsdiv_r
+	bcc	00007$
+	lda	*(fsdiv_r+3)
+	add	*(fsdiv_d+3)
+	sta	*(fsdiv_r+3)
+	lda	*(fsdiv_r+2)
+	adc	*(fsdiv_d+2)
+	sta	*(fsdiv_r+2)
+	lda	*(fsdiv_r+1)
+	adc	*(fsdiv_d+1)
+	sta	*(fsdiv_r+1)
+	lda	*fsdiv_r
+	adc	#0
+	sta	*fsdiv_r
+	clc
+	bra	00008$
+00007$:
+	sec
+00008$:
+	rol	*(fsdiv_q+3)
+	rol	*(fsdiv_q+2)
+	rol	*(fsdiv_q+1)
+	rol	*fsdiv_q
+	lsl	*(fsdiv_r+3)
+	rol	*(fsdiv_r+2)
+	rol	*(fsdiv_r+1)
+	rol	*fsdiv_r
+	dbnz	*fsdiv_cnt,00006$
+
+	; Round and normalize.
+	inc	*(fsdiv_q+3)
+	bne	00009$
+	inc	*(fsdiv_q+2)
+	bne	00009$
+	inc	*(fsdiv_q+1)
+	bne	00009$
+	inc	*fsdiv_q
+00009$:
+	lsr	*fsdiv_q
+	ror	*(fsdiv_q+1)
+	ror	*(fsdiv_q+2)
+	ror	*(fsdiv_q+3)
+	inc	*(fsdiv_exp+1)
+	bne	00010$
+	inc	*fsdiv_exp
+00010$:
+	lda	*fsdiv_exp
+	bmi	fsdiv_ret_0
+	bne	00011$
+
+	; Drop the hidden bit, pack.
+	lda	*(fsdiv_q+1)
+	lsla
+	lsr	*(fsdiv_exp+1)
+	rora
+	sta	*___SDCC_hc08_ret2
+	lda	*(fsdiv_exp+1)
+	ora	*fsdiv_sign
+	sta	*___SDCC_hc08_ret3
+	ldx	*(fsdiv_q+2)
+	lda	*(fsdiv_q+3)
+	rts
+
+00011$:
+	; Exponent >= 256: return infinity.
+	lda	*fsdiv_sign
+	ora	#0x7f
+	sta	*___SDCC_hc08_ret3
+	mov	#0x80,*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+
+fsdiv_ret_0:
+	clr	*___SDCC_hc08_ret3
+	clr	*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fsdiv.c"
+
+#endif
@@ -0,0 +1,80 @@
+/*-------------------------------------------------------------------------
+   _fseq.c - float comparison for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* Like ../_fseq.c, this compares the bit patterns, except that +0 and -0
+   compare equal. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+char
+__fseq (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	lda	___fseq_PARM_1
+	cmp	___fseq_PARM_2
+	bne	00001$
+	lda	(___fseq_PARM_1+1)
+	cmp	(___fseq_PARM_2+1)
+	bne	00001$
+	lda	(___fseq_PARM_1+2)
+	cmp	(___fseq_PARM_2+2)
+	bne	00001$
+	lda	(___fseq_PARM_1+3)
+	cmp	(___fseq_PARM_2+3)
+	bne	00001$
+	lda	#1
+	rts
+00001$:
+	lda	___fseq_PARM_1
+	ora	___fseq_PARM_2
+	and	#0x7f
+	ora	(___fseq_PARM_1+1)
+	ora	(___fseq_PARM_2+1)
+	ora	(___fseq_PARM_1+2)
+	ora	(___fseq_PARM_2+2)
+	ora	(___fseq_PARM_1+3)
+	ora	(___fseq_PARM_2+3)
+	beq	00002$
+	clra
+	rts
+00002$:
+	lda	#1
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fseq.c"
+
+#endif
@@ -0,0 +1,184 @@
+/*-------------------------------------------------------------------------
+   _memmove.c - copy possibly overlapping memory for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* With a single index register, four bytes at a time are moved through
+   the direct page. Copies to a higher address are done backwards, from
+   the end; the order within a round of four bytes does not matter. */
+
+#include <stddef.h>
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+void *
+memmove (void *dst, const void *src, size_t n) __naked
+{
+  dst, src, n;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+memmove_d:
+	.ds	2
+memmove_s:
+	.ds	2
+memmove_b:
+	.ds	4
+memmove_n:
+	.ds	3
+	.area	CSEG	(CODE)
+
+	psha
+	pshx
+
+	; Rounds of 4 bytes, counted as with two nested dbnz loops.
+	lda	_memmove_PARM_3
+	ldx	(_memmove_PARM_3+1)
+	stx	*(memmove_n+2)
+	lsra
+	rorx
+	lsra
+	rorx
+	stx	*(memmove_n+1)
+	tstx
+	beq	00001$
+	inca
+00001$:
+	sta	*memmove_n
+	lda	*(memmove_n+2)
+	and	#3
+	sta	*(memmove_n+2)
+
+	; Copy backwards if src < dst.
+	lda	(_memmove_PARM_2+1)
+	sub	2,s
+	lda	_memmove_PARM_2
+	sbc	1,s
+	bcs	00010$
+
+	lda	(_memmove_PARM_2+1)
+	sta	*(memmove_s+1)
+	lda	_memmove_PARM_2
+	sta	*memmove_s
+	lda	2,s
+	sta	*(memmove_d+1)
+	lda	1,s
+	sta	*memmove_d
+
+	; The remaining n % 4 bytes first.
+	tst	*(memmove_n+2)
+	beq	00003$
+00002$:
+	ldhx	*memmove_s
+	mov	,x+,*memmove_b
+	sthx	*memmove_s
+	ldhx	*memmove_d
+	mov	*memmove_b,x+
+	sthx	*memmove_d
+	dbnz	*(memmove_n+2),00002$
+00003$:
+	tst	*memmove_n
+	beq	00020$
+00004$:
+	ldhx	*memmove_s
+	mov	,x+,*memmove_b
+	mov	,x+,*(memmove_b+1)
+	mov	,x+,*(memmove_b+2)
+	mov	,x+,*(memmove_b+3)
+	sthx	*memmove_s
+	ldhx	*memmove_d
+	mov	*memmove_b,x+
+	mov	*(memmove_b+1),x+
+	mov	*(memmove_b+2),x+
+	mov	*(memmove_b+3),x+
+	sthx	*memmove_d
+	dbnz	*(memmove_n+1),00004$
+	dbnz	*memmove_n,00004$
+	bra	00020$
+
+	; Start at the ends.
+00010$:
+	lda	(_memmove_PARM_2+1)
+	add	(_memmove_PARM_3+1)
+	sta	*(memmove_s+1)
+	lda	_memmove_PARM_2
+	adc	_memmove_PARM_3
+	sta	*memmove_s
+	lda	2,s
+	add	(_memmove_PARM_3+1)
+	sta	*(memmove_d+1)
+	lda	1,s
+	adc	_memmove_PARM_3
+	sta	*memmove_d
+
+	tst	*(memmove_n+2)
+	beq	00012$
+00011$:
+	ldhx	*memmove_s
+	aix	#-1
+	sthx	*memmove_s
+	lda	,x
+	ldhx	*memmove_d
+	aix	#-1
+	sthx	*memmove_d
+	sta	,x
+	dbnz	*(memmove_n+2),00011$
+00012$:
+	tst	*memmove_n
+	beq	00020$
+00013$:
+	ldhx	*memmove_s
+	aix	#-4
+	sthx	*memmove_s
+	mov	,x+,*memmove_b
+	mov	,x+,*(memmove_b+1)
+	mov	,x+,*(memmove_b+2)
+	mov	,x+,*(memmove_b+3)
+	ldhx	*memmove_d
+	aix	#-4
+	sthx	*memmove_d
+	mov	*memmove_b,x+
+	mov	*(memmove_b+1),x+
+	mov	*(memmove_b+2),x+
+	mov	*(memmove_b+3),x+
+	dbnz	*(memmove_n+1),00013$
+	dbnz	*memmove_n,00013$
+
+00020$:
+	pulx
+	pula
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_memmove.c"
+
+#endif
@@ -0,0 +1,114 @@
+/*-------------------------------------------------------------------------
+   _memset.c - fill memory for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* The fill byte is stored four times per round of the loop; the count of
+   rounds is kept in the direct page for dbnz. */
+
+#include <string.h>
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+#ifdef __SDCC_BROKEN_STRING_FUNCTIONS
+void *
+memset (void *s, unsigned char c, size_t n) __naked
+#else
+void *
+memset (void *s, int c, size_t n) __naked
+#endif
+{
+  s, c, n;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+memset_n:
+	.ds	3
+	.area	CSEG	(CODE)
+
+	psha
+	pshx
+
+	; Rounds of 4 bytes, counted as with two nested dbnz loops.
+	lda	_memset_PARM_3
+	ldx	(_memset_PARM_3+1)
+	stx	*(memset_n+2)
+	lsra
+	rorx
+	lsra
+	rorx
+	stx	*(memset_n+1)
+	tstx
+	beq	00001$
+	inca
+00001$:
+	sta	*memset_n
+
+	lda	1,s
+	psha
+	pulh
+	ldx	2,s
+#ifdef __SDCC_BROKEN_STRING_FUNCTIONS
+	lda	_memset_PARM_2
+#else
+	lda	(_memset_PARM_2+1)
+#endif
+
+	; The remaining n % 4 bytes first.
+	brclr	#0,*(memset_n+2),00002$
+	sta	,x
+	aix	#1
+00002$:
+	brclr	#1,*(memset_n+2),00003$
+	sta	,x
+	sta	1,x
+	aix	#2
+00003$:
+	tst	*memset_n
+	beq	00005$
+00004$:
+	sta	,x
+	sta	1,x
+	sta	2,x
+	sta	3,x
+	aix	#4
+	dbnz	*(memset_n+1),00004$
+	dbnz	*memset_n,00004$
+00005$:
+	pulx
+	pula
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_memset.c"
+
+#endif
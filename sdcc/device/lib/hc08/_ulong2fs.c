@@ -0,0 +1,178 @@
+/*-------------------------------------------------------------------------
+   _ulong2fs.c - long to float conversion for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* These give the same results as ../_ulong2fs.c and ../_slong2fs.c, bit for
+   bit: the long is shifted right one bit at a time until it fits the
+   mantissa, rounding each time. __slong2fs converts the magnitude and sets
+   the sign bit. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+float
+__ulong2fs (unsigned long a) __naked
+{
+  a;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+ulong2fs_m:
+	.ds	4
+ulong2fs_exp:
+	.ds	1
+ulong2fs_sign:
+	.ds	1
+	.area	CSEG	(CODE)
+
+	lda	___ulong2fs_PARM_1
+	sta	*ulong2fs_m
+	lda	(___ulong2fs_PARM_1+1)
+	sta	*(ulong2fs_m+1)
+	lda	(___ulong2fs_PARM_1+2)
+	sta	*(ulong2fs_m+2)
+	lda	(___ulong2fs_PARM_1+3)
+	sta	*(ulong2fs_m+3)
+	clr	*ulong2fs_sign
+
+	; Convert ulong2fs_m.
+ulong2fs:
+	ora	*(ulong2fs_m+2)
+	ora	*(ulong2fs_m+1)
+	ora	*ulong2fs_m
+	bne	00001$
+	clr	*___SDCC_hc08_ret3
+	clr	*___SDCC_hc08_ret2
+	clrx
+	rts
+00001$:
+	mov	#150,*ulong2fs_exp
+
+	; Normalize up, a byte at a time while that fits.
+00002$:
+	lda	*ulong2fs_m
+	ora	*(ulong2fs_m+1)
+	bne	00003$
+	mov	*(ulong2fs_m+2),*(ulong2fs_m+1)
+	mov	*(ulong2fs_m+3),*(ulong2fs_m+2)
+	clr	*(ulong2fs_m+3)
+	lda	*ulong2fs_exp
+	sub	#8
+	sta	*ulong2fs_exp
+	bra	00002$
+00003$:
+	lda	*ulong2fs_m
+	bne	00005$
+00004$:
+	brset	#7,*(ulong2fs_m+1),00007$
+	lsl	*(ulong2fs_m+3)
+	rol	*(ulong2fs_m+2)
+	rol	*(ulong2fs_m+1)
+	dec	*ulong2fs_exp
+	bra	00004$
+
+	; Normalize down, rounding each bit.
+00005$:
+	brclr	#0,*(ulong2fs_m+3),00006$
+	lda	*(ulong2fs_m+3)
+	add	#2
+	sta	*(ulong2fs_m+3)
+	bcc	00006$
+	inc	*(ulong2fs_m+2)
+	bne	00006$
+	inc	*(ulong2fs_m+1)
+	bne	00006$
+	inc	*ulong2fs_m
+00006$:
+	lsr	*ulong2fs_m
+	ror	*(ulong2fs_m+1)
+	ror	*(ulong2fs_m+2)
+	ror	*(ulong2fs_m+3)
+	inc	*ulong2fs_exp
+	tst	*ulong2fs_m
+	bne	00005$
+
+	; Drop the hidden bit, pack.
+00007$:
+	lda	*(ulong2fs_m+1)
+	lsla
+	lsr	*ulong2fs_exp
+	rora
+	sta	*___SDCC_hc08_ret2
+	lda	*ulong2fs_exp
+	ora	*ulong2fs_sign
+	sta	*___SDCC_hc08_ret3
+	ldx	*(ulong2fs_m+2)
+	lda	*(ulong2fs_m+3)
+	rts
+  __endasm;
+}
+
+float
+__slong2fs (signed long sl) __naked
+{
+  sl;	/* reference to make compiler happy */
+
+  __asm
+	lda	___slong2fs_PARM_1
+	sta	*ulong2fs_m
+	lda	(___slong2fs_PARM_1+1)
+	sta	*(ulong2fs_m+1)
+	lda	(___slong2fs_PARM_1+2)
+	sta	*(ulong2fs_m+2)
+	lda	(___slong2fs_PARM_1+3)
+	sta	*(ulong2fs_m+3)
+	clr	*ulong2fs_sign
+	tst	*ulong2fs_m
+	bpl	00001$
+	mov	#0x80,*ulong2fs_sign
+	clra
+	sub	*(ulong2fs_m+3)
+	sta	*(ulong2fs_m+3)
+	clra
+	sbc	*(ulong2fs_m+2)
+	sta	*(ulong2fs_m+2)
+	clra
+	sbc	*(ulong2fs_m+1)
+	sta	*(ulong2fs_m+1)
+	clra
+	sbc	*ulong2fs_m
+	sta	*ulong2fs_m
+	lda	*(ulong2fs_m+3)
+00001$:
+	jmp	ulong2fs
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_ulong2fs.c"
+#include "../_slong2fs.c"
+
+#endif
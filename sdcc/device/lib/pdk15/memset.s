@@ -0,0 +1,98 @@
+;--------------------------------------------------------------------------
+;  memset.s - fill memory
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License 
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;  might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+; The destination of memset() is always in RAM, so, unlike the C version,
+; this does not go through the generic pointer, and the loop is unrolled
+; four times. The unused upper byte of c holds the remainder count.
+
+; void *memset(void *s, int c, size_t n);
+
+.module memset
+
+	.area DATA
+_memset_PARM_1::
+	.ds 2
+_memset_PARM_2::
+	.ds 2
+_memset_PARM_3::
+	.ds 2
+
+	.area CODE
+
+_memset::
+	mov	a, _memset_PARM_1+0
+	mov	p, a
+
+	mov	a, _memset_PARM_3+0
+	and	a, #3
+	mov	_memset_PARM_2+1, a
+
+	; Rounds of 4 bytes, counted as with two nested dzsn loops.
+	sr	_memset_PARM_3+1
+	src	_memset_PARM_3+0
+	sr	_memset_PARM_3+1
+	src	_memset_PARM_3+0
+	mov	a, _memset_PARM_3+0
+	ceqsn	a, #0
+	inc	_memset_PARM_3+1
+
+	mov	a, _memset_PARM_2+0
+
+	; The remaining n % 4 bytes first.
+	inc	_memset_PARM_2+1
+rem:
+	dzsn	_memset_PARM_2+1
+	goto	rem_store
+	goto	rounds
+rem_store:
+	idxm	p, a
+	inc	p
+	goto	rem
+
+rounds:
+	inc	_memset_PARM_3+1
+	dzsn	_memset_PARM_3+1
+	goto	loop
+	goto	end
+loop:
+	idxm	p, a
+	inc	p
+	idxm	p, a
+	inc	p
+	idxm	p, a
+	inc	p
+	idxm	p, a
+	inc	p
+	dzsn	_memset_PARM_3+0
+	goto	loop
+	dzsn	_memset_PARM_3+1
+	goto	loop
+
+end:
+	mov	a, _memset_PARM_1+1
+	mov	p, a
+	mov	a, _memset_PARM_1+0
+	ret
@@ -0,0 +1,148 @@
+/*-------------------------------------------------------------------------
+   _fs2ulong.c - float to long conversion for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* These give the same results as ../_fs2ulong.c and ../_fs2slong.c, bit for
+   bit: the fraction is truncated, negative floats give 0 in __fs2ulong, and
+   floats too large for the mantissa to be shifted right give 0. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+unsigned long
+__fs2ulong (float a1) __naked
+{
+  a1;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+fs2ulong_m:
+	.ds	4
+	.area	CSEG	(CODE)
+
+	ldhx	#___fs2ulong_PARM_1
+	lda	,x
+	bmi	fs2ulong_ret_0
+
+	; Convert the float at hx, the sign is ignored.
+fs2ulong:
+	lda	1,x
+	lsla
+	lda	,x
+	rola
+	sub	#127
+	bcs	fs2ulong_ret_0
+	cmp	#24
+	bhs	fs2ulong_ret_0
+	; The shift count is 23 - (exponent - 127).
+	nega
+	add	#23
+	sta	*fs2ulong_m
+	lda	1,x
+	ora	#0x80
+	sta	*(fs2ulong_m+1)
+	lda	2,x
+	sta	*(fs2ulong_m+2)
+	lda	3,x
+	sta	*(fs2ulong_m+3)
+	lda	*fs2ulong_m
+	clr	*fs2ulong_m
+
+	; Shift the mantissa right, a byte at a time first.
+00001$:
+	cmp	#8
+	blo	00002$
+	mov	*(fs2ulong_m+2),*(fs2ulong_m+3)
+	mov	*(fs2ulong_m+1),*(fs2ulong_m+2)
+	clr	*(fs2ulong_m+1)
+	sub	#8
+	bra	00001$
+00002$:
+	tsta
+	beq	00004$
+	tax
+00003$:
+	lsr	*(fs2ulong_m+1)
+	ror	*(fs2ulong_m+2)
+	ror	*(fs2ulong_m+3)
+	dbnzx	00003$
+00004$:
+	clr	*___SDCC_hc08_ret3
+	mov	*(fs2ulong_m+1),*___SDCC_hc08_ret2
+	ldx	*(fs2ulong_m+2)
+	lda	*(fs2ulong_m+3)
+	rts
+
+fs2ulong_ret_0:
+	clr	*___SDCC_hc08_ret3
+	clr	*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+  __endasm;
+}
+
+signed long
+__fs2slong (float f) __naked
+{
+  f;	/* reference to make compiler happy */
+
+  __asm
+	ldhx	#___fs2slong_PARM_1
+	lda	,x
+	bmi	00001$
+	jmp	fs2ulong
+00001$:
+	jsr	fs2ulong
+	; Negate the result.
+	sta	*(fs2ulong_m+3)
+	stx	*(fs2ulong_m+2)
+	clra
+	sub	*(fs2ulong_m+3)
+	sta	*(fs2ulong_m+3)
+	clra
+	sbc	*(fs2ulong_m+2)
+	tax
+	clra
+	sbc	*___SDCC_hc08_ret2
+	sta	*___SDCC_hc08_ret2
+	clra
+	sbc	*___SDCC_hc08_ret3
+	sta	*___SDCC_hc08_ret3
+	lda	*(fs2ulong_m+3)
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fs2ulong.c"
+#include "../_fs2slong.c"
+
+#endif
@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------
+   _fslt.c - float comparison for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* Like ../_fslt.c, this compares the floats as signed longs, with the
+   order reversed when both are negative, and +0 and -0 compare equal. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+char
+__fslt (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	; a1 == 0 && a2 == 0: return 0.
+	lda	___fslt_PARM_1
+	ora	___fslt_PARM_2
+	and	#0x7f
+	ora	(___fslt_PARM_1+1)
+	ora	(___fslt_PARM_2+1)
+	ora	(___fslt_PARM_1+2)
+	ora	(___fslt_PARM_2+2)
+	ora	(___fslt_PARM_1+3)
+	ora	(___fslt_PARM_2+3)
+	beq	00003$
+	; Both negative: return a2 < a1.
+	lda	___fslt_PARM_1
+	and	___fslt_PARM_2
+	bpl	00001$
+	lda	(___fslt_PARM_2+3)
+	sub	(___fslt_PARM_1+3)
+	lda	(___fslt_PARM_2+2)
+	sbc	(___fslt_PARM_1+2)
+	lda	(___fslt_PARM_2+1)
+	sbc	(___fslt_PARM_1+1)
+	lda	___fslt_PARM_2
+	sbc	___fslt_PARM_1
+	bra	00002$
+00001$:
+	; Otherwise return a1 < a2.
+	lda	(___fslt_PARM_1+3)
+	sub	(___fslt_PARM_2+3)
+	lda	(___fslt_PARM_1+2)
+	sbc	(___fslt_PARM_2+2)
+	lda	(___fslt_PARM_1+1)
+	sbc	(___fslt_PARM_2+1)
+	lda	___fslt_PARM_1
+	sbc	___fslt_PARM_2
+00002$:
+	bge	00004$
+	lda	#1
+	rts
+00004$:
+	clra
+00003$:
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fslt.c"
+
+#endif
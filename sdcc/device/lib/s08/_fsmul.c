@@ -0,0 +1,275 @@
+/*-------------------------------------------------------------------------
+   _fsmul.c - float multiplication for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* This gives the same results as ../_fsmul.c, bit for bit: the product of
+   the mantissas is computed as one 16x16 multiply and two 16x8 multiplies,
+   leaving out the product of the low bytes, and then rounded. */
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+float
+__fsmul (float a1, float a2) __naked
+{
+  a1, a2;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+fsmul_a:
+	.ds	4
+fsmul_b:
+	.ds	4
+fsmul_r:
+	.ds	4
+fsmul_exp:
+	.ds	2
+fsmul_sign:
+	.ds	1
+fsmul_t:
+	.ds	1
+	.area	CSEG	(CODE)
+
+	ldhx	#___fsmul_PARM_1
+	lda	,x
+	sta	*fsmul_a
+	lda	1,x
+	sta	*(fsmul_a+1)
+	lda	2,x
+	sta	*(fsmul_a+2)
+	lda	3,x
+	sta	*(fsmul_a+3)
+	lda	4,x
+	sta	*fsmul_b
+	lda	5,x
+	sta	*(fsmul_b+1)
+	lda	6,x
+	sta	*(fsmul_b+2)
+	lda	7,x
+	sta	*(fsmul_b+3)
+
+	; a1 == 0 || a2 == 0: return 0.
+	ora	*fsmul_b
+	ora	*(fsmul_b+1)
+	ora	*(fsmul_b+2)
+	beq	fsmul_ret_0
+	lda	*fsmul_a
+	ora	*(fsmul_a+1)
+	ora	*(fsmul_a+2)
+	ora	*(fsmul_a+3)
+	bne	fsmul_sign_exp
+fsmul_ret_0:
+	clr	*___SDCC_hc08_ret3
+	clr	*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+
+fsmul_sign_exp:
+	lda	*fsmul_a
+	eor	*fsmul_b
+	and	#0x80
+	sta	*fsmul_sign
+
+	; Sum of the exponents.
+	lda	*(fsmul_a+1)
+	lsla
+	lda	*fsmul_a
+	rola
+	sta	*(fsmul_exp+1)
+	lda	*(fsmul_b+1)
+	lsla
+	lda	*fsmul_b
+	rola
+	add	*(fsmul_exp+1)
+	sta	*(fsmul_exp+1)
+	clra
+	rola
+	sta	*fsmul_exp
+
+	; Hidden bits.
+	bset	#7,*(fsmul_a+1)
+	bset	#7,*(fsmul_b+1)
+
+	; ah * bh * 65536 + am * bm
+	lda	*(fsmul_a+1)
+	ldx	*(fsmul_b+1)
+	mul
+	stx	*fsmul_r
+	sta	*(fsmul_r+1)
+	lda	*(fsmul_a+2)
+	ldx	*(fsmul_b+2)
+	mul
+	stx	*(fsmul_r+2)
+	sta	*(fsmul_r+3)
+
+	; + (ah * bm + am * bh) * 256
+	lda	*(fsmul_a+1)
+	ldx	*(fsmul_b+2)
+	mul
+	add	*(fsmul_r+2)
+	sta	*(fsmul_r+2)
+	txa
+	adc	*(fsmul_r+1)
+	sta	*(fsmul_r+1)
+	bcc	00002$
+	inc	*fsmul_r
+00002$:
+	lda	*(fsmul_a+2)
+	ldx	*(fsmul_b+1)
+	mul
+	add	*(fsmul_r+2)
+	sta	*(fsmul_r+2)
+	txa
+	adc	*(fsmul_r+1)
+	sta	*(fsmul_r+1)
+	bcc	00003$
+	inc	*fsmul_r
+00003$:
+
+	; + (al * (bh * 256 + bm)) / 256
+	lda	*(fsmul_a+3)
+	ldx	*(fsmul_b+2)
+	mul
+	stx	*fsmul_t
+	lda	*(fsmul_a+3)
+	ldx	*(fsmul_b+1)
+	mul
+	add	*fsmul_t
+	sta	*fsmul_t
+	txa
+	adc	#0
+	tax
+	lda	*(fsmul_r+3)
+	add	*fsmul_t
+	sta	*(fsmul_r+3)
+	txa
+	adc	*(fsmul_r+2)
+	sta	*(fsmul_r+2)
+	bcc	00004$
+	inc	*(fsmul_r+1)
+	bne	00004$
+	inc	*fsmul_r
+00004$:
+
+	; + (bl * (ah * 256 + am)) / 256
+	lda	*(fsmul_b+3)
+	ldx	*(fsmul_a+2)
+	mul
+	stx	*fsmul_t
+	lda	*(fsmul_b+3)
+	ldx	*(fsmul_a+1)
+	mul
+	add	*fsmul_t
+	sta	*fsmul_t
+	txa
+	adc	#0
+	tax
+	lda	*(fsmul_r+3)
+	add	*fsmul_t
+	sta	*(fsmul_r+3)
+	txa
+	adc	*(fsmul_r+2)
+	sta	*(fsmul_r+2)
+	bcc	00005$
+	inc	*(fsmul_r+1)
+	bne	00005$
+	inc	*fsmul_r
+00005$:
+
+	; Round and normalize, the exponent is the sum minus 126 or 127.
+	lda	*(fsmul_r+3)
+	add	#0x40
+	sta	*(fsmul_r+3)
+	bcc	00006$
+	inc	*(fsmul_r+2)
+	bne	00006$
+	inc	*(fsmul_r+1)
+	bne	00006$
+	inc	*fsmul_r
+00006$:
+	tst	*fsmul_r
+	bpl	00008$
+	add	#0x40
+	bcc	00007$
+	inc	*(fsmul_r+2)
+	bne	00007$
+	inc	*(fsmul_r+1)
+	bne	00007$
+	inc	*fsmul_r
+00007$:
+	mov	#126,*fsmul_t
+	bra	00009$
+00008$:
+	lsl	*(fsmul_r+3)
+	rol	*(fsmul_r+2)
+	rol	*(fsmul_r+1)
+	rol	*fsmul_r
+	mov	#127,*fsmul_t
+00009$:
+	lda	*(fsmul_exp+1)
+	sub	*fsmul_t
+	sta	*(fsmul_exp+1)
+	lda	*fsmul_exp
+	sbc	#0
+	bpl	00011$
+	jmp	fsmul_ret_0
+00011$:
+	bne	00010$
+
+	; Drop the hidden bit, pack.
+	lda	*fsmul_r
+	lsla
+	lsr	*(fsmul_exp+1)
+	rora
+	sta	*___SDCC_hc08_ret2
+	lda	*(fsmul_exp+1)
+	ora	*fsmul_sign
+	sta	*___SDCC_hc08_ret3
+	ldx	*(fsmul_r+1)
+	lda	*(fsmul_r+2)
+	rts
+
+00010$:
+	; Exponent >= 256: return infinity.
+	lda	*fsmul_sign
+	ora	#0x7f
+	sta	*___SDCC_hc08_ret3
+	mov	#0x80,*___SDCC_hc08_ret2
+	clrx
+	clra
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_fsmul.c"
+
+#endif
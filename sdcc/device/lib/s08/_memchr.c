@@ -0,0 +1,109 @@
+/*-------------------------------------------------------------------------
+   _memchr.c - search memory for a byte for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* cbeq compares and increments the pointer in one instruction; it is
+   unrolled four times per round of the loop. */
+
+#include <stddef.h>
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+void *
+memchr (const void *s, int c, size_t n) __naked
+{
+  s, c, n;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+memchr_n:
+	.ds	3
+	.area	CSEG	(CODE)
+
+	psha
+	pshx
+
+	; Rounds of 4 bytes, counted as with two nested dbnz loops.
+	lda	_memchr_PARM_3
+	ldx	(_memchr_PARM_3+1)
+	stx	*(memchr_n+2)
+	lsra
+	rorx
+	lsra
+	rorx
+	stx	*(memchr_n+1)
+	tstx
+	beq	00001$
+	inca
+00001$:
+	sta	*memchr_n
+	lda	*(memchr_n+2)
+	and	#3
+	sta	*(memchr_n+2)
+
+	pulh
+	pulx
+	lda	(_memchr_PARM_2+1)
+
+	; The remaining n % 4 bytes first.
+	tst	*(memchr_n+2)
+	beq	00003$
+00002$:
+	cbeq	,x+,00010$
+	dbnz	*(memchr_n+2),00002$
+00003$:
+	tst	*memchr_n
+	beq	00005$
+00004$:
+	cbeq	,x+,00010$
+	cbeq	,x+,00010$
+	cbeq	,x+,00010$
+	cbeq	,x+,00010$
+	dbnz	*(memchr_n+1),00004$
+	dbnz	*memchr_n,00004$
+00005$:
+	clra
+	clrx
+	rts
+
+00010$:
+	aix	#-1
+	pshh
+	txa
+	pulx
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_memchr.c"
+
+#endif
@@ -0,0 +1,148 @@
+/*-------------------------------------------------------------------------
+   _memcmp.c - compare memory for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* With a single index register, four bytes of s1 at a time are moved to
+   the direct page, then compared to s2. Like ../_memcmp.c, this returns
+   the difference of the first pair of bytes that differ. */
+
+#include <stddef.h>
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+int
+memcmp (const void *s1, const void *s2, size_t n) __naked
+{
+  s1, s2, n;	/* reference to make compiler happy */
+
+  __asm
+	.area	OSEG	(PAG, OVR)
+memcmp_s1:
+	.ds	2
+memcmp_s2:
+	.ds	2
+memcmp_b:
+	.ds	4
+memcmp_n:
+	.ds	3
+	.area	CSEG	(CODE)
+
+	sta	*(memcmp_s1+1)
+	stx	*memcmp_s1
+	lda	_memcmp_PARM_2
+	sta	*memcmp_s2
+	lda	(_memcmp_PARM_2+1)
+	sta	*(memcmp_s2+1)
+
+	; Rounds of 4 bytes, counted as with two nested dbnz loops.
+	lda	_memcmp_PARM_3
+	ldx	(_memcmp_PARM_3+1)
+	stx	*(memcmp_n+2)
+	lsra
+	rorx
+	lsra
+	rorx
+	stx	*(memcmp_n+1)
+	tstx
+	beq	00001$
+	inca
+00001$:
+	sta	*memcmp_n
+
+	; The remaining n % 4 bytes first.
+	lda	*(memcmp_n+2)
+	and	#3
+	beq	00003$
+	sta	*(memcmp_n+2)
+00002$:
+	ldhx	*memcmp_s1
+	lda	,x
+	aix	#1
+	sthx	*memcmp_s1
+	ldhx	*memcmp_s2
+	cmp	,x
+	bne	00010$
+	aix	#1
+	sthx	*memcmp_s2
+	dbnz	*(memcmp_n+2),00002$
+00003$:
+	tst	*memcmp_n
+	beq	00005$
+00004$:
+	ldhx	*memcmp_s1
+	mov	,x+,*memcmp_b
+	mov	,x+,*(memcmp_b+1)
+	mov	,x+,*(memcmp_b+2)
+	mov	,x+,*(memcmp_b+3)
+	sthx	*memcmp_s1
+	ldhx	*memcmp_s2
+	lda	*memcmp_b
+	cmp	,x
+	bne	00010$
+	lda	*(memcmp_b+1)
+	cmp	1,x
+	bne	00009$
+	lda	*(memcmp_b+2)
+	cmp	2,x
+	bne	00008$
+	lda	*(memcmp_b+3)
+	cmp	3,x
+	bne	00007$
+	aix	#4
+	sthx	*memcmp_s2
+	dbnz	*(memcmp_n+1),00004$
+	dbnz	*memcmp_n,00004$
+00005$:
+	clra
+	clrx
+	rts
+
+	; The bytes differ, hx + 3, 2, 1 or 0 points to the one of s2.
+00007$:
+	aix	#1
+00008$:
+	aix	#1
+00009$:
+	aix	#1
+00010$:
+	sub	,x
+	clrx
+	bcc	00011$
+	decx
+00011$:
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_memcmp.c"
+
+#endif
@@ -0,0 +1,79 @@
+/*-------------------------------------------------------------------------
+   _strlen.c - length of a string for the hc08
+
+   This library is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING. If not, write to the
+   Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+   MA 02110-1301, USA.
+
+   As a special exception, if you link this library with other files,
+   some of which are compiled with SDCC, to produce an executable,
+   this library does not by itself cause the resulting executable to
+   be covered by the GNU General Public License. This exception does
+   not however invalidate any other reasons why the executable file
+   might be covered by the GNU General Public License.
+-------------------------------------------------------------------------*/
+
+/* cbeq compares and increments the pointer in one instruction; it is
+   unrolled four times per round of the loop. */
+
+#include <stddef.h>
+
+#if !defined(__SDCC_STACK_AUTO) && !defined(_SDCC_NO_ASM_LIB_FUNCS)
+
+#pragma save
+#pragma less_pedantic
+
+size_t
+strlen (const char *s) __naked
+{
+  s;	/* reference to make compiler happy */
+
+  __asm
+	psha
+	pshx
+	pshx
+	pulh
+	tax
+	clra
+00001$:
+	cbeq	,x+,00002$
+	cbeq	,x+,00002$
+	cbeq	,x+,00002$
+	cbeq	,x+,00002$
+	bra	00001$
+
+	; Return hx - 1 - s.
+00002$:
+	aix	#-1
+	txa
+	sub	2,s
+	pshh
+	tax
+	pula
+	sbc	1,s
+	ais	#2
+	psha
+	txa
+	pulx
+	rts
+  __endasm;
+}
+
+#pragma restore
+
+#else
+
+#include "../_strlen.c"
+
+#endif
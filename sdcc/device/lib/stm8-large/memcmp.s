@@ -0,0 +1,112 @@
+;--------------------------------------------------------------------------
+;  memcmp.s - compare memory
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+; This memcmp() implementation has been optimized for speed using 4x loop
+; unrolling and index relative addressing. Like _memcmp.c, it returns the
+; difference of the first pair of bytes that differ.
+
+; int memcmp(const void *s1, const void *s2, size_t n);
+
+	.globl _memcmp
+
+	.area CODE
+
+_memcmp:
+	ldw	x, (4, sp)
+	ldw	y, (6, sp)
+
+	srl	(8, sp)
+	rrc	(9, sp)
+	jrnc	n_x0
+	ld	a, (x)
+	cp	a, (y)
+	jrne	diff
+	incw	x
+	incw	y
+n_x0:
+	srl	(8, sp)
+	rrc	(9, sp)
+	jrnc	n_00
+	ld	a, (x)
+	cp	a, (y)
+	jrne	diff
+	ld	a, (1, x)
+	cp	a, (1, y)
+	jrne	diff_1
+	incw	x
+	incw	y
+	incw	x
+	incw	y
+n_00:
+	tnz	(9, sp)
+	jrne	loop_ent
+	dec	(8, sp)
+	jrmi	equal
+	jra	loop_ent
+
+loop:
+	addw	x, #4
+	addw	y, #4
+loop_ent:
+	ld	a, (x)
+	cp	a, (y)
+	jrne	diff
+	ld	a, (1, x)
+	cp	a, (1, y)
+	jrne	diff_1
+	ld	a, (2, x)
+	cp	a, (2, y)
+	jrne	diff_2
+	ld	a, (3, x)
+	cp	a, (3, y)
+	jrne	diff_3
+
+	dec	(9, sp)
+	jrne	loop
+	dec	(8, sp)
+	jrpl	loop
+
+equal:
+	clrw	x
+	retf
+
+diff_3:
+	incw	y
+diff_2:
+	incw	y
+diff_1:
+	incw	y
+diff:
+	sub	a, (y)
+	jrc	less
+	clrw	x
+	ld	xl, a
+	retf
+
+less:
+	ldw	x, #0xff00
+	ld	xl, a
+	retf
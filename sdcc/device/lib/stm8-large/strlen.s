@@ -0,0 +1,59 @@
+;--------------------------------------------------------------------------
+;  strlen.s - length of a string
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+; This strlen() implementation has been optimized for speed using 4x loop
+; unrolling and index relative addressing.
+
+; size_t strlen(const char *s);
+
+	.globl _strlen
+
+	.area CODE
+
+_strlen:
+	ldw	x, (4, sp)
+
+loop:
+	tnz	(x)
+	jreq	end
+	tnz	(1, x)
+	jreq	end_1
+	tnz	(2, x)
+	jreq	end_2
+	tnz	(3, x)
+	jreq	end_3
+	addw	x, #4
+	jra	loop
+
+end_3:
+	incw	x
+end_2:
+	incw	x
+end_1:
+	incw	x
+end:
+	subw	x, (4, sp)
+	retf
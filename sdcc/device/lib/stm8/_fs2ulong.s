@@ -0,0 +1,100 @@
+;--------------------------------------------------------------------------
+;  _fs2ulong.s - float to long conversion
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; unsigned long __fs2ulong (float a1);
+; signed long __fs2slong (float f);
+;
+; These give the same results as the C versions, bit for bit: the fraction
+; is truncated, negative floats give 0 in __fs2ulong, and floats too large
+; for the mantissa to be shifted right give 0.
+
+	.globl	___fs2ulong
+	.globl	___fs2slong
+
+	.area CODE
+
+___fs2slong:
+	ldw	x, (5, sp)
+	ldw	y, (3, sp)
+	jrpl	fs2ulong
+	ld	a, yh
+	and	a, #0x7f
+	ld	yh, a
+	callr	fs2ulong
+	jp	__fast_long_neg
+
+___fs2ulong:
+	ldw	x, (5, sp)
+	ldw	y, (3, sp)
+	jrmi	fs2ulong_ret_0
+
+	; Convert the float in y:x.
+fs2ulong:
+	ld	a, yl
+	sll	a
+	ld	a, yh
+	rlc	a
+	sub	a, #127
+	jrc	fs2ulong_ret_0
+	cp	a, #24
+	jruge	fs2ulong_ret_0
+	neg	a
+	add	a, #23
+	push	a
+	; (1, sp): shift count.
+	ld	a, yl
+	or	a, #0x80
+	clrw	y
+	ld	yl, a
+
+	; Shift the mantissa right, a byte at a time first.
+00101$:
+	ld	a, (1, sp)
+	cp	a, #8
+	jrult	00102$
+	sub	a, #8
+	ld	(1, sp), a
+	clr	a
+	rrwa	y
+	rrwa	x
+	jra	00101$
+00102$:
+	tnz	a
+	jreq	00104$
+00103$:
+	srlw	y
+	rrcw	x
+	dec	a
+	jrne	00103$
+00104$:
+	pop	a
+	ret
+
+fs2ulong_ret_0:
+	clrw	x
+	clrw	y
+	ret
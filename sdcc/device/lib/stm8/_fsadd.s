@@ -0,0 +1,289 @@
+;--------------------------------------------------------------------------
+;  _fsadd.s - float addition and subtraction
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+; float __fsadd (float a1, float a2);
+; float __fssub (float a1, float a2);
+;
+; These give the same results as the C versions in device/lib, bit for bit:
+; the mantissas are scaled by 16 and added as signed longs, the arithmetic
+; right shift of the one with the smaller exponent truncates towards minus
+; infinity, and the result is truncated except when the sum overflows.
+; a1 - a2 is computed as -((-a1) + a2), as _fssub.c does.
+
+	.globl	___fsadd
+	.globl	___fssub
+
+	.area CODE
+
+fsadd_ret_a2:
+	; Return a2.
+	ldw	x, (15, sp)
+	ldw	y, (13, sp)
+	jra	fsadd_ret
+fsadd_ret_a1:
+	; Return a1.
+	ldw	x, (11, sp)
+	ldw	y, (9, sp)
+fsadd_ret:
+	ld	a, yh
+	xor	a, (1, sp)
+	ld	yh, a
+	addw	sp, #6
+	ret
+
+___fssub:
+	ld	a, (3, sp)
+	xor	a, #0x80
+	ld	(3, sp), a
+	ld	a, #0x80
+	jra	fsadd_flip
+
+___fsadd:
+	clr	a
+fsadd_flip:
+	sub	sp, #6
+	; (1, sp): sign flip of the result, (2, sp): exponent difference,
+	; (4, sp): sign of the sum, (5, sp): shift count, (6, sp): exponent,
+	; a1 at (9, sp), a2 at (13, sp).
+	ld	(1, sp), a
+	clr	(4, sp)
+
+	; a2 == 0: return a1.
+	ldw	x, (15, sp)
+	jrne	00101$
+	ldw	x, (13, sp)
+	jreq	fsadd_ret_a1
+00101$:
+	; a1 == 0: return a2.
+	ldw	x, (11, sp)
+	jrne	00102$
+	ldw	x, (9, sp)
+	jreq	fsadd_ret_a2
+00102$:
+	; Make a1 the argument with the larger exponent.
+	ld	a, (10, sp)
+	sll	a
+	ld	a, (9, sp)
+	rlc	a
+	ld	(6, sp), a
+	ld	a, (14, sp)
+	sll	a
+	ld	a, (13, sp)
+	rlc	a
+	sub	a, (6, sp)
+	jrule	00103$
+	ld	(2, sp), a
+	add	a, (6, sp)
+	ld	(6, sp), a
+	ldw	x, (9, sp)
+	ldw	y, (13, sp)
+	ldw	(13, sp), x
+	ldw	(9, sp), y
+	ldw	x, (11, sp)
+	ldw	y, (15, sp)
+	ldw	(15, sp), x
+	ldw	(11, sp), y
+	ld	a, (2, sp)
+	jra	00104$
+00103$:
+	neg	a
+	ld	(2, sp), a
+00104$:
+	cp	a, #26
+	jruge	fsadd_ret_a1
+
+	; y:x = mantissa of a1 << 4, negated for a negative a1.
+	ld	a, (10, sp)
+	or	a, #0x80
+	clrw	y
+	ld	yl, a
+	ldw	x, (11, sp)
+	sllw	x
+	rlcw	y
+	sllw	x
+	rlcw	y
+	sllw	x
+	rlcw	y
+	sllw	x
+	rlcw	y
+	tnz	(9, sp)
+	jrpl	00105$
+	cplw	y
+	negw	x
+	jrc	00105$
+	incw	y
+00105$:
+	ldw	(11, sp), x
+	ldw	(9, sp), y
+
+	; y:x = mantissa of a2, negated for a negative a2,
+	; then shifted left by 4 - k (k = exponent difference).
+	ld	a, (14, sp)
+	or	a, #0x80
+	clrw	y
+	ld	yl, a
+	ldw	x, (15, sp)
+	tnz	(13, sp)
+	jrpl	00106$
+	cplw	y
+	negw	x
+	jrc	00106$
+	incw	y
+00106$:
+	ld	a, (2, sp)
+	sub	a, #4
+	jrnc	00110$
+00107$:
+	sllw	x
+	rlcw	y
+	inc	a
+	jrne	00107$
+	jra	00120$
+00110$:
+	cp	a, #8
+	jrult	00112$
+	ld	(2, sp), a
+	ld	a, yh
+	rrwa	y
+	rrwa	x
+	ld	a, (2, sp)
+	sub	a, #8
+	jra	00110$
+00112$:
+	tnz	a
+	jreq	00120$
+00113$:
+	sraw	y
+	rrcw	x
+	dec	a
+	jrne	00113$
+
+00120$:
+	; Add, and split the sum into sign and magnitude.
+	addw	x, (11, sp)
+	jrnc	00121$
+	incw	y
+00121$:
+	addw	y, (9, sp)
+	jrpl	00122$
+	cplw	y
+	negw	x
+	jrc	00123$
+	incw	y
+00123$:
+	ld	a, #0x80
+	ld	(4, sp), a
+	jra	00124$
+00122$:
+	jrne	00124$
+	tnzw	x
+	jreq	00192$
+
+00124$:
+	; Normalize.
+	cpw	y, #0x0800
+	jruge	00130$
+	clr	(5, sp)
+00125$:
+	cpw	y, #0x0008
+	jruge	00127$
+	clr	a
+	rlwa	x
+	rlwa	y
+	ld	a, (5, sp)
+	add	a, #8
+	ld	(5, sp), a
+	jra	00125$
+00127$:
+	ld	a, (5, sp)
+00128$:
+	cpw	y, #0x0800
+	jruge	00129$
+	sllw	x
+	rlcw	y
+	inc	a
+	jra	00128$
+00129$:
+	ld	(5, sp), a
+	ld	a, (6, sp)
+	sub	a, (5, sp)
+	jrc	00192$
+	ld	(6, sp), a
+	jra	00140$
+
+00130$:
+	; Round off while the sum has overflowed.
+	cpw	y, #0x1000
+	jrult	00140$
+	ld	a, xl
+	srl	a
+	jrnc	00131$
+	addw	x, #2
+	jrnc	00131$
+	incw	y
+00131$:
+	srlw	y
+	rrcw	x
+	inc	(6, sp)
+	jreq	00193$
+	jra	00130$
+
+00140$:
+	; Drop the 4 extra bits and the hidden bit, pack.
+	srlw	y
+	rrcw	x
+	srlw	y
+	rrcw	x
+	srlw	y
+	rrcw	x
+	srlw	y
+	rrcw	x
+	ld	a, yl
+	sll	a
+	srl	(6, sp)
+	rrc	a
+	ld	yl, a
+	ld	a, (6, sp)
+	or	a, (4, sp)
+	jra	00195$
+
+00192$:
+	; Return 0.
+	clrw	x
+	clrw	y
+	clr	a
+	jra	00195$
+00193$:
+	; Return infinity.
+	clrw	x
+	ldw	y, #0x0080
+	ld	a, (4, sp)
+	or	a, #0x7f
+00195$:
+	xor	a, (1, sp)
+	ld	yh, a
+	addw	sp, #6
+	ret
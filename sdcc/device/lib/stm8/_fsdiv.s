@@ -0,0 +1,208 @@
+;--------------------------------------------------------------------------
+;  _fsdiv.s - float division
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; float __fsdiv (float a1, float a2);
+;
+; This gives the same results as _fsdiv.c, bit for bit: a 25 bit quotient
+; of the mantissas is computed by restoring division and then rounded.
+
+	.globl	___fsdiv
+
+	.area CODE
+
+___fsdiv:
+	; a2 == 0: return NaN for 0 / 0, otherwise infinity with the sign of a1.
+	ldw	x, (9, sp)
+	jrne	00102$
+	ld	a, (7, sp)
+	sll	a
+	or	a, (8, sp)
+	jrne	00102$
+	ldw	y, #0x7f80
+	tnz	(3, sp)
+	jrpl	00101$
+	ldw	y, #0xff80
+00101$:
+	ldw	x, (5, sp)
+	jrne	00100$
+	ld	a, (3, sp)
+	sll	a
+	or	a, (4, sp)
+	jrne	00100$
+	ldw	y, #0xffc0
+00100$:
+	clrw	x
+	ret
+
+00102$:
+	; a1 == 0: return 0.
+	ldw	x, (5, sp)
+	jrne	00103$
+	ldw	y, (3, sp)
+	jrne	00103$
+	clrw	x
+	ret
+
+00103$:
+	sub	sp, #8
+	; (1, sp): quotient, (5, sp): sign, (6, sp): loop counter,
+	; (7, sp): exponent, a1 at (11, sp), a2 at (15, sp).
+
+	ld	a, (11, sp)
+	xor	a, (15, sp)
+	and	a, #0x80
+	ld	(5, sp), a
+
+	; Difference of the exponents.
+	clr	(7, sp)
+	ld	a, (16, sp)
+	sll	a
+	ld	a, (15, sp)
+	rlc	a
+	ld	(8, sp), a
+	ld	a, (12, sp)
+	sll	a
+	ld	a, (11, sp)
+	rlc	a
+	clrw	x
+	ld	xl, a
+	subw	x, (7, sp)
+	addw	x, #126
+	ldw	(7, sp), x
+
+	clrw	x
+	ldw	(1, sp), x
+	ldw	(3, sp), x
+
+	; Mantissas, a1 in y:x, a2 in place.
+	clr	(15, sp)
+	ld	a, (16, sp)
+	or	a, #0x80
+	ld	(16, sp), a
+	ld	a, (12, sp)
+	or	a, #0x80
+	clrw	y
+	ld	yl, a
+	ldw	x, (13, sp)
+
+	; Make sure there are 25 bits of quotient.
+	cp	a, (16, sp)
+	jrugt	00105$
+	jrult	00104$
+	cpw	x, (17, sp)
+	jruge	00105$
+00104$:
+	sllw	x
+	rlcw	y
+	ld	a, (8, sp)
+	sub	a, #1
+	ld	(8, sp), a
+	jrnc	00105$
+	dec	(7, sp)
+00105$:
+
+	; Restoring division, one quotient bit per round.
+	ld	a, #25
+	ld	(6, sp), a
+00106$:
+	subw	x, (17, sp)
+	ld	a, yl
+	sbc	a, (16, sp)
+	ld	yl, a
+	ld	a, yh
+	sbc	a, #0
+	ld	yh, a
+	jrnc	00107$
+	addw	x, (17, sp)
+	ld	a, yl
+	adc	a, (16, sp)
+	ld	yl, a
+	ld	a, yh
+	adc	a, #0
+	ld	yh, a
+	rcf
+	jra	00108$
+00107$:
+	scf
+00108$:
+	rlc	(4, sp)
+	rlc	(3, sp)
+	rlc	(2, sp)
+	sllw	x
+	rlcw	y
+	dec	(6, sp)
+	jrne	00106$
+
+	; Round and normalize.
+	ldw	x, (3, sp)
+	clrw	y
+	ld	a, (2, sp)
+	ld	yl, a
+	incw	x
+	jrne	00109$
+	incw	y
+00109$:
+	srlw	y
+	rrcw	x
+	ldw	(1, sp), x
+	ldw	x, (7, sp)
+	incw	x
+	jrmi	00120$
+	ld	a, xh
+	tnz	a
+	jrne	00121$
+	ld	a, xl
+	ld	(8, sp), a
+	ldw	x, (1, sp)
+
+	; Pack.
+	ld	a, yl
+	sll	a
+	srl	(8, sp)
+	rrc	a
+	ld	yl, a
+	ld	a, (8, sp)
+	or	a, (5, sp)
+	ld	yh, a
+	addw	sp, #8
+	ret
+
+00120$:
+	; Exponent < 0: return 0.
+	clrw	x
+	clrw	y
+	addw	sp, #8
+	ret
+00121$:
+	; Exponent >= 256: return infinity.
+	clrw	x
+	ldw	y, #0x7f80
+	ld	a, (5, sp)
+	or	a, #0x7f
+	ld	yh, a
+	addw	sp, #8
+	ret
@@ -0,0 +1,75 @@
+;--------------------------------------------------------------------------
+;  _fslt.s - float comparison
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; char __fslt (float a1, float a2);
+;
+; Like _fslt.c, this compares the floats as signed longs, with the order
+; reversed when both are negative, and +0 and -0 compare equal.
+
+	.globl	___fslt
+
+	.area CODE
+
+___fslt:
+	; a1 == 0 && a2 == 0: return 0.
+	ld	a, (3, sp)
+	or	a, (7, sp)
+	and	a, #0x7f
+	or	a, (4, sp)
+	or	a, (8, sp)
+	or	a, (5, sp)
+	or	a, (6, sp)
+	or	a, (9, sp)
+	or	a, (10, sp)
+	jreq	00103$
+	; Both negative: return a2 < a1.
+	ld	a, (3, sp)
+	and	a, (7, sp)
+	jrpl	00101$
+	ldw	x, (9, sp)
+	subw	x, (5, sp)
+	ld	a, (8, sp)
+	sbc	a, (4, sp)
+	ld	a, (7, sp)
+	sbc	a, (3, sp)
+	jra	00102$
+00101$:
+	; Otherwise return a1 < a2.
+	ldw	x, (5, sp)
+	subw	x, (9, sp)
+	ld	a, (4, sp)
+	sbc	a, (8, sp)
+	ld	a, (3, sp)
+	sbc	a, (7, sp)
+00102$:
+	jrsge	00104$
+	ld	a, #1
+	ret
+00104$:
+	clr	a
+00103$:
+	ret
@@ -0,0 +1,219 @@
+;--------------------------------------------------------------------------
+;  _fsmul.s - float multiplication
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; float __fsmul (float a1, float a2);
+;
+; This gives the same results as _fsmul.c, bit for bit: the product of the
+; mantissas is computed as one 16x16 multiply and two 16x8 multiplies,
+; leaving out the product of the low bytes, and then rounded.
+
+	.globl	___fsmul
+
+	.area CODE
+
+fsmul_ret_0:
+	clrw	x
+	clrw	y
+	ret
+
+___fsmul:
+	; a1 == 0 || a2 == 0: return 0.
+	ldw	x, (5, sp)
+	jrne	00101$
+	ldw	x, (3, sp)
+	jreq	fsmul_ret_0
+00101$:
+	ldw	x, (9, sp)
+	jrne	00102$
+	ldw	x, (7, sp)
+	jreq	fsmul_ret_0
+00102$:
+	sub	sp, #8
+	; (1, sp): product, (5, sp): sign, (6, sp): scratch, (7, sp): exponent,
+	; a1 at (11, sp), a2 at (15, sp).
+
+	ld	a, (11, sp)
+	xor	a, (15, sp)
+	and	a, #0x80
+	ld	(5, sp), a
+
+	; Sum of the exponents.
+	ld	a, (16, sp)
+	sll	a
+	ld	a, (15, sp)
+	rlc	a
+	ld	(6, sp), a
+	ld	a, (12, sp)
+	sll	a
+	ld	a, (11, sp)
+	rlc	a
+	add	a, (6, sp)
+	ld	(8, sp), a
+	clr	a
+	rlc	a
+	ld	(7, sp), a
+
+	; Hidden bits.
+	ld	a, (12, sp)
+	or	a, #0x80
+	ld	(12, sp), a
+	ld	a, (16, sp)
+	or	a, #0x80
+	ld	(16, sp), a
+
+	; Low word: am * bm + (al * bm) / 256 + (bl * am) / 256 + 0x40
+	; + al * bh + bl * ah, with the carries counted in y.
+	clrw	y
+	ld	a, (13, sp)
+	ld	xl, a
+	ld	a, (17, sp)
+	mul	x, a
+	ldw	(3, sp), x
+	ld	a, (14, sp)
+	ld	xl, a
+	ld	a, (17, sp)
+	mul	x, a
+	ld	a, xh
+	clrw	x
+	ld	xl, a
+	addw	x, (3, sp)
+	ldw	(3, sp), x
+	ld	a, (18, sp)
+	ld	xl, a
+	ld	a, (13, sp)
+	mul	x, a
+	ld	a, xh
+	clrw	x
+	ld	xl, a
+	addw	x, (3, sp)
+	addw	x, #0x40
+	jrnc	00103$
+	incw	y
+00103$:
+	ldw	(3, sp), x
+	ld	a, (14, sp)
+	ld	xl, a
+	ld	a, (16, sp)
+	mul	x, a
+	addw	x, (3, sp)
+	jrnc	00104$
+	incw	y
+00104$:
+	ldw	(3, sp), x
+	ld	a, (18, sp)
+	ld	xl, a
+	ld	a, (12, sp)
+	mul	x, a
+	addw	x, (3, sp)
+	jrnc	00105$
+	incw	y
+00105$:
+	ldw	(3, sp), x
+
+	; High word: ah * bh plus the carries.
+	ldw	(1, sp), y
+	ld	a, (12, sp)
+	ld	xl, a
+	ld	a, (16, sp)
+	mul	x, a
+	addw	x, (1, sp)
+	ldw	(1, sp), x
+
+	; Middle: ah * bm + am * bh.
+	ld	a, (12, sp)
+	ld	xl, a
+	ld	a, (17, sp)
+	mul	x, a
+	addw	x, (2, sp)
+	ldw	(2, sp), x
+	jrnc	00106$
+	inc	(1, sp)
+00106$:
+	ld	a, (13, sp)
+	ld	xl, a
+	ld	a, (16, sp)
+	mul	x, a
+	addw	x, (2, sp)
+	ldw	(2, sp), x
+	jrnc	00107$
+	inc	(1, sp)
+00107$:
+
+	; Round and normalize, the exponent is the sum minus 126 or 127.
+	ldw	x, (3, sp)
+	ldw	y, (1, sp)
+	jrmi	00108$
+	sllw	x
+	rlcw	y
+	ld	a, #127
+	jra	00109$
+00108$:
+	addw	x, #0x40
+	jrnc	00110$
+	incw	y
+00110$:
+	ld	a, #126
+00109$:
+	ld	(6, sp), a
+	ld	a, (8, sp)
+	sub	a, (6, sp)
+	ld	(8, sp), a
+	ld	a, (7, sp)
+	sbc	a, #0
+	jrmi	00120$
+	jrne	00121$
+
+	; Pack.
+	clr	a
+	rrwa	y
+	rrwa	x
+	ld	a, yl
+	sll	a
+	srl	(8, sp)
+	rrc	a
+	ld	yl, a
+	ld	a, (8, sp)
+	or	a, (5, sp)
+	ld	yh, a
+	addw	sp, #8
+	ret
+
+00120$:
+	; Exponent < 0: return 0.
+	clrw	x
+	clrw	y
+	addw	sp, #8
+	ret
+00121$:
+	; Exponent >= 256: return infinity.
+	clrw	x
+	ldw	y, #0x7f80
+	ld	a, (5, sp)
+	or	a, #0x7f
+	ld	yh, a
+	addw	sp, #8
+	ret
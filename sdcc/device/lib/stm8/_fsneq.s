@@ -0,0 +1,59 @@
+;--------------------------------------------------------------------------
+;  _fsneq.s - float comparison
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; char __fsneq (float a1, float a2);
+;
+; Like _fsneq.c, this compares the bit patterns, except that +0 and -0
+; compare equal.
+
+	.globl	___fsneq
+
+	.area CODE
+
+___fsneq:
+	ldw	x, (3, sp)
+	cpw	x, (7, sp)
+	jrne	00101$
+	ldw	x, (5, sp)
+	cpw	x, (9, sp)
+	jreq	00102$
+00101$:
+	ld	a, (3, sp)
+	or	a, (7, sp)
+	and	a, #0x7f
+	or	a, (4, sp)
+	or	a, (8, sp)
+	or	a, (5, sp)
+	or	a, (6, sp)
+	or	a, (9, sp)
+	or	a, (10, sp)
+	jreq	00102$
+	ld	a, #1
+	ret
+00102$:
+	clr	a
+	ret
@@ -0,0 +1,117 @@
+;--------------------------------------------------------------------------
+;  _ulong2fs.s - long to float conversion
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+
+; float __ulong2fs (unsigned long a);
+; float __slong2fs (signed long sl);
+;
+; These give the same results as the C versions, bit for bit: the long is
+; shifted right one bit at a time until it fits the mantissa, rounding each
+; time. __slong2fs converts the magnitude and sets the sign bit.
+
+	.globl	___ulong2fs
+	.globl	___slong2fs
+
+	.area CODE
+
+___slong2fs:
+	ldw	x, (5, sp)
+	ldw	y, (3, sp)
+	jrpl	ulong2fs
+	cplw	y
+	negw	x
+	jrc	00101$
+	incw	y
+00101$:
+	callr	ulong2fs
+	ld	a, yh
+	xor	a, #0x80
+	ld	yh, a
+	ret
+
+___ulong2fs:
+	ldw	x, (5, sp)
+	ldw	y, (3, sp)
+
+	; Convert y:x.
+ulong2fs:
+	tnzw	y
+	jrne	00102$
+	tnzw	x
+	jrne	00103$
+	ret
+00102$:
+	push	#150
+	; (1, sp): exponent.
+	jra	00105$
+00103$:
+	push	#150
+
+	; Normalize up, a byte at a time while that fits.
+00104$:
+	clr	a
+	rlwa	x
+	rlwa	y
+	ld	a, (1, sp)
+	sub	a, #8
+	ld	(1, sp), a
+	tnzw	y
+	jreq	00104$
+00105$:
+	cpw	y, #0x0080
+	jruge	00106$
+	sllw	x
+	rlcw	y
+	dec	(1, sp)
+	jra	00105$
+
+	; Normalize down, rounding each bit.
+00106$:
+	ld	a, yh
+	tnz	a
+	jreq	00108$
+	ld	a, xl
+	srl	a
+	jrnc	00107$
+	addw	x, #2
+	jrnc	00107$
+	incw	y
+00107$:
+	srlw	y
+	rrcw	x
+	inc	(1, sp)
+	jra	00106$
+
+	; Drop the hidden bit, pack.
+00108$:
+	ld	a, yl
+	sll	a
+	srl	(1, sp)
+	rrc	a
+	ld	yl, a
+	pop	a
+	ld	yh, a
+	ret
@@ -0,0 +1,74 @@
+;--------------------------------------------------------------------------
+;  memset.s - fill memory
+;
+;  This library is free software; you can redistribute it and/or modify it
+;  under the terms of the GNU General Public License as published by the
+;  Free Software Foundation; either version 2, or (at your option) any
+;  later version.
+;
+;  This library is distributed in the hope that it will be useful,
+;  but WITHOUT ANY WARRANTY; without even the implied warranty of
+;  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+;  GNU General Public License for more details.
+;
+;  You should have received a copy of the GNU General Public License
+;  along with this library; see the file COPYING. If not, write to the
+;  Free Software Foundation, 51 Franklin Street, Fifth Floor, Boston,
+;   MA 02110-1301, USA.
+;
+;  As a special exception, if you link this library with other files,
+;  some of which are compiled with SDCC, to produce an executable,
+;  this library does not by itself cause the resulting executable to
+;  be covered by the GNU General Public License. This exception does
+;  not however invalidate any other reasons why the executable file
+;   might be covered by the GNU General Public License.
+;--------------------------------------------------------------------------
+
+; This memset() implementation has been optimized for speed: the fill byte
+; is doubled into y and stored a word at a time, with 2x loop unrolling.
+
+; void *memset(void *s, int c, size_t n);
+
+	.globl _memset
+
+	.area CODE
+
+_memset:
+	ldw	x, (3, sp)
+	ld	a, (6, sp)
+	ld	yl, a
+	ld	yh, a
+
+	srl	(7, sp)
+	rrc	(8, sp)
+	jrnc	n_x0
+	ld	(x), a
+	incw	x
+n_x0:
+	srl	(7, sp)
+	rrc	(8, sp)
+	jrnc	n_00
+	ldw	(x), y
+	incw	x
+	incw	x
+n_00:
+	tnz	(8, sp)
+	jrne	loop_ent
+	dec	(7, sp)
+	jrmi	end
+	jra	loop_ent
+
+loop:
+	addw	x, #4
+loop_ent:
+	ldw	(x), y
+	ldw	(2, x), y
+
+	dec	(8, sp)
+	jrne	loop
+	dec	(7, sp)
+	jrpl	loop
+
+end:
+	ldw	x, (3, sp)
+	ret
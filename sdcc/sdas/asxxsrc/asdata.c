@@ -234,6 +234,8 @@ int     oflag;          /*      -o, generate relocatable output flag
                          */
 int     pflag;          /*      -p, disable listing pagination
                          */
+int     rflag;          /*      -r, binary T/R/P records in object file
+                         */
 int     sflag;          /*      -s, generate symbol table flag
                          */
 int     uflag;          /*      -u, disable .list/.nlist processing flag
@@ -53,11 +53,20 @@
  *              VOID    getst()
  *              int     more()
  *              int     nxtline()
+ *              size_t  srcgetl()
+ *              srcfil *srcfind()
+ *              srcfil *srcread()
  *              VOID    unget()
  *
- *      aslex.c contains no local/static variables
+ *      aslex.c contains the static variable
+ *              srcfil *srcp
+ *      the list of source files read into memory.
  */
 
+static  struct  srcfil  *srcp;
+
+static  size_t          srcgetl(struct dbuf_s *dbuf, struct asmf *ap);
+
 /*)Function     VOID    getid(id,c)
  *
  *              char *  id              a pointer to a string of
@@ -555,15 +564,14 @@ comma(int flag)
  *      called functions:
  *              int     dbuf_init()
  *              int     dbuf_set_length()
- *              int     dbuf_getline()
  *              const char * dbuf_c_str()
  *              int     dbuf_append_str()
- *              int     fclose()        c-library
  *              char *  fgetm()         asmcro.c
+ *              size_t  srcgetl()       aslex.c
  *              char *  strcpy()        c_library
  *
  *      side effects:
- *              include file will be closed at detection of end of file.
+ *              include file will be left at detection of end of file.
  *              the next sequential source file may be selected.
  *              The current file specification afn[] and the path
  *              length afp may be changed.
@@ -638,8 +646,9 @@ comma(int flag)
  *      Macros may be invoked within include files and include
  *      files can be invoked within macros.
  *
- *      Include files are opened, read, and closed on each pass
- *      of the assembler.
+ *      Source and include files are read into memory once, in
+ *      the first pass of the assembler.  The following passes
+ *      take the lines from memory.
  *
  *      Macros are recreated during each pass of the assembler.
  */
@@ -680,7 +689,7 @@ loop:   if (asmc == NULL) return(0);
 
         switch(asmc->objtyp) {
         case T_ASM:
-                if ((len = dbuf_getline (&dbuf_ib, asmc->fp)) == 0) {
+                if ((len = srcgetl (&dbuf_ib, asmc)) == 0) {
                         if ((asmc->flevel != flevel) || (asmc->tlevel != tlevel)) {
                                 err('i');
                                 fprintf(stderr, "?ASxxxx-Error-<i> at end of assembler file\n");
@@ -707,8 +716,7 @@ loop:   if (asmc == NULL) return(0);
                 break;
 
         case T_INCL:
-                if ((len = dbuf_getline (&dbuf_ib, asmc->fp)) == 0) {
-                        fclose(asmc->fp);
+                if ((len = srcgetl (&dbuf_ib, asmc)) == 0) {
                         incfil -= 1;
                         if ((asmc->flevel != flevel) || (asmc->tlevel != tlevel)) {
                                 err('i');
@@ -802,6 +810,135 @@ loop:   if (asmc == NULL) return(0);
         return(1);
 }
 
+/*)Function     size_t  srcgetl(dbuf, ap)
+ *
+ *              struct dbuf_s * dbuf    line buffer
+ *              struct asmf *   ap      source/include file structure
+ *
+ *      The function srcgetl() appends the next line of the
+ *      source text of ap, including the trailing NL, to dbuf.
+ *
+ *      local variables:
+ *              char *  p               start of the line
+ *              char *  q               end of the line
+ *              size_t  len             line length
+ *
+ *      global variables:
+ *              none
+ *
+ *      called functions:
+ *              int     dbuf_append()
+ *              size_t  dbuf_get_length()
+ *              VOID *  memchr()        c_library
+ *
+ *      side effects:
+ *              The read position of ap is advanced.
+ *              Returns the length of dbuf, 0 at end of file.
+ */
+
+static size_t
+srcgetl(struct dbuf_s *dbuf, struct asmf *ap)
+{
+        char *p, *q;
+        size_t len;
+
+        if (ap->pos >= ap->sf->size)
+                return(0);
+
+        p = ap->sf->text + ap->pos;
+        q = (char *) memchr(p, '\n', ap->sf->size - ap->pos);
+        len = (q != NULL) ? (size_t) (q - p) + 1 : ap->sf->size - ap->pos;
+        dbuf_append(dbuf, p, len);
+        ap->pos += len;
+
+        return(dbuf_get_length(dbuf));
+}
+
+/*)Function     srcfil *        srcfind(id)
+ *
+ *              char *  id              source file identification
+ *
+ *      The function srcfind() returns the source text of
+ *      a file read into memory by srcread() or NULL.
+ *
+ *      local variables:
+ *              srcfil *sf              pointer to a srcfil structure
+ *
+ *      global variables:
+ *              srcfil *srcp            list of source files
+ *
+ *      called functions:
+ *              int     strcmp()        c_library
+ *
+ *      side effects:
+ *              none
+ */
+
+struct srcfil *
+srcfind(const char *id)
+{
+        struct srcfil *sf;
+
+        for (sf = srcp; sf != NULL; sf = sf->next) {
+                if (strcmp(sf->id, id) == 0)
+                        return(sf);
+        }
+        return(NULL);
+}
+
+/*)Function     srcfil *        srcread(fp, id)
+ *
+ *              FILE *  fp              opened source file
+ *              char *  id              source file identification
+ *
+ *      The function srcread() reads the source file fp
+ *      into memory and adds it to the list of source files.
+ *
+ *      local variables:
+ *              struct dbuf_s   dbuf    file text buffer
+ *              char    buf[]           read buffer
+ *              size_t  n               bytes read
+ *              srcfil *sf              pointer to a srcfil structure
+ *
+ *      global variables:
+ *              srcfil *srcp            list of source files
+ *
+ *      called functions:
+ *              int     dbuf_init()
+ *              int     dbuf_append()
+ *              size_t  dbuf_get_length()
+ *              VOID *  dbuf_detach()
+ *              size_t  fread()         c_library
+ *              VOID *  new()           assym.c
+ *              char *  strcpy()        c_library
+ *
+ *      side effects:
+ *              The file is read to its end.
+ */
+
+struct srcfil *
+srcread(FILE *fp, const char *id)
+{
+        struct dbuf_s dbuf;
+        struct srcfil *sf;
+        char buf[4096];
+        size_t n;
+
+        dbuf_init(&dbuf, 4096);
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+                dbuf_append(&dbuf, buf, n);
+
+        sf = (struct srcfil *) new (sizeof(struct srcfil));
+        sf->size = dbuf_get_length(&dbuf);
+        sf->text = (char *) dbuf_detach(&dbuf);
+        sf->id = (char *) new (strlen(id) + 1);
+        strcpy(sf->id, id);
+        sf->next = srcp;
+        srcp = sf;
+
+        return(sf);
+}
+
 
 /*)Function:    int     getlnm()
  *
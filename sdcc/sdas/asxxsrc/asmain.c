@@ -238,6 +238,7 @@ search_path_fopen(const char *filename, const char *mode)
  *              int     page            current page number
  *              int     pflag           disable listing pagination
  *              int     pass            assembler pass number
+ *              int     rflag           -r, binary records in object file
  *              int     radix           current number conversion radix:
  *                                      2 (binary), 8 (octal), 10 (decimal),
  *                                      16 (hexadecimal)
@@ -273,8 +274,8 @@ search_path_fopen(const char *filename, const char *mode)
  *              VOID    outbuf()        asout.c
  *              VOID    outchk()        asout.c
  *              VOID    outgsd()        asout.c
- *              int     rewind()        c_library
  *              int     setjmp()        c_library
+ *              srcfil *srcread()       aslex.c
  *              char *  strcpy()        c_library
  *              VOID    symglob()       assym.c
  *              VOID    syminit()       assym.c
@@ -383,6 +384,11 @@ main(int argc, char *argv[])
                                         ++pflag;
                                         break;
 
+                                case 'r':
+                                case 'R':
+                                        ++rflag;
+                                        break;
+
                                 case 'u':
                                 case 'U':
                                         ++uflag;
@@ -447,6 +453,9 @@ main(int argc, char *argv[])
                         asmc->fp = afile(p, "", 0);
                         strcpy(asmc->afn,afn);
                         asmc->afp = afp;
+                        asmc->sf = srcread(asmc->fp, asmc->afn);
+                        fclose(asmc->fp);
+                        asmc->fp = NULL;
                 }
         }
         if (asmp == NULL)
@@ -455,7 +464,7 @@ main(int argc, char *argv[])
                 lfp = afile(q, "lst", 1);
         /* sdas specific */
         if (oflag) {
-                ofp = afile(q, (is_sdas() && p != q) ? "" : "rel", 1);
+                ofp = afile(q, (is_sdas() && p != q) ? "" : "rel", rflag ? 2 : 1);
                 // save the file name if we have to delete it on error
                 strcpy(relFile,afn);
         }
@@ -491,8 +500,7 @@ main(int argc, char *argv[])
                 incline = 0;
                 asmc = asmp;
                 while (asmc) {
-                        if (asmc->fp)
-                                rewind(asmc->fp);
+                        asmc->pos = 0;
                         asmc = asmc->next;
                 }
                 asmc = asmp;
@@ -726,6 +734,9 @@ asexit(int i)
  *              VOID    outrw()         asout.c
  *              VOID    phase()         asmain.c
  *              VOID    qerr()          assubr.c
+ *              int     sprintf()       c_library
+ *              srcfil *srcfind()       aslex.c
+ *              srcfil *srcread()       aslex.c
  *              char *  strcpy()        c_library
  *              char *  strncpy()       c_library
  *              char *  strsto()        assym.c
@@ -748,6 +759,8 @@ asmbl(void)
         int  equtype;
         char opt[NCPS];
         char fn[FILSPC+FILSPC];
+        char fnid[FILSPC+FILSPC+FILSPC+2];
+        struct srcfil *sf;
         char *p;
         int d, uaf, uf;
         a_uint n, v;
@@ -1389,9 +1402,17 @@ loop:
                  */
                 getdstr(fn, FILSPC + FILSPC);
                 /*
-                 * Open File
+                 * Open and read the file, unless read in an
+                 * earlier pass.  Where it is found depends on
+                 * the path of the including file.
                  */
-                if ((fp = search_path_fopen(fn, "r")) == NULL) {
+                sprintf(fnid, "%.*s|%s", afp, afn, fn);
+                if ((sf = srcfind(fnid)) == NULL &&
+                    (fp = search_path_fopen(fn, "r")) != NULL) {
+                        sf = srcread(fp, fnid);
+                        fclose(fp);
+                }
+                if (sf == NULL) {
                         --incfil;
                         err('i');
                 } else {
@@ -1402,7 +1423,7 @@ loop:
                         asmi->flevel = flevel;
                         asmi->tlevel = tlevel;
                         asmi->lnlist = lnlist;
-                        asmi->fp = fp;
+                        asmi->sf = sf;
                         asmi->afp = afptmp;
                         strcpy(asmi->afn,afntmp);
                         if (lnlist & LIST_PAG) {
@@ -1856,7 +1877,7 @@ equate(char *id, struct expr *e1, a_uint equtype)
  *
  *              char *  fn              file specification string
  *              char *  ft              file type string
- *              int     wf              read(0)/write(1) flag
+ *              int     wf              read(0)/write(1)/binary write(2) flag
  *
  *      The function afile() opens a file for reading or writing.
  *
@@ -1890,7 +1911,7 @@ afile(char *fn, char *ft, int wf)
 
         afilex(fn, ft);
 
-        if ((fp = fopen(afntmp, wf?"w":"r")) == NULL) {
+        if ((fp = fopen(afntmp, wf == 2 ? "wb" : wf ? "w" : "r")) == NULL) {
             fprintf(stderr, "?ASxxxx-Error-<cannot %s> : \"%s\"\n", wf?"create":"open", afntmp);
             asexit(ER_FATAL);
         }
@@ -2151,6 +2172,7 @@ char *usetxt[] = {
         "  -o   Create object file/outfile[.rel]",
         "  -s   Create symbol file/outfile[.sym]",
         "  -p   Disable automatic listing pagination",
+        "  -r   Binary T/R/P records in object file",
         "  -u   Disable .list/.nlist processing",
         "  -w   Wide listing format for symbol table",
         "  -z   Disable case sensitivity for symbols",
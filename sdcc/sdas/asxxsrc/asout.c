@@ -188,6 +188,19 @@
  *      specify the _CODE area first, making this the default page area.
  *
  *
+ *      (9)     Binary Records (sdas specific, -r option)
+ *
+ *              t cc nn nn ...
+ *              r cc nn nn ...
+ *              p cc nn nn ...
+ *
+ *      With the -r option the T, R and P lines are written as binary
+ *      records instead: the lower case designator, a byte with the
+ *      number of values cc and the cc values as raw bytes, without a
+ *      line terminator.  All other lines are unchanged.  The record
+ *      holds the same values as the corresponding text line.
+ *
+ *
  *      asout.c contains the following functions:
  *              int     lobyte()
  *              int     hibyte()
@@ -201,6 +214,7 @@
  *              VOID    outdp()
  *              VOID    outdot()
  *              VOID    outgsd()
+ *              VOID    outrec()
  *              VOID    outsym()
  *              VOID    outab()
  *              VOID    outaw()
@@ -890,8 +904,7 @@ outall(void)
  *              char *  txtp            Pointer to T Line Values
  *
  *      functions called:
- *              int     fprintf()       c_library
- *              VOID    out()           asout.c
+ *              VOID    outrec()        asout.c
  *
  *      side effects:
  *              assembled data and relocation buffers will be cleared.
@@ -901,12 +914,8 @@ VOID
 outdot(void)
 {
         if (oflag && pass==2) {
-                fprintf(ofp, "T");
-                out(txt,(int) (txtp-txt));
-                fprintf(ofp, "\n");
-                fprintf(ofp, "R");
-                out(rel,(int) (relp-rel));
-                fprintf(ofp, "\n");
+                outrec("T", txt, (int) (txtp-txt));
+                outrec("R", rel, (int) (relp-rel));
                 txtp = txt;
                 relp = rel;
         }
@@ -979,8 +988,7 @@ outchk(int nt, int nr)
  *              char *  txtp            Pointer to T Line Values
  *
  *      functions called:
- *              int     fprintf()       c_library
- *              VOID    out()           asout.c
+ *              VOID    outrec()        asout.c
  *
  *      side effects:
  *              All bufferred data written to .REL file and
@@ -991,17 +999,53 @@ VOID
 outbuf(char *s)
 {
         if (txtp > &txt[a_bytes]) {
-                fprintf(ofp, "T");
-                out(txt,(int) (txtp-txt));
-                fprintf(ofp, "\n");
-                fprintf(ofp, "%s", s);
-                out(rel,(int) (relp-rel));
-                fprintf(ofp, "\n");
+                outrec("T", txt, (int) (txtp-txt));
+                outrec(s, rel, (int) (relp-rel));
         }
         txtp = txt;
         relp = rel;
 }
 
+/*)Function     VOID    outrec(s, p, n)
+ *
+ *              char *  s               "T", "R" or "P"
+ *              char *  p               pointer to data bytes
+ *              int     n               number of data bytes
+ *
+ *      The function outrec() outputs a T, R or P line to the
+ *      .REL file, as a binary record if the -r option was given.
+ *
+ *      local variables:
+ *              none
+ *
+ *      global variables:
+ *              FILE *  ofp             relocation output file handle
+ *              int     rflag           -r, binary records flag
+ *
+ *      functions called:
+ *              int     fprintf()       c_library
+ *              size_t  fwrite()        c_library
+ *              VOID    out()           asout.c
+ *              int     putc()          c_library
+ *
+ *      side effects:
+ *              Data is sent to the .REL file.
+ */
+
+VOID
+outrec(char *s, char *p, int n)
+{
+        if (rflag) {
+                putc(*s - 'A' + 'a', ofp);
+                putc(n, ofp);
+                fwrite(p, 1, n, ofp);
+        } else {
+                fprintf(ofp, "%s", s);
+                out(p, n);
+                fprintf(ofp, "\n");
+        }
+}
+
 VOID
 outradix()
 {
@@ -52,6 +52,8 @@
  *              VOID    allglob()
  *              area *  alookup()
  *              int     hash()
+ *              unsigned int    idxhash()
+ *              VOID    idxsym()
  *              sym *   lookup()
  *              mne *   mlookup()
  *              char *  new()
@@ -63,9 +65,30 @@
  *      assym.c contains the static variables:
  *              char *  pnext
  *              int     bytes
- *      used by the string store function.
+ *      used by the string store function and
+ *              mne **  mneidx
+ *              sym **  symidx
+ *      the lookup tables used by mlookup() and lookup().
  */
 
+/*
+ * The symbols stay linked into the NHASH lists of
+ * symhash[], which determine the order of the
+ * symbols in the .rel and listing files.  Lookups
+ * go through symidx[] instead, an open addressed
+ * table holding all symbols, which is doubled in
+ * size whenever it becomes half full.  mneidx[] is
+ * the same for the fixed set of mnemonics.
+ */
+static  struct  mne     **mneidx;
+static  unsigned int    mneidxmsk;
+static  struct  sym     **symidx;
+static  unsigned int    symidxmsk;
+static  unsigned int    symidxcnt;
+
+static  unsigned int    idxhash(const char *p, int flag);
+static  VOID            idxsym(struct sym *sp);
+
 /*)Function     VOID    syminit()
  *
  *      The function syminit() is called early in the game
@@ -77,6 +100,8 @@
  *
  *      local variables:
  *              int     h               computed hash value
+ *              int     i               lookup table index / size
+ *              int     n               number of mnemonics
  *              mne *   mp              pointer to a mne structure
  *              mne **  mpp             pointer to an array of
  *                                      mne structure pointers
@@ -91,9 +116,15 @@
  *                                      linked mnemonic/directive lists
  *              sym * symhash[]         array of pointers to NHASH
  *                                      linked symbol lists
+ *              mne **  mneidx          mnemonic/directive lookup table
+ *              sym **  symidx          symbol lookup table
  *
  *      functions called:
- *              none
+ *              VOID    free()          c_library
+ *              unsigned int idxhash()  assym.c
+ *              VOID    idxsym()        assym.c
+ *              char *  new()           assym.c
+ *              int     symeq()         assym.c
  *
  *      side effects:
  *              (1)     The symbol hash tables are initialized,
@@ -114,27 +145,60 @@ syminit(void)
         struct sym **spp;
         int h;
 
+        unsigned int i, n;
+
         mpp = &mnehash[0];
         while (mpp < &mnehash[NHASH])
                 *mpp++ = NULL;
         mp = &mne[0];
+        n = 0;
         for (;;) {
                 h = hash(mp->m_id, 1);
                 mp->m_mp = mnehash[h];
                 mnehash[h] = mp;
+                ++n;
                 if (mp->m_flag&S_EOL)
                         break;
                 ++mp;
         }
 
+        /*
+         * Mnemonic lookup table, at most half full.
+         * As with the mnehash[] lists, a mnemonic
+         * defined more than once is found as the
+         * last one in mne[].
+         */
+        for (i = 64; i < 2 * n; i <<= 1)
+                ;
+        if (mneidx != NULL)
+                free(mneidx);
+        mneidx = (struct mne **) new (i * sizeof(struct mne *));
+        mneidxmsk = i - 1;
+        for (mp = &mne[0]; ; ++mp) {
+                for (i = idxhash(mp->m_id, 1) & mneidxmsk;
+                     mneidx[i] != NULL;
+                     i = (i + 1) & mneidxmsk) {
+                        if (symeq(mp->m_id, mneidx[i]->m_id, 1))
+                                break;
+                }
+                mneidx[i] = mp;
+                if (mp->m_flag&S_EOL)
+                        break;
+        }
+
         spp = &symhash[0];
         while (spp < &symhash[NHASH])
                 *spp++ = NULL;
+        if (symidx != NULL)
+                free(symidx);
+        symidx = NULL;
+        symidxmsk = symidxcnt = 0;
         sp = &sym[0];
         for (;;) {
                 h = hash(sp->s_id, zflag);
                 sp->s_sp = symhash[h];
                 symhash[h] = sp;
+                idxsym(sp);
                 if (sp->s_flag&S_EOL)
                         break;
                 ++sp;
@@ -191,13 +255,14 @@ alookup(char *id)
  *
  *      local variables:
  *              mne *   mp              pointer to mne structure
- *              int     h               calculated hash value
+ *              int     i               lookup table index
  *
  *      global variables:
- *              mne * mnehash[]         array of pointers to NHASH
- *                                      linked mnemonic/directive lists
+ *              mne **  mneidx          mnemonic/directive lookup table
  *
  *      functions called:
+ *              unsigned int idxhash()  assym.c
+ *              int     symeq()         assym.c
  *              none
  *
  *      side effects:
@@ -208,17 +273,16 @@ struct mne *
 mlookup(char *id)
 {
         struct mne *mp;
-        int h;
+        unsigned int i;
 
         /*
          * JLH: case insensitive lookup always
          */
-        h = hash(id, 1);
-        mp = mnehash[h];
-        while (mp) {
+        i = idxhash(id, 1) & mneidxmsk;
+        while ((mp = mneidx[i]) != NULL) {
                 if(symeq(id, mp->m_id, 1))
                         return (mp);
-                mp = mp->m_mp;
+                i = (i + 1) & mneidxmsk;
         }
         return (NULL);
 }
@@ -235,15 +299,19 @@ mlookup(char *id)
  *
  *      local variables:
  *              int     h               computed hash value
+ *              int     i               lookup table index
  *              sym *   sp              pointer to a sym structure
  *
  *      global varaibles:
  *              sym *   symhash[]       array of pointers to NHASH
  *                                      linked symbol lists
+ *              sym **  symidx          symbol lookup table
  *              int     zflag           disable symbol case sensitivity
  *
  *      functions called:
  *              int     hash()          assym.c
+ *              unsigned int idxhash()  assym.c
+ *              VOID    idxsym()        assym.c
  *              char *  new()           assym.c
  *              char *  strsto()        assym.c
  *              int     symeq()         assym.c
@@ -257,15 +325,16 @@ struct sym *
 lookup(const char *id)
 {
         struct sym *sp;
+        unsigned int i;
         int h;
 
-        h = hash(id, zflag);
-        sp = symhash[h];
-        while (sp) {
+        i = idxhash(id, zflag) & symidxmsk;
+        while ((sp = symidx[i]) != NULL) {
                 if(symeq(id, sp->s_id, zflag))
                         return (sp);
-                sp = sp->s_sp;
+                i = (i + 1) & symidxmsk;
         }
+        h = hash(id, zflag);
         sp = (struct sym *) new (sizeof(struct sym));
         sp->s_sp = symhash[h];
         symhash[h] = sp;
@@ -276,9 +345,68 @@ lookup(const char *id)
         sp->s_area = NULL;
         sp->s_ref = 0;
         sp->s_addr = 0;
+        idxsym(sp);
         return (sp);
 }
 
+/*)Function     VOID    idxsym(sp)
+ *
+ *              sym *   sp              pointer to a sym structure
+ *
+ *      The function idxsym() enters a new symbol into the
+ *      symbol lookup table.  When the table would become
+ *      more than half full it is doubled in size first.
+ *
+ *      local variables:
+ *              sym **  old             previous lookup table
+ *              int     i               loop index
+ *              int     j               table index
+ *              int     n               previous table size
+ *
+ *      global variables:
+ *              sym **  symidx          symbol lookup table
+ *              int     symidxmsk       table size - 1
+ *              int     symidxcnt       symbols in the table
+ *              int     zflag           disable symbol case sensitivity
+ *
+ *      functions called:
+ *              VOID    free()          c_library
+ *              unsigned int idxhash()  assym.c
+ *              char *  new()           assym.c
+ *
+ *      side effects:
+ *              The symbol lookup table may be reallocated.
+ */
+
+static VOID
+idxsym(struct sym *sp)
+{
+        struct sym **old;
+        unsigned int i, j, n;
+
+        if (2 * (symidxcnt + 1) > symidxmsk + 1) {
+                old = symidx;
+                n = old ? symidxmsk + 1 : 0;
+                symidxmsk = n ? 2 * n - 1 : 1023;
+                symidx = (struct sym **) new ((symidxmsk + 1) * sizeof(struct sym *));
+                for (i = 0; i < n; ++i) {
+                        if (old[i] == NULL)
+                                continue;
+                        j = idxhash(old[i]->s_id, zflag) & symidxmsk;
+                        while (symidx[j] != NULL)
+                                j = (j + 1) & symidxmsk;
+                        symidx[j] = old[i];
+                }
+                if (old != NULL)
+                        free(old);
+        }
+        j = idxhash(sp->s_id, zflag) & symidxmsk;
+        while (symidx[j] != NULL)
+                j = (j + 1) & symidxmsk;
+        symidx[j] = sp;
+        ++symidxcnt;
+}
+
 /*)Function     VOID    symglob()
  *
  *      The function symglob() will mark all symbols of
@@ -455,6 +583,50 @@ hash(const char *p, int flag)
         return (h&HMASK);
 }
 
+/*)Function     unsigned int    idxhash(p, flag)
+ *
+ *              char *  p               pointer to string to hash
+ *              int     flag            case sensitive flag
+ *
+ *      The function idxhash() computes the FNV-1a hash
+ *      of a string, used for the lookup tables.  Unlike
+ *      hash() the full value is returned, the caller
+ *      masks it to the size of the table.
+ *
+ *              flag == 0       case sensitive hash
+ *              flag != 0       case insensitive hash
+ *
+ *      local variables:
+ *              unsigned int h  accumulated hash value
+ *
+ *      global variables:
+ *              char    ccase[]         an array of characters which
+ *                                      perform the case translation function
+ *
+ *      functions called:
+ *              none
+ *
+ *      side effects:
+ *              none
+ */
+
+static unsigned int
+idxhash(const char *p, int flag)
+{
+        unsigned int h;
+
+        h = 2166136261u;
+        while (*p) {
+                if(flag) {
+                        h ^= (unsigned char) ccase[*p++ & 0x007F];
+                } else {
+                        h ^= (unsigned char) *p++;
+                }
+                h *= 16777619u;
+        }
+        return (h);
+}
+
 /*)Function     char *  strsto(str)
  *
  *              char *  str             pointer to string to save
@@ -747,6 +747,8 @@ struct  expr
  *      tlevel  is the saved tlevel of the parent object
  *      lnlist  is the saved lnlist of the parent object
  *      fp      is the source FILE handle
+ *      sf      is the source text in memory
+ *      pos     is the read position in the source text
  *      afp     is the file path length (excludes the files name.ext)
  *      afn[]   is the assembler/include file path/name.ext
  */
@@ -759,10 +761,34 @@ struct  asmf
         int     tlevel;         /* saved tlevel */
         int     lnlist;         /* saved lnlist */
         FILE *  fp;             /* FILE Handle */
+        struct  srcfil *sf;     /* Source Text */
+        size_t  pos;            /* Read Position */
         int     afp;            /* File Path Length */
         char    afn[FILSPC];    /* File Name */
 };
 
+/*
+ *      The srcfil structure holds the text of an
+ *      assembler source or include file.  The file
+ *      is read once, in pass 0, the following passes
+ *      take the lines from memory.
+ *
+ * The Parameters:
+ *      next    is a pointer to the next source file
+ *      text    is the file text
+ *      size    is the size of the file text
+ *      id      identifies the file, for include files
+ *              the directory of the including file and
+ *              the .include file specification
+ */
+struct  srcfil
+{
+        struct  srcfil *next;   /* Link to Next Source File */
+        char *  text;           /* File Text */
+        size_t  size;           /* Text Size */
+        char *  id;             /* File Identification */
+};
+
 /*
  *      The macrofp structure masquerades as a FILE Handle
  *      for inclusion in an asmf structure.  This structure
@@ -974,6 +1000,8 @@ extern  int     oflag;          /*      -o, generate relocatable output flag
                                  */
 extern  int     pflag;          /*      -p, disable listing pagination
                                  */
+extern  int     rflag;          /*      -r, binary T/R/P records in object file
+                                 */
 extern  int     sflag;          /*      -s, generate symbol table flag
                                  */
 extern  int     uflag;          /*      -u, disable .list/.nlist processing flag
@@ -1155,6 +1183,8 @@ extern  int             getlnm(void);
 extern  VOID            getst(char *id, int c);
 extern  int             more(void);
 extern  int             nxtline(void);
+extern  struct  srcfil *srcfind(const char *id);
+extern  struct  srcfil *srcread(FILE *fp, const char *id);
 extern  VOID            unget(int c);
 
 /* assym.c */
@@ -1215,6 +1245,7 @@ extern  VOID            outdp(struct area *carea, struct expr *esp, int r);
 extern  VOID            outall(void);
 extern  VOID            outdot(void);
 extern  VOID            outbuf(char *s);
+extern  VOID            outrec(char *s, char *p, int n);
 extern  VOID            outchk(int nt, int nr);
 extern  VOID            outradix(void);
 extern  VOID            outgsd(void);
@@ -1302,6 +1333,8 @@ extern  int             getlnm();
 extern  VOID            getst();
 extern  int             more();
 extern  int             nxtline();
+extern  struct  srcfil *srcfind();
+extern  struct  srcfil *srcread();
 extern  VOID            unget();
 
 /* assym.c */
@@ -1363,6 +1396,7 @@ extern  VOID            outdp();
 extern  VOID            outall();
 extern  VOID            outdot();
 extern  VOID            outbuf();
+extern  VOID            outrec();
 extern  VOID            outchk();
 extern  VOID            outradix();
 extern  VOID            outgsd();
@@ -219,6 +219,14 @@
 #define         DBXMAXBYTES     64      /* NMAX > (  DBXMAXBYTES  ) */
 #define FILSPC  PATH_MAX        /* File spec length */
 
+/*
+ * sdld -T output types
+ */
+#define T_BIN   1               /* raw binary image */
+#define T_GB    2               /* Game Boy image */
+#define T_SMS   3               /* Sega Master System / Game Gear image */
+#define T_HEX   4               /* compact Intel Hex */
+
 #define NDATA   16              /* actual data */
 /*
  * NTXT must be defined to have the same value in
@@ -1015,6 +1023,10 @@ extern  FILE    *yfp;           /*      SDCDB output file handle
 
 extern  int     oflag;          /*      Output file type flag
                                  */
+extern  int     bintyp;         /*      -T output type
+                                 */
+extern  int     ihxlen;         /*      Intel Hex data bytes per record
+                                 */
 extern  int     objflg;         /*      Linked file/library object output flag
                                  */
 
@@ -1080,6 +1092,13 @@ extern  a_uint  rtadr1;         /*
                                  */
 extern  a_uint  rtadr2;         /*
                                  */
+extern  unsigned char rbval[];  /*      values of a binary T/R/P record
+                                 */
+extern  int     rbcnt;          /*      count of values in rbval[],
+                                 *      -1 if the current line is text
+                                 */
+extern  int     rbidx;          /*      index of the next value in rbval[]
+                                 */
 extern  int     obj_flag;       /*      Linked file/library object output flag
                                  */
 extern  int     a_bytes;        /*      REL file T Line address length
@@ -1198,6 +1217,13 @@ extern  VOID            lnkarea(void);
 extern  VOID            lnkarea2(void);
 extern  VOID            newarea(void);
 
+/* lkautobank.c */
+extern  VOID            autobank(void);
+extern  VOID            autobanklst(FILE *fp);
+extern  VOID            autobankprof(void);
+extern  VOID            autobankref(void);
+extern  VOID            autobanksav(void);
+
 /* lkbank.c */
 extern  VOID            chkbank(FILE *fp);
 extern  VOID            lkfclose(void);
@@ -1303,6 +1329,8 @@ extern  VOID            ixx(int i);
 extern  VOID            iflush(void);
 extern  VOID            dbx(int i);
 extern  VOID            dflush(void);
+extern  VOID            bxx(int i);
+extern  VOID            binsav(void);
 
 /* lks19.c */
 extern  VOID            s19(int i);
@@ -249,12 +249,16 @@ get_member_name_by_offset (FILE * fp, long offset)
 }
 
 static pmlibraryfile
-find_member_by_offset (const char *libspc, long offset)
+find_member_by_offset (const char *libspc, long offset, pmlibraryfile first, pmlibraryfile last)
 {
   pmlibraryfile p;
 
-  /* walk trough all archive members */
-  for (p = libr; p; p = p->next)
+  /* symbol tables list the symbols of a member together: try the last one first */
+  if (last != NULL && last->offset == offset && 0 == strcmp (libspc, last->libspc))
+    return last;
+
+  /* walk trough the archive members of this library */
+  for (p = first; p; p = p->next)
     {
       if (0 == strcmp (libspc, p->libspc) && p->offset == offset)
         return p;
@@ -270,6 +274,7 @@ buildlibraryindex_ar (struct lbname *lbnh, FILE * libfp, pmlibraryfile This, int
   char *obj_name;
   size_t hdr_size;
   int sym_found = 0;
+  pmlibraryfile first = This;
 
   /* walk trough all archive members */
   while ((hdr_size = ar_get_header (&hdr, libfp, &obj_name)) != 0)
@@ -313,7 +318,7 @@ buildlibraryindex_ar (struct lbname *lbnh, FILE * libfp, pmlibraryfile This, int
               sym = strdup (ps);
               ps += strlen (ps) + 1;
 
-              if ((entry = find_member_by_offset (lbnh->libspc, offset)) != NULL)
+              if ((entry = find_member_by_offset (lbnh->libspc, offset, first ? first->next : libr, This)) != NULL)
                 {
                   for (ThisSym = entry->symbols; ThisSym->next != NULL; ThisSym = ThisSym->next)
                     ;
@@ -394,14 +399,12 @@ buildlibraryindex_ar (struct lbname *lbnh, FILE * libfp, pmlibraryfile This, int
               long offset;
               pmlibraryfile entry;
 
-              sym = ps + sgetl (po);
+              sym = strdup (ps + sgetl (po));
               po += 4;
               offset = sgetl (po);
               po += 4;
 
-              sym = strdup (ps);
-
-              if ((entry = find_member_by_offset (lbnh->libspc, offset)) != NULL)
+              if ((entry = find_member_by_offset (lbnh->libspc, offset, first ? first->next : libr, This)) != NULL)
                 {
                   for (ThisSym = entry->symbols; ThisSym->next != NULL; ThisSym = ThisSym->next)
                     ;
@@ -472,7 +475,8 @@ buildlibraryindex_ar (struct lbname *lbnh, FILE * libfp, pmlibraryfile This, int
         }
       else
         {
-          if (NULL == libr)
+          /* no symbol table: index the module itself */
+          if (!sym_found)
             {
               /* Opened OK - create a new libraryfile object for it */
               if (This == NULL)
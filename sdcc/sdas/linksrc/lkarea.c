@@ -335,8 +335,21 @@ lkparea(char *id)
  *              structures.
  */
 
+/* sdld specific */
+/*
+ * Allocated address ranges of a memory space
+ */
+struct memmap {
+        a_uint  m_limit;        /* Size of the memory space */
+        int     m_n;            /* Number of ranges */
+        int     m_max;          /* Allocated ranges */
+        struct {
+                a_uint lo, hi;  /* Range [lo, hi) */
+        } *m_r;
+};
+/* end sdld specific */
 /* sdld6808 specific */
-unsigned long codemap6808[2048];
+struct memmap codemap6808 = { 0x10000 };
 /* end sdld6808 specific */
 /* sdld specific */
 VOID lnksect(struct area *tap);
@@ -365,7 +378,7 @@ lnkarea(void)
         struct sym *sp;
 
         if (TARGET_IS_6808) {
-                memset(codemap6808, 0, sizeof(codemap6808));
+                codemap6808.m_n = 0;
 
                 /* first sort all absolute areas to the front */
                 ap = areap;
@@ -511,51 +524,66 @@ lnkarea(void)
 }
 
 /* sdld specific */
+/*
+ * The allocated parts of a memory space are kept as a sorted list of
+ * disjoint address ranges, adjacent ranges merged, so that a search
+ * skips a whole allocated range at a time.  The results are those of
+ * the former bitmap of 32 address words, including where a conflict
+ * moves the search to, and the limit and overlap messages.
+ *
+ * Returns the index of the first range ending after addr, or at addr
+ * if touch is set.
+ */
+static int
+memmap_find(struct memmap *map, a_uint addr, int touch)
+{
+        int lo = 0, hi = map->m_n, mid;
+
+        while (lo < hi) {
+                mid = (lo + hi) / 2;
+                if (map->m_r[mid].hi < addr || (!touch && map->m_r[mid].hi == addr))
+                        lo = mid + 1;
+                else
+                        hi = mid;
+        }
+        return lo;
+}
+
+static int
+memmap_limit(a_uint start, a_uint size, char *id, struct memmap *map)
+{
+        if (((start + size) >> 5) > (map->m_limit >> 5)) {
+                fprintf(stderr, "internal memory limit is exceeded for %s; memory size = 0x%06X, address = 0x%06X\n", id, map->m_limit, start + size - 1);
+                return 1;
+        }
+        return 0;
+}
+
 static
-a_uint find_empty_space(a_uint start, a_uint size, char *id, unsigned long *map, unsigned int map_size)
+a_uint find_empty_space(a_uint start, a_uint size, char *id, struct memmap *map)
 {
-        a_uint i, j, k;
-        unsigned long mask, b;
-        map_size /= sizeof(*map); /* Convert from bytes to number of elements */
-
-        while (1) {
-                a_uint a = start;
-                i = start >> 5;
-                j = (start + size) >> 5;
-                mask = -(1 << (start & 0x1F));
-
-                if (j > map_size) {
-                        fprintf(stderr, "internal memory limit is exceeded for %s; memory size = 0x%06X, address = 0x%06X\n", id, map_size << 5, start + size - 1);
+        a_uint a, h, w, end;
+        int k;
+
+        while (!memmap_limit(start, size, id, map)) {
+                a = start;
+                end = start + size;
+                k = memmap_find(map, start, 0);
+                if (size == 0 || k >= map->m_n || map->m_r[k].lo >= end)
                         break;
-                }
-                else {
-                        while (i < j) {
-                                if (map[i] & mask) {
-                                        k = 32;
-                                        for (b=0x80000000; b!=0; b>>=1, k--) {
-                                                if (map[i] & b)
-                                                        break;
-                                        }
-                                        start = a + k;
-                                        break;
-                                }
-                                i++;
-                                mask = 0xFFFFFFFF;
-                                a += 32;
-                        }
-                        if (start > a)
-                                continue;
-
-                        mask &= (1 << ((start + size) & 0x1F)) - 1;
-                        if (i < map_size && map[i] & mask) {
-                                k = 32;
-                                for (b=0x80000000; b!=0; b>>=1, k--) {
-                                        if (map[i] & b)
-                                                break;
-                                }
-                                start = (a & ~0x1F) + k;
-                        }
-                        if (start <= a)
+                /*
+                 * Word w holds the first conflict,
+                 * h is its last allocated address.
+                 */
+                w = (map->m_r[k].lo > start ? map->m_r[k].lo : start) >> 5;
+                while (k + 1 < map->m_n && map->m_r[k + 1].lo < ((w + 1) << 5))
+                        k++;
+                h = (map->m_r[k].hi < ((w + 1) << 5) ? map->m_r[k].hi : ((w + 1) << 5)) - 1;
+                if (w < (end >> 5)) {
+                        start = a + ((w - (a >> 5)) << 5) + (h & 0x1F) + 1;
+                } else {
+                        start = h + 1;
+                        if (start <= a + ((w - (a >> 5)) << 5))
                                 break;
                 }
         }
@@ -563,34 +591,55 @@ a_uint find_empty_space(a_uint start, a_uint size, char *id, unsigned long *map,
 }
 
 static
-a_uint allocate_space(a_uint start, a_uint size, char *id, unsigned long *map,  unsigned int map_size)
+a_uint allocate_space(a_uint start, a_uint size, char *id, struct memmap *map)
 {
-        a_uint i, j;
-        unsigned long mask;
-        a_uint a = start;
-        i = start >> 5;
-        j = (start + size) >> 5;
-        mask = -(1 << (start & 0x1F));
-        map_size /= sizeof(*map); /* Convert from bytes to number of elements */
-
-        if (j > map_size) {
-                fprintf(stderr, "internal memory limit is exceeded for %s; memory size = 0x%06X, address = 0x%06X\n", id, map_size << 5, start + size - 1);
-        }
-        else {
-                while (i < j) {
-                        if (map[i] & mask) {
-                                fprintf(stderr, "memory overlap near 0x%X for %s\n", a, id);
+        a_uint lo, hi, x, y, w, wn;
+        int k, m;
+
+        if (memmap_limit(start, size, id, map) || size == 0 || start >= map->m_limit)
+                return start;
+
+        /*
+         * Report overlaps, then merge the touching ranges k ... m-1
+         * with the new one.
+         */
+        lo = start;
+        hi = start + size < map->m_limit ? start + size : map->m_limit;
+        wn = 0;
+        k = memmap_find(map, start, 1);
+        for (m = k; m < map->m_n && map->m_r[m].lo <= hi; m++) {
+                x = map->m_r[m].lo > start ? map->m_r[m].lo : start;
+                y = map->m_r[m].hi < hi ? map->m_r[m].hi : hi;
+                for (w = x >> 5; x < y && w <= (y - 1) >> 5; w++) {
+                        if (w >= wn) {
+                                fprintf(stderr, "memory overlap near 0x%X for %s\n",
+                                        start + ((w - (start >> 5)) << 5), id);
+                                wn = w + 1;
                         }
-                        map[i++] |= mask;
-                        mask = 0xFFFFFFFF;
-                        a += 32;
                 }
-                mask &= (1 << ((start + size) & 0x1F)) - 1;
-                if (i < map_size && map[i] & mask) {
-                        fprintf(stderr, "memory overlap near 0x%X for %s\n", a, id);
+                if (map->m_r[m].lo < lo)
+                        lo = map->m_r[m].lo;
+                if (map->m_r[m].hi > hi)
+                        hi = map->m_r[m].hi;
+        }
+        if (m == k) {
+                if (map->m_n == map->m_max) {
+                        map->m_max = map->m_max ? 2 * map->m_max : 256;
+                        map->m_r = realloc(map->m_r, map->m_max * sizeof(*map->m_r));
+                        if (map->m_r == NULL) {
+                                fprintf(stderr, "Out of space!\n");
+                                lkexit(ER_FATAL);
+                        }
                 }
-                map[i] |= mask;
+                memmove(&map->m_r[k + 1], &map->m_r[k], (map->m_n - k) * sizeof(*map->m_r));
+                map->m_n++;
+        } else
+        if (m > k + 1) {
+                memmove(&map->m_r[k + 1], &map->m_r[m], (map->m_n - m) * sizeof(*map->m_r));
+                map->m_n -= m - k - 1;
         }
+        map->m_r[k].lo = lo;
+        map->m_r[k].hi = hi;
         return start;
 }
 /* end sdld specific */
@@ -645,7 +694,7 @@ lnksect(struct area *tap)
                  * Absolute sections
                  */
                 while (taxp) {
-                        allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, codemap6808, sizeof (codemap6808));
+                        allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, &codemap6808);
                         taxp->a_addr = 0; /* reset to zero so relative addresses become absolute */
                         size += taxp->a_size;
                         taxp = taxp->a_axp;
@@ -655,13 +704,13 @@ lnksect(struct area *tap)
                  * Concatenated sections
                  */
                 if (TARGET_IS_6808 && tap->a_size && !(ap->a_flag & A_NOLOAD)) {
-                        addr = find_empty_space(addr, tap->a_size, tap->a_id, codemap6808, sizeof (codemap6808));
+                        addr = find_empty_space(addr, tap->a_size, tap->a_id, &codemap6808);
                 }
                 while (taxp) {
                         /* find next unused address now */
                         if (TARGET_IS_6808 && taxp->a_size && !(ap->a_flag & A_NOLOAD)) {
-                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, codemap6808, sizeof (codemap6808));
-                                allocate_space(addr, taxp->a_size, tap->a_id, codemap6808, sizeof (codemap6808));
+                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, &codemap6808);
+                                allocate_space(addr, taxp->a_size, tap->a_id, &codemap6808);
                         }
                         taxp->a_addr = addr;
                         addr += taxp->a_size;
@@ -767,8 +816,8 @@ setarea(void)
 
 /* sdld specific */
 a_uint lnksect2 (struct area *tap, int locIndex);
-unsigned long codemap8051[524288];
-unsigned long xdatamap[131216];
+struct memmap codemap8051 = { 0x1000000 };
+struct memmap xdatamap = { 131216 << 5 };
 struct area *dseg_ap = NULL;
 a_uint dram_start = 0;
 a_uint iram_start = 0;
@@ -788,8 +837,8 @@ VOID lnkarea2 (void)
         struct sym *sp_dseg_s=NULL, *sp_dseg_l=NULL;
 
         memset(idatamap, ' ', 256);
-        memset(codemap8051, 0, sizeof(codemap8051));
-        memset(xdatamap, 0, sizeof(xdatamap));
+        codemap8051.m_n = 0;
+        xdatamap.m_n = 0;
 
         /* first sort all absolute areas to the front */
         ap = areap;
@@ -1156,11 +1205,11 @@ a_uint lnksect2 (struct area *tap, int locIndex)
                         }
                         else if (locIndex == 1)
                         {
-                                allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, codemap8051, sizeof (codemap8051));
+                                allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, &codemap8051);
                         }
                         else if (locIndex == 2)
                         {
-                                allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, xdatamap, sizeof (xdatamap));
+                                allocate_space(taxp->a_addr, taxp->a_size, tap->a_id, &xdatamap);
                         }
                         taxp->a_addr = 0; /* reset to zero so relative addresses become absolute */
                         size += taxp->a_size;
@@ -1171,11 +1220,11 @@ a_uint lnksect2 (struct area *tap, int locIndex)
         {
                 if ((locIndex == 1) && tap->a_size)
                 {
-                        addr = find_empty_space(addr, tap->a_size, tap->a_id, codemap8051, sizeof (codemap8051));
+                        addr = find_empty_space(addr, tap->a_size, tap->a_id, &codemap8051);
                 }
                 if ((locIndex == 2) && tap->a_size)
                 {
-                        addr = find_empty_space(addr, tap->a_size, tap->a_id, xdatamap, sizeof (xdatamap));
+                        addr = find_empty_space(addr, tap->a_size, tap->a_id, &xdatamap);
                 }
                 while (taxp)
                 {
@@ -1252,13 +1301,13 @@ a_uint lnksect2 (struct area *tap, int locIndex)
                                         //find next unused address now
                                         if (locIndex == 1)
                                         {
-                                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, codemap8051, sizeof (codemap8051));
-                                                allocate_space(addr, taxp->a_size, tap->a_id, codemap8051, sizeof (codemap8051));
+                                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, &codemap8051);
+                                                allocate_space(addr, taxp->a_size, tap->a_id, &codemap8051);
                                         }
                                         if (locIndex == 2)
                                         {
-                                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, xdatamap, sizeof (xdatamap));
-                                                allocate_space(addr, taxp->a_size, tap->a_id, xdatamap, sizeof (xdatamap));
+                                                addr = find_empty_space(addr, taxp->a_size, tap->a_id, &xdatamap);
+                                                allocate_space(addr, taxp->a_size, tap->a_id, &xdatamap);
                                         }
                                         taxp->a_addr = addr;
                                         addr += taxp->a_size;
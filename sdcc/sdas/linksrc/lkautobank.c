@@ -0,0 +1,779 @@
+/* lkautobank.c - automatic assignment of banked code to banks
+
+This program is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation; either version 3, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>. */
+
+#include "aslink.h"
+
+/*Module        lkautobank.c
+ *
+ *      The module lkautobank.c distributes the segments of one
+ *      area (the banked area, one segment per module) over a set
+ *      of bank areas, so that references between segments placed
+ *      in different banks are rare.  With -a area=size:bank1,...
+ *      the linker records the references of the R lines read in
+ *      pass 0 and, before any addresses are assigned, moves each
+ *      segment of the banked area to one of the bank areas.  The
+ *      bank areas still get their addresses from -b.
+ *
+ *      The references between segments form a weighted graph,
+ *      each reference counting 1 plus the execution count of the
+ *      referenced symbol from the optional -h file.  Segments are
+ *      clustered along the heaviest edges as long as a cluster
+ *      fits into a bank, the clusters are placed first fit
+ *      decreasing and single segments are then moved between
+ *      banks while this lowers the weight of the cross bank
+ *      references.
+ *
+ *      lkautobank.c contains the following functions:
+ *              VOID    autobanksav()
+ *              VOID    autobankprof()
+ *              VOID    autobankref()
+ *              VOID    autobank()
+ *              VOID    autobanklst()
+ *
+ *      lkautobank.c contains these local variables:
+ *              char *  abpool          name of the banked area
+ *              char *  abspec          size and bank area list
+ *              char *  abprof          execution count file
+ *              abref * abrefs          references read in pass 0
+ *              int     abnref          number of references
+ *              int     abmref          allocated references
+ *              abseg * absegs          segments of the banked area
+ *              int     abnseg          number of segments
+ *              abbank *abbanks         the bank areas
+ *              int     abnbank         number of bank areas
+ *              unsigned long abwall    weight of all references
+ *              unsigned long abwcut    weight of cross bank references
+ */
+
+struct abref {
+        struct  areax   *r_from;        /* Referencing segment */
+        struct  areax   *r_axp;         /* Referenced segment, or */
+        struct  sym     *r_sp;          /* referenced symbol */
+};
+
+struct abseg {
+        struct  areax   *g_axp;         /* Segment */
+        int     g_bank;                 /* Assigned bank */
+        int     g_link;                 /* Next segment of cluster */
+};
+
+struct abbank {
+        char    *k_id;                  /* Bank area name */
+        struct  area    *k_ap;          /* Bank area */
+        a_uint  k_free;                 /* Space left */
+        int     k_nseg;                 /* Segments placed */
+};
+
+struct abedge {
+        int     e_a;                    /* Segment index, e_a < e_b */
+        int     e_b;
+        unsigned long e_w;              /* Weight */
+};
+
+struct abcnt {
+        struct  sym     *c_sp;          /* Symbol */
+        unsigned long c_n;              /* Execution count */
+};
+
+static  char    *abpool;
+static  char    *abspec;
+static  char    *abprof;
+static  struct  abref   *abrefs;
+static  int     abnref;
+static  int     abmref;
+static  struct  abseg   *absegs;
+static  int     abnseg;
+static  struct  abbank  *abbanks;
+static  int     abnbank;
+static  unsigned long abwall;
+static  unsigned long abwcut;
+
+/*)Function     VOID    autobanksav()
+ *
+ *      The function autobanksav() saves the -a option,
+ *      area = size : bank area, bank area, ...
+ *      The area name is needed in pass 0, the remainder
+ *      is evaluated by autobank().
+ *
+ *      local variables:
+ *              char    id[]            area name
+ *
+ *      global variables:
+ *              char    *ip             pointer into the text line
+ *
+ *      functions called:
+ *              VOID    getid()         lklex.c
+ *              int     getnb()         lklex.c
+ *              char *  strsto()        lksym.c
+ *              VOID    unget()         lklex.c
+ *
+ *      side effects:
+ *              abpool and abspec are set.
+ */
+
+VOID
+autobanksav(void)
+{
+        char id[NCPS];
+
+        unget(getnb());
+        getid(id, -1);
+        abpool = strsto(id);
+        abspec = strsto(ip);
+}
+
+/*)Function     VOID    autobankprof()
+ *
+ *      The function autobankprof() saves the name of the
+ *      execution count file of the -h option.
+ *
+ *      local variables:
+ *              none
+ *
+ *      global variables:
+ *              char    *ip             pointer into the text line
+ *
+ *      functions called:
+ *              int     getnb()         lklex.c
+ *              char *  strsto()        lksym.c
+ *              VOID    unget()         lklex.c
+ *
+ *      side effects:
+ *              abprof is set.
+ */
+
+VOID
+autobankprof(void)
+{
+        unget(getnb());
+        abprof = strsto(ip);
+}
+
+/*)Function     VOID    autobankref()
+ *
+ *      The function autobankref() is called for every R line
+ *      in pass 0 and records the references made by the
+ *      segments of the banked area.
+ *
+ *      local variables:
+ *              areax **a               module area list
+ *              int     aindex          referencing area index
+ *              areax * from            referencing segment
+ *              int     mode            relocation mode
+ *              int     rindex          referenced area/symbol index
+ *              sym **  s               module symbol list
+ *
+ *      global variables:
+ *              head    *hp             current head structure
+ *
+ *      functions called:
+ *              a_uint  eval()          lkeval.c
+ *              a_uint  evword()        lkrloc.c
+ *              int     more()          lklex.c
+ *              VOID *  realloc()       c_library
+ *              int     symeq()         lksym.c
+ *
+ *      side effects:
+ *              References are added to abrefs[].
+ */
+
+VOID
+autobankref(void)
+{
+        struct areax **a, *from;
+        struct sym **s;
+        int aindex, rindex, mode;
+
+        if (abpool == NULL || hp == NULL)
+                return;
+        a = hp->a_list;
+        s = hp->s_list;
+
+        if (eval() != (R3_WORD | R3_AREA) || eval())
+                return;
+        aindex = (int) evword();
+        if (aindex >= hp->h_narea || (from = a[aindex]) == NULL ||
+            !symeq(abpool, from->a_bap->a_id, 1))
+                return;
+
+        while (more()) {
+                mode = (int) eval();
+                if ((mode & R_ESCAPE_MASK) == R_ESCAPE_MASK)
+                        mode = ((mode & ~R_ESCAPE_MASK) << 8) | eval();
+                eval();
+                rindex = (int) evword();
+
+                if (abnref == abmref) {
+                        abmref = abmref ? 2 * abmref : 1024;
+                        abrefs = (struct abref *)
+                                realloc(abrefs, abmref * sizeof(struct abref));
+                        if (abrefs == NULL) {
+                                fprintf(stderr, "Out of space!\n");
+                                lkexit(ER_FATAL);
+                        }
+                }
+                abrefs[abnref].r_from = from;
+                if (mode & R3_SYM) {
+                        if (rindex >= hp->h_nsym)
+                                continue;
+                        abrefs[abnref].r_axp = NULL;
+                        abrefs[abnref].r_sp = s[rindex];
+                } else {
+                        if (rindex >= hp->h_narea)
+                                continue;
+                        abrefs[abnref].r_axp = a[rindex];
+                        abrefs[abnref].r_sp = NULL;
+                }
+                abnref++;
+        }
+}
+
+/*
+ * qsort() and bsearch() helpers
+ */
+static int
+segcmp(const void *p1, const void *p2)
+{
+        const struct areax *a1 = ((const struct abseg *) p1)->g_axp;
+        const struct areax *a2 = ((const struct abseg *) p2)->g_axp;
+
+        return (a1 < a2) ? -1 : (a1 > a2);
+}
+
+static int
+cntcmp(const void *p1, const void *p2)
+{
+        const struct sym *s1 = ((const struct abcnt *) p1)->c_sp;
+        const struct sym *s2 = ((const struct abcnt *) p2)->c_sp;
+
+        return (s1 < s2) ? -1 : (s1 > s2);
+}
+
+static int
+edgecmp(const void *p1, const void *p2)
+{
+        const struct abedge *e1 = (const struct abedge *) p1;
+        const struct abedge *e2 = (const struct abedge *) p2;
+
+        if (e1->e_a != e2->e_a)
+                return e1->e_a - e2->e_a;
+        return e1->e_b - e2->e_b;
+}
+
+static int
+weightcmp(const void *p1, const void *p2)
+{
+        const struct abedge *e1 = (const struct abedge *) p1;
+        const struct abedge *e2 = (const struct abedge *) p2;
+
+        if (e1->e_w != e2->e_w)
+                return (e1->e_w > e2->e_w) ? -1 : 1;
+        return edgecmp(p1, p2);
+}
+
+/*
+ * Segment index of areax taxp, -1 if not in the banked area,
+ * by binary search of the segments sorted by address in sorted[].
+ */
+static int
+segidx(struct abseg *sorted, struct areax *taxp)
+{
+        struct abseg key, *gp;
+
+        key.g_axp = taxp;
+        gp = (struct abseg *) bsearch(&key, sorted, abnseg,
+                                      sizeof(struct abseg), segcmp);
+        return gp ? gp->g_link : -1;
+}
+
+/*
+ * Union-find root of segment i
+ */
+static int
+root(int *parent, int i)
+{
+        while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+        return i;
+}
+
+/*
+ * Place segment i into the first bank with enough space, or
+ * return 0 if there is none.
+ */
+static int
+place(int i)
+{
+        int k;
+
+        for (k = 0; k < abnbank; k++) {
+                if (abbanks[k].k_free >= absegs[i].g_axp->a_size) {
+                        abbanks[k].k_free -= absegs[i].g_axp->a_size;
+                        absegs[i].g_bank = k;
+                        return 1;
+                }
+        }
+        return 0;
+}
+
+/*
+ * Read the execution counts file, "symbol count" per line.
+ * Returns the counts sorted by symbol, *pn is set to their number.
+ */
+static struct abcnt *
+readprof(int *pn)
+{
+        FILE *fp;
+        char line[NINPUT], id[NINPUT];
+        unsigned long n;
+        struct abcnt *cnt = NULL;
+        struct sym *sp;
+        int ncnt = 0, mcnt = 0;
+
+        *pn = 0;
+        if ((fp = fopen(abprof, "r")) == NULL) {
+                fprintf(stderr, "?ASlink-Error-<cannot open> : \"%s\"\n", abprof);
+                lkerr++;
+                return NULL;
+        }
+        while (fgets(line, sizeof(line), fp) != NULL) {
+                if (sscanf(line, "%s %lu", id, &n) != 2 || id[0] == ';' || id[0] == '#')
+                        continue;
+                if ((sp = lkpsym(id, 0)) == NULL)
+                        continue;
+                if (ncnt == mcnt) {
+                        mcnt = mcnt ? 2 * mcnt : 256;
+                        cnt = (struct abcnt *) realloc(cnt, mcnt * sizeof(struct abcnt));
+                        if (cnt == NULL) {
+                                fprintf(stderr, "Out of space!\n");
+                                lkexit(ER_FATAL);
+                        }
+                }
+                cnt[ncnt].c_sp = sp;
+                cnt[ncnt].c_n = n;
+                ncnt++;
+        }
+        fclose(fp);
+        if (cnt != NULL)
+                qsort(cnt, ncnt, sizeof(struct abcnt), cntcmp);
+        *pn = ncnt;
+        return cnt;
+}
+
+/*)Function     VOID    autobank()
+ *
+ *      The function autobank() evaluates the -a option, assigns
+ *      every segment of the banked area to one of the bank areas
+ *      and moves the segments into these areas.  The bank areas
+ *      are created if no module defines them.  The banked area
+ *      itself is removed from the area list.
+ *
+ *      local variables:
+ *              abedge *edge            references between segments
+ *              abcnt * cnt             execution counts
+ *              int     ncnt            number of execution counts
+ *              int     nedge           number of edges
+ *              int *   parent          union-find forest of clusters
+ *              a_uint *csize           cluster sizes
+ *              int *   cluster         clusters by decreasing size
+ *              int *   deg, *fill, *adj edges of each segment
+ *              unsigned long *wb       reference weight to each bank
+ *              abseg * sorted          segments sorted by address
+ *              area *  pool            the banked area
+ *              area *  pap             area preceding the banked area
+ *              area *  after           where to insert new bank areas
+ *              a_uint  size            bank size
+ *              a_uint  cmax            largest free space of a bank
+ *
+ *      global variables:
+ *              area    *areap          The pointer to the first
+ *                                      area structure of a linked list
+ *              char    *ip             pointer into the text line
+ *              int     lkerr           error flag
+ *
+ *      functions called:
+ *              a_uint  expr()          lkeval.c
+ *              VOID    getid()         lklex.c
+ *              int     getnb()         lklex.c
+ *              char *  new()           lksym.c
+ *              VOID    qsort()         c_library
+ *              int     symeq()         lksym.c
+ *
+ *      side effects:
+ *              The segments of the banked area are moved
+ *              to the bank areas.
+ */
+
+VOID
+autobank(void)
+{
+        struct area *pool, *tap, *pap, *after;
+        struct areax *taxp, **taxpp;
+        struct abseg *sorted;
+        struct abedge *edge;
+        struct abcnt *cnt, key, *cp;
+        struct abbank *kp;
+        char id[NCPS], *p;
+        a_uint size, cmax, *csize;
+        unsigned long w, *wb;
+        int *parent, *cluster, *deg, *fill, *adj;
+        int i, j, k, n, nedge, nclus, moved, pass;
+        int ncnt = 0;
+
+        if (abpool == NULL)
+                return;
+        for (pap = NULL, pool = areap; pool != NULL; pap = pool, pool = pool->a_ap) {
+                if (symeq(abpool, pool->a_id, 1))
+                        break;
+        }
+        if (pool == NULL) {
+                fprintf(stderr, "?ASlink-Warning-No definition of area %s\n", abpool);
+                lkerr++;
+                return;
+        }
+
+        /*
+         * Evaluate "= size : bank area, bank area, ..."
+         */
+        ip = abspec;
+        if (getnb() != '=') {
+                fprintf(stderr, "?ASlink-Error-No '=' in -a option\n");
+                lkerr++;
+                return;
+        }
+        size = expr(0);
+        if (getnb() != ':') {
+                fprintf(stderr, "?ASlink-Error-No ':' in -a option\n");
+                lkerr++;
+                return;
+        }
+        for (abnbank = 1, p = ip; *p; p++) {
+                if (*p == ',')
+                        abnbank++;
+        }
+        abbanks = (struct abbank *) new (abnbank * sizeof(struct abbank));
+        for (k = 0; k < abnbank; k++) {
+                kp = &abbanks[k];
+                getid(id, -1);
+                kp->k_id = strsto(id);
+                kp->k_free = size;
+                for (tap = areap; tap != NULL; tap = tap->a_ap) {
+                        if (symeq(id, tap->a_id, 1))
+                                break;
+                }
+                if (tap == pool) {
+                        fprintf(stderr, "?ASlink-Error-Area %s is banked and a bank\n", id);
+                        lkerr++;
+                        return;
+                }
+                if ((kp->k_ap = tap) != NULL) {
+                        for (taxp = tap->a_axp; taxp; taxp = taxp->a_axp)
+                                kp->k_free = (kp->k_free > taxp->a_size) ?
+                                                kp->k_free - taxp->a_size : 0;
+                }
+                if ((i = getnb()) != ',' && (i != 0 || k != abnbank - 1)) {
+                        fprintf(stderr, "?ASlink-Error-Invalid bank list in -a option\n");
+                        lkerr++;
+                        return;
+                }
+        }
+
+        /*
+         * The segments, and a copy sorted by address
+         * with g_link holding the segment index.
+         */
+        for (abnseg = 0, taxp = pool->a_axp; taxp; taxp = taxp->a_axp)
+                abnseg++;
+        absegs = (struct abseg *) new (abnseg * sizeof(struct abseg));
+        sorted = (struct abseg *) new (abnseg * sizeof(struct abseg));
+        for (i = 0, taxp = pool->a_axp; taxp; taxp = taxp->a_axp, i++) {
+                absegs[i].g_axp = sorted[i].g_axp = taxp;
+                absegs[i].g_bank = -1;
+                sorted[i].g_link = i;
+        }
+        qsort(sorted, abnseg, sizeof(struct abseg), segcmp);
+
+        /*
+         * Build the weighted reference graph
+         */
+        cnt = abprof ? readprof(&ncnt) : NULL;
+        edge = (struct abedge *) new ((abnref + 1) * sizeof(struct abedge));
+        for (nedge = 0, n = 0; n < abnref; n++) {
+                i = segidx(sorted, abrefs[n].r_from);
+                taxp = abrefs[n].r_sp ? abrefs[n].r_sp->s_axp : abrefs[n].r_axp;
+                if (i < 0 || taxp == NULL || (j = segidx(sorted, taxp)) < 0 || i == j)
+                        continue;
+                w = 1;
+                if (cnt != NULL && abrefs[n].r_sp != NULL) {
+                        key.c_sp = abrefs[n].r_sp;
+                        cp = (struct abcnt *) bsearch(&key, cnt, ncnt,
+                                                      sizeof(struct abcnt), cntcmp);
+                        if (cp != NULL)
+                                w += cp->c_n;
+                }
+                edge[nedge].e_a = i < j ? i : j;
+                edge[nedge].e_b = i < j ? j : i;
+                edge[nedge].e_w = w;
+                nedge++;
+        }
+        free(abrefs);
+        abrefs = NULL;
+        abnref = abmref = 0;
+        free(cnt);
+
+        qsort(edge, nedge, sizeof(struct abedge), edgecmp);
+        for (n = 0, i = 0; i < nedge; i++) {
+                if (n && edge[n-1].e_a == edge[i].e_a && edge[n-1].e_b == edge[i].e_b) {
+                        edge[n-1].e_w += edge[i].e_w;
+                } else {
+                        edge[n++] = edge[i];
+                }
+        }
+        nedge = n;
+
+        /*
+         * Cluster along the heaviest edges while a cluster
+         * fits into the largest bank.
+         */
+        parent = (int *) new (abnseg * sizeof(int));
+        csize = (a_uint *) new (abnseg * sizeof(a_uint));
+        for (i = 0; i < abnseg; i++) {
+                parent[i] = i;
+                csize[i] = absegs[i].g_axp->a_size;
+        }
+        for (cmax = 0, k = 0; k < abnbank; k++) {
+                if (abbanks[k].k_free > cmax)
+                        cmax = abbanks[k].k_free;
+        }
+        qsort(edge, nedge, sizeof(struct abedge), weightcmp);
+        for (n = 0; n < nedge; n++) {
+                i = root(parent, edge[n].e_a);
+                j = root(parent, edge[n].e_b);
+                if (i == j || csize[i] + csize[j] > cmax)
+                        continue;
+                if (j < i) {
+                        k = i; i = j; j = k;
+                }
+                parent[j] = i;
+                csize[i] += csize[j];
+        }
+
+        /*
+         * Chain the segments of each cluster in link order, then
+         * place the clusters first fit decreasing.  A cluster that
+         * fits nowhere as a whole is placed segment by segment.
+         */
+        cluster = (int *) new (abnseg * sizeof(int));
+        for (i = abnseg - 1; i >= 0; i--) {
+                j = root(parent, i);
+                if (j != i) {
+                        absegs[i].g_link = absegs[j].g_link;
+                        absegs[j].g_link = i + 1;
+                }
+        }
+        for (nclus = 0, i = 0; i < abnseg; i++) {
+                if (root(parent, i) == i)
+                        cluster[nclus++] = i;
+        }
+        for (i = 1; i < nclus; i++) {
+                k = cluster[i];
+                for (j = i; j > 0 && csize[cluster[j-1]] < csize[k]; j--)
+                        cluster[j] = cluster[j-1];
+                cluster[j] = k;
+        }
+        for (n = 0; n < nclus; n++) {
+                i = cluster[n];
+                for (k = 0; k < abnbank; k++) {
+                        if (abbanks[k].k_free >= csize[i])
+                                break;
+                }
+                for (j = i; ; j = absegs[j].g_link - 1) {
+                        if (k < abnbank) {
+                                absegs[j].g_bank = k;
+                                abbanks[k].k_free -= absegs[j].g_axp->a_size;
+                        } else
+                        if (!place(j)) {
+                                fprintf(stderr,
+                                        "?ASlink-Error-Area %s of module %s does not fit into any bank\n",
+                                        abpool, absegs[j].g_axp->a_bhp->m_id);
+                                lkerr++;
+                                absegs[j].g_bank = 0;
+                        }
+                        if (absegs[j].g_link == 0)
+                                break;
+                }
+        }
+
+        /*
+         * Move single segments to the bank they reference most
+         * while this reduces the cross bank weight.
+         */
+        deg = (int *) new ((abnseg + 1) * sizeof(int));
+        adj = (int *) new ((2 * nedge + 1) * sizeof(int));
+        fill = (int *) new ((abnseg + 1) * sizeof(int));
+        wb = (unsigned long *) new (abnbank * sizeof(unsigned long));
+        for (n = 0; n < nedge; n++) {
+                deg[edge[n].e_a + 1]++;
+                deg[edge[n].e_b + 1]++;
+        }
+        for (i = 0; i < abnseg; i++)
+                deg[i + 1] += deg[i];
+        for (n = 0; n < nedge; n++) {
+                i = edge[n].e_a;
+                j = edge[n].e_b;
+                adj[deg[i] + fill[i]++] = n;
+                adj[deg[j] + fill[j]++] = n;
+        }
+        for (pass = 0, moved = 1; moved && pass < 16; pass++) {
+                for (moved = 0, i = 0; i < abnseg; i++) {
+                        memset(wb, 0, abnbank * sizeof(unsigned long));
+                        for (n = deg[i]; n < deg[i + 1]; n++) {
+                                struct abedge *ep = &edge[adj[n]];
+
+                                j = (ep->e_a == i) ? ep->e_b : ep->e_a;
+                                wb[absegs[j].g_bank] += ep->e_w;
+                        }
+                        k = absegs[i].g_bank;
+                        for (j = 0; j < abnbank; j++) {
+                                if (wb[j] > wb[k] &&
+                                    abbanks[j].k_free >= absegs[i].g_axp->a_size)
+                                        k = j;
+                        }
+                        if (k != absegs[i].g_bank) {
+                                abbanks[absegs[i].g_bank].k_free += absegs[i].g_axp->a_size;
+                                abbanks[k].k_free -= absegs[i].g_axp->a_size;
+                                absegs[i].g_bank = k;
+                                moved++;
+                        }
+                }
+        }
+        for (abwall = abwcut = 0, n = 0; n < nedge; n++) {
+                abwall += edge[n].e_w;
+                if (absegs[edge[n].e_a].g_bank != absegs[edge[n].e_b].g_bank)
+                        abwcut += edge[n].e_w;
+        }
+
+        /*
+         * Move the segments into the bank areas, creating missing
+         * bank areas in place of the banked area, and unlink the
+         * banked area.
+         */
+        for (i = 0; i < abnseg; i++)
+                abbanks[absegs[i].g_bank].k_nseg++;
+        for (after = pool, k = 0; k < abnbank; k++) {
+                kp = &abbanks[k];
+                if (kp->k_ap == NULL) {
+                        tap = (struct area *) new (sizeof(struct area));
+                        tap->a_id = kp->k_id;
+                        tap->a_flag = pool->a_flag;
+                        tap->a_ap = after->a_ap;
+                        after->a_ap = tap;
+                        after = tap;
+                        kp->k_ap = tap;
+                        if (kp->k_nseg == 0) {
+                                /*
+                                 * An empty bank still needs a segment
+                                 */
+                                taxp = (struct areax *) new (sizeof(struct areax));
+                                if (is_sdld() && !(TARGET_IS_Z80 || TARGET_IS_Z180 || TARGET_IS_GB))
+                                        taxp->a_addr = -1;
+                                taxp->a_bap = tap;
+                                taxp->a_bhp = absegs[0].g_axp->a_bhp;
+                                tap->a_axp = taxp;
+                        }
+                }
+                for (taxpp = &kp->k_ap->a_axp; *taxpp; taxpp = &(*taxpp)->a_axp)
+                        ;
+                for (i = 0; i < abnseg; i++) {
+                        if (absegs[i].g_bank != k)
+                                continue;
+                        taxp = absegs[i].g_axp;
+                        taxp->a_axp = NULL;
+                        taxp->a_bap = kp->k_ap;
+                        *taxpp = taxp;
+                        taxpp = &taxp->a_axp;
+                }
+        }
+        if (pap == NULL)
+                areap = pool->a_ap;
+        else
+                pap->a_ap = pool->a_ap;
+
+        free(sorted);
+        free(edge);
+        free(parent);
+        free(csize);
+        free(cluster);
+        free(deg);
+        free(fill);
+        free(adj);
+        free(wb);
+}
+
+/*)Function     VOID    autobanklst(fp)
+ *
+ *              FILE *  fp              output file handle
+ *
+ *      The function autobanklst() lists the bank assignment
+ *      made by autobank() in the map file.
+ *
+ *      local variables:
+ *              int     i               loop counter
+ *              int     k               bank index
+ *              char *  frmt            number format
+ *
+ *      global variables:
+ *              int     xflag           map file radix type flag
+ *
+ *      functions called:
+ *              int     fprintf()       c_library
+ *
+ *      side effects:
+ *              Map file output is generated.
+ */
+
+VOID
+autobanklst(FILE *fp)
+{
+        int i, k;
+        char *frmt;
+
+        if (abnbank == 0 || absegs == NULL)
+                return;
+
+        switch (xflag) {
+        default:
+        case 0: frmt = "  %8X";  break;
+        case 1: frmt = "  %8o";  break;
+        case 2: frmt = "  %8u";  break;
+        }
+
+        fprintf(fp, "\nAutomatic Bank Assignment of Area %s\n\n", abpool);
+        fprintf(fp, "Bank                                 Free  Segments\n");
+        fprintf(fp, "--------------------------------  --------  --------\n");
+        for (k = 0; k < abnbank; k++) {
+                fprintf(fp, "%-32.32s", abbanks[k].k_id);
+                fprintf(fp, frmt, abbanks[k].k_free);
+                fprintf(fp, "  %8d\n", abbanks[k].k_nseg);
+        }
+        fprintf(fp, "\nCross bank reference weight %lu of %lu\n\n", abwcut, abwall);
+        fprintf(fp, "Module                                Size  Bank\n");
+        fprintf(fp, "--------------------------------  --------  --------------------------------\n");
+        for (i = 0; i < abnseg; i++) {
+                fprintf(fp, "%-32.32s", absegs[i].g_axp->a_bhp->m_id);
+                fprintf(fp, frmt, absegs[i].g_axp->a_size);
+                fprintf(fp, "  %s\n", abbanks[absegs[i].g_bank].k_id);
+        }
+}
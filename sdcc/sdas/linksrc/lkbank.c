@@ -448,6 +448,7 @@ chkbank(FILE *fp)
  *                                      bank structure of a linked list
  *              FILE *  jfp             NoICE output file handle
  *              int     oflag           data output type flag
+ *              int     bintyp          -T output type
  *              FILE *  stderr          Standard Error Output handle
  *
  *      functions called:
@@ -536,8 +537,13 @@ lkfopen(void)
                                         default:
                                         case 2: frmt = "ihx"; break;
                                         }
+                                        /* sdld specific */
+                                        if (bintyp == T_HEX)
+                                                frmt = "hex";
+                                        /* end sdld specific */
                                         fpt = strsto(bp->b_fspec);
-                                        strcat(fpt, ".ihx");
+                                        strcat(fpt, ".");
+                                        strcat(fpt, frmt);
                                         fp = afile(fpt, frmt, 1);
                                 } else
                                 if (oflag == 2) {
@@ -566,6 +572,18 @@ lkfopen(void)
                                         fpt = strsto(bp->b_fspec);
                                         strcat(fpt, ".elf");
                                         fp = afile(fpt, "elf", 2);
+                                } else
+                                if (oflag == 5) {
+                                        switch(bintyp) {
+                                        default:
+                                        case T_BIN: frmt = "bin"; break;
+                                        case T_GB:  frmt = "gb";  break;
+                                        case T_SMS: frmt = "sms"; break;
+                                        }
+                                        fpt = strsto(bp->b_fspec);
+                                        strcat(fpt, ".");
+                                        strcat(fpt, frmt);
+                                        fp = afile(fpt, frmt, 2);
                                 }
                                 /* end sdld specific */
                                 if (fp != stderr) {
@@ -63,6 +63,10 @@ char    rb[NINPUT];     /*      LST file text line being
                          */
 int     oflag;          /*      Output file type flag
                          */
+int     bintyp;         /*      -T output type
+                         */
+int     ihxlen = IXXMAXBYTES; /*    Intel Hex data bytes per record
+                         */
 int     objflg;         /*      Linked file/library object output flag
                          */
 
@@ -127,6 +131,13 @@ a_uint  rtadr1 = 0;     /*
                          */
 a_uint  rtadr2 = 0;     /*
                          */
+unsigned char rbval[256];       /* values of a binary T/R/P record
+                         */
+int     rbcnt = -1;     /*      count of values in rbval[],
+                         *      -1 if the current line is text
+                         */
+int     rbidx;          /*      index of the next value in rbval[]
+                         */
 int     obj_flag = 0;   /*      Linked file/library object output flag
                          */
 int     a_bytes;        /*      REL file T Line address length
@@ -64,6 +64,9 @@
  *
  *	global variables:
  *		int	radix		current number conversion radix
+ *		int	rbcnt		count of binary record values
+ *		int	rbidx		index of next binary value
+ *		char	rbval[]		binary record values
  *
  *	functions called:
  *		int	digit()		lkeval.c
@@ -82,6 +85,8 @@ eval(void)
 	int c, v;
 	a_uint n;
 
+	if (rbcnt >= 0)
+		return(rbidx < rbcnt ? rbval[rbidx++] : 0);
 	c = getnb();
 	n = 0;
 	while ((v = digit(c, radix)) >= 0) {
@@ -23,6 +23,7 @@
  */
 
 #include "aslink.h"
+#include "lkrel.h"
 
 /*)Module       lklex.c
  *
@@ -494,6 +495,7 @@ int d;
  *              char *  fgets()         c_library
  *              int     fprintf()       c_library
  *              VOID    lkulist()       lklist.c
+ *              char *  rel_readln()    lkrel.c
  *              VOID    lkexit()        lkmain.c
  *
  *      side effects:
@@ -510,7 +512,9 @@ nxtline()
 loop:   if (pflag && cfp && cfp->f_type == F_STD)
                 fprintf(stdout, "ASlink >> ");
 
-        if (sfp == NULL || fgets(ib, sizeof(ib), sfp) == NULL) {
+        if (sfp == NULL || (cfp->f_type == F_REL ?
+                        rel_readln(ib, sizeof(ib), sfp) :
+                        (rbcnt = -1, fgets(ib, sizeof(ib), sfp))) == NULL) {
                 obj_flag = 0;
                 if (sfp) {
                         if(sfp != stdin) {
@@ -535,7 +539,7 @@ loop:   if (pflag && cfp && cfp->f_type == F_STD)
                         } else
                         if (ftype == F_REL) {
                                 obj_flag = cfp->f_obj;
-                                sfp = afile(fid, "", 0);
+                                sfp = afile(fid, "", 3);
                                 if (sfp && (obj_flag == 0)) {
                                         if (uflag && (pass != 0)) {
                                                 if (is_sdld())
@@ -579,13 +583,15 @@ loop:   if (pflag && cfp && cfp->f_type == F_STD)
  *      skipping white space (SPACES and TABS) and returns a (0)
  *      if the end of the line or a comment delimeter (;) is found,
  *      or a (1) if their are additional characters in the line.
+ *      For a binary record the remaining values are counted.
  *
  *      local variables:
  *              int     c               next character from
  *                                      the input text line
  *
  *      global variables:
- *              none
+ *              int     rbcnt           count of binary record values
+ *              int     rbidx           index of next binary value
  *
  *      called functions:
  *              int     getnb()         lklex.c
@@ -613,6 +619,8 @@ more()
 {
         int c;
 
+        if (rbcnt >= 0)
+                return(rbidx < rbcnt);
         c = getnb();
         if (c != '\0' && c != ';' && !isHex (c))
           lkexit (ER_FATAL);
@@ -65,8 +65,24 @@
 /* First entry in the library object symbol cache */
 pmlibraryfile libr = NULL;
 
+/* Hash table over all symbols of the library object symbol cache.
+ * The chains keep the order of libr, so the first definition found
+ * is the same as with a linear search through libr.
+ */
+struct libsymhash
+{
+  const char *name;
+  pmlibraryfile lib;
+  struct libsymhash *next;
+};
+
+static struct libsymhash **libsymtab = NULL;
+static unsigned int libsymmask;
+
 int buildlibraryindex (void);
 void freelibraryindex (void);
+static unsigned int libsymhash (const char *name);
+static void hashlibraryindex (void);
 #endif /* INDEXLIB */
 
 struct aslib_target *aslib_targets[] = {
@@ -478,7 +494,7 @@ fndsym (char *name)
 {
   struct lbfile *lbfh, *lbf;
   pmlibraryfile ThisLibr;
-  pmlibrarysymbol ThisSym = NULL;
+  struct libsymhash *ThisHash;
 
   pmlibraryfile FirstFound;
   int numfound = 0;
@@ -486,78 +502,79 @@ fndsym (char *name)
   D ("Searching symbol: %s\n", name);
 
   /* Build the index if this is the first call to fndsym */
-  if (libr == NULL)
-    buildlibraryindex ();
+  if (libsymtab == NULL)
+    {
+      buildlibraryindex ();
+      hashlibraryindex ();
+    }
 
-  /* Iterate through all library object files */
+  /* Iterate through all library object files defining the symbol */
   FirstFound = libr;            /* So gcc stops whining */
-  for (ThisLibr = libr; ThisLibr != NULL; ThisLibr = ThisLibr->next)
+  for (ThisHash = libsymtab[libsymhash (name) & libsymmask]; ThisHash != NULL; ThisHash = ThisHash->next)
     {
-      /* Iterate through all symbols in an object file */
-      for (ThisSym = ThisLibr->symbols; ThisSym != NULL; ThisSym = ThisSym->next)
+      if (!strcmp (ThisHash->name, name))
         {
-          if (!strcmp (ThisSym->name, name))
+          ThisLibr = ThisHash->lib;
+
+          if ((!ThisLibr->loaded) && (numfound == 0))
             {
-              if ((!ThisLibr->loaded) && (numfound == 0))
+              /* Object file is not loaded - add it to the list */
+              lbfh = (struct lbfile *) new (sizeof (struct lbfile));
+              if (lbfhead == NULL)
                 {
-                  /* Object file is not loaded - add it to the list */
-                  lbfh = (struct lbfile *) new (sizeof (struct lbfile));
-                  if (lbfhead == NULL)
-                    {
-                      lbfhead = lbfh;
-                    }
-                  else
-                    {
-                      for (lbf = lbfhead; lbf->next != NULL; lbf = lbf->next)
-                        ;
+                  lbfhead = lbfh;
+                }
+              else
+                {
+                  for (lbf = lbfhead; lbf->next != NULL; lbf = lbf->next)
+                    ;
 
-                      lbf->next = lbfh;
-                    }
-                  lbfh->libspc = ThisLibr->libspc;
-                  lbfh->filspc = ThisLibr->filspc;
-                  lbfh->relfil = strdup (ThisLibr->relfil);
-                  lbfh->offset = ThisLibr->offset;
-                  lbfh->type = ThisLibr->type;
+                  lbf->next = lbfh;
+                }
+              lbfh->libspc = ThisLibr->libspc;
+              lbfh->filspc = ThisLibr->filspc;
+              lbfh->relfil = strdup (ThisLibr->relfil);
+              lbfh->offset = ThisLibr->offset;
+              lbfh->type = ThisLibr->type;
 
-                  (*aslib_targets[lbfh->type]->loadfile) (lbfh);
+              (*aslib_targets[lbfh->type]->loadfile) (lbfh);
 
-                  ThisLibr->loaded = 1;
-                }
+              ThisLibr->loaded = 1;
+            }
 
-              if (numfound == 0)
-                {
-                  numfound++;
-                  FirstFound = ThisLibr;
-                }
-              else
-                {
-                  char absPath1[PATH_MAX];
-                  char absPath2[PATH_MAX];
+          if (numfound == 0)
+            {
+              numfound++;
+              FirstFound = ThisLibr;
+            }
+          else
+            {
+              char absPath1[PATH_MAX];
+              char absPath2[PATH_MAX];
 #if defined(_WIN32)
-                  int j;
-
-                  _fullpath (absPath1, FirstFound->libspc, PATH_MAX);
-                  _fullpath (absPath2, ThisLibr->libspc, PATH_MAX);
-                  for (j = 0; absPath1[j] != 0; j++)
-                    absPath1[j] = tolower ((unsigned char) absPath1[j]);
-                  for (j = 0; absPath2[j] != 0; j++)
-                    absPath2[j] = tolower ((unsigned char) absPath2[j]);
+              int j;
+
+              _fullpath (absPath1, FirstFound->libspc, PATH_MAX);
+              _fullpath (absPath2, ThisLibr->libspc, PATH_MAX);
+              for (j = 0; absPath1[j] != 0; j++)
+                absPath1[j] = tolower ((unsigned char) absPath1[j]);
+              for (j = 0; absPath2[j] != 0; j++)
+                absPath2[j] = tolower ((unsigned char) absPath2[j]);
 #else
-                  if (NULL == realpath (FirstFound->libspc, absPath1))
-                    *absPath1 = '\0';
-                  if (NULL == realpath (ThisLibr->libspc, absPath2))
-                    *absPath2 = '\0';
+              if (NULL == realpath (FirstFound->libspc, absPath1))
+                *absPath1 = '\0';
+              if (NULL == realpath (ThisLibr->libspc, absPath2))
+                *absPath2 = '\0';
 #endif
-                  if (!(EQ (absPath1, absPath2) && EQ (FirstFound->relfil, ThisLibr->relfil)))
+              if (!(EQ (absPath1, absPath2) && EQ (FirstFound->relfil, ThisLibr->relfil)))
+                {
+                  if (numfound == 1)
                     {
-                      if (numfound == 1)
-                        {
-                          fprintf (stderr, "?ASlink-Warning-Definition of public symbol '%s'" " found more than once:\n", name);
-                          fprintf (stderr, "   Library: '%s', Module: '%s'\n", FirstFound->libspc, FirstFound->relfil);
-                        }
-                      fprintf (stderr, "   Library: '%s', Module: '%s'\n", ThisLibr->libspc, ThisLibr->relfil);
-                      numfound++;
+                      fprintf (stderr, "?ASlink-Warning-Definition of public symbol '%s'" " found more than once:\n", name);
+                      fprintf (stderr, "   Library: '%s', Module: '%s'\n", FirstFound->libspc, FirstFound->relfil);
                     }
+                  fprintf (stderr, "   Library: '%s', Module: '%s'\n", ThisLibr->libspc, ThisLibr->relfil);
+                  numfound++;
                 }
             }
         }
@@ -653,12 +670,93 @@ buildlibraryindex (void)
   return 0;
 }
 
+/* libsymhash - FNV-1a hash of a symbol name */
+static unsigned int
+libsymhash (const char *name)
+{
+  unsigned int h = 2166136261u;
+
+  while (*name)
+    {
+      h ^= (unsigned char) *name++;
+      h *= 16777619u;
+    }
+  return h;
+}
+
+/* hashlibraryindex - enter all symbols of the in-memory library index into
+ *                    libsymtab, so that fndsym() doesn't have to scan every
+ *                    symbol of every library for each undefined symbol
+ */
+static void
+hashlibraryindex (void)
+{
+  pmlibraryfile ThisLibr;
+  pmlibrarysymbol ThisSym;
+  struct libsymhash **tail;
+  unsigned int nsym = 0, size = 64;
+
+  for (ThisLibr = libr; ThisLibr != NULL; ThisLibr = ThisLibr->next)
+    for (ThisSym = ThisLibr->symbols; ThisSym != NULL; ThisSym = ThisSym->next)
+      nsym++;
+
+  /* keep the load factor below 1/2 */
+  while (size < 2 * nsym)
+    size <<= 1;
+  libsymmask = size - 1;
+  libsymtab = (struct libsymhash **) new (size * sizeof (struct libsymhash *));
+  tail = (struct libsymhash **) new (size * sizeof (struct libsymhash *));
+
+  for (ThisLibr = libr; ThisLibr != NULL; ThisLibr = ThisLibr->next)
+    {
+      for (ThisSym = ThisLibr->symbols; ThisSym != NULL; ThisSym = ThisSym->next)
+        {
+          unsigned int h = libsymhash (ThisSym->name) & libsymmask;
+          struct libsymhash *ThisHash = (struct libsymhash *) new (sizeof (struct libsymhash));
+
+          ThisHash->name = ThisSym->name;
+          ThisHash->lib = ThisLibr;
+          ThisHash->next = NULL;
+
+          /* append, to preserve the library search order */
+          if (tail[h] == NULL)
+            libsymtab[h] = ThisHash;
+          else
+            tail[h]->next = ThisHash;
+          tail[h] = ThisHash;
+        }
+    }
+
+  free (tail);
+
+  D ("Hashed %u library symbols into %u buckets\n", nsym, size);
+}
+
 /* Release all memory allocated for the in-memory library index */
 void
 freelibraryindex (void)
 {
   pmlibraryfile ThisLibr, ThisLibr2Free;
   pmlibrarysymbol ThisSym, ThisSym2Free;
+  unsigned int i;
+
+  if (libsymtab)
+    {
+      for (i = 0; i <= libsymmask; i++)
+        {
+          struct libsymhash *ThisHash = libsymtab[i];
+
+          while (ThisHash)
+            {
+              struct libsymhash *ThisHash2Free = ThisHash;
+
+              ThisHash = ThisHash->next;
+              free (ThisHash2Free);
+            }
+        }
+      free (libsymtab);
+      libsymtab = NULL;
+    }
 
   ThisLibr = libr;
 
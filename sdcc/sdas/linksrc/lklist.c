@@ -340,6 +340,107 @@ static int _cmpSymByAddr(const void *p1, const void *p2)
 }
 /* end sdld specific */
 
+/*
+ * Symbols with an area, sorted by area extension and in
+ * symhash[] order within each one.  Built once by axpsyms()
+ * so that lstarea() does not scan the whole symbol table
+ * for every area extension.
+ */
+struct axpsym {
+        struct sym *sp;
+        int seq;
+};
+
+static struct axpsym *axpsym;
+static int naxpsym = -1;
+
+static int
+_cmpAxpSym(const void *p1, const void *p2)
+{
+        const struct axpsym *s1 = (const struct axpsym *) p1;
+        const struct axpsym *s2 = (const struct axpsym *) p2;
+
+        if (s1->sp->s_axp != s2->sp->s_axp)
+                return((char *) s1->sp->s_axp < (char *) s2->sp->s_axp ? -1 : 1);
+        return(s1->seq - s2->seq);
+}
+
+/*)Function     int     axpsyms(oxp, first)
+ *
+ *              areax * oxp             pointer to an area extension structure
+ *              int *   first           returned index of the first symbol
+ *
+ *      The function axpsyms() returns the number of symbols defined
+ *      in the area extension oxp and, in first, the index of the first
+ *      of them in axpsym[].  The symbols keep the order of a scan of
+ *      symhash[].  axpsym[] is built on the first call, the symbol
+ *      table must not change after that.
+ *
+ *      local variables:
+ *              int     i               loop counter
+ *              int     lo              binary search lower bound
+ *              int     hi              binary search upper bound
+ *              int     m               binary search midpoint
+ *              sym *   sp              pointer to a symbol structure
+ *
+ *      global variables:
+ *              sym *symhash[NHASH]     array of pointers to NHASH
+ *                                      linked symbol lists
+ *
+ *      functions called:
+ *              VOID *  malloc()        c_library
+ *              VOID    qsort()         c_library
+ *
+ *      side effects:
+ *              axpsym[] is allocated and sorted on the first call.
+ */
+
+static int
+axpsyms(struct areax *oxp, int *first)
+{
+        int i, lo, hi, m;
+        struct sym *sp;
+
+        if (naxpsym < 0) {
+                naxpsym = 0;
+                for (i=0; i<NHASH; i++) {
+                        for (sp=symhash[i]; sp != NULL; sp=sp->s_sp) {
+                                if (sp->s_axp)
+                                        ++naxpsym;
+                        }
+                }
+                axpsym = (struct axpsym *) malloc((naxpsym ? naxpsym : 1) * sizeof(struct axpsym));
+                if (axpsym == NULL) {
+                        fprintf(stderr, "Insufficient space to build Map Segment.\n");
+                        lkexit(ER_FATAL);
+                }
+                naxpsym = 0;
+                for (i=0; i<NHASH; i++) {
+                        for (sp=symhash[i]; sp != NULL; sp=sp->s_sp) {
+                                if (sp->s_axp) {
+                                        axpsym[naxpsym].sp = sp;
+                                        axpsym[naxpsym].seq = naxpsym;
+                                        ++naxpsym;
+                                }
+                        }
+                }
+                qsort(axpsym, naxpsym, sizeof(struct axpsym), _cmpAxpSym);
+        }
+        lo = 0;
+        hi = naxpsym;
+        while (lo < hi) {
+                m = (lo + hi) / 2;
+                if ((char *) axpsym[m].sp->s_axp < (char *) oxp)
+                        lo = m + 1;
+                else
+                        hi = m;
+        }
+        *first = lo;
+        for (hi=lo; hi<naxpsym && axpsym[hi].sp->s_axp == oxp; hi++)
+                ;
+        return(hi - lo);
+}
+
 /*)Function     VOID    lstarea(xp, yp)
  *
  *              area *  xp              pointer to an area structure
@@ -371,13 +472,13 @@ static int _cmpSymByAddr(const void *p1, const void *p2)
  *      global variables:
  *              int     a_bytes         T line address bytes
  *              FILE    *mfp            Map output file handle
- *              sym *symhash[NHASH]     array of pointers to NHASH
- *                                      linked symbol lists
+ *              axpsym *axpsym          symbols sorted by area extension
  *              int     wflag           Wide format listing
  *              int     xflag           Map file radix type flag
  *
  *      functions called:
  *              int     fprintf()       c_library
+ *              int     axpsyms()       lklist.c
  *              VOID    free()          c_library
  *              char *  malloc()        c_library
  *              char    putc()          c_library
@@ -407,14 +508,7 @@ lstarea(struct area *xp, struct bank *yp)
         nmsym = 0;
         oxp = xp->a_axp;
         while (oxp) {
-                for (i=0; i<NHASH; i++) {
-                        sp = symhash[i];
-                        while (sp != NULL) {
-                                if (oxp == sp->s_axp)
-                                        ++nmsym;
-                                sp = sp->s_sp;
-                        }
-                }
+                nmsym += axpsyms(oxp, &i);
                 oxp = oxp->a_axp;
         }
 
@@ -440,14 +534,8 @@ lstarea(struct area *xp, struct bank *yp)
         nmsym = 0;
         oxp = xp->a_axp;
         while (oxp) {
-                for (i=0; i<NHASH; i++) {
-                        sp = symhash[i];
-                        while (sp != NULL) {
-                                if (oxp == sp->s_axp) {
-                                        p[nmsym++] = sp;
-                                }
-                                sp = sp->s_sp;
-                        }
+                for (n=axpsyms(oxp, &i); n>0; n--) {
+                        p[nmsym++] = axpsym[i++].sp;
                 }
                 oxp = oxp->a_axp;
         }
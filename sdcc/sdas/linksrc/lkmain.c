@@ -247,12 +247,18 @@ main(int argc, char *argv[])
                                 /*
                                  * Options with arguments
                                  */
+                                case 'a':
+                                case 'A':
+
                                 case 'b':
                                 case 'B':
 
                                 case 'g':
                                 case 'G':
 
+                                case 'h':
+                                case 'H':
+
                                 case 'k':
                                 case 'K':
 
@@ -266,6 +272,7 @@ main(int argc, char *argv[])
                                 case 'X':
                                 case 'C':
                                 case 'S':
+                                case 'T':
                                         strcat(ip, " ");
                                         if (i < argc - 1)
                                                 strcat(ip, argv[++i]);
@@ -360,6 +367,10 @@ main(int argc, char *argv[])
                         v_mask = 0x7FFFFFFF;
                         /* end sdas specific */
 
+                        /*
+                         * Assign banked segments to banks.
+                         */
+                        autobank();
                         /*
                          * Set area base addresses.
                          */
@@ -731,8 +742,13 @@ link_main()
         case 'T':
         case 'R':
         case 'P':
-                if (pass == 0)
+                if (pass == 0) {
+                        /* sdld specific */
+                        if (c == 'R')
+                                autobankref();
+                        /* end sdld specific */
                         break;
+                }
                 reloc(c);
                 break;
 
@@ -873,6 +889,10 @@ map(void)
                 }
                 fprintf(mfp, "\n");
         }
+        /*
+         * List Automatic Bank Assignment
+         */
+        autobanklst(mfp);
         /*
          * List Base Address Definitions
          */
@@ -1025,8 +1045,13 @@ parse()
                                         oflag = 2;
                                         break;
 
-                                case 't':
                                 case 'T':
+                                        if (is_sdld()) {
+                                                binsav();
+                                                return(0);
+                                        }
+                                        // else fall through
+                                case 't':
                                         oflag = 3;
                                         break;
 
@@ -1110,11 +1135,21 @@ parse()
                                         pflag = 1;
                                         break;
 
+                                case 'a':
+                                case 'A':
+                                        autobanksav();
+                                        return(0);
+
                                 case 'b':
                                 case 'B':
                                         bassav();
                                         return(0);
 
+                                case 'h':
+                                case 'H':
+                                        autobankprof();
+                                        return(0);
+
                                 case 'g':
                                 case 'G':
                                         gblsav();
@@ -1414,6 +1449,7 @@ setgbl()
  *              int     wf              0 ==>> read
  *                                      1 ==>> write
  *                                      2 ==>> binary write
+ *                                      3 ==>> binary read
  *
  *      The function afile() opens a file for reading or writing.
  *              (1)     If the file type specification string ft
@@ -1496,7 +1532,7 @@ afile(char *fn, char *ft, int wf)
         *p1++ = 0;
 
         /*
-         * Select Read/Write/Binary Write
+         * Select Read/Write/Binary Write/Binary Read
          */
         switch(wf) {
         default:
@@ -1507,9 +1543,10 @@ afile(char *fn, char *ft, int wf)
 #else
         case 2: frmt = "wb";    break;
 #endif
+        case 3: frmt = "rb";    break;
         }
         if ((fp = fopen(afspec, frmt)) == NULL && strcmp(ft,"adb") != 0) { /* Do not complain for optional adb files */
-                fprintf(stderr, "?ASlink-Error-<cannot %s> : \"%s\"\n", wf?"create":"open", afspec);
+                fprintf(stderr, "?ASlink-Error-<cannot %s> : \"%s\"\n", (wf == 1 || wf == 2)?"create":"open", afspec);
                 lkerr++;
         }
         return (fp);
@@ -1717,6 +1754,8 @@ char *usetxt[] = {
         "Relocation:",
         "  -b   area base address = expression",
         "  -g   global symbol = expression",
+        "  -a   area = bank size : bank area,...  Assign area to banks",
+        "  -h   file  Symbol execution counts for -a",
         "Map format:",
         "  -m   Map output generated as (out)file[.map]",
         "  -w   Wide listing format for map file",
@@ -1726,6 +1765,13 @@ char *usetxt[] = {
         "Output:",
         "  -i   Intel Hex as (out)file[.ihx]",
         "  -s   Motorola S Record as (out)file[.s19]",
+        "  -T   type[,option=value...]  Binary image as (out)file[.type]",
+        "       bin, gb (Game Boy) or sms (Master System / Game Gear),",
+        "       or compact Intel Hex as (out)file[.hex] for type hex",
+        "       fill=, start=, size= or end=, len= (hex)",
+        "       name=, rom=, ram=, mbc=, gbc (gb)",
+        "       region=, code=, version= (sms)",
+        "       (options may be separated by : instead of ,)",
 //      "  -t   Tandy CoCo Disk BASIC binary as (out)file[.bi-]",
 #if NOICE
         "  -j   NoICE Debug output as (out)file[.noi]",
@@ -1760,6 +1806,8 @@ char *usetxt_8051[] = {
         "Relocation:",
         "  -b   area base address = expression",
         "  -g   global symbol = expression",
+        "  -a   area = bank size : bank area,...  Assign area to banks",
+        "  -h   file  Symbol execution counts for -a",
         "Map format:",
         "  -m   Map output generated as (out)file[.map]",
         "  -w   Wide listing format for map file",
@@ -1769,6 +1817,13 @@ char *usetxt_8051[] = {
         "Output:",
         "  -i   Intel Hex as (out)file[.ihx]",
         "  -s   Motorola S Record as (out)file[.s19]",
+        "  -T   type[,option=value...]  Binary image as (out)file[.type]",
+        "       bin, gb (Game Boy) or sms (Master System / Game Gear),",
+        "       or compact Intel Hex as (out)file[.hex] for type hex",
+        "       fill=, start=, size= or end=, len= (hex)",
+        "       name=, rom=, ram=, mbc=, gbc (gb)",
+        "       region=, code=, version= (sms)",
+        "       (options may be separated by : instead of ,)",
 #if NOICE
         "  -j   NoICE Debug output as (out)file[.noi]",
 #endif
@@ -1807,6 +1862,8 @@ char *usetxt_6808[] = {
         "Relocation:",
         "  -b   area base address = expression",
         "  -g   global symbol = expression",
+        "  -a   area = bank size : bank area,...  Assign area to banks",
+        "  -h   file  Symbol execution counts for -a",
         "Map format:",
         "  -m   Map output generated as (out)file[.map]",
         "  -w   Wide listing format for map file",
@@ -1816,6 +1873,13 @@ char *usetxt_6808[] = {
         "Output:",
         "  -i   Intel Hex as (out)file[.ihx]",
         "  -s   Motorola S Record as (out)file[.s19]",
+        "  -T   type[,option=value...]  Binary image as (out)file[.type]",
+        "       bin, gb (Game Boy) or sms (Master System / Game Gear),",
+        "       or compact Intel Hex as (out)file[.hex] for type hex",
+        "       fill=, start=, size= or end=, len= (hex)",
+        "       name=, rom=, ram=, mbc=, gbc (gb)",
+        "       region=, code=, version= (sms)",
+        "       (options may be separated by : instead of ,)",
         "  -E   ELF executable as file[.elf]",
 #if NOICE
         "  -j   NoICE Debug output as (out)file[.noi]",
@@ -1853,6 +1917,8 @@ char *usetxt_z80_gb[] = {
         "Relocation:",
         "  -b   area base address = expression",
         "  -g   global symbol = expression",
+        "  -a   area = bank size : bank area,...  Assign area to banks",
+        "  -h   file  Symbol execution counts for -a",
         "Map format:",
         "  -m   Map output generated as (out)file[.map]",
         "  -w   Wide listing format for map file",
@@ -1862,6 +1928,13 @@ char *usetxt_z80_gb[] = {
         "Output:",
         "  -i   Intel Hex as (out)file[.ihx]",
         "  -s   Motorola S Record as (out)file[.s19]",
+        "  -T   type[,option=value...]  Binary image as (out)file[.type]",
+        "       bin, gb (Game Boy) or sms (Master System / Game Gear),",
+        "       or compact Intel Hex as (out)file[.hex] for type hex",
+        "       fill=, start=, size= or end=, len= (hex)",
+        "       name=, rom=, ram=, mbc=, gbc (gb)",
+        "       region=, code=, version= (sms)",
+        "       (options may be separated by : instead of ,)",
 #if SDCDB
         "  -y   SDCDB Debug output as (out)file[.cdb]",
 #endif
@@ -27,6 +27,7 @@
  *      gary@s-4.com.
  */
 
+#include <ctype.h>
 #include "aslink.h"
 
 /*)Module       lkout.c
@@ -42,8 +43,11 @@
  *              VOID    iflush()
  *              VOID    dbx()
  *              VOID    dflush()
+ *              VOID    binsav()
+ *              VOID    bxx()
  *
- *      lkout.c contains no local variables.
+ *      lkout.c contains the binary image (-T) options
+ *      and the images being built as local variables.
  */
 
 /*)Function     lkout(i)
@@ -69,6 +73,7 @@
  *              VOID    s19()           lks19.c
  *              VOID    dbx()           lkout.c
  *              VOID    elf()           lkelf.c
+ *              VOID    bxx()           lkout.c
  *
  *      side effects:
  *              The REL data is output in the required format.
@@ -112,6 +117,12 @@ lkout(int i)
          */
         if (oflag == 4) {
                 elf(i);
+        } else
+        /*
+         * Binary Image Formats
+         */
+        if (oflag == 5) {
+                bxx(i);
         }
 }
 
@@ -239,6 +250,7 @@ lkflush()
  *      global variables:
  *              int     a_bytes         T Line Address Bytes
  *              int     hilo            byte order
+ *              int     ihxlen          data bytes per record
  *              FILE *  ofp             output file handle
  *              int     rtaflg          first output flag
  *              int     rtcnt           count of data words
@@ -266,7 +278,8 @@ lkflush()
  *      2       Record Type Field
  *      2       Checksum Field
  *
- *      Plus 32 data bytes (64 characters)
+ *      Plus ihxlen data bytes, 32 (64 characters) unless
+ *      changed by the -T hex option.
  */
 
 VOID
@@ -320,7 +333,7 @@ ixx(int i)
                                 if ((rtadr1 & 0xffff) == 0) {
                                         iflush();
                                 }
-                                if (rtadr1 - rtadr0 == IXXMAXBYTES) {
+                                if (rtadr1 - rtadr0 == (a_uint) ihxlen) {
                                         iflush();
                                 }
                         }
@@ -358,10 +371,16 @@ ixx(int i)
  *              a_uint  hi_addr         segment number
  *              int     i               loop counter
  *              int     max             number of data bytes
+ *              int     newhi           output a segment record
+ *              char *  p               pointer into str[]
+ *              a_uint  prev_hi_addr    last segment output
+ *              FILE *  prev_ofp        file of the last segment
  *              int     reclen          record length
+ *              char    str[]           record text
  *
  *      global variables:
  *              int     a_bytes         T Line Address Bytes
+ *              int     bintyp          -T output type
  *              FILE *  ofp             output file handle
  *              int     rtaflg          first output flag
  *              char    rtbuf[]         output buffer
@@ -370,6 +389,8 @@ ixx(int i)
  *
  *      functions called:
  *              int     fprintf()       c_library
+ *              int     fwrite()        c_library
+ *              long    ftell()         c_library
  *
  *      side effects:
  *              The data is output to the file defined by ofp.
@@ -380,7 +401,7 @@ ixx(int i)
  * of G. Osborn, gary@s-4.com.
  * The new version concatenates the assembler
  * output records when they represent contiguous
- * memory segments to produce IXXMAXBYTES data byte
+ * memory segments to produce ihxlen data byte
  * Intel Hex output lines whenever possible, resulting
  * in a substantial reduction in file size.
  * More importantly, the download time
@@ -390,16 +411,31 @@ ixx(int i)
 VOID
 iflush()
 {
-        int i, max, reclen;
+        static const char hex[] = "0123456789ABCDEF";
+        static a_uint prev_hi_addr = 0;
+        static FILE * prev_ofp = NULL;
+        int i, max, reclen, newhi;
         a_uint chksum, lo_addr, hi_addr;
+        char str[2 * NMAX + 16];
+        char *p;
 
         max = (int) (rtadr1 - rtadr0);
         if (max) {
                 if (a_bytes > 2) {
-                        static a_uint prev_hi_addr = 0;
-
                         hi_addr = (rtadr0 >> 16) & 0xffff;
-                        if ((hi_addr != prev_hi_addr) || rtaflg) {
+                        if (bintyp == T_HEX) {
+                                /*
+                                 * Compact output only changes the
+                                 * segment when it has to, a new
+                                 * file starting at segment 0.
+                                 */
+                                newhi = (hi_addr != prev_hi_addr) ||
+                                        ((ofp != prev_ofp) && (hi_addr || ftell(ofp)));
+                                prev_ofp = ofp;
+                        } else {
+                                newhi = (hi_addr != prev_hi_addr) || rtaflg;
+                        }
+                        if (newhi) {
                                 chksum =  0x02;
                                 chksum += 0x04;
                                 chksum += hi_addr;
@@ -417,29 +453,38 @@ iflush()
                  * Only the ":" and the checksum itself are excluded
                  * from the checksum.  The record length includes
                  * only the data bytes.
+                 *
+                 * The record is formatted in str[] and written
+                 * with a single call.
                  */
                 lo_addr = rtadr0 & 0xffff;
                 reclen = max;
                 chksum = reclen;
                 chksum += lo_addr;
                 chksum += lo_addr >> 8;
-#ifdef  LONGINT
-                fprintf(ofp, ":%02X%04lX00", reclen, lo_addr);
-#else
-                fprintf(ofp, ":%02X%04X00", reclen, lo_addr);
-#endif
+                p = str;
+                *p++ = ':';
+                *p++ = hex[(reclen >> 4) & 0x0f];
+                *p++ = hex[reclen & 0x0f];
+                *p++ = hex[(lo_addr >> 12) & 0x0f];
+                *p++ = hex[(lo_addr >> 8) & 0x0f];
+                *p++ = hex[(lo_addr >> 4) & 0x0f];
+                *p++ = hex[lo_addr & 0x0f];
+                *p++ = '0';
+                *p++ = '0';
                 for (i=0; i<max; i++) {
                         chksum += rtbuf[i];
-                        fprintf(ofp, "%02X", rtbuf[i] & 0x00ff);
+                        *p++ = hex[(rtbuf[i] >> 4) & 0x0f];
+                        *p++ = hex[rtbuf[i] & 0x0f];
                 }
                 /*
                  * 2's complement
                  */
-#ifdef  LONGINT
-                fprintf(ofp, "%02lX\n", (~chksum + 1) & 0x00ff);
-#else
-                fprintf(ofp, "%02X\n", (~chksum + 1) & 0x00ff);
-#endif
+                chksum = (~chksum + 1) & 0x00ff;
+                *p++ = hex[chksum >> 4];
+                *p++ = hex[chksum & 0x0f];
+                *p++ = '\n';
+                fwrite(str, 1, p - str, ofp);
                 rtadr0 = rtadr1;
         }
 
@@ -951,3 +996,564 @@ dflush()
 
         rtadr0 = rtadr1;
 }
+
+
+/*)Binary Image Formats
+ *
+ *      The -T option writes the linked data directly as the
+ *      memory image a target loads, without going through an
+ *      Intel Hex file and makebin:
+ *
+ *              -T bin          raw binary image (.bin)
+ *              -T gb           Game Boy image (.gb)
+ *              -T sms          Sega Master System / Game Gear
+ *                              image (.sms)
+ *              -T hex          compact Intel Hex (.hex), as an
+ *                              .ihx file run through packihx
+ *
+ *      followed by ",option=value" settings, which may also
+ *      be separated by ':' as sdcc -Wl splits its argument
+ *      at the commas:
+ *
+ *              fill=n          value of unused bytes, 0xFF
+ *              start=addr      address of the first image byte, 0
+ *              size=n          image size, by default up to the
+ *                              last byte written
+ *              end=addr        address past the last image byte,
+ *                              instead of size
+ *              name=title      gb: cartridge title
+ *              rom=n           gb: ROM banks, 2, the default size
+ *              ram=n           gb: RAM banks, 0
+ *              mbc=n           gb: cartridge type, 0
+ *              gbc             gb: Game Boy Color cartridge
+ *              region=n        sms: region code, 4 (SMS export)
+ *              code=n          sms: product code, 0
+ *              version=n       sms: version, 0
+ *              len=n           hex: data bytes per record, 16
+ *
+ *      The image of each output file is built in memory and
+ *      written, after any header fixups, when the file is closed.
+ */
+
+/*
+ * Binary image options
+ */
+static  int     bfill = 0xFF;   /* unused byte value */
+static  a_uint  bstart;         /* image start address */
+static  a_uint  bsize;          /* image size, 0 - up to last byte */
+static  char    gbname[16];     /* gb: cartridge title */
+static  int     gbrom = 2;      /* gb: ROM banks */
+static  int     gbram;          /* gb: RAM banks */
+static  int     gbmbc;          /* gb: cartridge type */
+static  int     gbcgb;          /* gb: Game Boy Color flag */
+static  int     smsregion = 4;  /* sms: region code */
+static  a_uint  smscode;        /* sms: product code */
+static  int     smsver;         /* sms: version */
+
+/*
+ * The image being built for an output file
+ */
+struct  bimage
+{
+        struct  bimage *i_ip;   /* next image */
+        FILE *  i_ofp;          /* output file handle */
+        unsigned char *i_buf;   /* image buffer */
+        a_uint  i_max;          /* bytes allocated */
+        a_uint  i_len;          /* bytes written, up to the last */
+        int     i_err;          /* range error reported */
+};
+
+static  struct  bimage *bimagep;
+
+/*)Function     binsav()
+ *
+ *      The function binsav() parses the -T option,
+ *      type[,option=value...], selecting the output
+ *      format and setting the image options.
+ *
+ *      local variables:
+ *              int     c               character
+ *              a_uint  end             end address option
+ *              char    id[]            type or option name
+ *              char *  p               pointer into gbname[]
+ *              a_uint  v               option value
+ *
+ *      global variables:
+ *              int     bintyp          -T output type
+ *              int     ihxlen          data bytes per record
+ *              int     lkerr           error flag
+ *              int     oflag           output type flag
+ *
+ *      functions called:
+ *              a_uint  expr()          lkeval.c
+ *              int     fprintf()       c_library
+ *              int     get()           lklex.c
+ *              VOID    getid()         lklex.c
+ *              int     getnb()         lklex.c
+ *              int     symeq()         lksym.c
+ *              VOID    unget()         lklex.c
+ *
+ *      side effects:
+ *              The output type and image options are set.
+ */
+
+VOID
+binsav(void)
+{
+        int c;
+        a_uint end, v;
+        char id[NCPS];
+        char *p;
+
+        if ((c = getnb()) == 0) {
+                fprintf(stderr, "No output type for -T\n");
+                lkerr++;
+                return;
+        }
+        getid(id, c);
+        if (symeq(id, "bin", 1)) {
+                bintyp = T_BIN;
+        } else
+        if (symeq(id, "gb", 1)) {
+                bintyp = T_GB;
+        } else
+        if (symeq(id, "sms", 1)) {
+                bintyp = T_SMS;
+        } else
+        if (symeq(id, "hex", 1)) {
+                bintyp = T_HEX;
+                ihxlen = 16;
+        } else {
+                fprintf(stderr, "Unknown output type -T %s\n", id);
+                lkerr++;
+                return;
+        }
+        oflag = (bintyp == T_HEX) ? 1 : 5;
+
+        end = 0;
+        while ((c = getnb()) != 0) {
+                if ((c == ',') || (c == ':'))
+                        continue;
+                getid(id, c);
+                if (symeq(id, "gbc", 1)) {
+                        gbcgb = 1;
+                        continue;
+                }
+                if (getnb() != '=') {
+                        fprintf(stderr, "No '=' in -T option %s\n", id);
+                        lkerr++;
+                        return;
+                }
+                if (symeq(id, "name", 1)) {
+                        memset(gbname, 0, sizeof(gbname));
+                        p = gbname;
+                        while ((c = get()) != 0 && c != ',' && c != ':') {
+                                if (p < &gbname[sizeof(gbname)])
+                                        *p++ = c;
+                        }
+                        unget(c);
+                        continue;
+                }
+                v = expr(0);
+                if (symeq(id, "fill", 1)) {
+                        bfill = (int) v & 0xFF;
+                } else
+                if (symeq(id, "start", 1)) {
+                        bstart = v;
+                } else
+                if (symeq(id, "size", 1)) {
+                        bsize = v;
+                } else
+                if (symeq(id, "end", 1)) {
+                        end = v;
+                } else
+                if (symeq(id, "rom", 1)) {
+                        gbrom = (int) v;
+                } else
+                if (symeq(id, "ram", 1)) {
+                        gbram = (int) v;
+                } else
+                if (symeq(id, "mbc", 1)) {
+                        gbmbc = (int) v;
+                } else
+                if (symeq(id, "region", 1)) {
+                        smsregion = (int) v;
+                } else
+                if (symeq(id, "code", 1)) {
+                        smscode = v;
+                } else
+                if (symeq(id, "version", 1)) {
+                        smsver = (int) v;
+                } else
+                if (symeq(id, "len", 1)) {
+                        if ((v < 1) || (v > 2 * IXXMAXBYTES)) {
+                                fprintf(stderr, "-T len=%u must be 1 to %d\n", (unsigned) v, 2 * IXXMAXBYTES);
+                                lkerr++;
+                        } else {
+                                ihxlen = (int) v;
+                        }
+                } else {
+                        fprintf(stderr, "Unknown -T option %s\n", id);
+                        lkerr++;
+                }
+        }
+        if (end) {
+                if (end <= bstart) {
+                        fprintf(stderr, "-T end=0x%X is not after start=0x%X\n", (unsigned) end, (unsigned) bstart);
+                        lkerr++;
+                } else {
+                        bsize = end - bstart;
+                }
+        }
+        if ((bintyp == T_GB) && (bsize == 0)) {
+                bsize = (a_uint) gbrom * 0x4000;
+        }
+}
+
+/*)Function     bimage(fp, n)
+ *
+ *              FILE *  fp              output file handle
+ *              a_uint  n               image bytes needed
+ *
+ *      The function bimage() returns the image of the output
+ *      file fp, creating it or growing it, filled with the
+ *      fill byte, to hold at least n bytes.
+ *
+ *      local variables:
+ *              struct bimage *bip      image pointer
+ *              a_uint  max             new image allocation
+ *
+ *      global variables:
+ *              none
+ *
+ *      functions called:
+ *              VOID    lkexit()        lkmain.c
+ *              VOID *  memset()        c_library
+ *              VOID *  new()           lksym.c
+ *              VOID *  realloc()       c_library
+ *
+ *      side effects:
+ *              The image may be created or reallocated.
+ */
+
+static struct bimage *
+bimage(FILE *fp, a_uint n)
+{
+        static struct bimage *bip;
+        a_uint max;
+
+        if ((bip == NULL) || (bip->i_ofp != fp)) {
+                for (bip = bimagep; bip != NULL; bip = bip->i_ip) {
+                        if (bip->i_ofp == fp)
+                                break;
+                }
+                if (bip == NULL) {
+                        bip = (struct bimage *) new (sizeof (struct bimage));
+                        bip->i_ofp = fp;
+                        bip->i_ip = bimagep;
+                        bimagep = bip;
+                }
+        }
+        if (n > bip->i_max) {
+                max = bip->i_max ? bip->i_max : 0x8000;
+                while (max < n)
+                        max *= 2;
+                if (bsize && (max > bsize))
+                        max = (n > bsize) ? n : bsize;
+                bip->i_buf = (unsigned char *) realloc(bip->i_buf, max);
+                if (bip->i_buf == NULL) {
+                        fprintf(stderr, "Out of space!\n");
+                        lkexit(ER_FATAL);
+                }
+                memset(bip->i_buf + bip->i_max, bfill, max - bip->i_max);
+                bip->i_max = max;
+        }
+        return(bip);
+}
+
+/*)Function     gbhdr(buf, size)
+ *
+ *              unsigned char * buf     Game Boy image
+ *              a_uint  size            image size
+ *
+ *      The function gbhdr() fills in the Game Boy cartridge
+ *      header at 0x0104-0x014F: the Nintendo logo, which the
+ *      Game Boy checks before running the cartridge, the title,
+ *      the cartridge type, the ROM and RAM sizes and the header
+ *      and global checksums.
+ *
+ *      local variables:
+ *              a_uint  chk             checksum
+ *              a_uint  i               loop counter
+ *
+ *      global variables:
+ *              none
+ *
+ *      functions called:
+ *              int     fprintf()       c_library
+ *              VOID *  memcpy()        c_library
+ *
+ *      side effects:
+ *              The header bytes of the image are set.
+ */
+
+static VOID
+gbhdr(unsigned char *buf, a_uint size)
+{
+        static const unsigned char gb_logo[] = {
+                0xce, 0xed, 0x66, 0x66, 0xcc, 0x0d, 0x00, 0x0b,
+                0x03, 0x73, 0x00, 0x83, 0x00, 0x0c, 0x00, 0x0d,
+                0x00, 0x08, 0x11, 0x1f, 0x88, 0x89, 0x00, 0x0e,
+                0xdc, 0xcc, 0x6e, 0xe6, 0xdd, 0xdd, 0xd9, 0x99,
+                0xbb, 0xbb, 0x67, 0x63, 0x6e, 0x0e, 0xec, 0xcc,
+                0xdd, 0xdc, 0x99, 0x9f, 0xbb, 0xb9, 0x33, 0x3e
+        };
+        a_uint chk, i;
+
+        memcpy(&buf[0x104], gb_logo, sizeof (gb_logo));
+
+        /*
+         * 0134-0143: title in upper case, 00 filled
+         */
+        for (i = 0; i < sizeof (gbname); i++) {
+                buf[0x134 + i] = toupper((unsigned char) gbname[i]);
+        }
+        if (gbcgb) {
+                buf[0x143] = 0x80;
+        }
+
+        /*
+         * 0147: cartridge type
+         * 0148: ROM size, 32 KB << n
+         * 0149: RAM size
+         */
+        buf[0x147] = gbmbc;
+        for (i = 0; (i <= 8) && (gbrom != (2 << i)); i++)
+                ;
+        if (i > 8) {
+                fprintf(stderr, "?ASlink-Warning-Unsupported number of ROM banks (%d)\n", gbrom);
+                i = 0;
+        }
+        buf[0x148] = i;
+        switch (gbram) {
+        case 0:  buf[0x149] = 0; break;
+        case 1:  buf[0x149] = 2; break;
+        case 4:  buf[0x149] = 3; break;
+        case 16: buf[0x149] = 4; break;
+        default:
+                fprintf(stderr, "?ASlink-Warning-Unsupported number of RAM banks (%d)\n", gbram);
+                buf[0x149] = 0;
+                break;
+        }
+
+        /*
+         * 014D: header checksum
+         * 014E-014F: global checksum, high byte first
+         */
+        for (chk = 0, i = 0x134; i < 0x14d; i++)
+                chk += buf[i];
+        buf[0x14d] = (0xe7 - chk) & 0xff;
+        buf[0x14e] = 0;
+        buf[0x14f] = 0;
+        for (chk = 0, i = 0; i < size; i++)
+                chk += buf[i];
+        buf[0x14e] = (chk >> 8) & 0xff;
+        buf[0x14f] = chk & 0xff;
+}
+
+/*)Function     smshdr(buf, size)
+ *
+ *              unsigned char * buf     SMS / Game Gear image
+ *              a_uint  size            image size
+ *
+ *      The function smshdr() fills in the Sega header at
+ *      0x7FF0-0x7FFF: "TMR SEGA", the checksum of the
+ *      image (0x0000-0x7FEF and 0x8000 up), the product
+ *      code and version and the region and size code.
+ *      The reserved bytes 0x7FF8-0x7FF9 are not changed.
+ *
+ *      local variables:
+ *              a_uint  chk             checksum
+ *              a_uint  i               loop counter
+ *              a_uint  n               checksummed size
+ *              int     sc              size code
+ *
+ *      global variables:
+ *              none
+ *
+ *      functions called:
+ *              VOID *  memcpy()        c_library
+ *
+ *      side effects:
+ *              The header bytes of the image are set.
+ */
+
+static VOID
+smshdr(unsigned char *buf, a_uint size)
+{
+        static const unsigned char sc_size[] = {
+                /* 32K,  64K,  128K, 256K, 512K, 1M */
+                0x0c, 0x0e, 0x0f, 0x00, 0x01, 0x02
+        };
+        a_uint chk, i, n;
+        int sc;
+
+        memcpy(&buf[0x7ff0], "TMR SEGA", 8);
+
+        /*
+         * The checksum covers the largest
+         * size code not past the image end.
+         */
+        for (sc = 0, n = 0x8000; (sc < 5) && (2 * n <= size); sc++)
+                n *= 2;
+        for (chk = 0, i = 0; i < 0x7ff0; i++)
+                chk += buf[i];
+        for (i = 0x8000; i < n; i++)
+                chk += buf[i];
+        buf[0x7ffa] = chk & 0xff;
+        buf[0x7ffb] = (chk >> 8) & 0xff;
+
+        /*
+         * Product code, the low four digits in BCD,
+         * then the rest of it and the version.
+         */
+        buf[0x7ffc] = ((smscode / 10) % 10) << 4 | (smscode % 10);
+        buf[0x7ffd] = ((smscode / 1000) % 10) << 4 | ((smscode / 100) % 10);
+        buf[0x7ffe] = ((smscode / 10000) & 0x0f) << 4 | (smsver & 0x0f);
+        buf[0x7fff] = (smsregion & 0x0f) << 4 | sc_size[sc];
+}
+
+/*)Function     bxx(i)
+ *
+ *              int     i               1 - process data
+ *                                      0 - end of data
+ *
+ *      The function bxx() places the relocated data into
+ *      the image of the output file and, at the end of
+ *      data, writes the image.
+ *
+ *      local variables:
+ *              a_uint  addr            image offset
+ *              struct bimage *bip      image pointer
+ *              a_uint  j               temporary
+ *              int     k               loop counter
+ *              a_uint  len             image size
+ *
+ *      global variables:
+ *              int     a_bytes         T Line Address Bytes
+ *              int     bintyp          -T output type
+ *              int     hilo            byte order
+ *              int     lkerr           error flag
+ *              FILE *  ofp             output file handle
+ *              int     rtcnt           count of data words
+ *              int     rtflg[]         output the data flag
+ *              a_uint  rtval[]         relocated data
+ *              a_uint  rtadr2          address temporary
+ *
+ *      functions called:
+ *              struct bimage *bimage() lkout.c
+ *              int     fprintf()       c_library
+ *              int     fwrite()        c_library
+ *              VOID    gbhdr()         lkout.c
+ *              VOID    smshdr()        lkout.c
+ *
+ *      side effects:
+ *              The data is placed into the image which
+ *              is output to the file defined by ofp.
+ */
+
+VOID
+bxx(int i)
+{
+        struct bimage *bip;
+        a_uint addr, j, len;
+        int k;
+
+        if (i) {
+                if (TARGET_IS_6808 && ap->a_flag & A_NOLOAD)
+                        return;
+
+                if (hilo == 0) {
+                        switch(a_bytes){
+                        default:
+                        case 2:
+                                j = rtval[0];
+                                rtval[0] = rtval[1];
+                                rtval[1] = j;
+                                break;
+                        case 3:
+                                j = rtval[0];
+                                rtval[0] = rtval[2];
+                                rtval[2] = j;
+                                break;
+                        case 4:
+                                j = rtval[0];
+                                rtval[0] = rtval[3];
+                                rtval[3] = j;
+                                j = rtval[2];
+                                rtval[2] = rtval[1];
+                                rtval[1] = j;
+                                break;
+                        }
+                }
+                for (i=0,rtadr2=0; i<a_bytes; i++) {
+                        rtadr2 = (rtadr2 << 8) | rtval[i];
+                }
+                bip = bimage(ofp, 0);
+                for (k=a_bytes; k<rtcnt; k++, rtadr2++) {
+                        if (!rtflg[k])
+                                continue;
+                        addr = rtadr2 - bstart;
+                        if ((rtadr2 < bstart) || (bsize && (addr >= bsize))) {
+                                if (!bip->i_err) {
+                                        fprintf(stderr,
+                                            "?ASlink-Error-Data at 0x%X is outside of the binary image\n",
+                                            (unsigned) rtadr2);
+                                        lkerr++;
+                                        bip->i_err = 1;
+                                }
+                                continue;
+                        }
+                        if (addr >= bip->i_max)
+                                bip = bimage(ofp, addr + 1);
+                        bip->i_buf[addr] = (unsigned char) rtval[k];
+                        if (addr >= bip->i_len)
+                                bip->i_len = addr + 1;
+                }
+        } else {
+                bip = bimage(ofp, 0);
+                len = bsize ? bsize : bip->i_len;
+                if (bintyp == T_GB) {
+                        if (len < 0x150) {
+                                fprintf(stderr, "?ASlink-Error-Game Boy image size 0x%X is too small\n", (unsigned) len);
+                                lkerr++;
+                                return;
+                        }
+                } else
+                if (bintyp == T_SMS) {
+                        if (bsize == 0) {
+                                for (len = 0x8000; len < bip->i_len; len *= 2)
+                                        ;
+                        } else
+                        if (len < 0x8000) {
+                                fprintf(stderr, "?ASlink-Error-SMS image size 0x%X is too small\n", (unsigned) len);
+                                lkerr++;
+                                return;
+                        }
+                }
+                bip = bimage(ofp, len);
+                if (bintyp == T_GB) {
+                        gbhdr(bip->i_buf, len);
+                } else
+                if (bintyp == T_SMS) {
+                        smshdr(bip->i_buf, len);
+                }
+                if (fwrite(bip->i_buf, 1, len, ofp) != (size_t) len) {
+                        fprintf(stderr, "?ASlink-Error-Cannot write the binary image\n");
+                        lkerr++;
+                }
+                free(bip->i_buf);
+                bip->i_buf = NULL;
+                bip->i_max = bip->i_len = 0;
+        }
+}
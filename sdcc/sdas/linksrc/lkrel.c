@@ -82,6 +82,35 @@ is_rel (FILE * libfp)
   return ret;
 }
 
+/* Read a line of a .rel file.  The binary T, R and P records written by
+   sdas -r (see asout.c) are returned as a line holding just the upper case
+   designator, their values are left in rbval[] for more() and eval(). */
+char *
+rel_readln (char *str, int size, FILE * fp)
+{
+  int c, n;
+
+  c = getc (fp);
+  if (c == 't' || c == 'r' || c == 'p')
+    {
+      if ((n = getc (fp)) == EOF || fread (rbval, 1, n, fp) != (size_t) n)
+        {
+          fprintf (stderr, "?ASlink-Error-Truncated binary record\n");
+          lkexit (ER_FATAL);
+        }
+      rbcnt = n;
+      rbidx = 0;
+      str[0] = c - 'a' + 'A';
+      str[1] = '\0';
+      return str;
+    }
+  if (c != EOF)
+    ungetc (c, fp);
+
+  rbcnt = -1;
+  return lk_readnl (str, size, fp);
+}
+
 /* Load a standalone or embedded .rel */
 int
 load_rel (FILE * libfp, long size)
@@ -93,7 +122,7 @@ load_rel (FILE * libfp, long size)
 
       end = (size >= 0) ? ftell (libfp) + size : -1;
 
-      while ((end < 0 || ftell (libfp) < end) && lk_readnl (str, sizeof (str), libfp) != NULL)
+      while ((end < 0 || ftell (libfp) < end) && rel_readln (str, sizeof (str), libfp) != NULL)
         {
           if (0 == strcmp (str, "</REL>"))
             return 1;
@@ -124,7 +153,7 @@ enum_symbols (FILE * fp, long size, int (*func) (const char *symvoid, void *para
    * our object file and don't go into the next one.
    */
 
-  while ((end < 0 || ftell (fp) < end) && lk_readnl (buf, sizeof (buf), fp) != NULL)
+  while ((end < 0 || ftell (fp) < end) && rel_readln (buf, sizeof (buf), fp) != NULL)
     {
       char symname[NINPUT];
       char c;
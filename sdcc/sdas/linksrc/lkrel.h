@@ -42,6 +42,7 @@ extern "C"
   int is_rel (FILE * libfp);
   int load_rel (FILE * libfp, long size);
   int enum_symbols (FILE * fp, long size, int (*func) (const char *symvoid, void *param), void *param);
+  char *rel_readln (char *str, int size, FILE * fp);
 
 
 #ifdef __cplusplus
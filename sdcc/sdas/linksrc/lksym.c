@@ -36,6 +36,8 @@
  *
  *      lksym.c contains the following functions:
  *              int     hash()
+ *              unsigned int    idxhash()
+ *              VOID    idxsym()
  *              sym *   lkpsym()
  *              char *  new()
  *              sym *   newsym()
@@ -49,9 +51,26 @@
  *      lksym.c contains the static variables:
  *              char *  pnext
  *              int     bytes
- *      used by the string store function.
+ *      used by the string store function and
+ *              sym **  symidx
+ *      the lookup table used by lkpsym().
  */
 
+/*
+ * The symbols stay linked into the NHASH lists of
+ * symhash[], which determine the order of the
+ * symbols in the map and other output files.
+ * Lookups go through symidx[] instead, an open
+ * addressed table holding all symbols, which is
+ * doubled in size whenever it becomes half full.
+ */
+static  struct  sym     **symidx;
+static  unsigned int    symidxmsk;
+static  unsigned int    symidxcnt;
+
+static  unsigned int    idxhash(char *p, int cflag);
+static  VOID            idxsym(struct sym *sp);
+
 /*)Function     VOID    syminit()
  *
  *      The function syminit() is called to clear the hashtable.
@@ -69,6 +88,7 @@
  *
  *      side effects:
  *              (1)     The symbol hash tables are cleared
+ *              (2)     The symbol lookup table is released
  */
 
 VOID
@@ -79,6 +99,11 @@ syminit(void)
         spp = &symhash[0];
         while (spp < &symhash[NHASH])
                 *spp++ = NULL;
+
+        if (symidx != NULL)
+                free(symidx);
+        symidx = NULL;
+        symidxmsk = symidxcnt = 0;
 }
 
 /*)Function     sym *   newsym()
@@ -215,15 +240,19 @@ newsym(void)
  *
  *      local variables:
  *              int     h               computed hash value
+ *              int     i               lookup table index
  *              sym *   sp              pointer to a sym structure
  *
  *      global varaibles:
  *              sym * symhash[]         array of pointers to NHASH
  *                                      linked symbol lists
+ *              sym **  symidx          symbol lookup table
  *              int     zflag           Disable symbol case sensitivity
  *
  *      functions called:
  *              int     hash()          lksym.c
+ *              unsigned int idxhash()  lksym.c
+ *              VOID    idxsym()        lksym.c
  *              char *  new()           lksym.c
  *              int     symeq()         lksym.c
  *
@@ -236,24 +265,86 @@ struct sym *
 lkpsym(char *id, int f)
 {
         struct sym *sp;
+        unsigned int i;
         int h;
 
-        h = hash(id, zflag);
-        sp = symhash[h];
-        while (sp != NULL) {
-                if (symeq(id, sp->s_id, zflag))
-                        return (sp);
-                sp = sp->s_sp;
+        if (symidx != NULL) {
+                i = idxhash(id, zflag) & symidxmsk;
+                while ((sp = symidx[i]) != NULL) {
+                        if (symeq(id, sp->s_id, zflag))
+                                return (sp);
+                        i = (i + 1) & symidxmsk;
+                }
         }
         if (f == 0)
                 return (NULL);
+        h = hash(id, zflag);
         sp = (struct sym *) new (sizeof(struct sym));
         sp->s_sp = symhash[h];
         symhash[h] = sp;
         sp->s_id = strsto(id);   /* JLH */
+        idxsym(sp);
         return (sp);
 }
 
+/*)Function     VOID    idxsym(sp)
+ *
+ *              sym *   sp              pointer to a sym structure
+ *
+ *      The function idxsym() enters a new symbol into the
+ *      symbol lookup table.  When the table would become
+ *      more than half full it is doubled in size first.
+ *
+ *      local variables:
+ *              sym **  old             previous lookup table
+ *              int     i               loop index
+ *              int     j               table index
+ *              int     n               previous table size
+ *
+ *      global variables:
+ *              sym **  symidx          symbol lookup table
+ *              int     symidxmsk       table size - 1
+ *              int     symidxcnt       symbols in the table
+ *              int     zflag           Disable symbol case sensitivity
+ *
+ *      functions called:
+ *              VOID    free()          c_library
+ *              unsigned int idxhash()  lksym.c
+ *              char *  new()           lksym.c
+ *
+ *      side effects:
+ *              The symbol lookup table may be reallocated.
+ */
+
+static VOID
+idxsym(struct sym *sp)
+{
+        struct sym **old;
+        unsigned int i, j, n;
+
+        if (2 * (symidxcnt + 1) > symidxmsk + 1) {
+                old = symidx;
+                n = old ? symidxmsk + 1 : 0;
+                symidxmsk = n ? 2 * n - 1 : 1023;
+                symidx = (struct sym **) new ((symidxmsk + 1) * sizeof(struct sym *));
+                for (i = 0; i < n; ++i) {
+                        if (old[i] == NULL)
+                                continue;
+                        j = idxhash(old[i]->s_id, zflag) & symidxmsk;
+                        while (symidx[j] != NULL)
+                                j = (j + 1) & symidxmsk;
+                        symidx[j] = old[i];
+                }
+                if (old != NULL)
+                        free(old);
+        }
+        j = idxhash(sp->s_id, zflag) & symidxmsk;
+        while (symidx[j] != NULL)
+                j = (j + 1) & symidxmsk;
+        symidx[j] = sp;
+        ++symidxcnt;
+}
+
 /*)Function     a_uint  symval(tsp)
  *
  *              sym *   tsp             pointer to a symbol structure
@@ -487,6 +578,50 @@ hash(char *p, int cflag)
         return (h&HMASK);
 }
 
+/*)Function     unsigned int    idxhash(p, cflag)
+ *
+ *              char *  p               pointer to string to hash
+ *              int     cflag           case sensitive flag
+ *
+ *      The function idxhash() computes the FNV-1a hash
+ *      of a string, used for the symbol lookup table.
+ *      Unlike hash() the full value is returned, the
+ *      caller masks it to the size of the table.
+ *
+ *              cflag == 0      case sensitive hash
+ *              cflag != 0      case insensitive hash
+ *
+ *      local variables:
+ *              unsigned int h  accumulated hash value
+ *
+ *      global variables:
+ *              char    ccase[]         an array of characters which
+ *                                      perform the case translation function
+ *
+ *      functions called:
+ *              none
+ *
+ *      side effects:
+ *              none
+ */
+
+static unsigned int
+idxhash(char *p, int cflag)
+{
+        unsigned int h;
+
+        h = 2166136261u;
+        while (*p) {
+                if(cflag) {
+                        h ^= (unsigned char) ccase[*p++ & 0x007F];
+                } else {
+                        h ^= (unsigned char) *p++;
+                }
+                h *= 16777619u;
+        }
+        return (h);
+}
+
 #if     decus
 
 /*)Function     char *  strsto(str)
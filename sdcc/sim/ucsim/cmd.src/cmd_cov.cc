@@ -0,0 +1,453 @@
+/*
+ * Simulator of microcontrollers (cmd.src/cmd_cov.cc)
+ *
+ */
+
+/* This file is part of microcontroller simulator: ucsim.
+
+UCSIM is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+UCSIM is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UCSIM; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+02111-1307, USA. */
+/*@1@*/
+
+#include "ddconfig.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// prj
+#include "utils.h"
+#include "fiocl.h"
+
+// sim
+#include "simcl.h"
+
+// local
+#include "cmd_covcl.h"
+
+
+void
+set_coverage_help(class cl_cmd *cmd)
+{
+  cmd->set_help("coverage subcommand",
+		"Executed instructions and branch directions",
+		"Long of coverage");
+}
+
+static bool
+no_coverage(class cl_uc *uc, class cl_console_base *con)
+{
+  if (uc->cov_map)
+    return(false);
+  con->dd_printf("Coverage is empty, use \"coverage start\" first\n");
+  return(true);
+}
+
+/* Flags of an address of the rom, 0 outside of it */
+
+static int
+cov_flags(class cl_uc *uc, t_addr addr)
+{
+  t_addr a= addr - uc->rom->start_address;
+
+  if ((a < 0) ||
+      (a >= uc->rom->get_size()))
+    return(0);
+  return(uc->cov_map[a]);
+}
+
+/* Length of the instruction, taken from the map if it was executed */
+
+static int
+cov_length(class cl_uc *uc, t_addr addr)
+{
+  int c= cov_flags(uc, addr), l;
+
+  if (c & COV_EXEC)
+    l= c >> COV_LSHIFT;
+  else
+    l= uc->inst_length(addr);
+  return((l > 0)?l:1);
+}
+
+
+/*
+ * Command: coverage start
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_coverage_start_cmd)
+{
+  uc->cov_start();
+  if (!uc->covering)
+    con->dd_printf("Error: coverage can not be started\n");
+  return(false);
+}
+
+CMDHELP(cl_coverage_start_cmd,
+	"coverage start",
+	"Start marking executed instructions",
+	"long help of coverage start")
+
+
+/*
+ * Command: coverage stop
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_coverage_stop_cmd)
+{
+  uc->covering= false;
+  return(false);
+}
+
+CMDHELP(cl_coverage_stop_cmd,
+	"coverage stop",
+	"Stop marking, keep the coverage map",
+	"long help of coverage stop")
+
+
+/*
+ * Command: coverage clear
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_coverage_clear_cmd)
+{
+  uc->cov_clear();
+  return(false);
+}
+
+CMDHELP(cl_coverage_clear_cmd,
+	"coverage clear",
+	"Clear the coverage map",
+	"long help of coverage clear")
+
+
+/*
+ * Source lines of the cdb file
+ *----------------------------------------------------------------------------
+ */
+
+/* Records of function ends (line 0) limit the code of the last line of
+   the function, they are sorted by the address following the function.
+   Records of the same address are sorted by line */
+
+static t_addr
+line_bound(class cl_cdb_line *l)
+{
+  return(l->line?(l->addr):(l->end));
+}
+
+static int
+cmp_bound(const void *a, const void *b)
+{
+  t_addr ka= line_bound(*(class cl_cdb_line * const *)a);
+  t_addr kb= line_bound(*(class cl_cdb_line * const *)b);
+  if (ka != kb)
+    return((ka < kb)?-1:1);
+  long la= (*(class cl_cdb_line * const *)a)->line;
+  long lb= (*(class cl_cdb_line * const *)b)->line;
+  if (la != lb)
+    return((la < lb)?-1:1);
+  return(0);
+}
+
+static int
+cmp_source(const void *a, const void *b)
+{
+  class cl_cdb_line *la= *(class cl_cdb_line * const *)a;
+  class cl_cdb_line *lb= *(class cl_cdb_line * const *)b;
+  int r= strcmp((char*)(la->file), (char*)(lb->file));
+  if (r)
+    return(r);
+  if (la->line != lb->line)
+    return((la->line < lb->line)?-1:1);
+  if (la->addr != lb->addr)
+    return((la->addr < lb->addr)?-1:1);
+  return(0);
+}
+
+/* Code of a line extends to the next line or function end record, the
+   last one gets a single instruction. If more lines start at the same
+   address (opening brace of a function and its first statement), the
+   code belongs to the last one, others get an empty range. Returns array
+   of the records sorted by file, line and address */
+
+static class cl_cdb_line **
+source_lines(class cl_uc *uc, t_index *cnt)
+{
+  class cl_list *lines= uc->cdb_lines;
+  class cl_cdb_line **ls;
+  t_index i, j, n= lines->count;
+
+  ls= (class cl_cdb_line **)malloc((n+1) * sizeof(class cl_cdb_line *));
+  for (i= 0; i < n; i++)
+    {
+      ls[i]= (class cl_cdb_line *)(lines->at(i));
+      if (!ls[i]->line)
+	ls[i]->end= ls[i]->addr + cov_length(uc, ls[i]->addr);
+    }
+  qsort(ls, n, sizeof(class cl_cdb_line *), cmp_bound);
+  for (i= 0; i < n; i++)
+    {
+      class cl_cdb_line *l= ls[i];
+      if (!l->line)
+	continue;
+      if ((i+1 < n) &&
+	  ls[i+1]->line &&
+	  (ls[i+1]->addr == l->addr))
+	{
+	  l->end= l->addr;
+	  continue;
+	}
+      for (j= i+1; (j < n) && (line_bound(ls[j]) <= l->addr); j++)
+	;
+      l->end= (j < n)?line_bound(ls[j]):(l->addr + cov_length(uc, l->addr));
+    }
+  qsort(ls, n, sizeof(class cl_cdb_line *), cmp_source);
+  // function end records have empty file name, they are at the start
+  for (i= 0; (i < n) && !ls[i]->line; i++)
+    ;
+  *cnt= n - i;
+  memmove(ls, &ls[i], (n - i) * sizeof(class cl_cdb_line *));
+  return(ls);
+}
+
+static bool
+line_hit(class cl_uc *uc, class cl_cdb_line *l)
+{
+  t_addr a;
+
+  if (l->end == l->addr)
+    return((cov_flags(uc, l->addr) & COV_EXEC) != 0);
+  for (a= l->addr; a < l->end; a++)
+    if (cov_flags(uc, a) & COV_EXEC)
+      return(true);
+  return(false);
+}
+
+
+/*
+ * Command: coverage info
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_coverage_info_cmd)
+{
+  t_addr a, s;
+  long insts= 0, brs= 0, both= 0;
+
+  if (no_coverage(uc, con))
+    return(false);
+  s= uc->rom->get_size();
+  for (a= 0; a < s; a++)
+    {
+      int c= uc->cov_map[a];
+      if (!(c & COV_EXEC))
+	continue;
+      insts++;
+      if (uc->is_cond_branch(uc->rom->start_address + a))
+	{
+	  brs++;
+	  if ((c & (COV_NEXT|COV_JUMP)) == (COV_NEXT|COV_JUMP))
+	    both++;
+	}
+    }
+  con->dd_printf("%ld instructions executed\n", insts);
+  con->dd_printf("%ld conditional branches executed, %ld of them both ways\n",
+		 brs, both);
+  if (uc->cdb_lines->count)
+    {
+      t_index i, n;
+      long hit= 0, lines= 0;
+      class cl_cdb_line **ls= source_lines(uc, &n);
+      for (i= 0; i < n; i++)
+	{
+	  bool h= line_hit(uc, ls[i]);
+	  // a line can have several pieces of code
+	  while ((i+1 < n) &&
+		 (ls[i+1]->line == ls[i]->line) &&
+		 (ls[i+1]->file == ls[i]->file))
+	    h= line_hit(uc, ls[++i]) || h;
+	  lines++;
+	  if (h)
+	    hit++;
+	}
+      free(ls);
+      con->dd_printf("%ld of %ld source lines executed\n", hit, lines);
+    }
+  return(false);
+}
+
+CMDHELP(cl_coverage_info_cmd,
+	"coverage [info]",
+	"Number of executed instructions, branches and source lines",
+	"long help of coverage info")
+
+
+/*
+ * Command: coverage lcov
+ *----------------------------------------------------------------------------
+ */
+
+static void
+out(class cl_f *fout, class cl_console_base *con, chars &o)
+{
+  if (fout)
+    fout->write_str((char*)o);
+  else
+    con->dd_printf("%s", (char*)o);
+}
+
+/* Name of static functions is prefixed by module in the cdb file */
+
+static char *
+func_name(class cl_cdb_rec *f)
+{
+  char *n= (char*)(f->fname);
+  char *p= strchr(n, '$');
+  return(p?(p+1):n);
+}
+
+COMMAND_DO_WORK_UC(cl_coverage_lcov_cmd)
+{
+  class cl_cmd_arg *params[2]= { cmdline->param(0),
+				 cmdline->param(1) };
+  char *outname= NULL, *test= NULL;
+  class cl_f *fout= NULL;
+  class cl_cdb_line **ls, **fl;
+  t_index i, j, k, n;
+  chars o;
+
+  if (cmdline->syntax_match(uc, STRING STRING))
+    {
+      outname= params[0]->value.string.string;
+      test= params[1]->value.string.string;
+    }
+  else if (cmdline->syntax_match(uc, STRING))
+    outname= params[0]->value.string.string;
+  else if (params[0] != NULL)
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if (no_coverage(uc, con))
+    return(false);
+  if (!uc->cdb_lines->count)
+    {
+      con->dd_printf("Error: no source lines, load a cdb file made with --debug\n");
+      return(false);
+    }
+  if (outname &&
+      ((fout= mk_io(outname, "w")) == NULL))
+    {
+      con->dd_printf("Error: can not open %s\n", outname);
+      return(false);
+    }
+
+  ls= source_lines(uc, &n);
+  // first line record of every function, by start address
+  fl= (class cl_cdb_line **)calloc(uc->cdb_funcs->count+1,
+				   sizeof(class cl_cdb_line *));
+  for (j= 0; j < uc->cdb_funcs->count; j++)
+    {
+      class cl_cdb_rec *f= (class cl_cdb_rec *)(uc->cdb_funcs->at(j));
+      for (i= 0; i < n; i++)
+	if ((ls[i]->addr == f->addr) &&
+	    (!fl[j] || (ls[i]->line < fl[j]->line)))
+	  fl[j]= ls[i];
+    }
+
+  for (i= 0; i < n; i= k)
+    {
+      chars file= ls[i]->file;
+      long lf= 0, lh= 0, brf= 0, brh= 0, fnf= 0, fnh= 0;
+
+      for (k= i; (k < n) && (ls[k]->file == file); k++)
+	;
+      o.format("TN:%s\nSF:%s\n", test?test:"", (char*)file);
+      out(fout, con, o);
+      for (j= 0; j < uc->cdb_funcs->count; j++)
+	{
+	  class cl_cdb_rec *f= (class cl_cdb_rec *)(uc->cdb_funcs->at(j));
+	  if (!fl[j] ||
+	      !(fl[j]->file == file))
+	    continue;
+	  bool h= (cov_flags(uc, f->addr) & COV_EXEC) != 0;
+	  o.format("FN:%ld,%s\nFNDA:%d,%s\n", fl[j]->line, func_name(f),
+		   h?1:0, func_name(f));
+	  out(fout, con, o);
+	  fnf++;
+	  if (h)
+	    fnh++;
+	}
+      o.format("FNF:%ld\nFNH:%ld\n", fnf, fnh);
+      out(fout, con, o);
+
+      t_index l, m;
+      for (l= i; l < k; l= m)
+	{
+	  long line= ls[l]->line;
+	  bool h= false;
+	  int block= 0;
+	  for (m= l; (m < k) && (ls[m]->line == line); m++)
+	    h= line_hit(uc, ls[m]) || h;
+	  o.format("DA:%ld,%d\n", line, h?1:0);
+	  out(fout, con, o);
+	  lf++;
+	  if (h)
+	    lh++;
+	  // branch 0 is the jump, branch 1 is the fall through
+	  for (t_index p= l; p < m; p++)
+	    {
+	      t_addr a;
+	      for (a= ls[p]->addr; a < ls[p]->end; a+= cov_length(uc, a))
+		{
+		  if (!uc->is_cond_branch(a))
+		    continue;
+		  int c= cov_flags(uc, a);
+		  if (c & COV_EXEC)
+		    o.format("BRDA:%ld,%d,0,%d\nBRDA:%ld,%d,1,%d\n",
+			     line, block, (c & COV_JUMP)?1:0,
+			     line, block, (c & COV_NEXT)?1:0);
+		  else
+		    o.format("BRDA:%ld,%d,0,-\nBRDA:%ld,%d,1,-\n",
+			     line, block, line, block);
+		  out(fout, con, o);
+		  brf+= 2;
+		  brh+= ((c & COV_JUMP)?1:0) + ((c & COV_NEXT)?1:0);
+		  block++;
+		}
+	    }
+	}
+      o.format("BRF:%ld\nBRH:%ld\nLF:%ld\nLH:%ld\nend_of_record\n",
+	       brf, brh, lf, lh);
+      out(fout, con, o);
+    }
+  free(fl);
+  free(ls);
+  if (fout)
+    delete fout;
+  return(false);
+}
+
+CMDHELP(cl_coverage_lcov_cmd,
+	"coverage lcov [\"outfile\" [\"testname\"]]",
+	"Write coverage of source lines and branches in lcov tracefile format",
+	"long help of coverage lcov")
+
+
+/* End of cmd.src/cmd_cov.cc */
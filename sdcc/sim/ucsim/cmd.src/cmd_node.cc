@@ -0,0 +1,213 @@
+/*
+ * Simulator of microcontrollers (cmd.src/cmd_node.cc)
+ *
+ */
+
+/* This file is part of microcontroller simulator: ucsim.
+
+UCSIM is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+UCSIM is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UCSIM; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+02111-1307, USA. */
+/*@1@*/
+
+#include "ddconfig.h"
+
+#include <stdio.h>
+
+// prj
+#include "utils.h"
+
+// sim
+#include "simcl.h"
+#include "serial_hwcl.h"
+
+// local
+#include "cmd_nodecl.h"
+
+
+void
+set_node_help(class cl_cmd *cmd)
+{
+  cmd->set_help("node subcommand",
+		"Manage controllers simulated together",
+		"Long of node");
+}
+
+static class cl_uc *
+get_node(class cl_sim *sim, class cl_cmd_arg *param,
+	 class cl_console_base *con)
+{
+  long nr= param->value.number;
+
+  if ((nr < 0) ||
+      (nr >= sim->nodes->count))
+    {
+      con->dd_printf("Error: No node %ld\n", nr);
+      return(NULL);
+    }
+  return((class cl_uc *)(sim->nodes->at(nr)));
+}
+
+
+/*
+ * Command: node list
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_SIM(cl_node_list_cmd)
+{
+  int i;
+
+  for (i= 0; i < sim->nodes->count; i++)
+    {
+      class cl_uc *n= (class cl_uc *)(sim->nodes->at(i));
+      con->dd_printf("%c%2d %-10s PC= 0x%06x %18.15f sec\n",
+		     (n == sim->uc)?'*':' ', i,
+		     n->type?n->type->type_str:"?", AU(n->PC),
+		     n->get_rtime());
+    }
+  con->dd_printf("Quantum= %.15f sec\n", sim->quantum);
+  return(false);
+}
+
+CMDHELP(cl_node_list_cmd,
+	"node list",
+	"List of controllers, * marks the selected one",
+	"long help of node list")
+
+
+/*
+ * Command: node add
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_SIM(cl_node_add_cmd)
+{
+  class cl_cmd_arg *param= cmdline->param(0);
+  const char *type= NULL;
+  class cl_uc *n;
+
+  if (param)
+    type= param->s_value;
+  if ((n= sim->add_node(type)) == NULL)
+    {
+      con->dd_printf("Error: Controller could not be made\n");
+      return(false);
+    }
+  con->dd_printf("Node %d: %s\n", sim->node_nr(n),
+		 n->type?n->type->type_str:"?");
+  return(false);
+}
+
+CMDHELP(cl_node_add_cmd,
+	"node add [type]",
+	"Add a controller, of the type of the first one by default",
+	"long help of node add")
+
+
+/*
+ * Command: node select
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_SIM(cl_node_select_cmd)
+{
+  class cl_cmd_arg *params[1]= { cmdline->param(0) };
+  class cl_uc *n;
+
+  if (!cmdline->syntax_match(0, NUMBER))
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if ((n= get_node(sim, params[0], con)) != NULL)
+    sim->select_node(n);
+  return(false);
+}
+
+CMDHELP(cl_node_select_cmd,
+	"node select nr",
+	"Select the controller which other commands work on",
+	"long help of node select")
+
+
+/*
+ * Command: node link
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_SIM(cl_node_link_cmd)
+{
+  class cl_cmd_arg *params[4]= { cmdline->param(0),
+				 cmdline->param(1),
+				 cmdline->param(2),
+				 cmdline->param(3) };
+  class cl_uc *n1, *n2;
+  class cl_hw *h1, *h2;
+
+  if (!cmdline->syntax_match(0, NUMBER NUMBER NUMBER NUMBER))
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if ((n1= get_node(sim, params[0], con)) == NULL ||
+      (n2= get_node(sim, params[2], con)) == NULL)
+    return(false);
+  h1= n1->get_hw(HW_UART, params[1]->value.number, NULL);
+  h2= n2->get_hw(HW_UART, params[3]->value.number, NULL);
+  if (!h1 || !h2 || (h1 == h2))
+    {
+      con->dd_printf("Error: No such UARTs\n");
+      return(false);
+    }
+  ((class cl_serial_hw *)h1)->link((class cl_serial_hw *)h2);
+  return(false);
+}
+
+CMDHELP(cl_node_link_cmd,
+	"node link nr1 uart1 nr2 uart2",
+	"Connect two UARTs of controllers to each other",
+	"long help of node link")
+
+
+/*
+ * Command: node quantum
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_SIM(cl_node_quantum_cmd)
+{
+  if (cmdline->tokens->count < 1)
+    {
+      syntax_error(con);
+      return(false);
+    }
+  double q= strtod_unscaled((char *)(cmdline->tokens->at(0)));
+  if (q < 0)
+    {
+      con->dd_printf("Error: Quantum must not be negative\n");
+      return(false);
+    }
+  sim->quantum= q;
+  sim->sync_at= 0;
+  return(false);
+}
+
+CMDHELP(cl_node_quantum_cmd,
+	"node quantum time",
+	"Simulated time the controllers may run ahead of each other",
+	"long help of node quantum")
+
+
+/* End of cmd.src/cmd_node.cc */
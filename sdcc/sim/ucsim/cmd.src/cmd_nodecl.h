@@ -0,0 +1,42 @@
+/*
+ * Simulator of microcontrollers (cmd.src/cmd_nodecl.h)
+ *
+ */
+
+/* This file is part of microcontroller simulator: ucsim.
+
+UCSIM is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+UCSIM is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UCSIM; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+02111-1307, USA. */
+/*@1@*/
+
+#ifndef CMD_CMD_NODECL_HEADER
+#define CMD_CMD_NODECL_HEADER
+
+#include "newcmdcl.h"
+
+
+extern void set_node_help(class cl_cmd *cmd);
+
+// Controllers simulated together
+COMMAND_ON(sim,cl_node_list_cmd);
+COMMAND_ON(sim,cl_node_add_cmd);
+COMMAND_ON(sim,cl_node_select_cmd);
+COMMAND_ON(sim,cl_node_link_cmd);
+COMMAND_ON(sim,cl_node_quantum_cmd);
+
+
+#endif
+
+/* End of cmd.src/cmd_nodecl.h */
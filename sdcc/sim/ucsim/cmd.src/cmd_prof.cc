@@ -0,0 +1,479 @@
+/*
+ * Simulator of microcontrollers (cmd.src/cmd_prof.cc)
+ *
+ */
+
+/* This file is part of microcontroller simulator: ucsim.
+
+UCSIM is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+UCSIM is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with UCSIM; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+02111-1307, USA. */
+/*@1@*/
+
+#include "ddconfig.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// prj
+#include "utils.h"
+#include "fiocl.h"
+
+// sim
+#include "simcl.h"
+
+// local
+#include "cmd_profcl.h"
+
+
+void
+set_profile_help(class cl_cmd *cmd)
+{
+  cmd->set_help("profile subcommand",
+		"Executions and cycles by instruction address",
+		"Long of profile");
+}
+
+static bool
+no_profile(class cl_uc *uc, class cl_console_base *con)
+{
+  if (uc->prof_execs)
+    return(false);
+  con->dd_printf("Profile is empty, use \"profile start\" first\n");
+  return(true);
+}
+
+static unsigned long
+profile_total(class cl_uc *uc)
+{
+  unsigned long t= 0;
+  t_addr i, s= uc->rom->get_size();
+
+  for (i= 0; i < s; i++)
+    t+= uc->prof_cycles[i];
+  return(t);
+}
+
+static double
+percent(unsigned long v, unsigned long total)
+{
+  return(total?(double(v)*100.0/double(total)):0.0);
+}
+
+/* Listing (.rst, .lst) lines of code start with the address, followed by
+   a single space and the first byte of the code */
+
+static bool
+listing_code(char *l, t_addr *addr)
+{
+  char *p= l, *e;
+
+  while (*p == ' ')
+    p++;
+  t_addr a= strtoll(p, &e, 16);
+  if ((e - p < 4) ||
+      (e[0] != ' ') ||
+      !isxdigit(e[1]) ||
+      !isxdigit(e[2]) ||
+      ((e[3] != ' ') && (e[3] != '\0')))
+    return(false);
+  *addr= a;
+  return(true);
+}
+
+static bool
+listing_addr(class cl_uc *uc, char *l, t_addr *a)
+{
+  t_addr addr;
+
+  if (!listing_code(l, &addr))
+    return(false);
+  addr-= uc->rom->start_address;
+  if ((addr < 0) ||
+      (addr >= uc->rom->get_size()))
+    return(false);
+  *a= addr;
+  return(true);
+}
+
+
+/*
+ * Command: profile start
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_profile_start_cmd)
+{
+  uc->prof_start();
+  if (!uc->profiling)
+    con->dd_printf("Error: profile can not be started\n");
+  return(false);
+}
+
+CMDHELP(cl_profile_start_cmd,
+	"profile start",
+	"Start counting executions and cycles of instructions",
+	"long help of profile start")
+
+
+/*
+ * Command: profile stop
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_profile_stop_cmd)
+{
+  uc->profiling= false;
+  return(false);
+}
+
+CMDHELP(cl_profile_stop_cmd,
+	"profile stop",
+	"Stop counting, keep the profile",
+	"long help of profile stop")
+
+
+/*
+ * Command: profile clear
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_profile_clear_cmd)
+{
+  uc->prof_clear();
+  return(false);
+}
+
+CMDHELP(cl_profile_clear_cmd,
+	"profile clear",
+	"Clear all counters of the profile",
+	"long help of profile clear")
+
+
+/*
+ * Command: profile list
+ *----------------------------------------------------------------------------
+ */
+
+static unsigned long *sort_by;
+
+static int
+cmp_cost(const void *a, const void *b)
+{
+  unsigned long ca= sort_by[*(const t_addr *)a];
+  unsigned long cb= sort_by[*(const t_addr *)b];
+  if (ca != cb)
+    return((ca < cb)?1:-1);
+  return((*(const t_addr *)a < *(const t_addr *)b)?-1:1);
+}
+
+COMMAND_DO_WORK_UC(cl_profile_list_cmd)
+{
+  class cl_cmd_arg *params[2]= { cmdline->param(0),
+				 cmdline->param(1) };
+  long n= 20;
+  const char *key= "cycles";
+  t_addr i, cnt= 0, s;
+  t_addr *addrs;
+  unsigned long total;
+
+  if (cmdline->syntax_match(uc, NUMBER STRING))
+    {
+      n= params[0]->value.number;
+      key= params[1]->value.string.string;
+    }
+  else if (cmdline->syntax_match(uc, NUMBER))
+    n= params[0]->value.number;
+  else if (cmdline->syntax_match(uc, STRING))
+    key= params[0]->value.string.string;
+  else if (params[0] != NULL)
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if (no_profile(uc, con))
+    return(false);
+  if (strcmp(key, "execs") == 0)
+    sort_by= uc->prof_execs;
+  else if (strcmp(key, "cycles") == 0)
+    sort_by= uc->prof_cycles;
+  else
+    {
+      con->dd_printf("Error: sort by \"cycles\" or \"execs\"\n");
+      return(false);
+    }
+
+  s= uc->rom->get_size();
+  addrs= (t_addr *)malloc(s * sizeof(t_addr));
+  for (i= 0; i < s; i++)
+    if (uc->prof_execs[i])
+      addrs[cnt++]= i;
+  qsort(addrs, cnt, sizeof(t_addr), cmp_cost);
+
+  total= profile_total(uc);
+  con->dd_printf("%10s %12s %7s\n", "execs", "cycles", "%");
+  for (i= 0; (i < cnt) && (n <= 0 || i < n); i++)
+    {
+      t_addr a= addrs[i];
+      con->dd_printf("%10lu %12lu %6.2f%%",
+		     uc->prof_execs[a], uc->prof_cycles[a],
+		     percent(uc->prof_cycles[a], total));
+      uc->print_disass(uc->rom->start_address + a, con);
+    }
+  con->dd_printf("%lu cycles in %ld instruction addresses\n",
+		 total, (long)cnt);
+  free(addrs);
+  return(false);
+}
+
+CMDHELP(cl_profile_list_cmd,
+	"profile [list [n] [cycles|execs]]",
+	"List the n (default 20, 0 for all) most costly instructions",
+	"long help of profile list")
+
+
+/*
+ * Command: profile annotate
+ *----------------------------------------------------------------------------
+ */
+
+COMMAND_DO_WORK_UC(cl_profile_annotate_cmd)
+{
+  class cl_cmd_arg *params[2]= { cmdline->param(0),
+				 cmdline->param(1) };
+  char *in, *out= NULL;
+  class cl_f *fin, *fout= NULL;
+  unsigned long total;
+  chars ln, o;
+
+  if (cmdline->syntax_match(uc, STRING STRING))
+    {
+      in= params[0]->value.string.string;
+      out= params[1]->value.string.string;
+    }
+  else if (cmdline->syntax_match(uc, STRING))
+    in= params[0]->value.string.string;
+  else
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if (no_profile(uc, con))
+    return(false);
+  if ((fin= mk_io(in, "r")) == NULL)
+    {
+      con->dd_printf("Error: can not open %s\n", in);
+      return(false);
+    }
+  if (out &&
+      ((fout= mk_io(out, "w")) == NULL))
+    {
+      con->dd_printf("Error: can not open %s\n", out);
+      delete fin;
+      return(false);
+    }
+
+  total= profile_total(uc);
+  ln= fin->get_s();
+  while (!ln.empty())
+    {
+      t_addr a;
+      if (listing_addr(uc, (char*)ln, &a) &&
+	  uc->prof_execs[a])
+	o.format("%10lu %12lu %6.2f%% |%s\n",
+		 uc->prof_execs[a], uc->prof_cycles[a],
+		 percent(uc->prof_cycles[a], total), (char*)ln);
+      else
+	o.format("%32s|%s\n", "", (char*)ln);
+      if (fout)
+	fout->write_str((char*)o);
+      else
+	con->dd_printf("%s", (char*)o);
+      ln= fin->get_s();
+    }
+  delete fin;
+  if (fout)
+    delete fout;
+  return(false);
+}
+
+CMDHELP(cl_profile_annotate_cmd,
+	"profile annotate \"listing\" [\"outfile\"]",
+	"Print a .rst or .lst listing with executions, cycles and percentage",
+	"long help of profile annotate")
+
+
+/*
+ * Command: profile tags
+ *----------------------------------------------------------------------------
+ */
+
+class cl_prof_tag: public cl_base
+{
+public:
+  chars tag;
+  unsigned long execs, cycles;
+  cl_prof_tag(chars t): cl_base() { tag= t; execs= cycles= 0; }
+};
+
+static int
+cmp_tag(const void *a, const void *b)
+{
+  class cl_prof_tag *ta= *(class cl_prof_tag * const *)a;
+  class cl_prof_tag *tb= *(class cl_prof_tag * const *)b;
+  if (ta->cycles != tb->cycles)
+    return((ta->cycles < tb->cycles)?1:-1);
+  return(strcmp((char*)(ta->tag), (char*)(tb->tag)));
+}
+
+/* Comments of the code generator ("; genPlus") and of peephole rules
+   ("; peephole 17 removed ...") are shortened to their first word(s),
+   so that all code of a kind is counted together */
+
+static chars
+comment_tag(char *c)
+{
+  chars t= "";
+  int words= 0, l, i;
+
+  while ((*c == ';') || isspace(*c))
+    c++;
+  if (strncmp(c, "gen", 3) == 0)
+    words= 1;
+  else if (strncmp(c, "peephole", 8) == 0)
+    words= 2;
+  for (l= 0; c[l]; l++)
+    if (isspace(c[l]) &&
+	words &&
+	(--words == 0))
+      break;
+  while (l &&
+	 isspace(c[l-1]))
+    l--;
+  for (i= 0; i < l; i++)
+    t+= c[i];
+  return(t);
+}
+
+COMMAND_DO_WORK_UC(cl_profile_tags_cmd)
+{
+  class cl_cmd_arg *params[3]= { cmdline->param(0),
+				 cmdline->param(1),
+				 cmdline->param(2) };
+  char *in, *prefix= NULL;
+  long n= 20;
+  class cl_f *fin;
+  class cl_list *tags;
+  class cl_prof_tag *tag, **sorted;
+  unsigned long total;
+  chars ln;
+  int i;
+
+  if (cmdline->syntax_match(uc, STRING STRING NUMBER))
+    {
+      in= params[0]->value.string.string;
+      prefix= params[1]->value.string.string;
+      n= params[2]->value.number;
+    }
+  else if (cmdline->syntax_match(uc, STRING NUMBER))
+    {
+      in= params[0]->value.string.string;
+      n= params[1]->value.number;
+    }
+  else if (cmdline->syntax_match(uc, STRING STRING))
+    {
+      in= params[0]->value.string.string;
+      prefix= params[1]->value.string.string;
+    }
+  else if (cmdline->syntax_match(uc, STRING))
+    in= params[0]->value.string.string;
+  else
+    {
+      syntax_error(con);
+      return(false);
+    }
+  if (no_profile(uc, con))
+    return(false);
+  if ((fin= mk_io(in, "r")) == NULL)
+    {
+      con->dd_printf("Error: can not open %s\n", in);
+      return(false);
+    }
+
+  tags= new cl_list(16, 16, "profile tags");
+  tags->add(tag= new cl_prof_tag("(none)"));
+  ln= fin->get_s();
+  while (!ln.empty())
+    {
+      t_addr a;
+      char *c;
+      if (listing_addr(uc, (char*)ln, &a))
+	{
+	  tag->execs+= uc->prof_execs[a];
+	  tag->cycles+= uc->prof_cycles[a];
+	}
+      else if ((c= strchr((char*)ln, ';')) != NULL)
+	{
+	  chars t= comment_tag(c);
+	  if (t.len() &&
+	      (!prefix ||
+	       t.starts_with(prefix)))
+	    {
+	      tag= NULL;
+	      for (i= 0; i < tags->count; i++)
+		{
+		  class cl_prof_tag *pt= (class cl_prof_tag *)(tags->at(i));
+		  if (pt->tag == t)
+		    {
+		      tag= pt;
+		      break;
+		    }
+		}
+	      if (tag == NULL)
+		tags->add(tag= new cl_prof_tag(t));
+	    }
+	}
+      ln= fin->get_s();
+    }
+  delete fin;
+
+  sorted= (class cl_prof_tag **)malloc(tags->count * sizeof(sorted[0]));
+  for (i= 0; i < tags->count; i++)
+    sorted[i]= (class cl_prof_tag *)(tags->at(i));
+  qsort(sorted, tags->count, sizeof(sorted[0]), cmp_tag);
+  total= profile_total(uc);
+  con->dd_printf("%10s %12s %7s\n", "execs", "cycles", "%");
+  for (i= 0; (i < tags->count) && (n <= 0 || i < n); i++)
+    {
+      tag= sorted[i];
+      if (!tag->execs)
+	break;
+      con->dd_printf("%10lu %12lu %6.2f%% %s\n", tag->execs, tag->cycles,
+		     percent(tag->cycles, total), (char*)(tag->tag));
+    }
+  free(sorted);
+  tags->free_all();
+  delete tags;
+  return(false);
+}
+
+CMDHELP(cl_profile_tags_cmd,
+	"profile tags \"listing\" [\"prefix\"] [n]",
+	"Cost of code after each kind of comment of a listing, e.g. \"gen\" or \"peephole\"",
+	"long help of profile tags")
+
+
+/* End of cmd.src/cmd_prof.cc */
@@ -345,6 +345,7 @@ COMMAND_DO_WORK_UC(cl_timer_run_cmd)
       return(0);
     }
   ticker->run = true;
+  uc->tickers_changed();
 
   if (id_str)
     free((char *)id_str);
@@ -381,6 +382,7 @@ COMMAND_DO_WORK_UC(cl_timer_stop_cmd)
       return(false);
     }
   ticker->run = false;
+  uc->tickers_changed();
 
   if (id_str)
     free((char *)id_str);
@@ -414,7 +416,7 @@ COMMAND_DO_WORK_UC(cl_timer_ticks_cmd)
 	con->dd_printf("Error: Timer %d does not exist\n", id_nr);
     }
   else if ((arg = (char *)cmdline->tokens->at(0)))
-    ticker->ticks= strtod_unscaled(arg);
+    ticker->set_ticks(strtod_unscaled(arg));
   else
     con->dd_printf("Error: Value is missing\n");
 
@@ -450,7 +452,7 @@ COMMAND_DO_WORK_UC(cl_timer_time_cmd)
 	con->dd_printf("Error: Timer %d does not exist\n", id_nr);
     }
   else if ((arg = (char *)cmdline->tokens->at(0)))
-    ticker->ticks= strtod_unscaled(arg) * ticker->freq;
+    ticker->set_ticks(strtod_unscaled(arg) * ticker->freq);
   else
     con->dd_printf("Error: Value is missing\n");
 
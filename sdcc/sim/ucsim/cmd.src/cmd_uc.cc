@@ -61,19 +61,19 @@ COMMAND_DO_WORK_UC(cl_state_cmd)
   con->dd_printf("Read= %lu ", (unsigned long)(uc->vc.rd));
   con->dd_printf("Write= %lu\n", (unsigned long)(uc->vc.wr));
   con->dd_printf("Total time since last reset= %g sec (%lu clks)\n",
-		 uc->get_rtime(), (unsigned long)(uc->ticks->ticks));
+		 uc->get_rtime(), (unsigned long)(uc->ticks->get_ticks()));
   con->dd_printf("Time in isr = %g sec (%lu clks) %3.2g%%\n",
 		 uc->isr_ticks->get_rtime(),
-		 uc->isr_ticks->ticks,
-		 (uc->ticks->ticks == 0)?0.0:
-		 (100.0*((double)(uc->isr_ticks->ticks)/
-			 (double)(uc->ticks->ticks))));
+		 uc->isr_ticks->get_ticks(),
+		 (uc->ticks->get_ticks() == 0)?0.0:
+		 (100.0*((double)(uc->isr_ticks->get_ticks())/
+			 (double)(uc->ticks->get_ticks()))));
   con->dd_printf("Time in idle= %g sec (%lu clks) %3.2g%%\n",
 		 uc->idle_ticks->get_rtime(),
-		 uc->idle_ticks->ticks,
-		 (uc->ticks->ticks == 0)?0.0:
-		 (100.0*((double)(uc->idle_ticks->ticks)/
-			 (double)(uc->ticks->ticks))));
+		 uc->idle_ticks->get_ticks(),
+		 (uc->ticks->get_ticks() == 0)?0.0:
+		 (100.0*((double)(uc->idle_ticks->get_ticks())/
+			 (double)(uc->ticks->get_ticks()))));
   con->dd_printf("Max value of stack pointer= 0x%06x, avg= 0x%06x\n",
 		 AU(uc->sp_max), AU(uc->sp_avg));
   con->dd_printf("Simulation: %s\n",
@@ -2,29 +2,7 @@
 #include <stdio.h>
 
 
-enum sif_command {
-  DETECT_SIGN	        = '!',	// answer to detect command
-  SIFCM_DETECT		= '_',	// command used to detect the interface
-  SIFCM_COMMANDS	= 'i',	// get info about commands
-  SIFCM_IFVER		= 'v',	// interface version
-  SIFCM_SIMVER		= 'V',	// simulator version
-  SIFCM_IFRESET		= '@',	// reset the interface
-  SIFCM_CMDINFO		= 'I',	// info about a command
-  SIFCM_CMDHELP		= 'h',	// help about a command
-  SIFCM_STOP		= 's',	// stop simulation
-  SIFCM_PRINT		= 'p',	// print character
-  SIFCM_FIN_CHECK	= 'f',	// check input file for input
-  SIFCM_READ		= 'r',	// read from input file
-  SIFCM_WRITE		= 'w',	// write to output file
-};
-
-enum sif_answer_type {
-  SIFAT_UNKNOWN		= 0x00,	// we don't know...
-  SIFAT_BYTE		= 0x01,	// just a byte
-  SIFAT_ARRAY		= 0x02,	// array of some bytes
-  SIFAT_STRING		= 0x03,	// a string
-  SIFAT_NONE		= 0x04	// no answer at all
-};
+#include "simif.h"
 
 unsigned char
 _sdcc_external_startup (void)
@@ -53,8 +31,6 @@ putchar (int c)
 }
 
 #define SIF_ADDRESS_SPACE_NAME	"xram"
-#define SIF_ADDRESS_SPACE	__xdata
-#define SIF_ADDRESS		0xffff
 
 unsigned char SIF_ADDRESS_SPACE * volatile sif;
 
@@ -230,6 +206,19 @@ fin_demo()
   printf("\nRead demo finished\n");
 }
 
+__xdata char block[16];
+
+void
+block_demo()
+{
+  unsigned int i;
+  printf("Copying a block from SIMIF input to output file:\n");
+  i= sif_read_block(block, sizeof(block));
+  printf("  %u bytes read, ", i);
+  i= sif_write_block(block, i);
+  printf("%u bytes written\n", i);
+}
+
 void
 main(void)
 {
@@ -254,6 +243,7 @@ main(void)
 		"to simif output file.\n"
 		"\n"
 		"Done.\n");
+      block_demo();
       fin_demo();
     }
   else
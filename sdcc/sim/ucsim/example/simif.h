@@ -0,0 +1,83 @@
+/*
+ * Target side of the uCsim simulator interface
+ *
+ * The interface must be turned on in the simulator with
+ * -I if=memory[address] (xram[0xffff] is assumed by default). Define
+ * SIF_ADDRESS_SPACE and SIF_ADDRESS before including this file to use
+ * a different location. Block transfers work on the address space of
+ * the interface, so on the mcs51 the buffers must be in __xdata.
+ */
+
+#ifndef SIMIF_HEADER
+#define SIMIF_HEADER
+
+enum sif_command {
+  DETECT_SIGN	        = '!',	// answer to detect command
+  SIFCM_DETECT		= '_',	// command used to detect the interface
+  SIFCM_COMMANDS	= 'i',	// get info about commands
+  SIFCM_IFVER		= 'v',	// interface version
+  SIFCM_SIMVER		= 'V',	// simulator version
+  SIFCM_IFRESET		= '@',	// reset the interface
+  SIFCM_CMDINFO		= 'I',	// info about a command
+  SIFCM_CMDHELP		= 'h',	// help about a command
+  SIFCM_STOP		= 's',	// stop simulation
+  SIFCM_PRINT		= 'p',	// print character
+  SIFCM_FIN_CHECK	= 'f',	// check input file for input
+  SIFCM_READ		= 'r',	// read from input file
+  SIFCM_WRITE		= 'w',	// write to output file
+  SIFCM_WRITE_BLOCK	= 'W',	// write memory block to output file
+  SIFCM_READ_BLOCK	= 'F',	// fill memory block from input file
+};
+
+enum sif_answer_type {
+  SIFAT_UNKNOWN		= 0x00,	// we don't know...
+  SIFAT_BYTE		= 0x01,	// just a byte
+  SIFAT_ARRAY		= 0x02,	// array of some bytes
+  SIFAT_STRING		= 0x03,	// a string
+  SIFAT_NONE		= 0x04	// no answer at all
+};
+
+#ifndef SIF_ADDRESS_SPACE
+#if defined(__SDCC_mcs51) || defined(__SDCC_ds390)
+#define SIF_ADDRESS_SPACE	__xdata
+#else
+#define SIF_ADDRESS_SPACE
+#endif
+#endif
+
+#ifndef SIF_ADDRESS
+#define SIF_ADDRESS		0xffff
+#endif
+
+#define SIF	(*(volatile unsigned char SIF_ADDRESS_SPACE *)SIF_ADDRESS)
+
+static unsigned int
+sif_block(unsigned char cmd, unsigned long addr, unsigned int len)
+{
+  unsigned int done;
+  SIF= cmd;
+  SIF= addr;
+  SIF= addr >> 8;
+  SIF= addr >> 16;
+  SIF= addr >> 24;
+  SIF= len;
+  SIF= len >> 8;
+  (void)SIF;			// length of answer, always 2
+  done= SIF;
+  done|= SIF << 8;
+  return done;
+}
+
+/* Copy len bytes from buf to the output file of the interface (stdout
+   of the simulator if no file is set). Returns number of bytes copied. */
+#define sif_write_block(buf, len) \
+  sif_block(SIFCM_WRITE_BLOCK, (unsigned long)(unsigned char SIF_ADDRESS_SPACE *)(buf), (len))
+
+/* Fill at most len bytes of buf from the input file of the interface.
+   Returns number of bytes read, 0 at end of input. */
+#define sif_read_block(buf, len) \
+  sif_block(SIFCM_READ_BLOCK, (unsigned long)(unsigned char SIF_ADDRESS_SPACE *)(buf), (len))
+
+#endif
+
+/* End of simif.h */
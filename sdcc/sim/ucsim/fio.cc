@@ -1218,6 +1218,48 @@ cl_f::set_escape(bool val)
 }
 
 
+/* In-memory link */
+
+cl_link_f::cl_link_f(chars fn):
+  cl_f(fn, "")
+{
+  type= F_PIPE;
+  peer= NULL;
+}
+
+cl_link_f::~cl_link_f(void)
+{
+  if (peer)
+    peer->peer= NULL;
+}
+
+int
+cl_link_f::write(char *buf, int count)
+{
+  int i;
+
+  if (!peer)
+    return count;
+  // Characters which do not fit into the buffer of the reader are lost
+  for (i= 0; (i < count) && (peer->free_place() > 0); i++)
+    peer->put(buf[i]);
+  return i;
+}
+
+/* What is written into fout can be read from fin */
+
+void
+mk_link(chars name, class cl_f **fin, class cl_f **fout)
+{
+  class cl_link_f *i= new cl_link_f(name), *o= new cl_link_f(name);
+
+  i->peer= o;
+  o->peer= i;
+  *fin= i;
+  *fout= o;
+}
+
+
 chars
 fio_type_name(enum file_type t)
 {
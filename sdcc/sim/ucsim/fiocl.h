@@ -216,6 +216,22 @@ class cl_f: public cl_base
   //virtual int connect(chars host, int to_port);
 };
 
+
+/* In-memory link, what is written into one end can be read from the other */
+
+class cl_link_f: public cl_f
+{
+ public:
+  class cl_link_f *peer;
+ public:
+  cl_link_f(chars fn);
+  virtual ~cl_link_f(void);
+  virtual enum file_type determine_type(void) { return F_PIPE; }
+  virtual int check_dev(void) { return last_used != first_free; }
+  virtual int write(char *buf, int count);
+  virtual bool eof(void) { return false; }
+};
+
 //extern void deb(const char *format, ...);
 
 extern int mk_srv_socket(int port);
@@ -223,6 +239,7 @@ extern int mk_srv_socket(int port);
 extern class cl_f *mk_io(chars fn, chars mode);
 extern class cl_f *cp_io(/*FILE *f*/int file_id, chars mode);
 extern class cl_f *mk_srv(int server_port);
+extern void mk_link(chars name, class cl_f **fin, class cl_f **fout);
 extern int srv_accept(class cl_f *listen_io,
 		      class cl_f **fin, class cl_f **fout);
 
@@ -239,6 +239,24 @@ cl_hc08::is_call(t_addr addr)
   return e?(e->is_call):false;
 }
 
+/* All relative branches are of type 'R', except bra, brn and bsr they are
+   conditional */
+
+bool
+cl_hc08::is_cond_branch(t_addr addr)
+{
+  struct dis_entry *e;
+  int b;
+
+  get_disasm_info(addr, NULL, &b, NULL, &e);
+  if (!e ||
+      (b != 'R'))
+    return false;
+  return((strncmp(e->mnemonic, "bra ", 4) != 0) &&
+	 (strncmp(e->mnemonic, "brn ", 4) != 0) &&
+	 (strncmp(e->mnemonic, "bsr ", 4) != 0));
+}
+
 int
 cl_hc08::longest_inst(void)
 {
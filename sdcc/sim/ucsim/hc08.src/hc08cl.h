@@ -68,6 +68,7 @@ public:
 				       int *immed_offset,
 				       struct dis_entry **dentry);
   virtual bool is_call(t_addr addr);
+  virtual bool is_cond_branch(t_addr addr);
   virtual t_mem get_1(t_addr addr);
   virtual t_mem get_2(t_addr addr);
   
@@ -224,6 +224,19 @@ bool cl_pdk::is_call(t_addr addr) {
   return e ? (e->is_call) : false;
 }
 
+// Compare and skip instructions (ceqsn, t0sn, dzsn, ...) are the only
+// conditionals, skipping counts as the jump.
+bool cl_pdk::is_cond_branch(t_addr addr) {
+  struct dis_entry *e;
+
+  get_disasm_info(addr, NULL, NULL, NULL, &e);
+  if (!e)
+    return false;
+  const char *s = strchr(e->mnemonic, ' ');
+  int l = s ? (s - e->mnemonic) : strlen(e->mnemonic);
+  return (l > 2) && (strncmp(e->mnemonic + l - 2, "sn", 2) == 0);
+}
+
 int cl_pdk::longest_inst(void) { return 1; }
 
 const char *cl_pdk::get_disasm_info(t_addr addr, int *ret_len, int *ret_branch,
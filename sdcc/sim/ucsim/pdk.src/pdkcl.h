@@ -70,6 +70,7 @@ public:
                                       int *immed_offset,
                                       struct dis_entry **dentry);
   virtual bool is_call(t_addr addr);
+  virtual bool is_cond_branch(t_addr addr);
 
   virtual void reset(void);
 
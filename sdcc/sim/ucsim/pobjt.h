@@ -35,7 +35,7 @@ typedef int	t_index;
 typedef int	(*match_func)(void *, void *);
 typedef void	(*iterator_func)(void *, void *);
 
-#define max_list_size (0x10000/sizeof(void *))
+#define max_list_size (0x7fffffff/sizeof(void *))
 #define ccNotFound -1
 
 
@@ -1152,6 +1152,17 @@ cl_51core::dis_tbl(void)
   return(disass_51);
 }
 
+/* Branch types 'r' and 'R' are the conditional jumps (JC, JZ, JB, CJNE,
+   DJNZ, ...) */
+
+bool
+cl_51core::is_cond_branch(t_addr addr)
+{
+  int b= inst_branch(addr);
+
+  return((b == 'r') || (b == 'R'));
+}
+
 struct name_entry *
 cl_51core::bit_tbl(void)
 {
@@ -1692,9 +1703,12 @@ cl_51core::do_inst(int step)
 	step--;
       if (state == stGO)
 	{
+	  t_addr PCsave= PC;
 	  interrupt->was_reti= false;
 	  pre_inst();
 	  result= exec_inst();
+	  if (profiling || covering)
+	    measure_inst(PCsave, result);
 	  post_inst();
 	}
       else
@@ -1775,7 +1789,7 @@ cl_51core::do_interrupt(void)
 	  is->clear();
 	  sim->app->get_commander()->
 	    debug("%g sec (%d clks): Accepting interrupt `%s' PC= 0x%06x\n",
-			  get_rtime(), ticks->ticks, object_name(is), PC);
+			  get_rtime(), ticks->get_ticks(), object_name(is), PC);
 	  IL= new it_level(pr, is->addr, PC, is);
 	  return(accept_it(IL));
 	}
@@ -1837,7 +1851,7 @@ cl_51core::idle_pd(void)
       if (state != stIDLE)
 	sim->app->get_commander()->
 	  debug("%g sec (%d clks): CPU in Idle mode (PC=0x%x, PCON=0x%x)\n",
-		get_rtime(), ticks->ticks, PC, pcon);
+		get_rtime(), ticks->get_ticks(), PC, pcon);
       state= stIDLE;
       //was_reti= 1;
     }
@@ -1846,7 +1860,7 @@ cl_51core::idle_pd(void)
       if (state != stPD)
 	sim->app->get_commander()->
 	  debug("%g sec (%d clks): CPU in PowerDown mode\n",
-			get_rtime(), ticks->ticks);
+			get_rtime(), ticks->get_ticks());
       state= stPD;
     }
   return(resGO);
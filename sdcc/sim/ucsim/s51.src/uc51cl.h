@@ -109,6 +109,7 @@ public:
   
   virtual int clock_per_cycle(void) { return(12); }
   virtual struct dis_entry *dis_tbl(void);
+  virtual bool is_cond_branch(t_addr addr);
   virtual struct name_entry *bit_tbl(void);
   virtual void disass(class cl_console_base *con, t_addr addr, const char *sep);
   virtual void print_regs(class cl_console_base *con);
@@ -83,8 +83,12 @@ cl_serial_hw::init(void)
   class cl_option *o= serial_port_option->use(s);
   free(s);
 
+  // Options of the command line are for the first controller only, further
+  // ones can be linked to each other (see cl_serial_hw::link())
+  bool use_options= uc->sim->node_nr(uc) <= 0;
+
   int port= -1;
-  if (o)
+  if (o && use_options)
     {
       port= serial_port_option->get_value((long)0);
       if (port < 0)
@@ -106,7 +110,7 @@ cl_serial_hw::init(void)
   free(s);
 
   port= -1;
-  if (o)
+  if (o && use_options)
     {
       port= serial_iport_option->get_value((long)0);
       if (port < 0)
@@ -128,7 +132,7 @@ cl_serial_hw::init(void)
   free(s);
 
   port= -1;
-  if (o)
+  if (o && use_options)
     {
       port= serial_oport_option->get_value((long)0);
       if (port < 0)
@@ -142,8 +146,8 @@ cl_serial_hw::init(void)
       c->add_console(listener);
     }
 
-  char *f_serial_in = (char*)serial_in_file_option->get_value((char*)0);
-  char *f_serial_out= (char*)serial_out_file_option->get_value((char*)0);
+  char *f_serial_in = use_options?(char*)serial_in_file_option->get_value((char*)0):NULL;
+  char *f_serial_out= use_options?(char*)serial_out_file_option->get_value((char*)0):NULL;
   class cl_f *fi, *fo;
   if (f_serial_in)
     {
@@ -297,6 +301,29 @@ cl_serial_hw::new_io(class cl_f *f_in, class cl_f *f_out)
   menu= 0;
 }
 
+/* Connect the output of this interface to the input of the other one and
+   vice versa. The simulator checks the input at every cycle because a link
+   is not a device which could be watched by the commander. */
+
+void
+cl_serial_hw::link(class cl_serial_hw *other)
+{
+  class cl_f *i1, *o1, *i2, *o2;
+  chars n1("", "node%d.%s%d", uc->sim->node_nr(uc), id_string, id);
+  chars n2("", "node%d.%s%d", other->uc->sim->node_nr(other->uc),
+	   other->id_string, other->id);
+
+  make_io();
+  other->make_io();
+  mk_link(n2+'>'+n1, &i1, &o2);
+  mk_link(n1+'>'+n2, &i2, &o1);
+  io->replace_files(true, i1, o1);
+  other->io->replace_files(true, i2, o2);
+  cfg_set(serconf_check_often, true);
+  other->cfg_set(serconf_check_often, true);
+  input_avail= other->input_avail= false;
+}
+
 bool
 cl_serial_hw::proc_input(void)
 {
@@ -79,6 +79,7 @@ class cl_serial_hw: public cl_hw
 
   virtual void make_io(void);
   virtual void new_io(class cl_f *f_in, class cl_f *f_out);
+  virtual void link(class cl_serial_hw *other);
   virtual bool proc_input(void);
   virtual void refresh_display(bool force) {}
   virtual void draw_display(void) {}
@@ -39,6 +39,7 @@ Software Foundation, 59 Temple Place - Suite 330, Boston, MA
 // cmd
 #include "cmd_execcl.h"
 #include "cmd_guicl.h"
+#include "cmd_nodecl.h"
 
 // local, sim.src
 #include "simcl.h"
@@ -55,6 +56,10 @@ cl_sim::cl_sim(class cl_app *the_app):
 {
   app= the_app;
   uc= 0;
+  nodes= new cl_list(2, 2, "nodes");
+  quantum= 0;
+  sync_at= 0;
+  start_uc= 0;
   state= SIM_NONE;
   //arguments= new cl_list(2, 2);
   //accept_args= more_args?strdup(more_args):0;
@@ -68,6 +73,7 @@ cl_sim::init(void)
   build_cmdset(app->get_commander()->cmdset);
   if (!(uc= mk_controller()))
     return(1);
+  nodes->add(uc);
   uc->init();
   simif= uc->get_hw(cchars("simif"), 0);
   return(0);
@@ -75,8 +81,8 @@ cl_sim::init(void)
 
 cl_sim::~cl_sim(void)
 {
-  if (uc)
-    delete uc;
+  nodes->free_all();
+  delete nodes;
 }
 
 class cl_uc *
@@ -96,6 +102,13 @@ cl_sim::step(void)
 
       int reason = uc->do_inst(1);
 
+      if (nodes->count > 1)
+	{
+	  sync_nodes();
+	  if (!(state & SIM_GO))
+	    return(0);
+	}
+
       if (reason == resGO || reason == resNOT_DONE)
         {
           steps_done++;
@@ -106,6 +119,93 @@ cl_sim::step(void)
   return(0);
 }
 
+/* Further controller, of the type given or of the type of the first one
+   (see "cpu_type" option) */
+
+class cl_uc *
+cl_sim::add_node(const char *type)
+{
+  class cl_option *o= app->options->get_option("cpu_type");
+  char *old= NULL;
+  class cl_uc *node;
+
+  if (type && o)
+    {
+      o->get_value(&old);
+      if (old)
+	old= strdup(old);
+      o->set_value(type);
+    }
+  node= mk_controller();
+  if (type && o)
+    {
+      union option_value *v= o->get_value();
+      if (v->sval)
+	free(v->sval);
+      v->sval= old;
+    }
+  if (!node)
+    return(NULL);
+  nodes->add(node);
+  node->init();
+  return(node);
+}
+
+int
+cl_sim::node_nr(class cl_uc *node)
+{
+  t_index i;
+
+  if (nodes->index_of(node, &i))
+    return(i);
+  return(-1);
+}
+
+void
+cl_sim::select_node(class cl_uc *node)
+{
+  uc= node;
+  simif= uc->get_hw(cchars("simif"), 0);
+  sync_at= 0;
+}
+
+/* Bring the other controllers up to the time of the selected one, at most
+   "quantum" behind. They are executed one after the other in the order of
+   their numbers, so the result does not depend on the host. A controller
+   which stops the simulation remains selected. */
+
+void
+cl_sim::sync_nodes(void)
+{
+  class cl_uc *sel= uc;
+  double t= sel->get_rtime();
+  int i;
+
+  if (t < sync_at)
+    return;
+  sync_at= t + quantum;
+  for (i= 0; (i < nodes->count) && (state & SIM_GO); i++)
+    {
+      class cl_uc *n= (class cl_uc *)(nodes->at(i));
+      double nt;
+      if (n == sel)
+	continue;
+      uc= n;
+      while ((state & SIM_GO) &&
+	     ((nt= n->get_rtime()) < t))
+	{
+	  n->do_inst(1);
+	  // Do not hang on a controller which does not advance in time
+	  if (n->get_rtime() == nt)
+	    break;
+	}
+    }
+  if (state & SIM_GO)
+    uc= sel;
+  else
+    select_node(uc);
+}
+
 /*int
 cl_sim::do_cmd(char *cmdstr, class cl_console *console)
 {
@@ -135,7 +235,8 @@ cl_sim::start(class cl_console_base *con, unsigned long steps_to_do)
       app->get_commander()->update_active();
     }
   if (uc)
-    start_tick= uc->ticks->ticks;
+    start_tick= uc->ticks->get_ticks();
+  start_uc= uc;
   steps_done= 0;
   steps_todo= steps_to_do;
 }
@@ -152,6 +253,8 @@ cl_sim::stop(int reason, class cl_ev_brk *ebrk)
   
   state&= ~SIM_GO;
   stop_at= dnow();
+  if (uc != start_uc)
+    simif= uc->get_hw(cchars("simif"), 0);
   if (simif)
     simif->cfg_set(simif_reason, reason);
 
@@ -251,9 +354,10 @@ cl_sim::stop(int reason, class cl_ev_brk *ebrk)
 	  break;
 	}
       cmd->frozen_console->dd_printf("F 0x%06x\n", AU(uc->PC)); // for sdcdb
-      unsigned long dt= uc?(uc->ticks->ticks - start_tick):0;
-      if ((reason != resSTEP) ||
-	  (steps_done > 1))
+      unsigned long dt= uc?(uc->ticks->get_ticks() - start_tick):0;
+      if (((reason != resSTEP) ||
+	   (steps_done > 1)) &&
+	  (uc == start_uc))
         cmd->frozen_console->dd_printf("Simulated %.0f ticks in %.15f sec, rate=%.15f\n",
                                        dt * uc->xtal / uc->ticks->freq,
                                        stop_at - start_at,
@@ -336,6 +440,26 @@ cl_sim::build_cmdset(class cl_cmdset *cmdset)
   cmd->init();
   cmd->add_name("n");
 
+  {
+    class cl_cmdset *cset= new cl_cmdset();
+    cset->init();
+    cset->add(cmd= new cl_node_list_cmd("_no_parameters_", 0));
+    cmd->init();
+    cset->add(cmd= new cl_node_list_cmd("list", 0));
+    cmd->init();
+    cset->add(cmd= new cl_node_add_cmd("add", 0));
+    cmd->init();
+    cset->add(cmd= new cl_node_select_cmd("select", 0));
+    cmd->init();
+    cset->add(cmd= new cl_node_link_cmd("link", 0));
+    cmd->init();
+    cset->add(cmd= new cl_node_quantum_cmd("quantum", 0));
+    cmd->init();
+    cmdset->add(cmd= new cl_super_cmd("node", 0, cset));
+    cmd->init();
+    set_node_help(cmd);
+  }
+
   /*{
     cset= new cl_cmdset();
     cset->init();
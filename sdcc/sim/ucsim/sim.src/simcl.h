@@ -52,11 +52,15 @@ public:
   int argc; char **argv;
 
   //class cl_commander *cmd;
-  class cl_uc *uc;
+  class cl_uc *uc;	// Selected controller, commands work on it
+  class cl_list *nodes;	// All of the simulated controllers
+  double quantum;	// Time other controllers may fall behind uc
+  double sync_at;	// Time of uc to bring the others up to
   class cl_gui *gui;
   class cl_hw *simif;
   
   double start_at, stop_at;
+  class cl_uc *start_uc;
   unsigned long start_tick;
   unsigned long steps_done;
   unsigned long steps_todo; // use this if not 0
@@ -70,6 +74,10 @@ public:
   virtual void build_cmdset(class cl_cmdset *cmdset);
 
   virtual class cl_uc *get_uc(void) { return(uc); }
+  virtual class cl_uc *add_node(const char *type);
+  virtual int node_nr(class cl_uc *node);
+  virtual void select_node(class cl_uc *node);
+  virtual void sync_nodes(void);
 
   virtual void start(class cl_console_base *con, unsigned long steps_to_do);
   virtual void stop(int reason, class cl_ev_brk *ebrk= NULL);
@@ -116,6 +116,25 @@ cl_sif_command::get_parameter(int nr, t_mem *into)
   return(true);
 }
 
+/* Little endian value of nr parameters, starting at parameter from */
+
+bool
+cl_sif_command::get_parameter(int from, int nr, t_addr *into)
+{
+  t_addr v= 0;
+  int i;
+  for (i= nr-1; i >= 0; i--)
+    {
+      t_mem p;
+      if (!get_parameter(from+i, &p))
+	return(false);
+      v= (v << 8) + (p & 0xff);
+    }
+  if (into)
+    *into= v;
+  return(true);
+}
+
 
 t_mem
 cl_sif_command::read(class cl_memory_cell *cel)
@@ -441,6 +460,85 @@ cl_sif_read::produce_answer(void)
 }
 
 
+/* Command: write memory block to output file */
+
+void
+cl_sif_write_block::produce_answer(void)
+{
+  t_addr a, len, done= 0;
+  class cl_address_space *as= sif?(sif->get_as()):NULL;
+
+  if (as &&
+      get_parameter(0, 4, &a) &&
+      get_parameter(4, 2, &len))
+    {
+      char b[256];
+      while (done < len)
+	{
+	  int i= 0;
+	  while ((i < (int)sizeof(b)) &&
+		 (done + i < len) &&
+		 as->valid_address(a + done + i))
+	    {
+	      b[i]= as->read(a + done + i);
+	      i++;
+	    }
+	  if (i == 0)
+	    break;
+	  // without output file the block goes to stdout, as print does
+	  if (sif->fout)
+	    sif->fout->write(b, i);
+	  else
+	    fwrite(b, 1, i, stdout);
+	  done+= i;
+	}
+      if (!sif->fout)
+	fflush(stdout);
+    }
+  t_mem ans[2]= { t_mem(done & 0xff), t_mem((done >> 8) & 0xff) };
+  set_answer(2, ans);
+}
+
+
+/* Command: fill memory block from input file */
+
+void
+cl_sif_read_block::produce_answer(void)
+{
+  t_addr a, len, done= 0;
+  class cl_address_space *as= sif?(sif->get_as()):NULL;
+
+  if (as &&
+      sif->fin &&
+      get_parameter(0, 4, &a) &&
+      get_parameter(4, 2, &len))
+    {
+      int b[256];
+      while ((done < len) &&
+	     sif->fin->input_avail())
+	{
+	  int max= len - done, i, j;
+	  if (max > (int)(sizeof(b)/sizeof(b[0])))
+	    max= sizeof(b)/sizeof(b[0]);
+	  i= sif->fin->read(b, max);
+	  if (i <= 0)
+	    break;
+	  for (j= 0; j < i; j++)
+	    {
+	      if (!as->valid_address(a + done))
+		break;
+	      as->write(a + done, b[j]);
+	      done++;
+	    }
+	  if (j < i)
+	    break;
+	}
+    }
+  t_mem ans[2]= { t_mem(done & 0xff), t_mem((done >> 8) & 0xff) };
+  set_answer(2, ans);
+}
+
+
 /* Command: reset */
 
 void
@@ -566,6 +664,10 @@ cl_simulator_interface::init(void)
   c->init();
   commands->add(c= new cl_sif_write(this));
   c->init();
+  commands->add(c= new cl_sif_write_block(this));
+  c->init();
+  commands->add(c= new cl_sif_read_block(this));
+  c->init();
 
   cl_var *v;
   uc->vars->add(v= new cl_var(cchars("simif_on"), cfg, simif_on,
@@ -833,17 +935,17 @@ cl_simulator_interface::conf_op(cl_memory_cell *cell, t_addr addr, t_mem *val)
     case simif_ticks: // tick counter
       if (val)
 	*val= cell->get();
-      cell->set(uc->ticks->ticks);
+      cell->set(uc->ticks->get_ticks());
       break;
     case simif_isr_ticks: // isr tick counter
       if (val)
 	*val= cell->get();
-      cell->set(uc->isr_ticks->ticks);
+      cell->set(uc->isr_ticks->get_ticks());
       break;
     case simif_idle_ticks: // idle tick counter
       if (val)
 	*val= cell->get();
-      cell->set(uc->idle_ticks->ticks);
+      cell->set(uc->idle_ticks->get_ticks());
       break;
     case simif_real_time: // real time in msec
       if (val)
@@ -83,6 +83,12 @@ enum sif_command {
   SIFCM_RESET		= 'R',	// reset CPU
   // -> R
   // <-
+  SIFCM_WRITE_BLOCK	= 'W',	// write memory block to output file
+  // -> W addr0 addr1 addr2 addr3 len0 len1
+  // <- 2 written0 written1
+  SIFCM_READ_BLOCK	= 'F',	// fill memory block from input file
+  // -> F addr0 addr1 addr2 addr3 len0 len1
+  // <- 2 read0 read1
 };
 
 enum sif_answer_type {
@@ -152,6 +158,7 @@ public:
   enum sif_answer_type get_answer_type(void) { return(answer_type); }
   int get_params_needed(void) { return(params_needed); }
   bool get_parameter(int nr, t_mem *into);
+  bool get_parameter(int from, int nr, t_addr *into);
 
   virtual t_mem read(class cl_memory_cell *cel);
   virtual void write(class cl_memory_cell *cel, t_mem *val);
@@ -341,6 +348,32 @@ public:
 };
 
 
+/* Command: write memory block to output file */
+class cl_sif_write_block: public cl_sif_command
+{
+public:
+  cl_sif_write_block(class cl_simulator_interface *the_sif):
+    cl_sif_command(SIFCM_WRITE_BLOCK, "write block",
+		   "Write memory block to output file",
+		   SIFAT_ARRAY, 6, the_sif)
+  {}
+  virtual void produce_answer(void);
+};
+
+
+/* Command: fill memory block from input file */
+class cl_sif_read_block: public cl_sif_command
+{
+public:
+  cl_sif_read_block(class cl_simulator_interface *the_sif):
+    cl_sif_command(SIFCM_READ_BLOCK, "read block",
+		   "Fill memory block from input file",
+		   SIFAT_ARRAY, 6, the_sif)
+  {}
+  virtual void produce_answer(void);
+};
+
+
 /*
  * Virtual hardware: simulator interface
  */
@@ -365,6 +398,7 @@ class cl_simulator_interface: public cl_hw
   virtual int init(void);
   virtual int cfg_size(void) { return simif_nuof; }
   virtual char *cfg_help(t_addr addr);
+  class cl_address_space *get_as(void) { return as; }
     
   virtual void set_cmd(class cl_cmdline *cmdline, class cl_console_base *con);
   virtual t_mem read(class cl_memory_cell *cel);
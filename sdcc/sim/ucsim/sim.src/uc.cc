@@ -31,6 +31,7 @@ Software Foundation, 59 Temple Place - Suite 330, Boston, MA
 #include <stdlib.h>
 #include <errno.h>
 #include <ctype.h>
+#include <math.h>
 #include "i_string.h"
 
 // prj
@@ -46,6 +47,8 @@ Software Foundation, 59 Temple Place - Suite 330, Boston, MA
 #include "cmd_setcl.h"
 #include "cmd_infocl.h"
 #include "cmd_timercl.h"
+#include "cmd_profcl.h"
+#include "cmd_covcl.h"
 #include "cmd_statcl.h"
 #include "cmd_memcl.h"
 
@@ -68,23 +71,62 @@ static class cl_uc_error_registry uc_error_registry;
 cl_ticker::cl_ticker(const char *aname, bool artime, double afreq, int adir, enum cpu_state astate, bool ainisr)
 {
   set_name(aname);
+  uc= 0;
   rtime = artime;
   freq= afreq;
   dir= adir;
   state= astate;
   inisr= ainisr;
   ticks= 0;
+  start= 0;
+  counting= false;
   run= true;
+
+  // One bit for each state, in and out of ISRs, see cl_uc::sync_tickers().
+  if (state == stUNDEF)
+    mask= ~0U;
+  else if (state == stGO)
+    mask= 1U << (inisr ? 1 : 0);
+  else
+    mask= 3U << (2 * state);
 }
 
 cl_ticker::~cl_ticker(void) {}
 
+/* The value is not updated while counting, it is computed from the master
+   clock of the controller when needed. */
+
+long
+cl_ticker::get_ticks(void)
+{
+  if (!counting || !uc)
+    return ticks;
+
+  unsigned long clocks= uc->clocks - start;
+  if (freq == uc->xtal)
+    return ticks + dir * (long)clocks;
+  return ticks + dir * (long)(clocks * freq / uc->xtal);
+}
+
+void
+cl_ticker::set_ticks(long val)
+{
+  ticks= val;
+  if (uc)
+    {
+      start= uc->clocks;
+      uc->tickers_changed();
+    }
+}
+
 void
-cl_ticker::tick(class cl_uc *uc, int nr, int count)
+cl_ticker::update(int nr, bool acounting)
 {
   long old_ticks = ticks;
 
-  ticks += dir * count;
+  ticks= get_ticks();
+  start= uc->clocks;
+  counting= acounting;
 
   if (old_ticks > 0 && ticks <= 0)
     {
@@ -93,10 +135,24 @@ cl_ticker::tick(class cl_uc *uc, int nr, int count)
     }
 }
 
+/* Master clocks until a counter counting down reaches zero */
+
+unsigned long
+cl_ticker::clocks_to_zero(void)
+{
+  long val= get_ticks();
+
+  if (!counting || dir >= 0 || val <= 0)
+    return ~0UL;
+  if (freq == uc->xtal)
+    return (val + -dir - 1) / -dir;
+  return (unsigned long)ceil(val * uc->xtal / (freq * -dir));
+}
+
 double
 cl_ticker::get_rtime(void)
 {
-  return (double)ticks / freq;
+  return (double)get_ticks() / freq;
 }
 
 void
@@ -137,7 +193,7 @@ cl_ticker::dump(class cl_uc *uc, int nr, class cl_console_base *con)
     {
       const char *scale;
       double sfreq= si_prefix(freq, &scale);
-      con->dd_printf(" %ld clks @ %.0f%sHz", ticks, sfreq, scale);
+      con->dd_printf(" %ld clks @ %.0f%sHz", get_ticks(), sfreq, scale);
     }
 
   con->dd_printf("\n");
@@ -161,6 +217,8 @@ cl_xtal_option::option_changed(void)
     return;
   double d;
   option->get_value(&d);
+  // Tickers convert master clocks with the old frequency up to now.
+  uc->sync_tickers();
   uc->xtal= d;
 }
 
@@ -213,7 +271,7 @@ unsigned long
 cl_time_clk::now()
 {
   if (!uc) return 0;
-  return uc->ticks->ticks;
+  return uc->ticks->get_ticks();
 }
 
 
@@ -386,6 +444,10 @@ cl_uc::cl_uc(class cl_sim *asim):
   xtal_option->init();
 
   counters= new cl_list(4, 2, "counters");
+  ticks= 0;
+  clocks= 0;
+  clocks_sync= ~0UL;
+  tickers_changed();
 
   it_levels= new cl_list(2, 2, "it levels");
   it_sources= new cl_irqs(2, 2);
@@ -397,6 +459,12 @@ cl_uc::cl_uc(class cl_sim *asim):
   sp_max= 0;
   sp_avg= 0;
   inst_exec= false;
+  profiling= false;
+  prof_execs= prof_cycles= NULL;
+  covering= false;
+  cov_map= NULL;
+  cdb_lines= new cl_list(16, 16, "cdb lines");
+  cdb_funcs= new cl_list(16, 16, "cdb functions");
 }
 
 
@@ -420,6 +488,16 @@ cl_uc::~cl_uc(void)
   delete address_spaces;
   delete memchips;
   //delete address_decoders;
+  if (prof_execs)
+    free(prof_execs);
+  if (prof_cycles)
+    free(prof_cycles);
+  if (cov_map)
+    free(cov_map);
+  cdb_lines->free_all();
+  delete cdb_lines;
+  cdb_funcs->free_all();
+  delete cdb_funcs;
 }
 
 
@@ -442,8 +520,12 @@ cl_uc::init(void)
   stop_at_time= 0;
   make_cpu_hw();
   mk_hw_elements();
-  class cl_cmdset *cs= sim->app->get_commander()->cmdset;
-  build_cmdset(cs);
+  // Commands work on the selected controller, one set is enough
+  if (sim->node_nr(this) <= 0)
+    {
+      class cl_cmdset *cs= sim->app->get_commander()->cmdset;
+      build_cmdset(cs);
+    }
   irq= false;
 
   double userxtal = xtal;
@@ -455,6 +537,7 @@ cl_uc::init(void)
   // maximum frequency and may be able to be stepped down rather than
   // powering up at a lower frequency and able to be stepped up.
   ticks= new cl_ticker("time", true, (userxtal > xtal ? userxtal : xtal), +1, stUNDEF);
+  ticks->uc= this;
 
   main_ticks= new cl_ticker("main", true, ticks->freq, +1, stGO, false);
   add_counter(main_ticks, main_ticks->get_name());
@@ -497,10 +580,10 @@ cl_uc::reset(void)
   irq= false;
   instPC= PC= 0;
   state = stGO;
-  ticks->ticks= 0;
-  isr_ticks->ticks= 0;
-  idle_ticks->ticks= 0;
-  main_ticks->ticks= 0;
+  ticks->set_ticks(0);
+  isr_ticks->set_ticks(0);
+  idle_ticks->set_ticks(0);
+  main_ticks->set_ticks(0);
   vc.inst= vc.fetch= vc.rd= vc.wr= 0;
   /* FIXME should we clear user counters?*/
   il= (class it_level *)(it_levels->top());
@@ -775,6 +858,66 @@ cl_uc::build_cmdset(class cl_cmdset *cmdset)
     set_timer_help(cmd);
   }
 
+  {
+    super_cmd= (class cl_super_cmd *)(cmdset->get_cmd("profile"));
+    if (super_cmd)
+      cset= super_cmd->get_subcommands();
+    else {
+      cset= new cl_cmdset();
+      cset->init();
+    }
+    cset->add(cmd= new cl_profile_list_cmd("_no_parameters_", 0));
+    cmd->init();
+    cset->add(cmd= new cl_profile_list_cmd("list", 0));
+    cmd->init();
+    cset->add(cmd= new cl_profile_start_cmd("start", 0));
+    cmd->init();
+    cmd->add_name("on");
+    cset->add(cmd= new cl_profile_stop_cmd("stop", 0));
+    cmd->init();
+    cmd->add_name("off");
+    cset->add(cmd= new cl_profile_clear_cmd("clear", 0));
+    cmd->init();
+    cset->add(cmd= new cl_profile_annotate_cmd("annotate", 0));
+    cmd->init();
+    cset->add(cmd= new cl_profile_tags_cmd("tags", 0));
+    cmd->init();
+  }
+  if (!super_cmd) {
+    cmdset->add(cmd= new cl_super_cmd("profile", 0, cset));
+    cmd->init();
+    set_profile_help(cmd);
+  }
+
+  {
+    super_cmd= (class cl_super_cmd *)(cmdset->get_cmd("coverage"));
+    if (super_cmd)
+      cset= super_cmd->get_subcommands();
+    else {
+      cset= new cl_cmdset();
+      cset->init();
+    }
+    cset->add(cmd= new cl_coverage_info_cmd("_no_parameters_", 0));
+    cmd->init();
+    cset->add(cmd= new cl_coverage_info_cmd("info", 0));
+    cmd->init();
+    cset->add(cmd= new cl_coverage_start_cmd("start", 0));
+    cmd->init();
+    cmd->add_name("on");
+    cset->add(cmd= new cl_coverage_stop_cmd("stop", 0));
+    cmd->init();
+    cmd->add_name("off");
+    cset->add(cmd= new cl_coverage_clear_cmd("clear", 0));
+    cmd->init();
+    cset->add(cmd= new cl_coverage_lcov_cmd("lcov", 0));
+    cmd->init();
+  }
+  if (!super_cmd) {
+    cmdset->add(cmd= new cl_super_cmd("coverage", 0, cset));
+    cmd->init();
+    set_coverage_help(cmd);
+  }
+
   {
     class cl_super_cmd *mem_create;
     class cl_cmdset *mem_create_cset;
@@ -1234,12 +1377,15 @@ long
 cl_uc::read_cdb_file(cl_f *f)
 {
   class cl_cdb_recs *fns= new cl_cdb_recs();
+  class cl_cdb_recs *sfns= new cl_cdb_recs();
   chars ln;
   char *lc;
   long cnt= 0;
   class cl_cdb_rec *r;
   class cl_var *v;
-  
+
+  cdb_lines->free_all();
+  cdb_funcs->free_all();
   ln= f->get_s();
   while (!ln.empty())
     {
@@ -1258,12 +1404,29 @@ cl_uc::read_cdb_file(cl_f *f)
 		    {
 		      vars->add(v= new cl_var(n, rom, r->addr, ""));
 		      v->init();
+		      cdb_funcs->add(new cl_cdb_rec(n, r->addr));
 		      fns->del(n);
 		      cnt++;
 		    }
 		  else
 		    fns->add(new cl_cdb_rec(n));
 		}
+	      else if ((lc[1] == ':') &&
+		       (lc[2] == 'F'))
+		{
+		  // static function: F:F<module>$name$...
+		  ln.start_parse(3);
+		  chars n= ln.token("$");
+		  n+= '$';
+		  n+= ln.token("$");
+		  if ((r= sfns->rec(n)) != NULL)
+		    {
+		      cdb_funcs->add(new cl_cdb_rec(n, r->addr));
+		      sfns->del(n);
+		    }
+		  else
+		    sfns->add(new cl_cdb_rec(n));
+		}
 	    }
 	}
       else if (lc[0] == 'L')
@@ -1283,17 +1446,63 @@ cl_uc::read_cdb_file(cl_f *f)
 		      fns->del(n);
 		      vars->add(v= new cl_var(n, rom, a, ""));
 		      v->init();
+		      cdb_funcs->add(new cl_cdb_rec(n, a));
 		      cnt++;
 		    }
 		  else
 		    fns->add(new cl_cdb_rec(n, a));
 		}
+	      else if ((ln[1] == ':') &&
+		       (lc[2] == 'F'))
+		{
+		  ln.start_parse(3);
+		  chars n= ln.token("$");
+		  n+= '$';
+		  n+= ln.token("$");
+		  chars t= ln.token(":");
+		  t= ln.token(" ");
+		  t_addr a= strtol((char*)t, 0, 16);
+		  if ((r= sfns->rec(n)) != NULL)
+		    {
+		      sfns->del(n);
+		      cdb_funcs->add(new cl_cdb_rec(n, a));
+		    }
+		  else
+		    sfns->add(new cl_cdb_rec(n, a));
+		}
+	      else if ((ln[1] == ':') &&
+		       (lc[2] == 'X'))
+		{
+		  // L:XG$name$...:address, last instruction of a function,
+		  // kept as line 0 to limit code of the last line
+		  ln.start_parse(3);
+		  chars t= ln.token(":");
+		  t= ln.token(" ");
+		  t_addr a= strtol((char*)t, 0, 16);
+		  cdb_lines->add(new cl_cdb_line("", 0, a));
+		}
+	      else if ((ln[1] == ':') &&
+		       (lc[2] == 'C'))
+		{
+		  // L:C$file$line$level$block:address
+		  ln.start_parse(4);
+		  chars fn= ln.token("$");
+		  chars t= ln.token("$");
+		  long l= strtol((char*)t, 0, 10);
+		  t= ln.token(":");
+		  t= ln.token(" ");
+		  t_addr a= strtol((char*)t, 0, 16);
+		  if (!fn.empty() && (l > 0))
+		    cdb_lines->add(new cl_cdb_line(fn, l, a));
+		}
 	    }
 	}
       ln= f->get_s();
     }
   fns->free_all();
   delete fns;
+  sfns->free_all();
+  delete sfns;
   return cnt;
 }
 
@@ -2008,49 +2217,65 @@ cl_uc::tick(int cycles)
   if (state != stPD)
     inst_ticks+= cycles;
 
-  ticks->tick(this, 0, cycles * clock_per_cycle() * ticks->freq / xtal);
-  update_tickers(true, ticks->freq, cycles * clock_per_cycle() * ticks->freq / xtal);
-
-  if (state == stGO)
-    update_tickers(false, xtal / clock_per_cycle(), cycles);
-  else
-    update_tickers(false, xtal, cycles * clock_per_cycle());
+  add_clocks(cycles * clock_per_cycle());
 
   return 0;
 }
 
-int
-cl_uc::update_tickers(bool rtime, double freq, int cycles)
+/* Tickers only have to be updated when the state or the interrupt nesting
+   changes, and when a timer counting down expires. Bit 2*state+inisr of
+   the mask of a ticker tells whether it counts in a state. */
+
+void
+cl_uc::sync_tickers(void)
 {
+  if (!ticks)
+    return;
+
   class it_level *il= (class it_level *)(it_levels->top());
-  int tickers_updated = 0;
+  bool inisr= il && il->level >= 0;
+  unsigned int bit= 1U << (2 * state + (inisr ? 1 : 0));
+  bool rtime_found= false, clks_found= false;
+  unsigned long sync= ~0UL;
 
+  ticks->update(0, ticks->run);
   for (int i= 0; i < counters->count; i++)
     {
       class cl_ticker *t= (class cl_ticker *)(counters->at(i));
-      if (t && t->run &&
-           t->rtime == rtime &&
-           t->freq == freq &&
-           (t->state == stUNDEF ||
-            (t->state == state &&
-             (t->state != stGO ||
-              ((!t->inisr && il->level < 0) ||
-               (t->inisr && il->level >= 0))))))
+      if (!t)
+        continue;
+      t->update(i, t->run && (t->mask & bit));
+      if (t->state != stUNDEF && (t->mask & bit))
         {
-          t->tick(this, i, cycles);
-          if (t->state != stUNDEF)
-            tickers_updated++;
+          if (t->rtime)
+            rtime_found= true;
+          else
+            clks_found= true;
         }
+      unsigned long c= t->clocks_to_zero();
+      if (c != ~0UL && clocks + c < sync)
+        sync= clocks + c;
     }
 
-  if (tickers_updated == 0)
+  // Make sure the time spent in each state is counted, both as real time
+  // and in clocks (instruction cycles when running).
+  if (!rtime_found)
     {
-      class cl_ticker *ticker = new cl_ticker(NULL, rtime, freq, +1, state, (il->level >= 0));
+      class cl_ticker *ticker = new cl_ticker(NULL, true, ticks->freq, +1, state, inisr);
       add_counter(ticker, ticker->get_name());
-      ticker->tick(this, counters->count, cycles);
+      ticker->update(counters->count, true);
+    }
+  if (!clks_found)
+    {
+      double freq= (state == stGO) ? xtal / clock_per_cycle() : xtal;
+      class cl_ticker *ticker = new cl_ticker(NULL, false, freq, +1, state, inisr);
+      add_counter(ticker, ticker->get_name());
+      ticker->update(counters->count, true);
     }
 
-  return(0);
+  ticker_state= state;
+  ticker_levels= it_levels->count;
+  clocks_sync= sync;
 }
 
 class cl_ticker *
@@ -2085,6 +2310,8 @@ cl_uc::add_counter(class cl_ticker *ticker, int nr)
   while (counters->count <= nr)
     counters->add(0);
   counters->put_at(nr, ticker);
+  ticker->uc= this;
+  tickers_changed();
 }
 
 void
@@ -2100,10 +2327,14 @@ cl_uc::add_counter(class cl_ticker *ticker, const char */*nam*/)
       if (!t)
 	{
 	  counters->put_at(i, ticker);
+	  ticker->uc= this;
+	  tickers_changed();
 	  return;
 	}
     }
   counters->add(ticker);
+  ticker->uc= this;
+  tickers_changed();
 }
 
 void
@@ -2205,6 +2436,9 @@ cl_uc::do_inst(int step)
       if (res == resINV_INST)
 	/* backup to start of instruction */
 	PC = PCsave;
+
+      if (profiling || covering)
+	measure_inst(PCsave, res);
       
       post_inst();
 
@@ -2281,6 +2515,79 @@ cl_uc::post_inst(void)
 }
 
 
+/* Profile and coverage of the instruction just executed at addr */
+
+void
+cl_uc::measure_inst(t_addr addr, int res)
+{
+  t_addr a= addr - rom->start_address;
+
+  if ((a < 0) ||
+      (a >= rom->get_size()))
+    return;
+  if (profiling)
+    {
+      prof_execs[a]++;
+      prof_cycles[a]+= inst_ticks;
+    }
+  if (covering &&
+      (res != resINV_INST))
+    {
+      uchar c= cov_map[a];
+      if (!(c & COV_EXEC))
+	c= COV_EXEC | (inst_length(addr) << COV_LSHIFT);
+      c|= (PC == addr + (c >> COV_LSHIFT))?COV_NEXT:COV_JUMP;
+      cov_map[a]= c;
+    }
+}
+
+/* Counters of the profile are allocated when it is first started */
+
+void
+cl_uc::prof_start(void)
+{
+  if (!rom)
+    return;
+  if (!prof_execs)
+    {
+      prof_execs= (unsigned long *)calloc(rom->get_size(), sizeof(unsigned long));
+      prof_cycles= (unsigned long *)calloc(rom->get_size(), sizeof(unsigned long));
+    }
+  profiling= prof_execs && prof_cycles;
+}
+
+void
+cl_uc::prof_clear(void)
+{
+  if (prof_execs)
+    memset(prof_execs, 0, rom->get_size() * sizeof(unsigned long));
+  if (prof_cycles)
+    memset(prof_cycles, 0, rom->get_size() * sizeof(unsigned long));
+}
+
+
+/* Coverage map holds a byte of flags for every address of the rom. Length
+   of the instruction is stored at the first execution, so the branch taken
+   can be told apart from the fall through without decoding it again */
+
+void
+cl_uc::cov_start(void)
+{
+  if (!rom)
+    return;
+  if (!cov_map)
+    cov_map= (uchar *)calloc(rom->get_size(), sizeof(uchar));
+  covering= cov_map != NULL;
+}
+
+void
+cl_uc::cov_clear(void)
+{
+  if (cov_map)
+    memset(cov_map, 0, rom->get_size() * sizeof(uchar));
+}
+
+
 /*
  * Interrupt processing
  */
@@ -2320,7 +2627,7 @@ cl_uc::do_interrupt(void)
 	  is->clear();
 	  sim->app->get_commander()->
 	    debug("%g sec (%d clks): Accepting interrupt `%s' PC= 0x%06x\n",
-			  get_rtime(), ticks->ticks, object_name(is), PC);
+			  get_rtime(), ticks->get_ticks(), object_name(is), PC);
 	  IL= new it_level(pr, is->addr, PC, is);
 	  return(accept_it(IL));
 	}
@@ -50,18 +50,27 @@ typedef int (*instruction_wrapper_fn)(class cl_uc *uc, t_mem code);
 class cl_ticker: public cl_base
 {
 public:
+  class cl_uc *uc;	// Controller whose master clock is counted
   bool rtime;
   double freq;
-  long ticks;
   int dir;
   enum cpu_state state;
   bool run;
   bool inisr;
+  unsigned int mask;	// Bits of the states (see cl_uc::sync_tickers) to count in
+protected:
+  long ticks;		// Value at the master clock "start"
+  unsigned long start;	// Master clock of the last update
+  bool counting;	// Counting since "start"
 
+public:
   cl_ticker(const char *aname, bool artime, double afreq, int adir = +1, enum cpu_state astate = stGO, bool ainisr = false);
   virtual ~cl_ticker(void);
 
-  virtual void tick(class cl_uc *uc, int nr, int count);
+  virtual long get_ticks(void);
+  virtual void set_ticks(long val);
+  virtual void update(int nr, bool acounting);
+  virtual unsigned long clocks_to_zero(void);
   virtual double get_rtime(void);
   virtual void dump(class cl_uc *uc, int nr, class cl_console_base *con);
 };
@@ -194,6 +203,28 @@ class cl_cdb_recs: public cl_sorted_list
   }
 };
 
+/* Source line of the cdb file and the code generated for it */
+
+class cl_cdb_line: public cl_base
+{
+ public:
+  chars file;
+  long line;
+  t_addr addr, end;
+ public:
+  cl_cdb_line(chars f, long l, t_addr a): cl_base()
+  { file= f; line= l; addr= a; end= a; }
+};
+
+/* Flags of coverage map, upper bits hold length of the instruction */
+
+enum cov_flags {
+  COV_EXEC	= 0x01,	// instruction executed
+  COV_NEXT	= 0x02,	// continued with the next instruction
+  COV_JUMP	= 0x04,	// continued anywhere else
+  COV_LSHIFT	= 3
+};
+
 /* Abstract microcontroller */
 
 class cl_uc: public cl_base
@@ -213,9 +244,20 @@ public:
   class cl_ticker *idle_ticks; // Time in idle mode
   class cl_ticker *main_ticks; // Time executing in main (non ISR) mode
   class cl_list *counters;	// User definable timers (tickers)
+  unsigned long clocks;		// Master (xtal) clock periods elapsed
+  unsigned long clocks_sync;	// Master clock to update the tickers at
+  enum cpu_state ticker_state;	// State and interrupt nesting the tickers
+  t_index ticker_levels;	// were last updated in
   int inst_ticks;		// ticks of an instruction
   double xtal;			// Clock speed
   struct vcounter_t vc;		// Virtual clk counter
+  bool profiling;		// Count executions per instruction address
+  unsigned long *prof_execs;	// Executions, indexed by address in rom
+  unsigned long *prof_cycles;	// Cycles of them, indexed the same way
+  bool covering;		// Mark executed instructions
+  uchar *cov_map;		// Coverage flags and length of instructions
+  class cl_list *cdb_lines;	// Source line records of the cdb file
+  class cl_list *cdb_funcs;	// Function records of the cdb file
   
   int brk_counter;		// Number of breakpoints
   class brk_coll *fbrk;		// Collection of FETCH break-points
@@ -301,7 +343,16 @@ public:
   virtual int tick_hw(int cycles);
   virtual void do_extra_hw(int cycles);
   virtual int tick(int cycles);
-  virtual int update_tickers(bool rtime, double freq, int cycles);
+  void add_clocks(unsigned long n)
+  {
+    if (state != ticker_state || it_levels->count != ticker_levels)
+      sync_tickers();
+    clocks+= n;
+    if (clocks >= clocks_sync)
+      sync_tickers();
+  }
+  virtual void sync_tickers(void);
+  virtual void tickers_changed(void) { ticker_state= stUNDEF; }
   virtual class cl_ticker *get_counter(int nr);
   virtual class cl_ticker *get_counter(const char *nam);
   virtual void add_counter(class cl_ticker *ticker, int nr);
@@ -320,6 +371,11 @@ public:
   virtual int exec_inst(void);
   virtual int exec_inst_tab(instruction_wrapper_fn itab[]);
   virtual void post_inst(void);
+  virtual void measure_inst(t_addr addr, int res);
+  virtual void prof_start(void);
+  virtual void prof_clear(void);
+  virtual void cov_start(void);
+  virtual void cov_clear(void);
 
   virtual int do_interrupt(void);
   virtual int priority_of(uchar nuof_it) {return(0);}
@@ -357,6 +413,7 @@ public:
   virtual int inst_length(t_addr addr);
   virtual int inst_branch(t_addr addr);
   virtual bool is_call(t_addr addr);
+  virtual bool is_cond_branch(t_addr addr) { return false; }
   virtual int longest_inst(void);
   virtual bool addr_name(class cl_console_base *con, class cl_address_space *as, t_addr addr);
   virtual bool addr_name(class cl_console_base *con, class cl_address_space *as, t_addr addr, int bitnr);
@@ -851,6 +851,15 @@ cl_stm8::is_call(t_addr addr)
   return e?(e->is_call):false;
 }
 
+bool
+cl_stm8::is_cond_branch(t_addr addr)
+{
+  int b;
+
+  get_disasm_info(addr, NULL, &b, NULL, NULL);
+  return(strchr("bftvVhHiI", b) != NULL);
+}
+
 int
 cl_stm8::longest_inst(void)
 {
@@ -1060,13 +1069,17 @@ cl_stm8::analyze(t_addr addr)
       return;
     }
 
-  while (!inst_at(addr) && (mnemonic = get_disasm_info(addr, &length, &branch, &immed_offset, NULL)))
+  while (rom->valid_address(addr) &&
+         !inst_at(addr) && (mnemonic = get_disasm_info(addr, &length, &branch, &immed_offset, NULL)))
     {
       set_inst_at(addr);
 
       if (branch == 'r' || branch == '!')
         return;
 
+      // Indirect branches have no target we could follow.
+      operand = 0;
+
       const char *var_name = NULL;
       const char *suffix = "";
 
@@ -1143,7 +1156,7 @@ cl_stm8::analyze(t_addr addr)
             }
         }
 
-      if (branch != ' ')
+      if (branch != ' ' && operand)
         {
           // If the target isn't already labelled we'll create one ourselves.
           // N.B. With jumps, branches and calls the target address is always
@@ -1200,10 +1213,9 @@ cl_stm8::analyze(t_addr addr)
             }
 
           analyze(operand);
-
-          if (branch == 'j')
-            return;
         }
+      if (branch == 'j')
+        return;
 
       addr= rom->validate_address(addr + length);
     }
@@ -1400,14 +1412,11 @@ cl_stm8::tick(int cycles_cpu)
 int
 cl_stm8::tick_master(int cycles_master)
 {
-  ticks->tick(this, 0, cycles_master * ticks->freq / xtal);
-  update_tickers(true, ticks->freq, cycles_master * ticks->freq / xtal);
-
   // tick for hardwares
   if (state != stPD)
     inst_ticks+= cycles_master;
 
-  update_tickers(false, xtal, cycles_master);
+  add_clocks(cycles_master);
   return 0;
 }
 
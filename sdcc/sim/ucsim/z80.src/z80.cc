@@ -301,6 +301,33 @@ cl_z80::is_call(t_addr addr)
   return e?(e->is_call):false;
 }
 
+/* DJNZ and the JR, JP, CALL, RET instructions with a condition code
+   ("JR NZ,%d", "RET C", but not "JP (HL)") */
+
+bool
+cl_z80::is_cond_branch(t_addr addr)
+{
+  struct dis_entry *e;
+  const char *m, *c;
+  int i;
+
+  get_disasm_info(addr, NULL, NULL, NULL, &e);
+  if (!e)
+    return false;
+  m= e->mnemonic;
+  if (strncmp(m, "DJNZ", 4) == 0)
+    return true;
+  if ((strncmp(m, "JR ", 3) != 0) &&
+      (strncmp(m, "JP ", 3) != 0) &&
+      (strncmp(m, "RET ", 4) != 0) &&
+      (strncmp(m, "CALL ", 5) != 0))
+    return false;
+  c= strchr(m, ' ') + 1;
+  for (i= 0; (c[i] >= 'A') && (c[i] <= 'Z'); i++)
+    ;
+  return((i > 0) && (i <= 2) && ((c[i] == ',') || (c[i] == '\0')));
+}
+
 int
 cl_z80::longest_inst(void)
 {
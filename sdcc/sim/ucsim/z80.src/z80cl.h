@@ -70,6 +70,7 @@ public:
                                       int *immed_offset,
                                       struct dis_entry **dentry);
   virtual bool is_call(t_addr addr);
+  virtual bool is_cond_branch(t_addr addr);
 
   virtual void store1( u16_t addr, t_mem val );
   virtual void store2( u16_t addr, u16_t val );
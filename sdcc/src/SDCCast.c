@@ -1916,6 +1916,54 @@ isLabelInAst (symbol * label, ast * tree)
   return isLabelInAst (label, tree->right) && isLabelInAst (label, tree->left);
 }
 
+/*-----------------------------------------------------------------*/
+/* astCodeCost - estimate the code size in bytes generated for an  */
+/*               undecorated tree, before any optimization         */
+/*-----------------------------------------------------------------*/
+static int
+astCodeCost (ast *tree)
+{
+  int cost;
+
+  if (!tree)
+    return 0;
+
+  if (IS_AST_VALUE (tree))
+    return (IS_AST_SYM_VALUE (tree) ? 2 : 1);
+
+  if (!IS_AST_OP (tree))
+    return 0;
+
+  switch (tree->opval.op)
+    {
+    /* Pure structure, no code of its own */
+    case BLOCK:
+    case NULLOP:
+    case LABEL:
+    case CAST:
+      cost = 0;
+      break;
+    case CALL:
+    case PCALL:
+      cost = 4;
+      break;
+    case '*':
+    case '/':
+    case '%':
+      cost = 4;
+      break;
+    default:
+      cost = 2;
+      break;
+    }
+
+  if (tree->opval.op == FOR)
+    cost += astCodeCost (AST_FOR (tree, initExpr)) +
+      astCodeCost (AST_FOR (tree, condExpr)) + astCodeCost (AST_FOR (tree, loopExpr));
+
+  return cost + astCodeCost (tree->left) + astCodeCost (tree->right);
+}
+
 /*-----------------------------------------------------------------*/
 /* isLoopCountable - return true if the loop count can be          */
 /* determined at compile time .                                    */
@@ -2513,6 +2561,226 @@ isInitiallyTrue (ast *initExpr, ast * condExpr)
   return !isEqualVal (AST_VALUE (condExpr), 0);
 }
 
+/*-----------------------------------------------------------------*/
+/* isUnrollableBody - check if a loop body can be duplicated and   */
+/*                    leaves the loop control variable alone       */
+/*-----------------------------------------------------------------*/
+static bool
+isUnrollableBody (ast * tree, symbol * sym)
+{
+  if (!tree || IS_AST_VALUE (tree) || IS_AST_LINK (tree))
+    return TRUE;
+
+  switch (tree->opval.op)
+    {
+    /* Labels have been created by the parser already and */
+    /* must not appear more than once in a function.      */
+    case LABEL:
+    case GOTO:
+    case IFX:
+    case SWITCH:
+    case CRITICAL:
+    case INLINEASM:
+      return FALSE;
+
+    case BLOCK:
+      if (tree->values.sym)
+        return FALSE;
+      break;
+
+    case '=':
+    case MUL_ASSIGN:
+    case DIV_ASSIGN:
+    case MOD_ASSIGN:
+    case AND_ASSIGN:
+    case OR_ASSIGN:
+    case XOR_ASSIGN:
+    case RIGHT_ASSIGN:
+    case LEFT_ASSIGN:
+    case SUB_ASSIGN:
+    case ADD_ASSIGN:
+      if (IS_AST_SYM_VALUE (tree->left) && isSymbolEqual (AST_SYMBOL (tree->left), sym))
+        return FALSE;
+      break;
+
+    case INC_OP:
+    case DEC_OP:
+      if (astHasSymbol (tree->left, sym) || astHasSymbol (tree->right, sym))
+        return FALSE;
+      break;
+
+    /* address of the loop control variable */
+    case '&':
+      if (!tree->right && astHasSymbol (tree->left, sym))
+        return FALSE;
+      break;
+
+    /* a global loop control variable could be changed by the callee */
+    case CALL:
+    case PCALL:
+      if (!sym->level)
+        return FALSE;
+      break;
+
+    default:
+      break;
+    }
+
+  return isUnrollableBody (tree->left, sym) && isUnrollableBody (tree->right, sym);
+}
+
+/*-----------------------------------------------------------------*/
+/* unrollBudget - size in bytes an unrolled loop may grow to       */
+/*-----------------------------------------------------------------*/
+static int
+unrollBudget (void)
+{
+  /* Padauk devices have at most a few kilowords of program memory */
+  if (TARGET_PDK_LIKE)
+    return 24;
+
+  return 64;
+}
+
+/*-----------------------------------------------------------------*/
+/* unrollShareSymbols - make the values in a copy of a decorated   */
+/*                      tree refer to the original symbols again,  */
+/*                      copyAst () gives each value its own copy   */
+/*-----------------------------------------------------------------*/
+static void
+unrollShareSymbols (ast * dest, ast * src)
+{
+  if (!dest || !src)
+    return;
+
+  if (IS_AST_VALUE (src))
+    {
+      if (src->opval.val->sym)
+        dest->opval.val->sym = src->opval.val->sym;
+      return;
+    }
+
+  if (IS_AST_OP (src) && src->opval.op == FOR)
+    {
+      unrollShareSymbols (AST_FOR (dest, initExpr), AST_FOR (src, initExpr));
+      unrollShareSymbols (AST_FOR (dest, condExpr), AST_FOR (src, condExpr));
+      unrollShareSymbols (AST_FOR (dest, loopExpr), AST_FOR (src, loopExpr));
+    }
+
+  unrollShareSymbols (dest->left, src->left);
+  unrollShareSymbols (dest->right, src->right);
+}
+
+/*-----------------------------------------------------------------*/
+/* unrollCopyAst - copy a decorated tree for loop unrolling        */
+/*-----------------------------------------------------------------*/
+static ast *
+unrollCopyAst (ast * src)
+{
+  ast *dest = copyAst (src);
+
+  unrollShareSymbols (dest, src);
+  return dest;
+}
+
+/*-----------------------------------------------------------------*/
+/* unrollLoopCopies - build copies of the loop body, each followed */
+/*                    by the loop expression, except maybe the last */
+/*-----------------------------------------------------------------*/
+static ast *
+unrollLoopCopies (ast * body, ast * loopExpr, long copies, bool lastLoopExpr)
+{
+  ast *unrolled = NULL;
+  long i;
+
+  for (i = 0; i < copies; i++)
+    {
+      ast *piece = unrollCopyAst (body);
+
+      if (lastLoopExpr || i < copies - 1)
+        piece = newNode (NULLOP, piece, unrollCopyAst (loopExpr));
+      unrolled = unrolled ? newNode (NULLOP, unrolled, piece) : piece;
+    }
+
+  return unrolled;
+}
+
+/*-----------------------------------------------------------------*/
+/* unrollLoop - unroll a for loop with a constant trip count when  */
+/*              optimizing for speed. Returns the fully unrolled   */
+/*              tree, or NULL if the loop stays a loop, in which   */
+/*              case it might have been partially unrolled, with   */
+/*              the remaining iterations returned in *rest, to be  */
+/*              done ahead of the loop.                            */
+/*-----------------------------------------------------------------*/
+static ast *
+unrollLoop (ast * loop, ast ** rest)
+{
+  symbol *sym;
+  ast *init, *end;
+  long initval, endval, count, maxval;
+  int bodycost, budget, factor;
+  unsigned int bits;
+
+  *rest = NULL;
+
+  if (!optimize.codeSpeed || optimize.noLoopUnroll || !loop->left)
+    return NULL;
+
+  if (!isLoopCountable (AST_FOR (loop, initExpr), AST_FOR (loop, condExpr), AST_FOR (loop, loopExpr), &sym, &init, &end))
+    return NULL;
+
+  if (sym->addrtaken || !isUnrollableBody (loop->left, sym) || hasSEFcalls (AST_FOR (loop, condExpr)))
+    return NULL;
+
+  end = decorateType (copyAst (end), RESULT_TYPE_NONE);
+  if (!IS_AST_LIT_VALUE (init) || !IS_AST_LIT_VALUE (end))
+    return NULL;
+
+  initval = (long) floatFromVal (AST_VALUE (init));
+  endval = (long) floatFromVal (AST_VALUE (end));
+  count = endval - initval;
+  if (count <= 0)
+    return NULL;
+
+  /* The loop would never end if the bound is out of range of the counter, */
+  /* the counter wraps around before reaching it.                          */
+  bits = getSize (sym->type) * 8;
+  if (SPEC_USIGN (getSpec (sym->type)) && initval < 0)
+    return NULL;
+  if (bits < 32)
+    {
+      maxval = SPEC_USIGN (getSpec (sym->type)) ? (1l << bits) - 1 : (1l << (bits - 1)) - 1;
+      if (endval > maxval || initval < -maxval - 1)
+        return NULL;
+    }
+
+  bodycost = astCodeCost (loop->left) + astCodeCost (AST_FOR (loop, loopExpr));
+  budget = unrollBudget ();
+
+  /* Small loops are unrolled completely */
+  if (count <= 16 && count * bodycost <= budget)
+    return newNode (NULLOP, AST_FOR (loop, initExpr), unrollLoopCopies (loop->left, AST_FOR (loop, loopExpr), count, TRUE));
+
+  /* Otherwise unroll by a factor that fits half the budget, */
+  /* the remaining iterations are done ahead of the loop.   */
+  for (factor = 4; factor > 1; factor /= 2)
+    if (count >= 2 * factor && (factor + count % factor) * bodycost <= budget)
+      break;
+  if (factor <= 1 || factor * bodycost > budget / 2)
+    return NULL;
+
+  if (count % factor)
+    *rest = unrollLoopCopies (loop->left, AST_FOR (loop, loopExpr), count % factor, TRUE);
+
+  AST_FOR (loop, condExpr) = decorateType (newNode ('<', newAst_VALUE (symbolVal (sym)),
+                                                    newAst_VALUE (valCastLiteral (sym->type, endval, endval))),
+                                           RESULT_TYPE_NONE);
+  loop->left = unrollLoopCopies (loop->left, AST_FOR (loop, loopExpr), factor, FALSE);
+
+  return NULL;
+}
+
 /*-----------------------------------------------------------------*/
 /* createDoFor - creates parse tree for 'for' statement            */
 /*                                                                 */
@@ -5797,8 +6065,34 @@ decorateType (ast *tree, RESULT_TYPE resultType)
       {
         symbol *sym;
         ast *init, *end;
+        ast *rest = NULL;
 
         if (!AST_FOR (tree, continueLabel)->isref &&
+            !AST_FOR (tree, falseLabel)->isref)
+          {
+            ast *unrolled = unrollLoop (tree, &rest);
+
+            if (unrolled)
+              return decorateType (unrolled, RESULT_TYPE_NONE);
+          }
+
+        if (rest)
+          {
+            /* a partially unrolled loop, the remaining iterations */
+            /* go between the initialization and the loop, as the  */
+            /* break label follows the loop in the enclosing tree  */
+            tree = createFor (AST_FOR (tree, trueLabel),
+                              AST_FOR (tree, continueLabel),
+                              AST_FOR (tree, falseLabel),
+                              AST_FOR (tree, condLabel),
+                              newNode (NULLOP, AST_FOR (tree, initExpr), rest),
+                              AST_FOR (tree, condExpr),
+                              AST_FOR (tree, loopExpr),
+                              tree->left,
+                              tree->right);
+            return decorateType (tree, RESULT_TYPE_NONE);
+          }
+        else if (!AST_FOR (tree, continueLabel)->isref &&
             !AST_FOR (tree, falseLabel)->isref &&
             isLoopReversible (tree, &sym, &init, &end))
           return reverseLoop (tree, sym, init, end);
@@ -7277,7 +7571,7 @@ expandInlineFuncs (ast * tree, ast * block)
         werrorfl (tree->left->filename, tree->left->lineno, E_INVALID_CRITICAL);
 
       /* Is this an inline function that we can inline? */
-      if (IFFUNC_ISINLINE (func->type) && !IFFUNC_HASVARARGS(func->type) && func->funcTree)
+      if ((IFFUNC_ISINLINE (func->type) || func->autoInline) && !IFFUNC_HASVARARGS(func->type) && func->funcTree)
         {
           symbol *retsym = NULL;
           symbol *retlab;
@@ -7456,6 +7750,148 @@ expandInlineFuncs (ast * tree, ast * block)
     }
 }
 
+/*-----------------------------------------------------------------*/
+/* autoInlineBlocked - check if a function body contains anything  */
+/*                     that prevents automatic inlining            */
+/*-----------------------------------------------------------------*/
+static bool
+autoInlineBlocked (ast *tree)
+{
+  if (!tree || !IS_AST_OP (tree))
+    return FALSE;
+
+  /* Inline assembler might refer to parameters or labels by name */
+  if (tree->opval.op == INLINEASM)
+    return TRUE;
+
+  /* Static locals must not be duplicated into each caller */
+  if (tree->opval.op == BLOCK)
+    {
+      symbol *decls;
+
+      for (decls = tree->values.sym; decls; decls = decls->next)
+        if (IS_STATIC (decls->etype) || IS_EXTERN (decls->etype))
+          return TRUE;
+    }
+
+  if (tree->opval.op == FOR &&
+    (autoInlineBlocked (AST_FOR (tree, initExpr)) ||
+     autoInlineBlocked (AST_FOR (tree, condExpr)) ||
+     autoInlineBlocked (AST_FOR (tree, loopExpr))))
+    return TRUE;
+
+  return autoInlineBlocked (tree->left) || autoInlineBlocked (tree->right);
+}
+
+/*-----------------------------------------------------------------*/
+/* autoInlineCallCost - estimate the code size spent at each call  */
+/*                      site and in the callee for a regular call  */
+/*-----------------------------------------------------------------*/
+static int
+autoInlineCallCost (symbol *func)
+{
+  value *args;
+  int cost;
+  int parmsize = 0;
+  int retsize = 0;
+
+  /* call and return instructions */
+  cost = TARGET_PDK_LIKE ? 2 : 4;
+
+  for (args = FUNC_ARGS (func->type); args; args = args->next)
+    if (args->type)
+      parmsize += getSize (args->type);
+
+  if (func->type->next && !IS_VOID (func->type->next))
+    retsize = getSize (func->type->next);
+
+  /* Parameters are loaded by the caller and stored or received by */
+  /* the callee, on stack based ports the caller also cleans up.    */
+  cost += 2 * parmsize + retsize;
+  if (parmsize && (IFFUNC_ISREENT (func->type) || options.stackAuto))
+    cost += 2;
+
+  return cost;
+}
+
+/*-----------------------------------------------------------------*/
+/* autoInlineLocalSize - size of parameters and locals that would  */
+/*                       move into each caller                     */
+/*-----------------------------------------------------------------*/
+static int
+autoInlineLocalSize (ast *tree)
+{
+  symbol *decls;
+  int size = 0;
+
+  if (!tree || !IS_AST_OP (tree))
+    return 0;
+
+  if (tree->opval.op == BLOCK)
+    for (decls = tree->values.sym; decls; decls = decls->next)
+      size += getSize (decls->type);
+
+  return size + autoInlineLocalSize (tree->left) + autoInlineLocalSize (tree->right);
+}
+
+/*-----------------------------------------------------------------*/
+/* autoInlineCheck - decide if calls to a static function that was */
+/*                   not declared inline are inlined anyway        */
+/*-----------------------------------------------------------------*/
+static bool
+autoInlineCheck (symbol *func, ast *body)
+{
+  sym_link *type = func->type;
+  int bodycost, callcost, limit;
+  value *args;
+
+  if (!optimize.autoInline || !IS_STATIC (getSpec (type)))
+    return FALSE;
+
+  /* Attributes that only make sense for a real call */
+  if (IFFUNC_ISISR (type) || IFFUNC_ISNAKED (type) || IFFUNC_HASVARARGS (type) || IFFUNC_ISSHADOWREGS (type) ||
+    IFFUNC_ISZ88DK_FASTCALL (type) || IFFUNC_ISZ88DK_CALLEE (type) || IFFUNC_ISZ88DK_SHORTCALL (type) ||
+    IFFUNC_ISOVERLAY (type) || FUNC_REGBANK (type) || IFFUNC_ISBUILTIN (type) || IFFUNC_ISJAVANATIVE (type))
+    return FALSE;
+
+  if (autoInlineBlocked (body))
+    return FALSE;
+
+  bodycost = astCodeCost (body);
+  callcost = autoInlineCallCost (func);
+
+  /* On mcs51 the parameters and locals of a non-reentrant callee  */
+  /* can share overlayed data memory, once inlined they become     */
+  /* part of each caller, which might not be a leaf function.      */
+  if (TARGET_MCS51_LIKE && !IFFUNC_ISREENT (type) && !options.stackAuto)
+    {
+      int datasize = autoInlineLocalSize (body);
+
+      for (args = FUNC_ARGS (type); args; args = args->next)
+        if (args->type)
+          datasize += getSize (args->type);
+      bodycost += datasize;
+    }
+
+  if (optimize.autoInlineThreshold > 0)
+    limit = optimize.autoInlineThreshold;
+  else if (optimize.codeSize)
+    limit = callcost;
+  else if (optimize.codeSpeed)
+    limit = 4 * callcost;
+  else
+    limit = 2 * callcost;
+
+  /* With --opt-code-size, never accept a body larger than the call */
+  if (optimize.codeSize && limit > callcost)
+    limit = callcost;
+
+  if (options.dump_inline)
+    werrorfl (func->fileDef, func->lineDef, I_AUTO_INLINE, func->name, bodycost <= limit ? "is" : "is not", bodycost, callcost, limit);
+
+  return (bodycost <= limit);
+}
+
 /*------------------------------------------------------------*/
 /* createFunctionDecl - Handle all of a function declaration  */
 /*                      except for the function body.         */
@@ -7578,6 +8014,11 @@ createFunction (symbol * name, ast * body)
 
   if (FUNC_ISINLINE (name->type))
     name->funcTree = copyAst (body);
+  else if (autoInlineCheck (name, body))
+    {
+      name->funcTree = copyAst (body);
+      name->autoInline = 1;
+    }
 
   allocParms (FUNC_ARGS (name->type), IFFUNC_ISSMALLC (name->type));  /* allocate the parameters */
 
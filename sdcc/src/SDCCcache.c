@@ -0,0 +1,613 @@
+/*-------------------------------------------------------------------------
+  SDCCcache.c - compilation result cache
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   In other words, you are welcome to use, share and improve this program.
+   You are forbidden to forbid anyone else to use, share and improve
+   what you give them.   Help stamp out software-hoarding!
+-------------------------------------------------------------------------*/
+
+/* The cache maps a key to the files produced by one compiler run.  The
+   key is a hash over the preprocessed source, the complete command line,
+   the compiler version and the peephole rules in use.  Each entry is a
+   single file <key>.cache in the cache directory holding all outputs
+   (asm, rel, lst, sym, adb); the file "index" holds the size and last
+   use time of each entry and the hit / miss counters.  When the total
+   size of all entries exceeds the limit, the least recently used
+   entries are removed. */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <errno.h>
+#ifdef _WIN32
+#include <direct.h>
+#define cache_mkdir(path)     _mkdir (path)
+#else
+#define cache_mkdir(path)     mkdir ((path), 0777)
+#endif
+
+#include "common.h"
+#include "dbuf_string.h"
+#include "SDCCsystem.h"
+#include "SDCCcache.h"
+
+#define CACHE_MAGIC           "SDCC cache 1\n"
+#define CACHE_DEFAULT_SIZE    65536     /* kB */
+#define CACHE_KEY_LEN         32
+
+extern FILE *yyin;
+
+/* files stored in an entry */
+enum
+{
+  CACHE_ASM,
+  CACHE_REL,
+  CACHE_LST,
+  CACHE_SYM,
+  CACHE_ADB,
+  CACHE_NROLES
+};
+
+static const char *cacheRoles[CACHE_NROLES] = { "asm", "rel", "lst", "sym", "adb" };
+
+struct cacheEntry
+{
+  char key[CACHE_KEY_LEN + 1];
+  unsigned long size;           /* bytes */
+  unsigned long stamp;          /* time of last use */
+};
+
+struct cacheIndex
+{
+  unsigned long hits, misses, stores, evictions;
+  struct cacheEntry *entries;
+  int nEntries;
+};
+
+static struct
+{
+  bool enabled;
+  bool hit;
+  int ppStatus;                 /* exit status of the preprocessor */
+  const char *dir;
+  char key[CACHE_KEY_LEN + 1];
+  char *inputName;              /* copy of the preprocessed source on a miss */
+  char *outputs[CACHE_NROLES];
+  struct dbuf_s bundle;         /* contents of the entry on a hit */
+  time_t start;
+} cache;
+
+/*-----------------------------------------------------------------*/
+/* cacheHash - two independent 64 bit hashes, giving a 128 bit key */
+/*-----------------------------------------------------------------*/
+struct cacheHash
+{
+  unsigned long long a, b;
+};
+
+static void
+hashBytes (struct cacheHash *h, const void *buf, size_t len)
+{
+  const unsigned char *p = buf;
+
+  while (len--)
+    {
+      /* FNV-1a */
+      h->a = (h->a ^ *p) * 0x100000001b3ull;
+      /* multiply and fold, as in the MurmurHash3 finalizer */
+      h->b = (h->b ^ *p) * 0xff51afd7ed558ccdull;
+      h->b ^= h->b >> 33;
+      p++;
+    }
+}
+
+static void
+hashStr (struct cacheHash *h, const char *s)
+{
+  if (s)
+    hashBytes (h, s, strlen (s) + 1);
+  else
+    hashBytes (h, "", 1);
+}
+
+static void
+hashFile (struct cacheHash *h, const char *path)
+{
+  FILE *fp = fopen (path, "rb");
+  char buf[4096];
+  size_t n;
+
+  hashStr (h, path);
+  if (!fp)
+    return;
+  while ((n = fread (buf, 1, sizeof (buf), fp)) > 0)
+    hashBytes (h, buf, n);
+  fclose (fp);
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheUsable - check if the compilation may be cached            */
+/*-----------------------------------------------------------------*/
+static bool
+cacheUsable (void)
+{
+  if (options.c1mode || !fullSrcFileName)
+    return false;
+
+  /* ports with their own assembler driver write other outputs */
+  if (port->assembler.do_assemble || !port->linker.rel_ext)
+    return false;
+
+  /* the side effects of these would be lost on a hit */
+  if (options.dump_ast || options.dump_i_code || options.dump_graphs || options.dump_inline || options.dump_treewidth || options.cyclomatic)
+    return false;
+
+  cache.dir = options.cache_dir ? options.cache_dir : getenv ("SDCC_CACHE_DIR");
+  if (!cache.dir || !*cache.dir)
+    return false;
+
+  if (cache_mkdir (cache.dir) && errno != EEXIST)
+    {
+      if (options.verbose)
+        printf ("sdcc: cache directory %s not usable: %s\n", cache.dir, strerror (errno));
+      return false;
+    }
+
+  return true;
+}
+
+static char *
+cachePath (const char *name, const char *ext)
+{
+  struct dbuf_s path;
+
+  dbuf_init (&path, PATH_MAX);
+  dbuf_printf (&path, "%s%c%s%s", cache.dir, DIR_SEPARATOR_CHAR, name, ext);
+  return dbuf_detach_c_str (&path);
+}
+
+static char *
+outputName (const char *full, const char *ext)
+{
+  struct dbuf_s name;
+
+  if (full)
+    return Safe_strdup (full);
+
+  dbuf_init (&name, PATH_MAX);
+  dbuf_printf (&name, "%s%s", dstFileName, ext);
+  return dbuf_detach_c_str (&name);
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheOutputNames - the files written by this compilation, named */
+/*                    as in glue (), assemble () and initValues () */
+/*-----------------------------------------------------------------*/
+static void
+cacheOutputNames (void)
+{
+  cache.outputs[CACHE_ASM] = outputName (noAssemble && fullDstFileName ? fullDstFileName : NULL, port->assembler.file_ext);
+  if (!noAssemble)
+    {
+      cache.outputs[CACHE_REL] = outputName (options.cc_only && fullDstFileName ? fullDstFileName : NULL, port->linker.rel_ext);
+      cache.outputs[CACHE_LST] = outputName (NULL, ".lst");
+      cache.outputs[CACHE_SYM] = outputName (NULL, ".sym");
+    }
+  if (options.debug)
+    cache.outputs[CACHE_ADB] = outputName (NULL, ".adb");
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheParse - split an entry into its files; returns false if    */
+/*              the entry is damaged. With write set, the files    */
+/*              are restored.                                      */
+/*-----------------------------------------------------------------*/
+static bool
+cacheParse (bool write)
+{
+  const char *p = dbuf_c_str (&cache.bundle);
+  const char *end = p + dbuf_get_length (&cache.bundle);
+
+  if (dbuf_get_length (&cache.bundle) < strlen (CACHE_MAGIC) || memcmp (p, CACHE_MAGIC, strlen (CACHE_MAGIC)))
+    return false;
+  p += strlen (CACHE_MAGIC);
+
+  while (p < end)
+    {
+      char role[8];
+      unsigned long size;
+      int len, i;
+
+      if (sscanf (p, "%7s %lu%n", role, &size, &len) != 2 || p[len] != '\n' || size > (unsigned long) (end - p - len - 1))
+        return false;
+      p += len + 1;
+
+      for (i = 0; i < CACHE_NROLES; i++)
+        if (!strcmp (role, cacheRoles[i]))
+          break;
+      if (i == CACHE_NROLES)
+        return false;
+
+      if (write && cache.outputs[i])
+        {
+          FILE *fp = fopen (cache.outputs[i], "wb");
+
+          if (!fp)
+            {
+              werror (E_FILE_OPEN_ERR, cache.outputs[i]);
+              return false;
+            }
+          fwrite (p, 1, size, fp);
+          fclose (fp);
+        }
+      p += size;
+    }
+
+  return true;
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheLookup - hash the preprocessed source and look for a match */
+/*-----------------------------------------------------------------*/
+bool
+cacheLookup (int argc, char **argv)
+{
+  struct cacheHash h = { 0xcbf29ce484222325ull, 0x9e3779b97f4a7c15ull };
+  struct dbuf_s src;
+  char buf[4096];
+  size_t n;
+  int i;
+  FILE *fp;
+
+  if (!(cache.enabled = cacheUsable ()))
+    return false;
+
+  cache.start = time (NULL);
+
+  dbuf_init (&src, 65536);
+  while ((n = fread (buf, 1, sizeof (buf), yyin)) > 0)
+    dbuf_append (&src, buf, n);
+  cache.ppStatus = sdcc_pclose (yyin);
+
+  hashStr (&h, CACHE_MAGIC);
+  hashStr (&h, SDCC_VERSION_STR);
+  hashStr (&h, getBuildNumber ());
+  hashStr (&h, port->target);
+  for (i = 1; i < argc; i++)
+    hashStr (&h, argv[i]);
+  hashStr (&h, port->peep.default_rules);
+  if (options.peep_file)
+    hashFile (&h, options.peep_file);
+  hashBytes (&h, dbuf_get_buf (&src), dbuf_get_length (&src));
+  sprintf (cache.key, "%016llx%016llx", h.a, h.b);
+
+  cacheOutputNames ();
+
+  /* a failed preprocessor run is never looked up, the compiler reports the errors */
+  if (!cache.ppStatus)
+    {
+      char *name = cachePath (cache.key, ".cache");
+
+      if ((fp = fopen (name, "rb")) != NULL)
+        {
+          dbuf_init (&cache.bundle, 65536);
+          while ((n = fread (buf, 1, sizeof (buf), fp)) > 0)
+            dbuf_append (&cache.bundle, buf, n);
+          fclose (fp);
+          cache.hit = cacheParse (false);
+          if (!cache.hit)
+            dbuf_destroy (&cache.bundle);
+        }
+      Safe_free (name);
+    }
+
+  if (options.verbose)
+    printf ("sdcc: cache %s for %s\n", cache.hit ? "hit" : "miss", cache.key);
+
+  if (cache.hit)
+    {
+      dbuf_destroy (&src);
+      yyin = NULL;
+      return true;
+    }
+
+  /* hand a copy of the preprocessed source to the lexer */
+  cache.inputName = cachePath (cache.key, ".i");
+  if (!(yyin = fopen (cache.inputName, "w+b")))
+    {
+      perror (cache.inputName);
+      exit (EXIT_FAILURE);
+    }
+  fwrite (dbuf_get_buf (&src), 1, dbuf_get_length (&src), yyin);
+  rewind (yyin);
+  dbuf_destroy (&src);
+
+  return false;
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheCloseInput - close the lexer input                         */
+/*-----------------------------------------------------------------*/
+int
+cacheCloseInput (void)
+{
+  if (!cache.enabled)
+    return sdcc_pclose (yyin);
+
+  fclose (yyin);
+  remove (cache.inputName);
+  return cache.ppStatus;
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheReadIndex / cacheWriteIndex                                */
+/*-----------------------------------------------------------------*/
+static void
+cacheReadIndex (struct cacheIndex *idx)
+{
+  char *name = cachePath ("index", "");
+  FILE *fp = fopen (name, "r");
+  struct cacheEntry e;
+  int size = 0;
+
+  memset (idx, 0, sizeof (*idx));
+  Safe_free (name);
+  if (!fp)
+    return;
+
+  if (fscanf (fp, "stats %lu %lu %lu %lu\n", &idx->hits, &idx->misses, &idx->stores, &idx->evictions) != 4)
+    {
+      fclose (fp);
+      return;
+    }
+  while (fscanf (fp, "%32s %lu %lu\n", e.key, &e.size, &e.stamp) == 3)
+    {
+      if (idx->nEntries == size)
+        {
+          size = size ? size * 2 : 64;
+          idx->entries = Safe_realloc (idx->entries, size * sizeof (struct cacheEntry));
+        }
+      idx->entries[idx->nEntries++] = e;
+    }
+  fclose (fp);
+}
+
+static void
+cacheWriteIndex (const struct cacheIndex *idx)
+{
+  char *name = cachePath ("index", "");
+  char *tmpName = cachePath ("index.", cache.key);
+  FILE *fp = fopen (tmpName, "w");
+  int i;
+
+  if (fp)
+    {
+      fprintf (fp, "stats %lu %lu %lu %lu\n", idx->hits, idx->misses, idx->stores, idx->evictions);
+      for (i = 0; i < idx->nEntries; i++)
+        if (idx->entries[i].key[0])
+          fprintf (fp, "%s %lu %lu\n", idx->entries[i].key, idx->entries[i].size, idx->entries[i].stamp);
+      fclose (fp);
+#ifdef _WIN32
+      remove (name);
+#endif
+      rename (tmpName, name);
+    }
+  Safe_free (tmpName);
+  Safe_free (name);
+}
+
+static void
+cacheTouch (struct cacheIndex *idx, unsigned long size)
+{
+  int i;
+
+  for (i = 0; i < idx->nEntries; i++)
+    if (!strcmp (idx->entries[i].key, cache.key))
+      break;
+
+  if (i == idx->nEntries)
+    {
+      idx->entries = Safe_realloc (idx->entries, (idx->nEntries + 1) * sizeof (struct cacheEntry));
+      strcpy (idx->entries[idx->nEntries++].key, cache.key);
+    }
+  idx->entries[i].size = size;
+  idx->entries[i].stamp = (unsigned long) time (NULL);
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheEvict - remove least recently used entries until the total */
+/*              size is below the limit                            */
+/*-----------------------------------------------------------------*/
+static void
+cacheEvict (struct cacheIndex *idx)
+{
+  unsigned long long total = 0;
+  unsigned long long limit = (unsigned long long) (options.cache_size > 0 ? options.cache_size : CACHE_DEFAULT_SIZE) * 1024;
+  int i;
+
+  for (i = 0; i < idx->nEntries; i++)
+    total += idx->entries[i].size;
+
+  while (total > limit)
+    {
+      int oldest = -1;
+      char *name;
+
+      for (i = 0; i < idx->nEntries; i++)
+        if (idx->entries[i].key[0] && (oldest < 0 || idx->entries[i].stamp < idx->entries[oldest].stamp))
+          oldest = i;
+      if (oldest < 0)
+        break;
+
+      name = cachePath (idx->entries[oldest].key, ".cache");
+      remove (name);
+      Safe_free (name);
+      total -= idx->entries[oldest].size;
+      idx->entries[oldest].key[0] = '\0';
+      idx->evictions++;
+    }
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheStore - bundle the outputs of a successful compilation     */
+/*-----------------------------------------------------------------*/
+static unsigned long
+cacheStore (void)
+{
+  struct dbuf_s bundle;
+  char *name, *tmpName;
+  unsigned long size = 0;
+  FILE *fp;
+  int i;
+
+  dbuf_init (&bundle, 65536);
+  dbuf_append_str (&bundle, CACHE_MAGIC);
+
+  for (i = 0; i < CACHE_NROLES; i++)
+    {
+      struct dbuf_s file;
+      struct stat st;
+      char buf[4096];
+      size_t n;
+
+      if (!cache.outputs[i])
+        continue;
+
+      /* leftovers from an earlier run with other options are not ours */
+      if (stat (cache.outputs[i], &st) || st.st_mtime < cache.start)
+        {
+          if (i == CACHE_ASM || i == CACHE_REL)
+            {
+              dbuf_destroy (&bundle);
+              return 0;
+            }
+          continue;
+        }
+
+      if (!(fp = fopen (cache.outputs[i], "rb")))
+        continue;
+      dbuf_init (&file, st.st_size + 1);
+      while ((n = fread (buf, 1, sizeof (buf), fp)) > 0)
+        dbuf_append (&file, buf, n);
+      fclose (fp);
+
+      dbuf_printf (&bundle, "%s %lu\n", cacheRoles[i], (unsigned long) dbuf_get_length (&file));
+      dbuf_append (&bundle, dbuf_get_buf (&file), dbuf_get_length (&file));
+      dbuf_destroy (&file);
+    }
+
+  name = cachePath (cache.key, ".cache");
+  tmpName = cachePath (cache.key, ".tmp");
+  if ((fp = fopen (tmpName, "wb")) != NULL)
+    {
+      if (fwrite (dbuf_get_buf (&bundle), 1, dbuf_get_length (&bundle), fp) == dbuf_get_length (&bundle))
+        size = dbuf_get_length (&bundle);
+      fclose (fp);
+#ifdef _WIN32
+      remove (name);
+#endif
+      if (!size || rename (tmpName, name))
+        {
+          remove (tmpName);
+          size = 0;
+        }
+    }
+  Safe_free (tmpName);
+  Safe_free (name);
+  dbuf_destroy (&bundle);
+
+  return size;
+}
+
+/*-----------------------------------------------------------------*/
+/* cacheFinish - restore or store the outputs, update the index    */
+/*-----------------------------------------------------------------*/
+void
+cacheFinish (void)
+{
+  struct cacheIndex idx;
+  int i;
+
+  if (!cache.enabled)
+    return;
+
+  cacheReadIndex (&idx);
+
+  if (cache.hit)
+    {
+      if (!cacheParse (true))
+        fatalError++;
+      idx.hits++;
+      cacheTouch (&idx, dbuf_get_length (&cache.bundle));
+      dbuf_destroy (&cache.bundle);
+    }
+  else
+    {
+      unsigned long size;
+
+      idx.misses++;
+      /* diagnostics are not replayed on a hit, so only silent compilations are stored */
+      if (!fatalError && !_SDCCERRG.reported && (size = cacheStore ()) != 0)
+        {
+          idx.stores++;
+          cacheTouch (&idx, size);
+        }
+    }
+
+  cacheEvict (&idx);
+  cacheWriteIndex (&idx);
+
+  Safe_free (idx.entries);
+  for (i = 0; i < CACHE_NROLES; i++)
+    Safe_free (cache.outputs[i]);
+  Safe_free (cache.inputName);
+}
+
+/*-----------------------------------------------------------------*/
+/* cachePrintStats - print the counters of the cache directory     */
+/*-----------------------------------------------------------------*/
+void
+cachePrintStats (void)
+{
+  struct cacheIndex idx;
+  unsigned long long total = 0;
+  int i, n = 0;
+
+  cache.dir = options.cache_dir ? options.cache_dir : getenv ("SDCC_CACHE_DIR");
+  if (!cache.dir || !*cache.dir)
+    {
+      printf ("cache: not enabled\n");
+      return;
+    }
+
+  cacheReadIndex (&idx);
+  for (i = 0; i < idx.nEntries; i++)
+    {
+      total += idx.entries[i].size;
+      n++;
+    }
+
+  printf ("cache directory: %s\n", cache.dir);
+  printf ("cache hits:      %lu\n", idx.hits);
+  printf ("cache misses:    %lu\n", idx.misses);
+  printf ("entries stored:  %lu\n", idx.stores);
+  printf ("entries evicted: %lu\n", idx.evictions);
+  printf ("entries:         %d (%llu kB of %d kB)\n", n, (total + 1023) / 1024,
+          options.cache_size > 0 ? options.cache_size : CACHE_DEFAULT_SIZE);
+
+  Safe_free (idx.entries);
+}
@@ -0,0 +1,51 @@
+/*-------------------------------------------------------------------------
+  SDCCcache.h - compilation result cache
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by the
+   Free Software Foundation; either version 2, or (at your option) any
+   later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+
+   In other words, you are welcome to use, share and improve this program.
+   You are forbidden to forbid anyone else to use, share and improve
+   what you give them.   Help stamp out software-hoarding!
+-------------------------------------------------------------------------*/
+
+#ifndef SDCCCACHE_H
+#define SDCCCACHE_H
+
+#include <stdbool.h>
+
+/** Reads the preprocessor output from yyin and looks up the result of a
+ *  previous compilation with identical input, options and compiler.
+ *  Returns true on a hit; the outputs are restored by cacheFinish().
+ *  On a miss yyin is replaced by a temporary copy of the preprocessed
+ *  source, to be closed with cacheCloseInput() after parsing.
+ *  Does nothing and returns false if the cache is not enabled.
+ */
+bool cacheLookup (int argc, char **argv);
+
+/** Closes yyin as opened by preProcess() or cacheLookup().
+ *  Returns non-zero if the preprocessor failed.
+ */
+int cacheCloseInput (void);
+
+/** Restores the outputs on a hit, stores them after a successful
+ *  compilation on a miss, and evicts old entries.
+ */
+void cacheFinish (void);
+
+/** Prints the hit / miss statistics of the cache directory.
+ */
+void cachePrintStats (void);
+
+#endif
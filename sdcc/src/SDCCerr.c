@@ -561,6 +561,12 @@ struct
     "invalid value for __z88dk_shortcall %s parameter: %x", 0},
   { E_DUPLICATE_PARAMTER_NAME, ERROR_LEVEL_ERROR,
     "duplicate parameter name %s for function %s", 0},
+  { I_AUTO_INLINE, ERROR_LEVEL_INFO,
+    "function '%s' %s automatically inlined (estimated cost %d, call overhead %d, limit %d)", 0},
+  { E_BAD_TREE_DEC, ERROR_LEVEL_ERROR,
+    "unknown tree-decomposition heuristic '%s', use thorup, min-degree, min-fill or best", 0},
+  { I_TREEWIDTH, ERROR_LEVEL_INFO,
+    "tree-decomposition for %s in function '%s': width %u (%s), %u nodes, %u bags, average bag size %.1f", 0},
 };
 
 /* -------------------------------------------------------------------------------
@@ -614,6 +620,7 @@ vwerror (int errNum, va_list marker)
     {
       if (ErrTab[errNum].errType >= ERROR_LEVEL_ERROR || _SDCCERRG.werror)
         fatalError++;
+      _SDCCERRG.reported++;
 
       if (filename && lineno)
         {
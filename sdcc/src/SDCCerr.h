@@ -276,6 +276,9 @@ enum {
   E_DECL_AFTER_STATEMENT_C99    = 247, /* declaration after statement requires ISO C99 or later */
   E_SHORTCALL_INVALID_VALUE     = 248, /* Invalid value for a __z88dk_shortcall specifier */
   E_DUPLICATE_PARAMTER_NAME     = 249, /* duplicate parameter name */
+  I_AUTO_INLINE                 = 250, /* automatic inlining decision */
+  E_BAD_TREE_DEC                = 251, /* unknown tree-decomposition heuristic */
+  I_TREEWIDTH                   = 252, /* width of tree-decomposition */
 
   /* don't touch this! */
   NUMBER_OF_ERROR_MESSAGES             /* Number of error messages */
@@ -324,6 +327,7 @@ struct SDCCERRG {
   FILE *out;
   int style;                        /* 1=MSVC */
   int werror;                       /* treat the warnings as errors */
+  int reported;                     /* number of messages printed */
 };
 
 extern struct SDCCERRG _SDCCERRG;
@@ -353,3 +353,30 @@ ifxForOp (operand * op, const iCode * ic)
 
   return NULL;
 }
+
+/*-----------------------------------------------------------------*/
+/* dryRunByteWeight - number of cycles one byte of code is worth   */
+/*                    to the register allocator: the value of      */
+/*                    --opt-code-tradeoff or, if that is not       */
+/*                    given, derived from --opt-code-speed/size.   */
+/*-----------------------------------------------------------------*/
+unsigned int
+dryRunByteWeight (void)
+{
+  if (optimize.codeTradeoff > 0)
+    return optimize.codeTradeoff;
+
+  return (2 << (optimize.codeSize * 3 + !optimize.codeSpeed * 3));
+}
+
+/*-----------------------------------------------------------------*/
+/* dryRunCost - combine the code size and the cycle count of a     */
+/*              code generation dry run into a single cost, in     */
+/*              cycles. The cycles are weighted by the estimated   */
+/*              execution count of the iCode.                      */
+/*-----------------------------------------------------------------*/
+float
+dryRunCost (unsigned int bytes, float cycles, const iCode *ic)
+{
+  return ((float)bytes * dryRunByteWeight () + cycles * ic->count);
+}
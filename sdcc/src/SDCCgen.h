@@ -97,6 +97,8 @@ void emitLabel (symbol * tlbl);
 void genInline (iCode * ic);
 void printLine (lineNode *, struct dbuf_s *);
 iCode *ifxForOp (operand *op, const iCode *ic);
+unsigned int dryRunByteWeight (void);
+float dryRunCost (unsigned int bytes, float cycles, const iCode *ic);
 
 #ifdef __cplusplus
 }
@@ -205,11 +205,15 @@ struct optimize
     int loopInvariant;
     int loopInduction;
     int noLoopReverse;
+    int noLoopUnroll;
     int codeSpeed;
     int codeSize;
+    int codeTradeoff;           /* cycles one byte of code is worth in the register allocator cost, 0 = derive from codeSpeed/codeSize */
     int lospre;
     int allow_unsafe_read;
     int noStdLibCall;
+    int autoInline;             /* inline small static functions without an explicit inline */
+    int autoInlineThreshold;    /* upper bound for the estimated cost of an automatically inlined body, 0 = derive from call overhead */
   };
 
 /** Build model.
@@ -236,6 +240,16 @@ typedef struct {
     char *funcs[128];   /* function name that belong to this */
 } olay;
 
+/** Heuristic for the tree-decompositions used by the register allocators,
+    lospre and the named address space optimization. */
+enum
+  {
+    TREE_DEC_THORUP = 0,
+    TREE_DEC_MIN_DEGREE,
+    TREE_DEC_MIN_FILL,
+    TREE_DEC_BEST      /* the one of smallest width */
+  };
+
 enum
   {
     NO_DEPENDENCY_FILE_OPT = 0,
@@ -257,6 +271,8 @@ struct options
     int dump_ast;               /* dump front-end tree before lowering to iCode */
     int dump_i_code;            /* dump iCode at various stages */
     int dump_graphs;            /* Dump graphs in .dot format (control-flow, conflict, etc) */
+    int dump_inline;            /* report automatic inlining decisions */
+    int dump_treewidth;         /* report width of tree-decompositions */
     int cc_only;                /* compile only flag              */
     int intlong_rent;           /* integer & long support routines reentrant */
     int float_rent;             /* floating point routines are reentrant */
@@ -321,11 +337,15 @@ struct options
     char *const_seg;            /* segment name to use instead of CONST */
     char *data_seg;             /* segment name to use instead of DATA */
     int dependencyFileOpt;      /* write dependencies to given file */
+    char *cache_dir;            /* directory of the compilation result cache */
+    int cache_size;             /* size limit of the cache in kB */
+    int cache_stats;            /* print cache statistics */
     /* sets */
     set *calleeSavesSet;        /* list of functions using callee save */
     set *excludeRegsSet;        /* registers excluded from saving */
 /*  set *olaysSet;               * not implemented yet: overlay segments used in #pragma OVERLAY */
     int max_allocs_per_node;    /* Maximum number of allocations / combinations considered at each node in the tree-decomposition based algorithms */
+    int tree_decomposition;     /* see TREE_DEC_* */
     bool noOptsdccInAsm;        /* Do not emit .optsdcc in asm */
     bool oldralloc;             /* Use old register allocator */
   };
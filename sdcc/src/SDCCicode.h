@@ -147,6 +147,7 @@ typedef struct iCode
   unsigned regsSaved:1;         /* registers have been saved */
   unsigned bankSaved:1;         /* register bank has been saved */
   unsigned builtinSEND:1;       /* SEND for parameter of builtin function */
+  unsigned tailCall:1;          /* call in tail position, ports may emit a jump instead */
 
   struct iCode *next;           /* next in chain */
   struct iCode *prev;           /* previous in chain */
@@ -316,7 +316,7 @@ lospre (iCode *sic, ebbIndex *ebbi)
   if(options.dump_graphs)
     dump_cfg_lospre(control_flow_graph);
 
-  get_nice_tree_decomposition (tree_decomposition, control_flow_graph);
+  get_nice_tree_decomposition (tree_decomposition, control_flow_graph, "lospre");
 
   if(options.dump_graphs)
     dump_dec_lospre(tree_decomposition);
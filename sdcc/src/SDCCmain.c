@@ -36,6 +36,7 @@
 #include "SDCCerr.h"
 #include "SDCCmacro.h"
 #include "SDCCargs.h"
+#include "SDCCcache.h"
 
 #ifdef _WIN32
 #include <process.h>
@@ -147,11 +148,20 @@ char buffer[PATH_MAX * 2];
 #define OPTION_NO_PEEP_RETURN       "--no-peep-return"
 #define OPTION_NO_OPTSDCC_IN_ASM    "--no-optsdcc-in-asm"
 #define OPTION_MAX_ALLOCS_PER_NODE  "--max-allocs-per-node"
+#define OPTION_TREE_DECOMPOSITION   "--tree-decomposition"
 #define OPTION_NO_LOSPRE            "--nolospre"
 #define OPTION_ALLOW_UNSAFE_READ    "--allow-unsafe-read"
 #define OPTION_DUMP_AST             "--dump-ast"
 #define OPTION_DUMP_I_CODE          "--dump-i-code"
 #define OPTION_DUMP_GRAPHS          "--dump-graphs"
+#define OPTION_DUMP_INLINE          "--dump-inline"
+#define OPTION_DUMP_TREEWIDTH       "--dump-treewidth"
+#define OPTION_AUTO_INLINE          "--auto-inline"
+#define OPTION_AUTO_INLINE_THRESHOLD "--auto-inline-threshold"
+#define OPTION_OPT_CODE_TRADEOFF    "--opt-code-tradeoff"
+#define OPTION_CACHE_DIR            "--cache-dir"
+#define OPTION_CACHE_SIZE           "--cache-size"
+#define OPTION_CACHE_STATS          "--cache-stats"
 
 #define OPTION_SMALL_MODEL          "--model-small"
 #define OPTION_MEDIUM_MODEL         "--model-medium"
@@ -198,6 +208,9 @@ static const OPTION optionsTable[] = {
   {0,   OPTION_DOLLARS_IN_IDENT, &options.dollars_in_ident, "Permit '$' as an identifier character"},
   {0,   OPTION_SIGNED_CHAR, &options.signed_char, "Make \"char\" signed by default"},
   {0,   OPTION_USE_NON_FREE, &options.use_non_free, "Search / include non-free licensed libraries and header files"},
+  {0,   OPTION_CACHE_DIR, &options.cache_dir, "<dir> Reuse results of identical compilations stored in this directory", CLAT_STRING},
+  {0,   OPTION_CACHE_SIZE, &options.cache_size, "<nnnn> Size limit of the compilation cache in kB (default 65536)", CLAT_INTEGER},
+  {0,   OPTION_CACHE_STATS, &options.cache_stats, "Print compilation cache statistics"},
 
   {0,   NULL, NULL, "Code generation options"},
   {'m', NULL, NULL, "Set the port to use e.g. -mz80."},
@@ -226,6 +239,7 @@ static const OPTION optionsTable[] = {
   {0,   OPTION_NO_LOOP_INV, NULL, "Disable optimisation of invariants"},
   {0,   OPTION_NO_LOOP_IND, NULL, "Disable loop variable induction"},
   {0,   "--noloopreverse", &optimize.noLoopReverse, "Disable the loop reverse optimisation"},
+  {0,   "--noloopunroll", &optimize.noLoopUnroll, "Disable loop unrolling with --opt-code-speed"},
   {0,   "--no-peep", &options.nopeep, "Disable the peephole assembly file optimisation"},
   {0,   "--no-reg-params", &options.noRegParams, "On some ports, disable passing some parameters in registers"},
   {0,   "--peep-asm", &options.asmpeep, "Enable peephole optimization on inline assembly"},
@@ -234,15 +248,21 @@ static const OPTION optionsTable[] = {
   {0,   OPTION_PEEP_FILE, &options.peep_file, "<file> use this extra peephole file", CLAT_STRING},
   {0,   OPTION_OPT_CODE_SPEED, NULL, "Optimize for code speed rather than size"},
   {0,   OPTION_OPT_CODE_SIZE, NULL, "Optimize for code size rather than speed"},
+  {0,   OPTION_OPT_CODE_TRADEOFF, &optimize.codeTradeoff, "<nnnn> Number of cycles one byte of code is worth to the register allocator", CLAT_INTEGER},
   {0,   OPTION_MAX_ALLOCS_PER_NODE, &options.max_allocs_per_node, "Maximum number of register assignments considered at each node of the tree decomposition", CLAT_INTEGER},
+  {0,   OPTION_TREE_DECOMPOSITION, NULL, "<heuristic> Tree decomposition heuristic: thorup (default), min-degree, min-fill or best"},
   {0,   OPTION_NO_LOSPRE, NULL, "Disable lospre"},
   {0,   OPTION_ALLOW_UNSAFE_READ, NULL, "Allow optimizations to read any memory location anytime"},
   {0,   "--nostdlibcall", &optimize.noStdLibCall, "Disable optimization of calls to standard library"},
+  {0,   OPTION_AUTO_INLINE, &optimize.autoInline, "Inline small static functions automatically"},
+  {0,   OPTION_AUTO_INLINE_THRESHOLD, &optimize.autoInlineThreshold, "<nnnn> Maximum estimated cost of an automatically inlined function", CLAT_INTEGER},
 
   {0,   NULL, NULL, "Internal debugging options"},
   {0,   OPTION_DUMP_AST, &options.dump_ast, "Dump front-end AST before generating i-code"},
   {0,   OPTION_DUMP_I_CODE, &options.dump_i_code, "Dump the i-code structure at all stages"},
   {0,   OPTION_DUMP_GRAPHS, &options.dump_graphs, "Dump graphs (control-flow, conflict, etc)"},
+  {0,   OPTION_DUMP_INLINE, &options.dump_inline, "Report automatic inlining decisions"},
+  {0,   OPTION_DUMP_TREEWIDTH, &options.dump_treewidth, "Report the width of the tree decompositions"},
   {0,   OPTION_ICODE_IN_ASM, &options.iCodeInAsm, "Include i-code as comments in the asm file"},
   {0,   OPTION_VERBOSE_ASM, &options.verboseAsm, "Include code generator comments in the asm output"},
 
@@ -1275,6 +1295,23 @@ parseCmdLine (int argc, char **argv)
               continue;
             }
 
+          if (strcmp (argv[i], OPTION_TREE_DECOMPOSITION) == 0)
+            {
+              const char *heuristic = getStringArg (OPTION_TREE_DECOMPOSITION, argv, &i, argc);
+
+              if (!strcmp (heuristic, "thorup"))
+                options.tree_decomposition = TREE_DEC_THORUP;
+              else if (!strcmp (heuristic, "min-degree"))
+                options.tree_decomposition = TREE_DEC_MIN_DEGREE;
+              else if (!strcmp (heuristic, "min-fill"))
+                options.tree_decomposition = TREE_DEC_MIN_FILL;
+              else if (!strcmp (heuristic, "best"))
+                options.tree_decomposition = TREE_DEC_BEST;
+              else
+                werror (E_BAD_TREE_DEC, heuristic);
+              continue;
+            }
+
           if (strcmp (argv[i], OPTION_PEEP_RETURN) == 0)
             {
               options.peepReturn = 1;
@@ -2626,7 +2663,9 @@ main (int argc, char **argv, char **envp)
   /* if no input then printUsage & exit */
   if (!options.c1mode && !fullSrcFileName && peekSet (relFilesSet) == NULL)
     {
-      if (options.printSearchDirs)
+      if (options.cache_stats)
+        cachePrintStats ();
+      if (options.printSearchDirs || options.cache_stats)
         exit (EXIT_SUCCESS);
       printUsage (TRUE);
       exit (EXIT_FAILURE);
@@ -2645,9 +2684,10 @@ main (int argc, char **argv, char **envp)
   finalizeOptions ();
 
   if (fullSrcFileName || options.c1mode)
-    {
-      preProcess (envp);
+    preProcess (envp);
 
+  if ((fullSrcFileName || options.c1mode) && !cacheLookup (argc, argv))
+    {
       initSymt ();
       initiCode ();
       initCSupport ();
@@ -2660,7 +2700,7 @@ main (int argc, char **argv, char **envp)
       yyparse ();
 
       if (!options.c1mode)
-        if (sdcc_pclose (yyin))
+        if (cacheCloseInput ())
           fatalError = 1;
 
       if (fatalError)
@@ -2691,6 +2731,10 @@ main (int argc, char **argv, char **envp)
   if (options.debug && debugFile)
     debugFile->closeFile ();
 
+  cacheFinish ();
+  if (options.cache_stats)
+    cachePrintStats ();
+
   if (!options.cc_only && !fatalError && !noAssemble && !options.c1mode && (fullSrcFileName || peekSet (relFilesSet) != NULL))
     {
       if (options.verbose)
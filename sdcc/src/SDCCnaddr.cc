@@ -70,7 +70,7 @@ switchAddressSpacesOptimally (iCode *ic, ebbIndex *ebbi)
   if(options.dump_graphs)
     dump_cfg_naddr(control_flow_graph);
 
-  get_nice_tree_decomposition (tree_decomposition, control_flow_graph);
+  get_nice_tree_decomposition (tree_decomposition, control_flow_graph, "bank selection");
 
   if(options.dump_graphs)
     dump_tree_decomposition_naddr(tree_decomposition);
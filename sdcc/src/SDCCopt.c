@@ -3045,6 +3045,80 @@ narrowReads(ebbIndex *ebbi)
     }
 }
 
+/*-----------------------------------------------------------------*/
+/* tailCallPosition - check if a call is directly followed by a    */
+/*                    return of its result, or of nothing at all   */
+/*-----------------------------------------------------------------*/
+static bool
+tailCallPosition (const iCode *ic)
+{
+  const iCode *ric = ic->next;
+  sym_link *ftype;
+
+  if (!ric || ric->op != RETURN)
+    return FALSE;
+
+  ftype = operandType (IC_LEFT (ic));
+  if (IS_FUNCPTR (ftype))
+    ftype = ftype->next;
+
+  if (IFFUNC_ISBUILTIN (ftype) || IFFUNC_ISBANKEDCALL (ftype))
+    return FALSE;
+
+  /* setjmp () would save a return address into a frame that no longer */
+  /* exists, longjmp () is implemented relative to its own return.     */
+  if (ic->op == CALL && !IS_LITERAL (getSpec (ftype)) &&
+    (!strcmp (OP_SYMBOL (IC_LEFT (ic))->name, "__setjmp") || !strcmp (OP_SYMBOL (IC_LEFT (ic))->name, "longjmp")))
+    return FALSE;
+
+  if (!IC_LEFT (ric))
+    return TRUE;
+
+  /* The result has to be passed on unchanged. */
+  return (IC_RESULT (ic) && isOperandEqual (IC_RESULT (ic), IC_LEFT (ric)) &&
+    getSize (ftype->next) == getSize (currFunc->type->next) && !IS_STRUCT (ftype->next));
+}
+
+/*-----------------------------------------------------------------*/
+/* markTailCalls - mark calls in tail position, the ports decide   */
+/*                 if they can replace them by a jump              */
+/*-----------------------------------------------------------------*/
+static void
+markTailCalls (ebbIndex *ebbi)
+{
+  sym_link *type;
+
+  /* Initialization code for absolute variables is not in a function. */
+  if (!currFunc)
+    return;
+
+  type = currFunc->type;
+
+  /* The caller's own epilogue is needed for these. */
+  if (IFFUNC_ISISR (type) || IFFUNC_ISCRITICAL (type) || IFFUNC_ISNAKED (type) || IFFUNC_ISBANKEDCALL (type) || options.profile)
+    return;
+
+  for (int i = 0; i < ebbi->count; i++)
+    {
+      eBBlock *ebp = ebbi->bbOrder[i];
+
+      for (iCode *ic = ebp->sch; ic; ic = ic->next)
+        if (ic->op == CALL || ic->op == PCALL)
+          ic->tailCall = tailCallPosition (ic);
+    }
+}
+
+/*-----------------------------------------------------------------*/
+/* isTailCall - for the code generators: check if a call has been  */
+/*              marked as tail call and still is one after         */
+/*              register allocation                                */
+/*-----------------------------------------------------------------*/
+bool
+isTailCall (const iCode *ic)
+{
+  return (ic->tailCall && tailCallPosition (ic));
+}
+
 /*-----------------------------------------------------------------*/
 /* eBBlockFromiCode - creates extended basic blocks from iCode     */
 /*                    will return an array of eBBlock pointers     */
@@ -3305,6 +3379,8 @@ eBBlockFromiCode (iCode *ic)
 
   narrowReads(ebbi);
 
+  markTailCalls (ebbi);
+
   /* allocate registers & generate code */
   port->assignRegisters (ebbi);
 
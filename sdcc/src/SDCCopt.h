@@ -39,5 +39,6 @@ const symbol *getAddrspaceiCode (const iCode *ic);
 void switchAddressSpaceAt (iCode *ic, const symbol *const addrspace);
 bool isPowerOf2 (unsigned long val);
 void guessCounts (iCode *start_ic, ebbIndex *ebbi);
+bool isTailCall (const iCode *ic);
 
 #endif
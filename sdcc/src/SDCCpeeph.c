@@ -29,9 +29,8 @@
 static peepRule *rootRules = NULL;
 static peepRule *currRule = NULL;
 
-#define HTAB_SIZE 53
-
 hTab *labelHash = NULL;
+unsigned long peepLineListVersion = 0;
 
 static struct
 {
@@ -39,7 +38,6 @@ static struct
   allocTrace labels;
 } _G;
 
-static int hashSymbolName (const char *name);
 static void buildLabelRefCountHash (lineNode * head);
 static void bindVar (int key, char **s, hTab ** vtab);
 
@@ -2350,6 +2348,8 @@ replaceRule (lineNode ** shead, lineNode * stail, peepRule * pr)
   char *lbp;
   lineNode *comment = NULL;
 
+  peepLineListVersion++;
+
   /* collect all the comment lines in the source */
   for (cl = *shead; cl != stail; cl = cl->next)
     {
@@ -2525,7 +2525,7 @@ isLabelReference (const char *line, const char **start, int *len)
 }
 
 /* Quick & dirty string hash function. */
-static int
+int
 hashSymbolName (const char *name)
 {
   int hash = 0;
@@ -2671,6 +2671,8 @@ peepHole (lineNode ** pls)
 
   assert(labelHash == NULL);
 
+  peepLineListVersion++;
+
   do
     {
       restart = FALSE;
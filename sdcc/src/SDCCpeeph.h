@@ -25,6 +25,7 @@
 #include "SDCCgen.h"
 
 #define MAX_PATTERN_LEN 256
+#define HTAB_SIZE 53
 
 typedef struct peepRule
   {
@@ -53,6 +54,11 @@ bool isLabelDefinition (const char *line, const char **start, int *len,
 
 extern hTab *labelHash;
 labelHashEntry *getLabelRef (const char *label, lineNode *head);
+int hashSymbolName (const char *name);
+
+/* Changes whenever the peephole optimizer edits the line list, so
+   that ports can keep analyses of it between rule conditions. */
+extern unsigned long peepLineListVersion;
 
 void initPeepHole (void);
 void peepHole (lineNode **);
@@ -322,6 +322,7 @@ typedef struct symbol
   unsigned isreqv:1;                /* is the register equivalent of a symbol */
   unsigned udChked:1;               /* use def checking has been already done */
   unsigned generated:1;             /* code generated (function symbols only) */
+  unsigned autoInline:1;            /* calls may be inlined automatically (function symbols only) */
   unsigned isinscope:1;             /* is in scope */
 
   /* following flags are used by the backend
@@ -41,6 +41,9 @@
 // void thorup_elimination_ordering(l_t &l, const J_t &J)
 // Creates an elimination ordering l of a graph J using Thorup's heuristic.
 //
+// void greedy_elimination_ordering(l_t &l, const G_t &G, bool min_fill)
+// Creates an elimination ordering l of a graph G using the min-degree or min-fill-in heuristic.
+//
 
 #include <map>
 #include <vector>
@@ -285,6 +288,103 @@ void thorup_tree_decomposition(T_t &tree_decomposition, const G_t &cfg)
   tree_decomposition_from_elimination_ordering(tree_decomposition, elimination_ordering, cfg);
 }
 
+// Number of edges that need to be added to make the neighbourhood of v a clique.
+inline unsigned int fill_in(const std::vector<std::set<unsigned int> > &adj, unsigned int v)
+{
+  unsigned int fill = 0;
+  std::set<unsigned int>::const_iterator n1, n2;
+  for (n1 = adj[v].begin(); n1 != adj[v].end(); ++n1)
+    for (n2 = n1, ++n2; n2 != adj[v].end(); ++n2)
+      if (adj[*n1].find(*n2) == adj[*n1].end())
+        fill++;
+  return(fill);
+}
+
+// Greedy elimination ordering for the undirected graph underlying G.
+// In each step the vertex of minimum degree (or minimum fill-in if min_fill is set) is eliminated,
+// i.e. its neighbours are made a clique and it is removed from the graph.
+// Ties are broken by the smaller vertex index, so the result is deterministic.
+// Complexity: O(n d^2 log n) for min-degree, O(n d^4 log n) for min-fill-in, where d is the maximum degree during elimination.
+template <class l_t, class G_t>
+void greedy_elimination_ordering(l_t &l, const G_t &G, bool min_fill)
+{
+  const unsigned int n = boost::num_vertices(G);
+  std::vector<std::set<unsigned int> > adj(n);
+  std::vector<unsigned int> cost(n);
+  std::set<std::pair<unsigned int, unsigned int> > queue;
+
+  typename boost::graph_traits<G_t>::edge_iterator e, e_end;
+  for (boost::tie(e, e_end) = boost::edges(G); e != e_end; ++e)
+    if (boost::source(*e, G) != boost::target(*e, G))
+      {
+        adj[boost::source(*e, G)].insert(boost::target(*e, G));
+        adj[boost::target(*e, G)].insert(boost::source(*e, G));
+      }
+
+  for (unsigned int v = 0; v < n; v++)
+    {
+      cost[v] = min_fill ? fill_in(adj, v) : adj[v].size();
+      queue.insert(std::make_pair(cost[v], v));
+    }
+
+  while (!queue.empty())
+    {
+      const unsigned int v = queue.begin()->second;
+      queue.erase(queue.begin());
+
+      const std::set<unsigned int> neighbours(adj[v]);
+      adj[v].clear();
+
+      std::set<unsigned int> changed;
+      std::set<unsigned int>::const_iterator n1, n2;
+      for (n1 = neighbours.begin(); n1 != neighbours.end(); ++n1)
+        {
+          adj[*n1].erase(v);
+          for (n2 = neighbours.begin(); n2 != neighbours.end(); ++n2)
+            if (*n1 != *n2)
+              adj[*n1].insert(*n2);
+          changed.insert(*n1);
+          // The fill-in of a vertex depends on the edges between its neighbours, too.
+          if (min_fill)
+            changed.insert(adj[*n1].begin(), adj[*n1].end());
+        }
+
+      for (n1 = changed.begin(); n1 != changed.end(); ++n1)
+        {
+          unsigned int c = min_fill ? fill_in(adj, *n1) : adj[*n1].size();
+          if (c == cost[*n1])
+            continue;
+          queue.erase(std::make_pair(cost[*n1], *n1));
+          cost[*n1] = c;
+          queue.insert(std::make_pair(c, *n1));
+        }
+
+      // tree_decomposition_from_elimination_ordering() eliminates from the back of the list.
+      l.push_front(v);
+    }
+}
+
+template <class T_t, class G_t>
+void greedy_tree_decomposition(T_t &tree_decomposition, const G_t &cfg, bool min_fill)
+{
+  std::list<unsigned int> elimination_ordering;
+
+  greedy_elimination_ordering(elimination_ordering, cfg, min_fill);
+
+  tree_decomposition_from_elimination_ordering(tree_decomposition, elimination_ordering, cfg);
+}
+
+// Width of a tree decomposition, i.e. the size of its largest bag minus one.
+template <class T_t>
+unsigned int tree_decomposition_width(const T_t &T)
+{
+  size_t w = 0;
+  for (unsigned int i = 0; i < boost::num_vertices(T); i++)
+    if (T[i].bag.size() > w)
+      w = T[i].bag.size();
+  return(w ? w - 1 : 0);
+}
+
 // Ensure that all joins are at proper join nodes: Each node that has two children has the same bag as its children.
 // Complexity: Linear in the number of vertices of T.
 template <class T_t>
@@ -603,11 +703,32 @@ void copy_undir(Gd_t &dst, const Gs_t &src)
 #undef USE_PP_MD // Slightly worse width than PP_FI_TM.
 #undef USE_PP_FI // Slightly worse width than PP_FI_TM.
 
-// Get a nice tree decomposition for a cfg.
+// Get a nice tree decomposition for a cfg, using the heuristic selected by --tree-decomposition.
 template <class T_t, class G_t>
-void get_nice_tree_decomposition(T_t &tree_dec, const G_t &cfg)
+void get_nice_tree_decomposition(T_t &tree_dec, const G_t &cfg, const char *purpose)
 {
-  thorup_tree_decomposition(tree_dec, cfg);
+  static const char *const heuristic_names[] = {"thorup", "min-degree", "min-fill"};
+  int heuristic = options.tree_decomposition;
+
+  if (heuristic == TREE_DEC_MIN_DEGREE || heuristic == TREE_DEC_MIN_FILL)
+    greedy_tree_decomposition(tree_dec, cfg, heuristic == TREE_DEC_MIN_FILL);
+  else
+    thorup_tree_decomposition(tree_dec, cfg);
+
+  if (heuristic == TREE_DEC_BEST)
+    {
+      heuristic = TREE_DEC_THORUP;
+      for (int h = TREE_DEC_MIN_DEGREE; h <= TREE_DEC_MIN_FILL; h++)
+        {
+          T_t tree_dec2;
+          greedy_tree_decomposition(tree_dec2, cfg, h == TREE_DEC_MIN_FILL);
+          if (tree_decomposition_width(tree_dec2) < tree_decomposition_width(tree_dec))
+            {
+              std::swap(tree_dec, tree_dec2);
+              heuristic = h;
+            }
+        }
+    }
 
 #ifdef HAVE_TREEDEC_COMBINATIONS_HPP
 
@@ -635,8 +756,12 @@ void get_nice_tree_decomposition(T_t &tree_dec, const G_t &cfg)
   a2.get_tree_decomposition(tree_dec2);
   wassert(treedec::is_valid_treedecomposition(cfg, tree_dec2));
 
+  bool from_treedec = false;
   if (treedec::get_width(tree_dec2) < treedec::get_width(tree_dec))
-    std::swap(tree_dec, tree_dec2);
+    {
+      std::swap(tree_dec, tree_dec2);
+      from_treedec = true;
+    }
 #endif
 
   nicify(tree_dec);
@@ -644,5 +769,19 @@ void get_nice_tree_decomposition(T_t &tree_dec, const G_t &cfg)
 #ifdef HAVE_TREEDEC_COMBINATIONS_HPP
   wassert(treedec::is_valid_treedecomposition(cfg, tree_dec));
 #endif
+
+  if (options.dump_treewidth && currFunc)
+    {
+      unsigned long total = 0;
+      for (unsigned int i = 0; i < boost::num_vertices(tree_dec); i++)
+        total += tree_dec[i].bag.size();
+      const char *name = heuristic_names[heuristic];
+#ifdef HAVE_TREEDEC_COMBINATIONS_HPP
+      if (from_treedec)
+        name = "treedec";
+#endif
+      werrorfl (currFunc->fileDef, currFunc->lineDef, I_TREEWIDTH, purpose, currFunc->name, tree_decomposition_width(tree_dec), name,
+        (unsigned int)boost::num_vertices(cfg), (unsigned int)boost::num_vertices(tree_dec), (double)total / boost::num_vertices(tree_dec));
+    }
 }
 
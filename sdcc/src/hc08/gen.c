@@ -104,7 +104,8 @@ static void updateiTempRegisterUse (operand * op);
 #define AOP_OP(aop) aop->op
 
 static bool regalloc_dry_run;
-static unsigned char regalloc_dry_run_cost;
+static unsigned int regalloc_dry_run_cost;
+static unsigned int regalloc_dry_run_cost_cycles; /* for the branches not emitted during the dry run, the rest is taken from the emitted lines */
 
 static void
 emitBranch (char *branchop, symbol * tlbl)
@@ -112,6 +113,7 @@ emitBranch (char *branchop, symbol * tlbl)
   if (!regalloc_dry_run)
     emitcode (branchop, "%05d$", labelKey2num (tlbl->key));
   regalloc_dry_run_cost += (!strcmp(branchop, "jmp") || !strcmp(branchop, "brclr") || !strcmp(branchop, "brset") ? 3 : 2);
+  regalloc_dry_run_cost_cycles += (!strcmp(branchop, "brclr") || !strcmp(branchop, "brset") ? 5 : (!strcmp(branchop, "jmp") && IS_S08 ? 4 : 3));
 }
 
 /*-----------------------------------------------------------------*/
@@ -2998,6 +3000,7 @@ asmopToBool (asmop *aop, bool resultInA)
             emitcode ("bne", "%05d$", labelKey2num (tlbl->key));
           emitcode ("tstx", "");
           regalloc_dry_run_cost += 4;
+          regalloc_dry_run_cost_cycles += 3;
           if (!regalloc_dry_run)
             emitLabel (tlbl);
         }
@@ -3074,6 +3077,7 @@ asmopToBool (asmop *aop, bool resultInA)
                 emitcode ("bne", "%05d$", labelKey2num (tlbl->key));
               emitcode ("tst", "%s", aopAdrStr (aop, 1, FALSE));
               regalloc_dry_run_cost += 4;
+              regalloc_dry_run_cost_cycles += 3;
               if (!regalloc_dry_run)
                 emitLabel (tlbl);
               break;
@@ -3808,6 +3812,7 @@ genCall (iCode * ic)
 {
   sym_link *dtype;
   sym_link *etype;
+  bool tailjump;
 //  bool restoreBank = FALSE;
 //  bool swapBanks = FALSE;
 
@@ -3833,15 +3838,20 @@ genCall (iCode * ic)
       _G.sendSet = NULL;
     }
 
+  /* Jump to the callee and let it return to our caller when there is */
+  /* nothing left to clean up after the call.                         */
+  tailjump = isTailCall (ic) && !ic->parmBytes && !ic->regsSaved && !currFunc->stack && !_G.stackPushes &&
+    !IFFUNC_CALLEESAVES (currFunc->type);
+
   /* make the call */
   if (IS_LITERAL (etype))
     {
-      emitcode ("jsr", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+      emitcode (tailjump ? "jmp" : "jsr", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
       regalloc_dry_run_cost += 3;
     }
   else
     {
-      bool jump = (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
+      bool jump = tailjump || (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
 
       emitcode (jump ? "jmp" : "jsr", "%s", (OP_SYMBOL (IC_LEFT (ic))->rname[0] ?
                               OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
@@ -3851,6 +3861,14 @@ genCall (iCode * ic)
   hc08_dirtyReg (hc08_reg_a, FALSE);
   hc08_dirtyReg (hc08_reg_hx, FALSE);
 
+  /* The callee returns directly to our caller, the return value already is in place. */
+  if (tailjump)
+    {
+      if (!regalloc_dry_run)
+        ic->next->generated = 1;
+      return;
+    }
+
   /* if we need assign a result value */
   if ((IS_ITEMP (IC_RESULT (ic)) &&
        (OP_SYMBOL (IC_RESULT (ic))->nRegs || OP_SYMBOL (IC_RESULT (ic))->spildir)) || IS_TRUE_SYMOP (IC_RESULT (ic)))
@@ -6218,6 +6236,7 @@ genAnd (iCode * ic, iCode * ifx)
           if (!regalloc_dry_run)
             emitcode ("brclr", "#%d,%s,%05d$", bitpos & 7, aopAdrStr (AOP (left), bitpos >> 3, FALSE), labelKey2num ((tlbl->key)));
           regalloc_dry_run_cost += 3;
+          regalloc_dry_run_cost_cycles += 5;
           emitBranch ("jmp", IC_TRUE (ifx));
           if (!regalloc_dry_run)
             emitLabel (tlbl);
@@ -6229,6 +6248,7 @@ genAnd (iCode * ic, iCode * ifx)
           if (!regalloc_dry_run)
             emitcode ("brset", "#%d,%s,%05d$", bitpos & 7, aopAdrStr (AOP (left), bitpos >> 3, FALSE), labelKey2num ((tlbl->key)));
           regalloc_dry_run_cost += 3;
+          regalloc_dry_run_cost_cycles += 5;
           emitBranch ("jmp", IC_FALSE (ifx));
           if (!regalloc_dry_run)
             emitLabel (tlbl);
@@ -8050,6 +8070,7 @@ genLeftShift (iCode * ic)
   if (!regalloc_dry_run)
     emitcode (countreg == hc08_reg_a ? "dbnza" : (countreg ? "dbnzx" : "dbnz 1, s"), "%05d$", labelKey2num (tlbl->key));
   regalloc_dry_run_cost += (countreg ? 2 : 4);
+  regalloc_dry_run_cost_cycles += (countreg ? (IS_S08 ? 4 : 3) : (IS_S08 ? 8 : 6));
 
   if (!regalloc_dry_run)
     emitLabel (tlbl1);
@@ -8456,6 +8477,7 @@ genRightShift (iCode * ic)
   if (!regalloc_dry_run)
     emitcode (countreg == hc08_reg_a ? "dbnza" : (countreg ? "dbnzx" : "dbnz 1, s"), "%05d$", labelKey2num (tlbl->key));
   regalloc_dry_run_cost += (countreg ? 2 : 4);
+  regalloc_dry_run_cost_cycles += (countreg ? (IS_S08 ? 4 : 3) : (IS_S08 ? 8 : 6));
 
   if (!regalloc_dry_run)
     emitLabel (tlbl1);
@@ -8572,6 +8594,7 @@ genUnpackBits (operand * result, operand * left, operand * right, iCode * ifx)
             emitcode ("beq", "%05d$", labelKey2num (tlbl->key));
           emitcode ("ora", "#0x%02x", (unsigned char) (0xff << blen));
           regalloc_dry_run_cost += 6;
+          regalloc_dry_run_cost_cycles += 3;
           if (!regalloc_dry_run)
             emitLabel (tlbl);
         }
@@ -8611,6 +8634,7 @@ genUnpackBits (operand * result, operand * left, operand * right, iCode * ifx)
             emitcode ("beq", "%05d$", labelKey2num (tlbl->key));
           emitcode ("ora", "#0x%02x", (unsigned char) (0xff << rlen));
          regalloc_dry_run_cost += 6;
+         regalloc_dry_run_cost_cycles += 3;
          if (!regalloc_dry_run)
             emitLabel (tlbl);
         }
@@ -8698,6 +8722,7 @@ genUnpackBitsImmed (operand * left, operand *right, operand * result, iCode * ic
           if (!regalloc_dry_run)
             emitcode ("brclr", "#%d,%s,%05d$", bstr, aopAdrStr (derefaop, 0, FALSE), labelKey2num ((tlbl->key)));
           regalloc_dry_run_cost += 3;
+          regalloc_dry_run_cost_cycles += 5;
           if (SPEC_USIGN (etype))
             rmwWithReg ("inc", hc08_reg_a);
           else
@@ -8730,6 +8755,7 @@ genUnpackBitsImmed (operand * left, operand *right, operand * result, iCode * ic
           if (!regalloc_dry_run)
             emitcode (inst, "#%d,%s,%05d$", bstr, aopAdrStr (derefaop, 0, FALSE), labelKey2num ((tlbl->key)));
           regalloc_dry_run_cost += 3;
+          regalloc_dry_run_cost_cycles += 5;
           emitBranch ("jmp", jlbl);
           if (!regalloc_dry_run)
             emitLabel (tlbl);
@@ -8759,6 +8785,7 @@ genUnpackBitsImmed (operand * left, operand *right, operand * result, iCode * ic
                 emitcode ("beq", "%05d$", labelKey2num (tlbl->key));
               emitcode ("ora", "#0x%02x", (unsigned char) (0xff << blen));
               regalloc_dry_run_cost += 6;
+              regalloc_dry_run_cost_cycles += 3;
               if (!regalloc_dry_run)
                 emitLabel (tlbl);
             }
@@ -8821,6 +8848,7 @@ genUnpackBitsImmed (operand * left, operand *right, operand * result, iCode * ic
             emitcode ("beq", "%05d$", labelKey2num (tlbl->key));
           emitcode ("ora", "#0x%02x", (unsigned char) (0xff << rlen));
           regalloc_dry_run_cost += 6;
+          regalloc_dry_run_cost_cycles += 3;
           if (!regalloc_dry_run)
             emitLabel (tlbl);
         }
@@ -10720,20 +10748,27 @@ init_aop_pass(void)
   hc08_aop_pass[7]->aopu.aop_dir = "___SDCC_hc08_ret7";
 }
 
-unsigned char
+float
 dryhc08iCode (iCode *ic)
 {
+  lineNode *line;
+
   regalloc_dry_run = TRUE;
   regalloc_dry_run_cost = 0;
+  regalloc_dry_run_cost_cycles = 0;
 
   init_aop_pass();
   
   genhc08iCode (ic);
 
+  for (line = genLine.lineHead; line; line = line->next)
+    if (!line->isComment && !line->isLabel && !line->isDebug)
+      regalloc_dry_run_cost_cycles += hc08_getInstructionCycles (line);
+
   destroy_line_list ();
   /*freeTrace (&_G.trace.aops);*/
 
-  return (regalloc_dry_run_cost);
+  return (dryRunCost (regalloc_dry_run_cost, regalloc_dry_run_cost_cycles, ic));
 }
 
 /*-----------------------------------------------------------------*/
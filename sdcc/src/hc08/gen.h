@@ -85,6 +85,7 @@ asmop;
 
 void genhc08Code (iCode *);
 void hc08_emitDebuggerSymbol (const char *);
+int hc08_getInstructionCycles (lineNode *line);
 
 extern unsigned fReturnSizeHC08;
 
@@ -411,6 +411,7 @@ _hasNativeMulFor (iCode *ic, sym_link *left, sym_link *right)
 typedef struct asmLineNode
   {
     int size;
+    int cycles;
   }
 asmLineNode;
 
@@ -421,6 +422,7 @@ newAsmLineNode (void)
 
   aln = Safe_alloc ( sizeof (asmLineNode));
   aln->size = 0;
+  aln->cycles = 0;
 
   return aln;
 }
@@ -686,6 +688,168 @@ hc08_instructionSize(const char *inst, const char *op1, const char *op2)
     }
 }
 
+/*--------------------------------------------------------------------*/
+/* Given an instruction and its first two operands, compute the       */
+/* number of bus cycles it takes on the selected target (HC08 or      */
+/* S08). Conditional branches are counted as taken, which costs the   */
+/* same as not taken on both cores. Operand forms are classified the  */
+/* same way as in hc08_instructionSize().                             */
+/*--------------------------------------------------------------------*/
+static int
+hc08_instructionCycles(const char *inst, const char *op1, const char *op2)
+{
+  hc08opcodedata *opcode;
+  bool ix, sp, wide;
+  long offset;
+  char * endnum = NULL;
+
+  opcode = bsearch (inst, hc08opcodeDataTable,
+                    sizeof(hc08opcodeDataTable)/sizeof(hc08opcodedata),
+                    sizeof(hc08opcodedata), hc08_opcodeCompare);
+
+  if (!opcode)
+    return 0;
+
+  ix = (op2[0] == 'x');
+  sp = (op2[0] == 's');
+  offset = strtol (op1, &endnum, 0) & 0xffff;
+  wide = (endnum && *endnum) || offset > 0xff;
+
+  switch (opcode->adrmode)
+    {
+      case HC08OP_INH:
+        if (!strcmp (inst, ".db"))
+          return 0;
+        if (!strncmp (inst, "psh", 3))
+          return 2;
+        if (!strncmp (inst, "pul", 3))
+          return IS_S08 ? 3 : 2;
+        if (!strcmp (inst, "rts"))
+          return IS_S08 ? 6 : 4;
+        if (!strcmp (inst, "rti"))
+          return IS_S08 ? 9 : 7;
+        if (!strcmp (inst, "swi"))
+          return IS_S08 ? 11 : 9;
+        if (!strcmp (inst, "mul"))
+          return 5;
+        if (!strcmp (inst, "div"))
+          return IS_S08 ? 6 : 7;
+        if (!strcmp (inst, "nsa"))
+          return IS_S08 ? 1 : 3;
+        if (!strcmp (inst, "daa") || !strcmp (inst, "tap"))
+          return IS_S08 ? 1 : 2;
+        if (!strcmp (inst, "tsx") || !strcmp (inst, "txs"))
+          return 2;
+        return 1;
+
+      case HC08OP_IM1:
+        return 2;
+
+      case HC08OP_BR:
+        if (!strcmp (inst, "bsr"))
+          return IS_S08 ? 5 : 4;
+        if (!strncmp (inst, "dbnz", 4))
+          return IS_S08 ? 4 : 3;
+        return 3;
+
+      case HC08OP_BSC:
+        return IS_S08 ? 5 : 4;
+
+      case HC08OP_BTB:
+        return 5;
+
+      case HC08OP_RMW:
+        {
+          /* clr and tst don't write back resp. don't read first */
+          int light = !strcmp (inst, "tst") || !IS_S08 && !strcmp (inst, "clr");
+          int cycles;
+          if (!op2[0])
+            cycles = 4;      /* direct */
+          else if (!op1[0])
+            cycles = 3;      /* ,x */
+          else if (ix)
+            cycles = 4;      /* oprx8,x */
+          else
+            cycles = 5;      /* oprx8,sp */
+          return cycles + IS_S08 - light;
+        }
+
+      case HC08OP_STD:
+        if (!strcmp (inst, "jmp") || !strcmp (inst, "jsr"))
+          {
+            int cycles;
+            if (!op2[0])
+              cycles = (op1[0] == '*') ? 2 : 3;
+            else if (!op1[0])
+              cycles = 2;
+            else
+              cycles = wide ? 4 : 3;
+            if (IS_S08 && (!op2[0] || !op1[0]))
+              cycles++;
+            if (!strcmp (inst, "jsr"))
+              cycles += 2;
+            return cycles;
+          }
+        if (!op2[0])
+          {
+            if (op1[0] == '#')
+              return 2;
+            if (op1[0] == '*')
+              return 3;
+            return 4;
+          }
+        if (!op1[0])
+          return (IS_S08 && strcmp (inst, "sta") && strcmp (inst, "stx")) ? 3 : 2;
+        return (wide ? 4 : 3) + sp;
+
+      case HC08OP_MOV:
+        if (op1[0] == '#')
+          return 4;
+        if (ix || !op1[0])
+          return IS_S08 ? 5 : 4;
+        return 5;
+
+      case HC08OP_CBEQ:
+        if (op1[0] == '#')
+          return 4;
+        if (sp)
+          return 6;
+        if (ix && !op1[0])
+          return IS_S08 ? 5 : 4;
+        return 5;
+
+      case HC08OP_CPHX:
+        if (op1[0] == '#')
+          return 3;
+        if (op1[0] == '*')
+          return IS_S08 ? 5 : 4;
+        return 6;
+
+      case HC08OP_LDHX:
+        if (op1[0] == '#')
+          return 3;
+        if (op1[0] == '*')
+          return 4;
+        if (!op2[0] || ix && !wide || sp)
+          return 5;
+        return 6;
+
+      case HC08OP_STHX:
+        if (op1[0] == '*')
+          return 4;
+        return 5;
+
+      case HC08OP_DBNZ:
+        if (!op2[0])
+          return IS_S08 ? 7 : 5;
+        if (!op1[0])
+          return IS_S08 ? 6 : 4;
+        return (IS_S08 ? 7 : 5) + sp;
+
+      default:
+        return 4;
+    }
+}
 
 static asmLineNode *
 hc08_asmLineNodeFromLineNode (lineNode *ln)
@@ -732,6 +896,7 @@ hc08_asmLineNodeFromLineNode (lineNode *ln)
   *op = '\0';
 
   aln->size = hc08_instructionSize(inst, op1, op2);
+  aln->cycles = hc08_instructionCycles(inst, op1, op2);
 
   return aln;
 }
@@ -745,6 +910,15 @@ hc08_getInstructionSize (lineNode *line)
   return line->aln->size;
 }
 
+int
+hc08_getInstructionCycles (lineNode *line)
+{
+  if (!line->aln)
+    line->aln = (asmLineNodeBase *) hc08_asmLineNodeFromLineNode (line);
+
+  return ((asmLineNode *) line->aln)->cycles;
+}
+
 /** $1 is always the basename.
     $2 is always the output file.
     $3 varies
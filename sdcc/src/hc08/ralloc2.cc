@@ -28,7 +28,7 @@ extern "C"
 {
   #include "ralloc.h"
   #include "gen.h"
-  unsigned char dryhc08iCode (iCode *ic);
+  float dryhc08iCode (iCode *ic);
   bool hc08_assignment_optimal;
 }
 
@@ -654,7 +654,7 @@ iCode *hc08_ralloc2_cc(ebbIndex *ebbi)
 
   tree_dec_t tree_decomposition;
 
-  get_nice_tree_decomposition(tree_decomposition, control_flow_graph);
+  get_nice_tree_decomposition(tree_decomposition, control_flow_graph, "register allocator");
 
   alive_tree_dec(tree_decomposition, control_flow_graph);
 
@@ -3202,6 +3202,7 @@ genCall (iCode * ic)
   bool accPushed = FALSE;
   bool resultInF0 = FALSE;
   bool assignResultGenerated = FALSE;
+  bool tailjump;
 
   D (emitcode (";", "genCall"));
 
@@ -3240,6 +3241,11 @@ genCall (iCode * ic)
       emitcode ("mov", "psw,#!constbyte", ((FUNC_REGBANK (dtype)) << 3) & 0xff);
     }
 
+  /* a call in tail position becomes a jump if our epilogue is empty */
+  tailjump = isTailCall (ic) && !ic->parmBytes && !swapBanks && !ic->regsSaved &&
+    !IFFUNC_CALLEESAVES (currFunc->type) && !currFunc->stack && !currFunc->xstack &&
+    !FUNC_HASSTACKPARM (currFunc->type);
+
   /* make the call */
   if (IFFUNC_ISBANKEDCALL (dtype))
     {
@@ -3270,13 +3276,20 @@ genCall (iCode * ic)
     {
       if (IS_LITERAL (etype))
         {
-          emitcode ("lcall", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+          emitcode (tailjump ? "ljmp" : "lcall", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
         }
       else
         {
-          emitcode ("lcall", "%s", (OP_SYMBOL (IC_LEFT (ic))->rname[0] ?
+          emitcode (tailjump ? "ljmp" : "lcall", "%s", (OP_SYMBOL (IC_LEFT (ic))->rname[0] ?
                                     OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
         }
+
+      /* the callee returns to our caller */
+      if (tailjump)
+        {
+          ic->next->generated = 1;
+          return;
+        }
     }
 
   if (swapBanks)
@@ -12361,7 +12374,10 @@ gen51Code (iCode * lic)
   /* now we are ready to call the
      peep hole optimizer */
   if (!options.nopeep)
-    peepHole (&genLine.lineHead);
+    {
+      rtrackOptimize (genLine.lineHead);
+      peepHole (&genLine.lineHead);
+    }
 
   /* now do the actual printing */
   printLine (genLine.lineHead, codeOutBuf);
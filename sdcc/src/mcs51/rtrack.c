@@ -21,15 +21,15 @@
 /*-------------------------------------------------------------------------
   Status:
     - passes regression test suite, still bugs are likely
-    - only active if environment variable SDCC_REGTRACK is set
+    - tracking during code generation is always on (see enable below),
+      rtrackOptimize() runs before the peephole optimizer
 
   Missed opportunities:
     - does not track offsets to symbols as in "mov dptr,#(_my_int + 2)"
-    - only used for moves to acc or dptr so chances to use:
-      "inc r2", "mov r2,a" would not be taken
-    - a label causes loss of tracking (no handling of information of blocks
-      known to follow/preceed the current block)
-    - not used in aopGet or genRet
+    - during code generation only used for moves to acc or dptr so
+      chances to use "inc r2" would not be taken
+    - a label causes loss of tracking during code generation,
+      rtrackOptimize() handles labels but only looks at moves
     - SFRX (__xdata volatile unsigned char __at(addr)) not handled as value
     - does not track which registers are known to be unchanged within
       a function (would not have to be saved when calling the function)
@@ -1198,3 +1198,976 @@ void rtrackLoadR0R1WithSym (const char *reg, const char *x)
   emitcode ("mov", "%s,#%s", reg, x );
 }
 #endif
+
+
+/*-------------------------------------------------------------------------
+  Data flow analysis over the lines of a function
+
+  The tracking above follows the lines while they are generated and
+  forgets everything at a label, where the state of the jumps to it is
+  not known yet. Once the function is complete, rtrackOptimize() runs a
+  forward analysis over its control flow graph: the state at a label is
+  the join of the states of all jumps to it and of the line falling
+  through, iterated to a fixed point, so loops are handled too.
+
+  Facts kept for a, b, dpl, dph and r0..r7 are a known value, a known
+  symbol (#_sym) or a value number telling that registers hold the same,
+  otherwise unknown value. For the carry flag only its value is kept.
+  Moves of a value already in place are removed, literal moves are
+  replaced by shorter ones from a register holding the value.
+-------------------------------------------------------------------------*/
+
+enum
+{
+  RT_R0 = 0,                    /* r0..r7 are RT_R0 + n */
+  RT_DPL = 8,
+  RT_DPH,
+  RT_B,
+  RT_A,
+  RT_NREGS
+};
+
+enum
+{
+  RT_UNKNOWN = 0,
+  RT_VALUE,                     /* the register holds value */
+  RT_SYM,                       /* low byte of the address of sym */
+  RT_SYMHI,                     /* high byte of the address of sym */
+  RT_COPY                       /* same as all other registers with vn */
+};
+
+typedef struct
+{
+  unsigned char kind;
+  unsigned char value;
+  const char *sym;
+  int vn;
+} rtrack_fact;
+
+typedef struct
+{
+  bool reached;                 /* false while no path to here is known */
+  signed char carry;            /* -1 if unknown */
+  rtrack_fact reg[RT_NREGS];
+} rtrack_state;
+
+typedef struct
+{
+  lineNode *pl;
+  char inst[8];
+  char op[3][128];
+  int nops;
+  int target;                   /* index of the label jumped to or -1 */
+  int label;                    /* index of the label defined or -1 */
+} rtrack_line;
+
+typedef struct
+{
+  rtrack_state in;
+  bool unknown;                 /* reached from where we can't see */
+} rtrack_label;
+
+static const char *rtrack_regname[RT_NREGS] =
+  {"r0", "r1", "r2", "r3", "r4", "r5", "r6", "r7", "dpl", "dph", "b", "a"};
+
+
+static int rtrack_reg (const char *op)
+{
+  if (!strcmp (op, "a") || !strcmp (op, "acc"))
+    return RT_A;
+  if (!strcmp (op, "b"))
+    return RT_B;
+  if (!strcmp (op, "dpl"))
+    return RT_DPL;
+  if (!strcmp (op, "dph"))
+    return RT_DPH;
+  if (op[0] == 'a' && op[1] == 'r')
+    op++;
+  if (op[0] == 'r' && op[1] >= '0' && op[1] <= '7' && !op[2])
+    return RT_R0 + op[1] - '0';
+  return -1;
+}
+
+
+/* numeric literal "#0x12" or "#18" */
+static bool rtrack_literal (const char *op, int *value)
+{
+  char *end;
+
+  if (op[0] != '#')
+    return false;
+  if (op[1] == '0' && op[2] == 'x')
+    *value = strtol (op + 3, &end, 16);
+  else if (isdigit ((unsigned char)op[1]) && (op[1] != '0' || !op[2]))
+    *value = strtol (op + 1, &end, 10);
+  else
+    return false;
+  return end != op + 1 && !*end;
+}
+
+
+/* Might writing to the direct address or bit op change a tracked
+   register or the register bank? */
+static bool rtrack_direct_aliases (const char *op)
+{
+  char name[128];
+  const char *p;
+  int len;
+  symbol *sym;
+
+  if (op[0] == '(')
+    op++;
+
+  if (isdigit ((unsigned char)op[0]))
+    return true;
+  if (!strncmp (op, "psw", 3))
+    return true;
+  if (op[0] != '_')
+    return false;
+
+  for (p = op + 1; isalnum ((unsigned char)*p) || *p == '_'; p++)
+    ;
+  len = p - (op + 1);
+  if (len >= (int)sizeof name)
+    return true;
+  memcpy (name, op + 1, len);
+  name[len] = 0;
+
+  sym = findSym (SymbolTab, NULL, name);
+  if (!sym || !sym->etype || !IS_SPEC (sym->etype))
+    return false;
+
+  if (SPEC_SCLS (sym->etype) == S_SBIT)
+    {
+      unsigned int addr = SPEC_ADDR (sym->etype) & 0xf8;
+      return addr == 0xd0 || addr == 0xe0 || addr == 0xf0;
+    }
+  if (SPEC_SCLS (sym->etype) == S_SFR)
+    {
+      unsigned long addr;
+      for (addr = SPEC_ADDR (sym->etype); addr; addr >>= 8)
+        switch (addr & 0xff)
+          {
+          case 0x82: case 0x83: case 0xd0: case 0xe0: case 0xf0:
+            return true;
+          }
+      return false;
+    }
+  return SPEC_ABSA (sym->etype) && SPEC_ADDR (sym->etype) < 0x20 &&
+    (SPEC_SCLS (sym->etype) == S_DATA || SPEC_SCLS (sym->etype) == S_IDATA);
+}
+
+
+static bool rtrack_fact_equal (const rtrack_fact *x, const rtrack_fact *y)
+{
+  if (x->kind != y->kind)
+    return false;
+  switch (x->kind)
+    {
+    case RT_VALUE:
+      return x->value == y->value;
+    case RT_SYM:
+    case RT_SYMHI:
+      return !strcmp (x->sym, y->sym);
+    case RT_COPY:
+      return x->vn == y->vn;
+    default:
+      return true;
+    }
+}
+
+
+/* do the registers surely hold the same value? */
+static bool rtrack_same (const rtrack_state *st, int dst, int src)
+{
+  return st->reg[src].kind != RT_UNKNOWN &&
+    rtrack_fact_equal (&st->reg[dst], &st->reg[src]);
+}
+
+
+static void rtrack_forget_all (rtrack_state *st)
+{
+  memset (st->reg, 0, sizeof st->reg);
+  st->carry = -1;
+}
+
+
+static void rtrack_forget_rx (rtrack_state *st)
+{
+  memset (&st->reg[RT_R0], 0, 8 * sizeof st->reg[0]);
+}
+
+
+static void rtrack_set_value (rtrack_state *st, int r, int value)
+{
+  memset (&st->reg[r], 0, sizeof st->reg[r]);
+  st->reg[r].kind = RT_VALUE;
+  st->reg[r].value = value;
+}
+
+
+/* r gets a value nothing is known about, except that registers it is
+   copied to later hold the same. The value number tells the line, so
+   copies made in an earlier pass through a loop have to go. */
+static void rtrack_set_new (rtrack_state *st, int r, int line)
+{
+  int vn = line * RT_NREGS + r + 1;
+  int i;
+
+  for (i = 0; i < RT_NREGS; i++)
+    if (st->reg[i].kind == RT_COPY && st->reg[i].vn == vn)
+      st->reg[i].kind = RT_UNKNOWN;
+  memset (&st->reg[r], 0, sizeof st->reg[r]);
+  st->reg[r].kind = RT_COPY;
+  st->reg[r].vn = vn;
+}
+
+
+static void rtrack_copy (rtrack_state *st, int dst, int src, int line)
+{
+  if (dst == src)
+    return;
+  if (st->reg[src].kind == RT_UNKNOWN)
+    rtrack_set_new (st, src, line);
+  st->reg[dst] = st->reg[src];
+}
+
+
+/* the result of an operation on a known value */
+static void rtrack_set_result (rtrack_state *st, int r, bool known, int value, int line)
+{
+  if (known)
+    rtrack_set_value (st, r, value & 0xff);
+  else
+    rtrack_set_new (st, r, line);
+}
+
+
+/* an instruction writes to op, in a way not tracked */
+static void rtrack_clobber (rtrack_state *st, const char *op, int line)
+{
+  int r = rtrack_reg (op);
+  const char *dot = strchr (op, '.');
+
+  if (r >= 0)
+    rtrack_set_new (st, r, line);
+  else if (!strcmp (op, "c"))
+    st->carry = -1;
+  else if (!strcmp (op, "dptr"))
+    {
+      rtrack_set_new (st, RT_DPL, line);
+      rtrack_set_new (st, RT_DPH, line);
+    }
+  else if (!strcmp (op, "ab"))
+    {
+      rtrack_set_new (st, RT_A, line);
+      rtrack_set_new (st, RT_B, line);
+    }
+  else if (op[0] == '@')
+    {
+      /* idata writes might hit the register bank */
+      if (op[1] == 'r')
+        rtrack_forget_rx (st);
+    }
+  else if (dot)
+    {
+      char base[8];
+
+      if (dot - op < (int)sizeof base)
+        {
+          memcpy (base, op, dot - op);
+          base[dot - op] = 0;
+          r = rtrack_reg (base);
+          if (r >= 0)
+            {
+              rtrack_set_new (st, r, line);
+              return;
+            }
+        }
+      if (rtrack_direct_aliases (op))
+        rtrack_forget_all (st);
+    }
+  else if (!strcmp (op, "sp"))
+    ;
+  else if (!strcmp (op, "rs0") || !strcmp (op, "rs1") || rtrack_direct_aliases (op))
+    rtrack_forget_all (st);
+}
+
+
+/* returns false if a and the operand op aren't both known values */
+static bool rtrack_operand_value (const rtrack_state *st, const char *op, int *value)
+{
+  int r = rtrack_reg (op);
+
+  if (r >= 0)
+    {
+      *value = st->reg[r].value;
+      return st->reg[r].kind == RT_VALUE && st->reg[RT_A].kind == RT_VALUE;
+    }
+  return rtrack_literal (op, value) && st->reg[RT_A].kind == RT_VALUE;
+}
+
+
+static bool rtrack_is_jump (const char *inst)
+{
+  return !strcmp (inst, "sjmp") || !strcmp (inst, "ljmp") || !strcmp (inst, "ajmp") ||
+    !strcmp (inst, "jc") || !strcmp (inst, "jnc") || !strcmp (inst, "jz") || !strcmp (inst, "jnz") ||
+    !strcmp (inst, "jb") || !strcmp (inst, "jnb") || !strcmp (inst, "jbc") ||
+    !strcmp (inst, "cjne") || !strcmp (inst, "djnz");
+}
+
+
+/* State after the line l, st is the state before. For jumps taken is
+   set to the state on the jump. */
+static void rtrack_step (rtrack_state *st, const rtrack_line *l, rtrack_state *taken, int line)
+{
+  const char *inst = l->inst;
+  const char *op1 = l->op[0], *op2 = l->op[1];
+  int r1 = l->nops > 0 ? rtrack_reg (op1) : -1;
+  int r2 = l->nops > 1 ? rtrack_reg (op2) : -1;
+  int value;
+
+  if (taken)
+    taken->reached = false;
+
+  if (!strcmp (inst, "mov"))
+    {
+      if (!strcmp (op1, "dptr"))
+        {
+          if (rtrack_literal (op2, &value))
+            {
+              rtrack_set_value (st, RT_DPL, value & 0xff);
+              rtrack_set_value (st, RT_DPH, (value >> 8) & 0xff);
+            }
+          else if (op2[0] == '#' && !strchr (op2, '.'))
+            {
+              const char *sym = op2 + 1;
+              memset (&st->reg[RT_DPL], 0, 2 * sizeof st->reg[0]);
+              st->reg[RT_DPL].kind = RT_SYM;
+              st->reg[RT_DPL].sym = sym;
+              st->reg[RT_DPH].kind = RT_SYMHI;
+              st->reg[RT_DPH].sym = sym;
+            }
+          else
+            rtrack_clobber (st, op1, line);
+        }
+      else if (r1 >= 0 && rtrack_literal (op2, &value))
+        rtrack_set_value (st, r1, value & 0xff);
+      else if (r1 >= 0 && op2[0] == '#' && !strchr (op2, '.'))
+        {
+          memset (&st->reg[r1], 0, sizeof st->reg[r1]);
+          st->reg[r1].kind = RT_SYM;
+          st->reg[r1].sym = op2 + 1;
+        }
+      else if (r1 >= 0 && r2 >= 0)
+        rtrack_copy (st, r1, r2, line);
+      else if (!strcmp (op1, "sp"))
+        ;
+      else
+        rtrack_clobber (st, op1, line);
+      return;
+    }
+
+  if (!strcmp (inst, "movx") || !strcmp (inst, "movc"))
+    {
+      /* writes to xdata don't change registers */
+      if (op1[0] != '@')
+        rtrack_clobber (st, op1, line);
+      return;
+    }
+
+  if (!strcmp (inst, "clr") || !strcmp (inst, "setb") || !strcmp (inst, "cpl"))
+    {
+      if (!strcmp (op1, "c"))
+        st->carry = inst[0] == 'c' && inst[1] == 'l' ? 0 :
+                    inst[0] == 's' ? 1 :
+                    st->carry < 0 ? -1 : !st->carry;
+      else if (r1 == RT_A && inst[0] == 'c')
+        rtrack_set_result (st, RT_A, inst[1] == 'l' || st->reg[RT_A].kind == RT_VALUE,
+                           inst[1] == 'l' ? 0 : ~st->reg[RT_A].value, line);
+      else
+        rtrack_clobber (st, op1, line);
+      return;
+    }
+
+  if (!strcmp (inst, "inc") || !strcmp (inst, "dec"))
+    {
+      int d = inst[0] == 'i' ? 1 : -1;
+
+      if (!strcmp (op1, "dptr"))
+        {
+          if (st->reg[RT_DPL].kind == RT_VALUE && st->reg[RT_DPH].kind == RT_VALUE)
+            {
+              value = (st->reg[RT_DPH].value << 8 | st->reg[RT_DPL].value) + d;
+              rtrack_set_value (st, RT_DPL, value & 0xff);
+              rtrack_set_value (st, RT_DPH, (value >> 8) & 0xff);
+            }
+          else
+            rtrack_clobber (st, op1, line);
+        }
+      else if (r1 >= 0)
+        rtrack_set_result (st, r1, st->reg[r1].kind == RT_VALUE, st->reg[r1].value + d, line);
+      else
+        rtrack_clobber (st, op1, line);
+      return;
+    }
+
+  if (!strcmp (inst, "add") || !strcmp (inst, "addc") || !strcmp (inst, "subb"))
+    {
+      bool known = rtrack_operand_value (st, op2, &value) && (inst[3] != 'c' || st->carry >= 0) &&
+                   (inst[0] == 'a' || st->carry >= 0);
+      int a = st->reg[RT_A].value, c = st->carry > 0;
+
+      if (!strcmp (inst, "add"))
+        value = a + value;
+      else if (!strcmp (inst, "addc"))
+        value = a + value + c;
+      else
+        value = a - value - c;
+      st->carry = known ? !!(value & 0x100) : -1;
+      rtrack_set_result (st, RT_A, known, value, line);
+      return;
+    }
+
+  if (!strcmp (inst, "anl") || !strcmp (inst, "orl") || !strcmp (inst, "xrl"))
+    {
+      if (r1 == RT_A)
+        {
+          bool known = rtrack_operand_value (st, op2, &value);
+          int a = st->reg[RT_A].value;
+
+          value = inst[0] == 'a' ? a & value : inst[0] == 'o' ? a | value : a ^ value;
+          rtrack_set_result (st, RT_A, known, value, line);
+        }
+      else
+        rtrack_clobber (st, op1, line);
+      return;
+    }
+
+  if (!strcmp (inst, "rl") || !strcmp (inst, "rr") || !strcmp (inst, "swap") ||
+      !strcmp (inst, "rlc") || !strcmp (inst, "rrc") || !strcmp (inst, "da"))
+    {
+      int a = st->reg[RT_A].value;
+      bool known = st->reg[RT_A].kind == RT_VALUE;
+
+      if (!strcmp (inst, "rl"))
+        value = a << 1 | a >> 7;
+      else if (!strcmp (inst, "rr"))
+        value = a >> 1 | a << 7;
+      else if (!strcmp (inst, "swap"))
+        value = a << 4 | a >> 4;
+      else if (!strcmp (inst, "rlc"))
+        {
+          known = known && st->carry >= 0;
+          value = a << 1 | (st->carry > 0);
+          st->carry = known ? a >> 7 : -1;
+        }
+      else if (!strcmp (inst, "rrc"))
+        {
+          known = known && st->carry >= 0;
+          value = a >> 1 | (st->carry > 0) << 7;
+          st->carry = known ? a & 1 : -1;
+        }
+      else
+        {
+          known = false;
+          st->carry = -1;
+        }
+      rtrack_set_result (st, RT_A, known, value, line);
+      return;
+    }
+
+  if (!strcmp (inst, "mul") || !strcmp (inst, "div"))
+    {
+      int a = st->reg[RT_A].value, b = st->reg[RT_B].value;
+      bool known = st->reg[RT_A].kind == RT_VALUE && st->reg[RT_B].kind == RT_VALUE &&
+                   (inst[0] == 'm' || b);
+
+      rtrack_set_result (st, RT_A, known, known ? (inst[0] == 'm' ? a * b : a / b) : 0, line);
+      rtrack_set_result (st, RT_B, known, known ? (inst[0] == 'm' ? (a * b) >> 8 : a % b) : 0, line);
+      st->carry = 0;
+      return;
+    }
+
+  if (!strcmp (inst, "xch"))
+    {
+      if (r2 >= 0)
+        {
+          rtrack_fact t = st->reg[RT_A];
+          st->reg[RT_A] = st->reg[r2];
+          st->reg[r2] = t;
+        }
+      else
+        {
+          rtrack_clobber (st, op1, line);
+          rtrack_clobber (st, op2, line);
+        }
+      return;
+    }
+
+  if (!strcmp (inst, "xchd") || !strcmp (inst, "pop"))
+    {
+      rtrack_clobber (st, op1, line);
+      if (l->nops > 1)
+        rtrack_clobber (st, op2, line);
+      if (!strcmp (op1, "psw"))
+        rtrack_forget_all (st);
+      return;
+    }
+
+  if (!strcmp (inst, "push") || !strcmp (inst, "nop"))
+    return;
+
+  if (rtrack_is_jump (inst))
+    {
+      if (!strcmp (inst, "jbc") || !strcmp (inst, "djnz"))
+        rtrack_clobber (st, op1, line);
+      if (!strcmp (inst, "cjne"))
+        st->carry = -1;
+
+      if (taken)
+        *taken = *st;
+
+      if (!strcmp (inst, "jc") || !strcmp (inst, "jnc"))
+        {
+          if (taken)
+            taken->carry = inst[1] == 'c';
+          st->carry = inst[1] != 'c';
+        }
+      else if (!strcmp (inst, "jz"))
+        {
+          if (taken)
+            rtrack_set_value (taken, RT_A, 0);
+        }
+      else if (!strcmp (inst, "jnz"))
+        rtrack_set_value (st, RT_A, 0);
+      else if (!strcmp (inst, "djnz") && r1 >= 0)
+        rtrack_set_value (st, r1, 0);
+      else if (!strcmp (inst, "cjne"))
+        {
+          /* not taken: equal, so not less */
+          if (r1 >= 0 && rtrack_literal (op2, &value))
+            rtrack_set_value (st, r1, value & 0xff);
+          st->carry = 0;
+        }
+
+      if (!strcmp (inst, "sjmp") || !strcmp (inst, "ljmp") || !strcmp (inst, "ajmp"))
+        st->reached = false;
+      return;
+    }
+
+  if (!strcmp (inst, "ret") || !strcmp (inst, "reti") || !strcmp (inst, "jmp"))
+    {
+      st->reached = false;
+      return;
+    }
+
+  /* calls and anything not known */
+  rtrack_forget_all (st);
+}
+
+
+/* meet the state st into the one at label; returns true if changed */
+static bool rtrack_join (rtrack_label *label, const rtrack_state *st)
+{
+  bool change = false;
+  int i;
+
+  if (!st->reached || label->unknown)
+    return false;
+
+  if (!label->in.reached)
+    {
+      label->in = *st;
+      return true;
+    }
+
+  for (i = 0; i < RT_NREGS; i++)
+    if (label->in.reg[i].kind != RT_UNKNOWN && !rtrack_fact_equal (&label->in.reg[i], &st->reg[i]))
+      {
+        label->in.reg[i].kind = RT_UNKNOWN;
+        change = true;
+      }
+  if (label->in.carry >= 0 && label->in.carry != st->carry)
+    {
+      label->in.carry = -1;
+      change = true;
+    }
+  return change;
+}
+
+
+/* split an instruction into mnemonic and operands; false if not one */
+static bool rtrack_parse (rtrack_line *l)
+{
+  const char *p = l->pl->line;
+  int n;
+
+  l->nops = 0;
+  while (isspace ((unsigned char)*p))
+    p++;
+  for (n = 0; isalpha ((unsigned char)*p) || (n && isdigit ((unsigned char)*p)); p++)
+    {
+      if (n == sizeof l->inst - 1)
+        return false;
+      l->inst[n++] = *p;
+    }
+  l->inst[n] = 0;
+  if (!n || (*p && !isspace ((unsigned char)*p)))
+    return false;
+
+  while (*p)
+    {
+      while (isspace ((unsigned char)*p))
+        p++;
+      if (!*p)
+        break;
+      if (l->nops == 3)
+        return false;
+      for (n = 0; *p && *p != ',' && *p != ';'; p++)
+        {
+          if (n == sizeof l->op[0] - 1)
+            return false;
+          l->op[l->nops][n++] = *p;
+        }
+      while (n && isspace ((unsigned char)l->op[l->nops][n - 1]))
+        n--;
+      l->op[l->nops++][n] = 0;
+      if (*p == ';')
+        break;
+      if (*p == ',')
+        p++;
+    }
+  return true;
+}
+
+
+static int rtrack_find_label (hTab *labels, const char *name)
+{
+  const rtrack_line *l;
+
+  if (!labels)
+    return -1;
+  for (l = hTabFirstItemWK (labels, hashSymbolName (name)); l; l = hTabNextItemWK (labels))
+    if (!strcmp (name, l->op[0]))
+      return l->label;
+  return -1;
+}
+
+
+/* mark the labels referenced from the line as reached from unknown */
+static void rtrack_mark_references (const char *line, hTab *labels, rtrack_label *label)
+{
+  const char *p, *start;
+
+  for (p = line; (p = strchr (p, '$')); p++)
+    {
+      char name[32];
+      int i;
+
+      for (start = p; start > line && isdigit ((unsigned char)start[-1]); start--)
+        ;
+      if (start == p || p - start + 1 >= (int)sizeof name)
+        continue;
+      memcpy (name, start, p - start + 1);
+      name[p - start + 1] = 0;
+      if ((i = rtrack_find_label (labels, name)) >= 0)
+        label[i].unknown = true;
+    }
+}
+
+
+static void rtrack_remove (lineNode *pl)
+{
+  if (options.verboseAsm || !pl->prev)
+    {
+      char *line = Safe_alloc (strlen (pl->line) + sizeof ";\tgenFromRTrack removed\t");
+      strcpy (line, ";\tgenFromRTrack removed\t");
+      strcat (line, pl->line);
+      Safe_free (pl->line);
+      pl->line = line;
+      pl->isComment = 1;
+      return;
+    }
+  pl->prev->next = pl->next;
+  if (pl->next)
+    pl->next->prev = pl->prev;
+  /* destroy_line_list() starts from the last line */
+  if (genLine.lineCurr == pl)
+    genLine.lineCurr = pl->prev;
+  Safe_free (pl->line);
+  if (pl->aln)
+    Safe_free (pl->aln);
+  Safe_free (pl);
+}
+
+
+static void rtrack_replace (lineNode *pl, const char *op1, const char *op2)
+{
+  char *line = Safe_alloc (strlen (pl->line) + strlen (op1) + strlen (op2) + sizeof ";\tgenFromRTrack replaced\t");
+
+  if (options.verboseAsm && pl->prev)
+    {
+      lineNode *comment;
+
+      sprintf (line, ";\tgenFromRTrack replaced\t%s", pl->line);
+      comment = newLineNode (line);
+      comment->isComment = 1;
+      connectLine (pl->prev, comment);
+      connectLine (comment, pl);
+    }
+  sprintf (line, "mov\t%s,%s", op1, op2);
+  Safe_free (pl->line);
+  pl->line = line;
+  if (pl->aln)
+    {
+      Safe_free (pl->aln);
+      pl->aln = NULL;
+    }
+}
+
+
+/* register holding the value, a preferred; -1 if none */
+static int rtrack_reg_with_value (const rtrack_state *st, int value)
+{
+  int i;
+
+  if (st->reg[RT_A].kind == RT_VALUE && st->reg[RT_A].value == value)
+    return RT_A;
+  for (i = RT_R0; i < RT_R0 + 8; i++)
+    if (st->reg[i].kind == RT_VALUE && st->reg[i].value == value)
+      return i;
+  return -1;
+}
+
+
+/* Remove the move l, or make it shorter, given the state st before it */
+static void rtrack_improve (const rtrack_state *st, rtrack_line *l)
+{
+  const char *op1 = l->op[0], *op2 = l->op[1];
+  int r1, r2, value;
+
+  if (!strcmp (l->inst, "clr") && l->nops == 1)
+    {
+      if ((!strcmp (op1, "a") && st->reg[RT_A].kind == RT_VALUE && !st->reg[RT_A].value) ||
+          (!strcmp (op1, "c") && st->carry == 0))
+        rtrack_remove (l->pl);
+      return;
+    }
+  if (!strcmp (l->inst, "setb") && l->nops == 1)
+    {
+      if (!strcmp (op1, "c") && st->carry == 1)
+        rtrack_remove (l->pl);
+      return;
+    }
+  if (strcmp (l->inst, "mov") || l->nops != 2)
+    return;
+
+  r1 = rtrack_reg (op1);
+  r2 = rtrack_reg (op2);
+
+  if (!strcmp (op1, "dptr"))
+    {
+      if (rtrack_literal (op2, &value))
+        {
+          if (st->reg[RT_DPL].kind == RT_VALUE && st->reg[RT_DPL].value == (value & 0xff) &&
+              st->reg[RT_DPH].kind == RT_VALUE && st->reg[RT_DPH].value == ((value >> 8) & 0xff))
+            rtrack_remove (l->pl);
+        }
+      else if (op2[0] == '#' &&
+               st->reg[RT_DPL].kind == RT_SYM && !strcmp (st->reg[RT_DPL].sym, op2 + 1) &&
+               st->reg[RT_DPH].kind == RT_SYMHI && !strcmp (st->reg[RT_DPH].sym, op2 + 1))
+        rtrack_remove (l->pl);
+      return;
+    }
+
+  if (r1 >= 0 && r2 >= 0)
+    {
+      if (rtrack_same (st, r1, r2))
+        rtrack_remove (l->pl);
+      return;
+    }
+
+  if (rtrack_literal (op2, &value))
+    {
+      int r;
+
+      value &= 0xff;
+      if (r1 >= 0 && st->reg[r1].kind == RT_VALUE && st->reg[r1].value == value)
+        {
+          rtrack_remove (l->pl);
+          return;
+        }
+      /* mov a,rn, mov rn,a and mov @ri,a take one byte less than
+         with #data, so do mov direct,a (one cycle less, too) and
+         mov direct,rn. Leave dpl and dph to the peephole optimizer,
+         which makes a mov dptr,#data of them. */
+      r = rtrack_reg_with_value (st, value);
+      if (r < 0 || r == r1 || r1 == RT_DPL || r1 == RT_DPH)
+        return;
+      if (r1 == RT_A)
+        rtrack_replace (l->pl, op1, rtrack_regname[r]);
+      else if (r == RT_A)
+        rtrack_replace (l->pl, op1, "a");
+      else if (op1[0] != '@' && (r1 < 0 || r1 >= RT_DPL))
+        rtrack_replace (l->pl, op1, rtrack_regname[r]);
+      return;
+    }
+
+  if (r1 >= 0 && op2[0] == '#' &&
+      st->reg[r1].kind == RT_SYM && !strcmp (st->reg[r1].sym, op2 + 1))
+    rtrack_remove (l->pl);
+}
+
+
+/* Forward data flow analysis of the lines of a function, removing
+   redundant moves. */
+void rtrackOptimize (lineNode *head)
+{
+  rtrack_line *lines = NULL;
+  rtrack_label *label = NULL;
+  hTab *labels = NULL;
+  rtrack_state st, taken;
+  int n = 0, nlabels = 0, alloc = 0, i, j;
+  bool change, jumptable = false;
+  lineNode *pl;
+
+  /* parse the lines, find the labels */
+  for (pl = head; pl; pl = pl->next)
+    {
+      rtrack_line *l;
+      const char *start;
+      int len;
+
+      /* don't touch functions with inline assembler */
+      if (pl->isInline)
+        goto done;
+      if (!pl->line || pl->isComment || pl->isDebug || *pl->line == ';' || strstr (pl->line, "==."))
+        continue;
+
+      if (n == alloc)
+        {
+          alloc = alloc ? 2 * alloc : 256;
+          lines = Safe_realloc (lines, alloc * sizeof *lines);
+        }
+      l = &lines[n++];
+      l->pl = pl;
+      l->inst[0] = 0;
+      l->nops = 0;
+      l->target = -1;
+      l->label = -1;
+
+      if (isLabelDefinition (pl->line, &start, &len, FALSE))
+        {
+          char name[sizeof l->op[0]];
+
+          if (len >= (int)sizeof l->op[0])
+            goto done;
+          memcpy (name, start, len);
+          name[len] = 0;
+          l->label = nlabels++;
+          strcpy (l->op[0], name);
+        }
+      else if (!rtrack_parse (l))
+        strcpy (l->inst, "?");
+      else if (l->nops && l->op[0][0] == '=')
+        l->inst[0] = 0;           /* symbol definition */
+    }
+
+  label = Safe_calloc (nlabels ? nlabels : 1, sizeof *label);
+  for (i = 0; i < n; i++)
+    if (lines[i].label >= 0)
+      hTabAddItem (&labels, hashSymbolName (lines[i].op[0]), &lines[i]);
+
+  /* resolve jumps, labels reached otherwise get an unknown state */
+  for (i = 0; i < n; i++)
+    {
+      rtrack_line *l = &lines[i];
+
+      if (l->label >= 0)
+        continue;
+      if (l->inst[0] && rtrack_is_jump (l->inst) && l->nops)
+        {
+          const char *name = l->op[l->nops - 1];
+
+          l->target = rtrack_find_label (labels, name);
+          /* entries of a jump table */
+          if (jumptable && l->target >= 0)
+            label[l->target].unknown = true;
+          if (strcmp (l->inst, "ljmp") && strcmp (l->inst, "ajmp") && strcmp (l->inst, "sjmp"))
+            jumptable = false;
+          for (j = 0; j < l->nops - 1; j++)
+            rtrack_mark_references (l->op[j], labels, label);
+        }
+      else
+        {
+          jumptable = !strcmp (l->inst, "jmp");
+          rtrack_mark_references (l->pl->line, labels, label);
+        }
+    }
+
+  for (i = 0; i < nlabels; i++)
+    if (label[i].unknown)
+      {
+        label[i].in.reached = true;
+        label[i].in.carry = -1;
+      }
+
+  /* iterate to the fixed point */
+  do
+    {
+      change = false;
+      memset (&st, 0, sizeof st);
+      st.reached = true;
+      st.carry = -1;
+
+      for (i = 0; i < n; i++)
+        {
+          rtrack_line *l = &lines[i];
+
+          if (l->label >= 0)
+            {
+              change |= rtrack_join (&label[l->label], &st);
+              st = label[l->label].in;
+              continue;
+            }
+          if (!st.reached)
+            continue;
+          if (!l->inst[0])
+            continue;
+          rtrack_step (&st, l, &taken, i);
+          if (l->target >= 0)
+            change |= rtrack_join (&label[l->target], &taken);
+        }
+    }
+  while (change);
+
+  /* use it */
+  memset (&st, 0, sizeof st);
+  st.reached = true;
+  st.carry = -1;
+  for (i = 0; i < n; i++)
+    {
+      rtrack_line *l = &lines[i];
+
+      if (l->label >= 0)
+        {
+          st = label[l->label].in;
+          continue;
+        }
+      if (!st.reached || !l->inst[0])
+        continue;
+      /* a line changed has the same effect, so go on with it as parsed */
+      rtrack_improve (&st, l);
+      rtrack_step (&st, l, &taken, i);
+    }
+
+done:
+  Safe_free (lines);
+  Safe_free (label);
+  if (labels)
+    {
+      hTabDeleteAll (labels);
+      Safe_free (labels);
+    }
+}
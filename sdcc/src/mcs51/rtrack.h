@@ -26,3 +26,5 @@ int rtrackMoveALit (const char *x);
 
 void rtrackLoadDptrWithSym (const char *x);
 void rtrackLoadR0R1WithSym (const char *reg, const char *x);
+
+void rtrackOptimize (lineNode *head);
@@ -1338,15 +1338,26 @@ genCall (const iCode *ic)
     }
   else
     {
+      // A call in tail position becomes a goto if there is no stack frame to clean up. Saves two bytes of the tiny stack.
+      bool tailjump = isTailCall (ic) && !ic->parmBytes && !bigreturn && !G.stack.pushed && !currFunc->stack;
+
       if (IS_LITERAL (etype))
-        emit2 ("call", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+        emit2 (tailjump ? "goto" : "call", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
       else
         {
-          bool jump = (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
+          bool jump = tailjump || (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
           emit2 (jump ? "goto" : "call", "%s",
                  (OP_SYMBOL (IC_LEFT (ic))->rname[0] ? OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
         }
       cost (1, 2);
+
+      if (tailjump)
+        {
+          if (!regalloc_dry_run)
+            ic->next->generated = 1;
+          G.p.type = AOP_INVALID;
+          return;
+        }
     }
   G.p.type = AOP_INVALID;
 
@@ -4034,9 +4045,7 @@ dryPdkiCode (iCode *ic)
 
   wassert (regalloc_dry_run);
 
-  const unsigned int word_cost_weight = 2 << (optimize.codeSize * 3 + !optimize.codeSpeed * 3);
-
-  return (regalloc_dry_run_cost_words * word_cost_weight + regalloc_dry_run_cost_cycles * ic->count);
+  return (dryRunCost (regalloc_dry_run_cost_words, regalloc_dry_run_cost_cycles, ic));
 }
 
 /*---------------------------------------------------------------------*/
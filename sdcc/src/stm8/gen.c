@@ -3053,7 +3053,7 @@ genIpush (const iCode * ic)
 static void
 genCall (const iCode *ic)
 {
-  bool SomethingReturned, bigreturn, half;
+  bool SomethingReturned, bigreturn, half, tailjump;
   sym_link *dtype = operandType (IC_LEFT (ic));
   sym_link *etype = getSpec (dtype);
   sym_link *ftype = IS_FUNCPTR (dtype) ? dtype->next : dtype;
@@ -3064,6 +3064,11 @@ genCall (const iCode *ic)
 
   /* Return value of big type or returning struct or union. */
   bigreturn = (getSize (ftype->next) > 4) || IS_STRUCT (ftype->next);
+
+  /* Jump to the callee and let it return to our caller when there is */
+  /* nothing left to clean up after the call.                         */
+  tailjump = isTailCall (ic) && !ic->parmBytes && !bigreturn && !currFunc->stack && !G.stack.pushed && !stm8_extend_stack &&
+    !(ic->op == PCALL && options.model == MODEL_LARGE);
   if (bigreturn)
     {
       wassertl (IC_RESULT (ic), "Unused return value in call to function returning large type.");
@@ -3143,20 +3148,20 @@ genCall (const iCode *ic)
 
           if (left->aop->type == AOP_LIT || left->aop->type == AOP_IMMD)
             {
-              emit2 ("call", "%s", aopGet2 (left->aop, 0));
-              cost (3, 4);
+              emit2 (tailjump ? "jp" : "call", "%s", aopGet2 (left->aop, 0));
+              cost (3, tailjump ? 1 : 4);
             }
           else if (aopInReg (left->aop, 0, Y_IDX)) // Faster than going through x.
             {
-              emit2 ("call", "(y)");
-              cost (2, 4);
+              emit2 (tailjump ? "jp" : "call", "(y)");
+              cost (2, tailjump ? 1 : 4);
             }
           else
             {
               genMove (ASMOP_X, left->aop, TRUE, TRUE, TRUE);
           
-              emit2 ("call", "(x)");
-              cost (1, 4);
+              emit2 (tailjump ? "jp" : "call", "(x)");
+              cost (1, tailjump ? 1 : 4);
             }
         }
       freeAsmop (left);
@@ -3167,12 +3172,12 @@ genCall (const iCode *ic)
         {
           if (IS_LITERAL (etype))
             {
-              emit2 ("callf", "0x%06X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
-              cost (4, 5);
+              emit2 (tailjump ? "jpf" : "callf", "0x%06X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+              cost (4, tailjump ? 2 : 5);
             }
           else
             {
-              bool jump = (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
+              bool jump = tailjump || (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
               emit2 (jump ? "jpf" : "callf", "%s",
                 (OP_SYMBOL (IC_LEFT (ic))->rname[0] ? OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
               cost (4, jump ? 2 : 5);
@@ -3182,12 +3187,12 @@ genCall (const iCode *ic)
         {
           if (IS_LITERAL (etype))
             {
-              emit2 ("call", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
-              cost (3, 4);
+              emit2 (tailjump ? "jp" : "call", "0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+              cost (3, tailjump ? 1 : 4);
             }
           else
             {
-              bool jump = (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
+              bool jump = tailjump || (!ic->parmBytes && IFFUNC_ISNORETURN (OP_SYMBOL (IC_LEFT (ic))->type));
               emit2 (jump ? "jp" : "call", "%s",
                 (OP_SYMBOL (IC_LEFT (ic))->rname[0] ? OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
               cost (3, jump ? 1 : 4);
@@ -3195,6 +3200,15 @@ genCall (const iCode *ic)
         }
     }
 
+  /* The callee returns directly to our caller, the return value already is in place. */
+  if (tailjump)
+    {
+      if (!regalloc_dry_run)
+        ic->next->generated = 1;
+      G.saved = FALSE;
+      return;
+    }
+
   SomethingReturned = (IS_ITEMP (IC_RESULT (ic)) &&
                        (OP_SYMBOL (IC_RESULT (ic))->nRegs || OP_SYMBOL (IC_RESULT (ic))->spildir))
                        || IS_TRUE_SYMOP (IC_RESULT (ic));
@@ -8130,9 +8144,7 @@ drySTM8iCode (iCode *ic)
 
   wassert (regalloc_dry_run);
 
-  const unsigned int byte_cost_weight = 2 << (optimize.codeSize * 3 + !optimize.codeSpeed * 3);
-
-  return ((float)regalloc_dry_run_cost_bytes * byte_cost_weight + (float)regalloc_dry_run_cost_cycles * ic->count);
+  return (dryRunCost (regalloc_dry_run_cost_bytes, regalloc_dry_run_cost_cycles, ic));
 }
 
 /*---------------------------------------------------------------------*/
@@ -11,20 +11,46 @@
 #define EQUALS(l, i) (!STRCASECMP((l), (i)))
 #define ISINST(l, i) (!STRNCASECMP((l), (i), sizeof(i) - 1) && (!(l)[sizeof(i) - 1] || isspace((unsigned char)((l)[sizeof(i) - 1]))))
 
+/* Registers and flags tracked by the liveness analysis behind notUsed. */
+static const char *const liveRegs[] = {"a", "xl", "xh", "yl", "yh", "c", "n", "z"};
+#define LIVE_REGS (sizeof (liveRegs) / sizeof (*liveRegs))
+#define LIVE_ALL ((1u << LIVE_REGS) - 1)
+
 typedef enum
 {
-  S4O_CONDJMP,
-  S4O_WR_OP,
-  S4O_RD_OP,
-  S4O_TERM,
-  S4O_VISITED,
-  S4O_ABORT,
-  S4O_CONTINUE
-} S4O_RET;
+  FLOW_SKIP,                    /* label, comment or debug line */
+  FLOW_ABORT,                   /* inline assembler, unknown jump target */
+  FLOW_NEXT,
+  FLOW_JUMP,
+  FLOW_CONDJUMP
+} FLOW_KIND;
+
+/* A line as seen by the liveness analysis. It is parsed once, when
+   the line is first met; rule replacements elsewhere only make the
+   liveness itself be recomputed. */
+typedef struct stm8AsmLineNode
+  {
+#ifdef UNNAMED_STRUCT_TAG
+  struct asmLineNodeBase;
+#else
+    /* exactly the same members as of struct asmLineNodeBase from SDCCgen.h */
+    int size;
+    bitVect *regsRead;
+    bitVect *regsWritten;
+#endif
+    FLOW_KIND flow;
+    unsigned int read;          /* registers the line might read */
+    unsigned int written;       /* registers the line surely overwrites */
+    const char *target;         /* label a jump goes to */
+    lineNode *targetLine;       /* line defining target */
+    unsigned int live;          /* registers that might be read from this line on */
+  }
+stm8AsmLineNode;
 
 static struct
 {
   lineNode *head;
+  unsigned long version;        /* peepLineListVersion the liveness belongs to */
 } _G;
 
 static bool
@@ -432,34 +458,12 @@ stm8instructionSize(const lineNode *pl)
 }
 
 /*-----------------------------------------------------------------*/
-/* incLabelJmpToCount - increment counter "jmpToCount" in entry    */
-/* of the list labelHash                                           */
-/*-----------------------------------------------------------------*/
-static bool
-incLabelJmpToCount (const char *label)
-{
-  labelHashEntry *entry;
-
-  entry = getLabelRef (label, _G.head);
-  if (!entry)
-    return FALSE;
-  entry->jmpToCount++;
-  return TRUE;
-}
-
-/*-----------------------------------------------------------------*/
-/* findLabel -                                                     */
-/* 1. extracts label in the opcode pl                              */
-/* 2. increment "label jump-to count" in labelHash                 */
-/* 3. search lineNode with label definition and return it          */
+/* jumpTarget - extracts the label of the jump pl                  */
 /*-----------------------------------------------------------------*/
-static lineNode *
-findLabel (const lineNode *pl)
+static const char *
+jumpTarget (const lineNode *pl)
 {
-  char *p;
-  lineNode *cpl;
-
-  /* 1. extract label in opcode */
+  const char *p;
 
   /* In each jump the label is at the end */
   p = strlen (pl->line) - 1 + pl->line;
@@ -481,22 +485,7 @@ findLabel (const lineNode *pl)
     }
 
   /* skip ',' resp. '\t' */
-  ++p;
-
-  /* 2. increment "label jump-to count" */
-  if (!incLabelJmpToCount (p))
-    return NULL;
-
-  /* 3. search lineNode with label definition and return it */
-  for (cpl = _G.head; cpl; cpl = cpl->next)
-    {
-      if (   cpl->isLabel
-          && strncmp (p, cpl->line, strlen(p)) == 0)
-        {
-          return cpl;
-        }
-    }
-  return NULL;
+  return ++p;
 }
 
 /* Check if reading arg implies reading what. */
@@ -899,172 +888,181 @@ stm8SurelyReturns(const lineNode *pl)
 }
 
 /*-----------------------------------------------------------------*/
-/* scan4op - "executes" and examines the assembler opcodes,        */
-/* follows conditional and un-conditional jumps.                   */
-/* Moreover it registers all passed labels.                        */
-/*                                                                 */
-/* Parameter:                                                      */
-/*    lineNode **pl                                                */
-/*       scanning starts from pl;                                  */
-/*       pl also returns the last scanned line                     */
-/*    const char *pReg                                             */
-/*       points to a register (e.g. "ar0"). scan4op() tests for    */
-/*       read or write operations with this register               */
-/*    const char *untilOp                                          */
-/*       points to NULL or a opcode (e.g. "push").                 */
-/*       scan4op() returns if it hits this opcode.                 */
-/*    lineNode **plCond                                            */
-/*       If a conditional branch is met plCond points to the       */
-/*       lineNode of the conditional branch                        */
-/*                                                                 */
-/* Returns:                                                        */
-/*    S4O_ABORT                                                    */
-/*       on error                                                  */
-/*    S4O_VISITED                                                  */
-/*       hit lineNode with "visited" flag set: scan4op() already   */
-/*       scanned this opcode.                                      */
-/*    S4O_FOUNDOPCODE                                              */
-/*       found opcode and operand, to which untilOp and pReg are   */
-/*       pointing to.                                              */
-/*    S4O_RD_OP, S4O_WR_OP                                         */
-/*       hit an opcode reading or writing from pReg                */
-/*    S4O_CONDJMP                                                  */
-/*       hit a conditional jump opcode. pl and plCond return the   */
-/*       two possible branches.                                    */
-/*    S4O_TERM                                                     */
-/*       acall, lcall, ret and reti "terminate" a scan.            */
+/* liveLine - returns what the liveness analysis needs to know     */
+/* about the line pl, parsing it on first use                      */
 /*-----------------------------------------------------------------*/
-static S4O_RET
-scan4op (lineNode **pl, const char *what, const char *untilOp,
-         lineNode **plCond)
+static stm8AsmLineNode *
+liveLine (lineNode *pl)
 {
-  for (; *pl; *pl = (*pl)->next)
-    {
-      if (!(*pl)->line || (*pl)->isDebug || (*pl)->isComment || (*pl)->isLabel)
-        continue;
-      D(("Scanning %s for %s\n", (*pl)->line, what));
-      /* don't optimize across inline assembler,
-         e.g. isLabel doesn't work there */
-      if ((*pl)->isInline)
-        {
-          D(("S4O_ABORT at inline asm\n"));
-          return S4O_ABORT;
-        }
+  stm8AsmLineNode *aln = (stm8AsmLineNode *) pl->aln;
+  unsigned int i;
 
-      if ((*pl)->visited)
-        {
-          D(("S4O_VISITED\n"));
-          return S4O_VISITED;
-        }
+  if (aln)
+    return aln;
 
-      (*pl)->visited = TRUE;
+  aln = Safe_alloc (sizeof (stm8AsmLineNode));
+  pl->aln = (asmLineNodeBase *) aln;
 
-      if(stm8MightRead(*pl, what))
+  if (!pl->line || pl->isDebug || pl->isComment || pl->isLabel)
+    aln->flow = FLOW_SKIP;
+  /* don't optimize across inline assembler,
+     e.g. isLabel doesn't work there */
+  else if (pl->isInline)
+    aln->flow = FLOW_ABORT;
+  else
+    {
+      for (i = 0; i < LIVE_REGS; i++)
         {
-          D(("S4O_RD_OP\n"));
-          return S4O_RD_OP;
+          if (stm8MightRead (pl, liveRegs[i]))
+            aln->read |= 1u << i;
+          if (stm8SurelyWrites (pl, liveRegs[i]))
+            aln->written |= 1u << i;
         }
 
-      // Check writes before conditional jumps, some jumps (btjf, btjt) write 'c'
-      if(stm8SurelyWrites(*pl, what))
+      if (stm8UncondJump (pl) || stm8CondJump (pl))
         {
-          D(("S4O_WR_OP\n"));
-          return S4O_WR_OP;
+          aln->flow = stm8UncondJump (pl) ? FLOW_JUMP : FLOW_CONDJUMP;
+          aln->target = jumpTarget (pl);
+          if (!aln->target)
+            aln->flow = FLOW_ABORT;
         }
-
-      if(stm8UncondJump(*pl))
+      else
         {
-          *pl = findLabel (*pl);
-            if (!*pl)
-              {
-                D(("S4O_ABORT at unconditional jump\n"));
-                return S4O_ABORT;
-              }
+          aln->flow = FLOW_NEXT;
+          if (stm8SurelyReturns (pl))
+            aln->written = LIVE_ALL;
         }
-      if(stm8CondJump(*pl))
+    }
+
+  return aln;
+}
+
+/*-----------------------------------------------------------------*/
+/* liveSolve - computes for each line of the function which        */
+/* registers might be read from there on, following jumps.         */
+/* Iterates to the least fixed point, so that loops don't keep a   */
+/* register alive that isn't read anywhere in or after them.       */
+/*-----------------------------------------------------------------*/
+static void
+liveSolve (lineNode *head)
+{
+  hTab *labels = newHashTable (HTAB_SIZE);
+  lineNode **lines = NULL;
+  int n = 0, alloc = 0, i;
+  lineNode *pl;
+  bool change;
+
+  _G.head = head;
+  _G.version = peepLineListVersion;
+
+  for (pl = head; pl; pl = pl->next)
+    {
+      const char *label;
+      int len;
+      char name[SDCC_NAME_MAX + 1];
+
+      if (n == alloc)
         {
-          *plCond = findLabel (*pl);
-          if (!*plCond)
-            {
-              D(("S4O_ABORT at conditional jump\n"));
-              return S4O_ABORT;
-            }
-          D(("S4O_CONDJMP\n"));
-          return S4O_CONDJMP;
+          alloc = alloc ? alloc * 2 : 256;
+          lines = Safe_realloc (lines, alloc * sizeof (lineNode *));
         }
+      lines[n++] = pl;
+      liveLine (pl)->live = 0;
 
-      /* Don't need to check for de, hl since stm8MightRead() does that */
-      if(stm8SurelyReturns(*pl))
+      if (pl->isLabel && isLabelDefinition (pl->line, &label, &len, FALSE) && len <= SDCC_NAME_MAX)
         {
-          D(("S4O_TERM\n"));
-          return S4O_TERM;
+          memcpy (name, label, len);
+          name[len] = 0;
+          hTabAddItem (&labels, hashSymbolName (name), pl);
         }
     }
-  D(("S4O_ABORT\n"));
-  return S4O_ABORT;
-}
 
-/*-----------------------------------------------------------------*/
-/* doTermScan - scan through area 2. This small wrapper handles:   */
-/* - action required on different return values                    */
-/* - recursion in case of conditional branches                     */
-/*-----------------------------------------------------------------*/
-static bool
-doTermScan (lineNode **pl, const char *what)
-{
-  lineNode *plConditional;
-  for (;; *pl = (*pl)->next)
+  for (i = 0; i < n; i++)
+    {
+      stm8AsmLineNode *aln = (stm8AsmLineNode *) lines[i]->aln;
+      const lineNode *cpl;
+
+      if (aln->flow != FLOW_JUMP && aln->flow != FLOW_CONDJUMP)
+        continue;
+
+      aln->targetLine = NULL;
+      if (!getLabelRef (aln->target, head))
+        continue;
+      for (cpl = hTabFirstItemWK (labels, hashSymbolName (aln->target)); cpl; cpl = hTabNextItemWK (labels))
+        if (strncmp (aln->target, cpl->line, strlen (aln->target)) == 0)
+          {
+            aln->targetLine = (lineNode *) cpl;
+            break;
+          }
+    }
+
+  do
     {
-      switch (scan4op (pl, what, NULL, &plConditional))
+      change = FALSE;
+      for (i = n - 1; i >= 0; i--)
         {
-          case S4O_TERM:
-          case S4O_VISITED:
-          case S4O_WR_OP:
-            /* all these are terminating conditions */
-            return TRUE;
-          case S4O_CONDJMP:
-            /* two possible destinations: recurse */
-              {
-                lineNode *pl2 = plConditional;
-                D(("CONDJMP trying other branch first\n"));
-                if (!doTermScan (&pl2, what))
-                  return FALSE;
-                D(("Other branch OK.\n"));
-              }
-            continue;
-          case S4O_RD_OP:
-          default:
-            /* no go */
-            return FALSE;
+          stm8AsmLineNode *aln = (stm8AsmLineNode *) lines[i]->aln;
+          unsigned int next = i + 1 < n ? ((stm8AsmLineNode *) lines[i + 1]->aln)->live : LIVE_ALL;
+          unsigned int target = aln->targetLine ? ((stm8AsmLineNode *) aln->targetLine->aln)->live : LIVE_ALL;
+          unsigned int live;
+
+          // Writes are checked before jumps, some jumps (btjf, btjt) write 'c'
+          switch (aln->flow)
+            {
+            case FLOW_SKIP:
+              live = next;
+              break;
+            case FLOW_NEXT:
+              live = aln->read | (next & ~aln->written);
+              break;
+            case FLOW_JUMP:
+              live = aln->read | (target & ~aln->written);
+              break;
+            case FLOW_CONDJUMP:
+              live = aln->read | ((next | target) & ~aln->written);
+              break;
+            case FLOW_ABORT:
+            default:
+              live = LIVE_ALL;
+              break;
+            }
+
+          if (live != aln->live)
+            {
+              aln->live = live;
+              change = TRUE;
+            }
         }
     }
-}
+  while (change);
 
-/*-----------------------------------------------------------------*/
-/* univisitLines - clear "visited" flag in all lines               */
-/*-----------------------------------------------------------------*/
-static void
-unvisitLines (lineNode *pl)
-{
-  for (; pl; pl = pl->next)
-    pl->visited = FALSE;
+  Safe_free (lines);
+  hTabDeleteAll (labels);
+  Safe_free (labels);
 }
 
 bool
 stm8notUsed (const char *what, lineNode *endPl, lineNode *head)
 {
-  lineNode *pl;
+  unsigned int i;
+
   if(strcmp(what, "x") == 0)
     return(stm8notUsed("xl", endPl, head) && stm8notUsed("xh", endPl, head));
   else if(strcmp(what, "y") == 0)
     return(stm8notUsed("yl", endPl, head) && stm8notUsed("yh", endPl, head));
 
-  _G.head = head;
+  // Anything else is assumed to be read.
+  for(i = 0; i < LIVE_REGS && strcmp(what, liveRegs[i]); i++);
+  if(i == LIVE_REGS)
+    return FALSE;
 
-  unvisitLines (_G.head);
+  if(_G.head != head || _G.version != peepLineListVersion)
+    liveSolve (head);
+
+  if(!endPl->next)
+    return FALSE;
 
-  pl = endPl->next;
-  return (doTermScan (&pl, what));
+  return !(liveLine (endPl->next)->live & (1u << i));
 }
 
 bool
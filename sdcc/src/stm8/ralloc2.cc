@@ -579,7 +579,7 @@ iCode *stm8_ralloc2_cc(ebbIndex *ebbi)
 
   tree_dec_t tree_decomposition;
 
-  get_nice_tree_decomposition(tree_decomposition, control_flow_graph);
+  get_nice_tree_decomposition(tree_decomposition, control_flow_graph, "register allocator");
 
   alive_tree_dec(tree_decomposition, control_flow_graph);
 
@@ -346,17 +346,60 @@ z80_init_asmops (void)
 
 static bool regalloc_dry_run;
 static unsigned int regalloc_dry_run_cost;
+static unsigned int regalloc_dry_run_cost_cycles;
+static unsigned int regalloc_dry_run_cost_timed;  /* Bytes in regalloc_dry_run_cost that came with a cycle count */
+
+/* Cycle counts of the basic operations the dry run cost is built from. */
+struct z80_timing
+{
+  unsigned char per_byte;       /* Estimate for code that is only costed in bytes */
+  unsigned char ld_r_r, ld_r_n, ld_r_hl, ld_hl_r, ld_hl_n, ld_r_ix, ld_ix_r, ld_ix_n;
+  unsigned char ld_hl_nn, ld_iy_nn, in_a, out_a;
+  unsigned char alu_r, alu_n, alu_hl, alu_ix;
+  unsigned char inc_r, inc_hl, inc_ix;
+  unsigned char rot_a, neg, rot_r, rot_hl, rot_ix;
+};
+
+/* Indexed by Z80_SUB_PORT. Rabbit cycles are clocks, gbz80 cycles are
+   clocks (4 per machine cycle), tlcs90 and eZ80 values are approximate.
+   gbz80 has no index registers, (ix+d) stands for the ldhl sp, #d; (hl)
+   sequence used for stack access instead. */
+static const struct z80_timing z80_timings[] =
+{
+  /* z80 */     {5,  4, 7, 7, 7, 10, 19, 19, 19,  10, 14, 11, 11,  4, 7, 7, 19,  4, 11, 23,  4, 8, 8, 15, 23},
+  /* z180 */    {4,  4, 6, 6, 7,  9, 14, 15, 15,   9, 12,  9, 10,  4, 6, 6, 14,  4, 10, 18,  3, 6, 7, 13, 19},
+  /* r2k */     {3,  2, 4, 5, 6,  7,  9, 10, 11,   6,  8, 11, 12,  2, 4, 5,  9,  2,  8, 12,  2, 4, 4, 10, 13},
+  /* r3ka */    {3,  2, 4, 5, 6,  7,  9, 10, 11,   6,  8, 11, 12,  2, 4, 5,  9,  2,  8, 12,  2, 4, 4, 10, 13},
+  /* gbz80 */   {5,  4, 8, 8, 8, 12, 20, 20, 24,  12, 12, 12, 12,  4, 8, 8, 20,  4, 12, 24,  4, 8, 8, 16, 28},
+  /* tlcs90 */  {4,  4, 6, 6, 8, 10, 10, 12, 14,   6,  8,  8, 10,  4, 6, 6, 10,  4, 10, 14,  4, 6, 4, 12, 16},
+  /* ez80_z80 */{2,  1, 2, 2, 2,  3,  4,  4,  5,   3,  4,  3,  3,  1, 2, 2,  4,  1,  4,  6,  1, 2, 2,  5,  7},
+};
+
+#define TIMING (&z80_timings[z80_opts.sub])
 
 static void
 cost(unsigned int bytes, unsigned int cycles)
 {
   regalloc_dry_run_cost += bytes;
+  regalloc_dry_run_cost_cycles += cycles;
+  regalloc_dry_run_cost_timed += bytes;
 }
 
 static void
 cost2(unsigned int bytes, unsigned int cycles_z80, unsigned int cycles_z180, unsigned int cycles_r2k, unsigned int cycles_gbz80, unsigned int cycles_tlcs90, unsigned int cycles_ez80_z80)
 {
-  regalloc_dry_run_cost += bytes;
+  if (IS_GB)
+    cost (bytes, cycles_gbz80);
+  else if (IS_RAB)
+    cost (bytes, cycles_r2k);
+  else if (IS_Z180)
+    cost (bytes, cycles_z180);
+  else if (IS_TLCS90)
+    cost (bytes, cycles_tlcs90);
+  else if (IS_EZ80_Z80)
+    cost (bytes, cycles_ez80_z80);
+  else
+    cost (bytes, cycles_z80);
 }
 
 /*-----------------------------------------------------------------*/
@@ -963,16 +1006,157 @@ emit3Cost (enum asminst inst, const asmop *op1, int offset1, const asmop *op2, i
   return (0);
 }
 
+/* Cycles for getting a byte into a register (or, if store, from a register into op), following the code ld_cost () assumes. */
+static unsigned int
+ld_r_cycles (const asmop *op, bool a, bool store)
+{
+  const struct z80_timing *t = TIMING;
+
+  switch (op->type)
+    {
+    case AOP_REG:
+    case AOP_HLREG:
+    case AOP_DUMMY:
+      return (t->ld_r_r);
+    case AOP_IMMD:
+    case AOP_LIT:
+      return (t->ld_r_n);
+    case AOP_SFR:
+      return ((store ? t->out_a : t->in_a) + (a ? 0 : t->ld_r_r));
+    case AOP_STK:
+      return (store ? t->ld_ix_r : t->ld_r_ix);
+    case AOP_HL:
+      return (t->ld_hl_nn + (store ? t->ld_hl_r : t->ld_r_hl));
+    case AOP_IY:
+    case AOP_EXSTK:
+      return (t->ld_iy_nn + (store ? t->ld_ix_r : t->ld_r_ix));
+    case AOP_PAIRPTR:
+      if (op->aopu.aop_pairId == PAIR_IY || op->aopu.aop_pairId == PAIR_IX)
+        return (store ? t->ld_ix_r : t->ld_r_ix);
+      return ((store ? t->ld_hl_r : t->ld_r_hl) + (a || op->aopu.aop_pairId == PAIR_HL ? 0 : t->ld_r_r));
+    default:
+      return (8 * t->per_byte);
+    }
+}
+
+static unsigned int
+ld_cycles (const asmop *op1, const asmop *op2)
+{
+  const struct z80_timing *t = TIMING;
+  bool op1reg = (op1->type == AOP_REG || op1->type == AOP_HLREG || op1->type == AOP_DUMMY);
+  bool op2reg = (op2->type == AOP_REG || op2->type == AOP_HLREG || op2->type == AOP_DUMMY);
+
+  if (op1reg)
+    return (ld_r_cycles (op2, aopInReg (op1, 0, A_IDX) || op1->type == AOP_DUMMY, false));
+  if (op2reg)
+    return (ld_r_cycles (op1, aopInReg (op2, 0, A_IDX) || op2->type == AOP_DUMMY, true));
+
+  /* Memory to memory goes through a register. */
+  if (op2->type == AOP_IMMD || op2->type == AOP_LIT)
+    switch (op1->type)
+      {
+      case AOP_STK:
+        return (t->ld_ix_n);
+      case AOP_HL:
+        return (t->ld_hl_nn + t->ld_hl_n);
+      case AOP_IY:
+      case AOP_EXSTK:
+        return (t->ld_iy_nn + t->ld_ix_n);
+      default:
+        break;
+      }
+  return (ld_r_cycles (op2, true, false) + ld_r_cycles (op1, true, true));
+}
+
+static unsigned int
+op8_cycles (const asmop *op2, unsigned int r, unsigned int n, unsigned int hl, unsigned int ix)
+{
+  const struct z80_timing *t = TIMING;
+
+  switch (op2->type)
+    {
+    case AOP_REG:
+    case AOP_HLREG:
+    case AOP_DUMMY:
+      return (r);
+    case AOP_IMMD:
+    case AOP_LIT:
+      return (n);
+    case AOP_STK:
+      return (ix);
+    case AOP_HL:
+      return (t->ld_hl_nn + hl);
+    case AOP_IY:
+    case AOP_EXSTK:
+      return (t->ld_iy_nn + ix);
+    case AOP_PAIRPTR:
+      if (op2->aopu.aop_pairId == PAIR_IY || op2->aopu.aop_pairId == PAIR_IX)
+        return (ix);
+      return (hl);
+    default:
+      return (8 * t->per_byte);
+    }
+}
+
+static unsigned int
+emit3Cycles (enum asminst inst, const asmop *op1, int offset1, const asmop *op2, int offset2)
+{
+  const struct z80_timing *t = TIMING;
+
+  if (op2 && offset2 >= op2->size)
+    op2 = ASMOP_ZERO;
+
+  switch (inst)
+    {
+    case A_CPL:
+    case A_RLA:
+    case A_RLCA:
+    case A_RRA:
+    case A_RRCA:
+      return (t->rot_a);
+    case A_NEG:
+      return (t->neg);
+    case A_LD:
+      return (ld_cycles (op1, op2));
+    case A_ADD:
+    case A_ADC:
+    case A_AND:
+    case A_CP:
+    case A_OR:
+    case A_SBC:
+    case A_SUB:
+    case A_XOR:
+      return (op8_cycles (op2, t->alu_r, t->alu_n, t->alu_hl, t->alu_ix));
+    case A_DEC:
+    case A_INC:
+      return (op8_cycles (op1, t->inc_r, t->inc_r, t->inc_hl, t->inc_ix));
+    case A_RL:
+    case A_RLC:
+    case A_RR:
+    case A_RRC:
+    case A_SLA:
+    case A_SRA:
+    case A_SRL:
+    case A_SWAP:
+      return (op8_cycles (op1, t->rot_r, t->rot_r, t->rot_hl, t->rot_ix));
+    default:
+      wassertl (0, "Tried get cost for unknown instruction");
+    }
+  return (0);
+}
+
 static void
 emit3_o (enum asminst inst, asmop *op1, int offset1, asmop *op2, int offset2)
 {
-  unsigned char cost;
+  unsigned int saved_cost, saved_cycles, saved_timed;
 
-  regalloc_dry_run_cost += emit3Cost (inst, op1, offset1, op2, offset2);
+  cost (emit3Cost (inst, op1, offset1, op2, offset2), emit3Cycles (inst, op1, offset1, op2, offset2));
   if (regalloc_dry_run)
     return;
 
-  cost = regalloc_dry_run_cost;
+  saved_cost = regalloc_dry_run_cost;
+  saved_cycles = regalloc_dry_run_cost_cycles;
+  saved_timed = regalloc_dry_run_cost_timed;
   if (!op1)
     emit2 ("%s", asminstnames[inst]);
   else if (!op2)
@@ -985,7 +1169,9 @@ emit3_o (enum asminst inst, asmop *op1, int offset1, asmop *op2, int offset2)
       Safe_free (l);
     }
 
-  regalloc_dry_run_cost = cost;
+  regalloc_dry_run_cost = saved_cost;
+  regalloc_dry_run_cost_cycles = saved_cycles;
+  regalloc_dry_run_cost_timed = saved_timed;
   //emitDebug(";emit3_o cost: %d total so far: %d", (int)emit3Cost(inst, op1, offset1, op2, offset2), (int)cost);
 }
 
@@ -2196,7 +2382,7 @@ fetchPairLong (PAIR_ID pairId, asmop *aop, const iCode *ic, int offset)
                   emit2 ("ld %s, %s", _pairs[id].l, aopGet (aop, offset, FALSE));
                   emit2 ("ld %s, %s", _pairs[id].h, aopGet (aop, offset + 1, FALSE));
                 }
-              regalloc_dry_run_cost += ld_cost (ASMOP_L, aop) + ld_cost (ASMOP_H, aop);
+              cost (ld_cost (ASMOP_L, aop) + ld_cost (ASMOP_H, aop), ld_cycles (ASMOP_L, aop) + ld_cycles (ASMOP_H, aop));
 
               if ((IS_RAB || IS_TLCS90) && id == PAIR_HL)
                 {
@@ -2251,7 +2437,7 @@ fetchPairLong (PAIR_ID pairId, asmop *aop, const iCode *ic, int offset)
               _moveA3 (aop, offset + 1);
               if (!regalloc_dry_run)
                 emit2 ("ld %s, %s", _pairs[pairId].l, aopGet (aop, offset, FALSE));
-              regalloc_dry_run_cost += ld_cost (ASMOP_A, aop);
+              cost (ld_cost (ASMOP_A, aop), ld_cycles (ASMOP_A, aop));
               emit2 ("ld %s, a", _pairs[pairId].h);
               regalloc_dry_run_cost += 1;
             }
@@ -2262,7 +2448,7 @@ fetchPairLong (PAIR_ID pairId, asmop *aop, const iCode *ic, int offset)
               regalloc_dry_run_cost++;
               if (!regalloc_dry_run)
                 emit2 ("ld %s, %s", _pairs[pairId].l, aopGet (aop, offset, FALSE));
-              regalloc_dry_run_cost += ld_cost (ASMOP_L, aop);
+              cost (ld_cost (ASMOP_L, aop), ld_cycles (ASMOP_L, aop));
             }
           else
             {
@@ -2270,13 +2456,13 @@ fetchPairLong (PAIR_ID pairId, asmop *aop, const iCode *ic, int offset)
                 {
                    if (!regalloc_dry_run)
                      emit2 ("ld %s, %s", _pairs[pairId].l, aopGet (aop, offset, FALSE));
-                   regalloc_dry_run_cost += ld_cost (ASMOP_L, aop);
+                   cost (ld_cost (ASMOP_L, aop), ld_cycles (ASMOP_L, aop));
                 }
               if (!aopInReg (aop, offset + 1, _pairs[pairId].h_idx))
                 {
                    if (!regalloc_dry_run)
                      emit2 ("ld %s, %s", _pairs[pairId].h, aopGet (aop, offset + 1, FALSE));
-                   regalloc_dry_run_cost += ld_cost (ASMOP_H, aop);
+                   cost (ld_cost (ASMOP_H, aop), ld_cycles (ASMOP_H, aop));
                 }
             }
         }
@@ -2982,7 +3168,9 @@ aopPut (asmop *aop, const char *s, int offset)
 static void
 aopPut3 (asmop *op1, int offset1, asmop *op2, int offset2, bool a_dead)
 {
-  unsigned char cost = regalloc_dry_run_cost;
+  unsigned int saved_cost = regalloc_dry_run_cost;
+  unsigned int saved_cycles = regalloc_dry_run_cost_cycles;
+  unsigned int saved_timed = regalloc_dry_run_cost_timed;
   int fp_offset=0;
   int sp_offset=0;
 
@@ -3006,7 +3194,10 @@ aopPut3 (asmop *op1, int offset1, asmop *op2, int offset2, bool a_dead)
         aopPut (op1, aopGet (op2, offset2, FALSE), offset1);
     }
 
-  regalloc_dry_run_cost = cost + ld_cost (op1, offset2 < op2->size ? op2 : ASMOP_ZERO);
+  regalloc_dry_run_cost = saved_cost;
+  regalloc_dry_run_cost_cycles = saved_cycles;
+  regalloc_dry_run_cost_timed = saved_timed;
+  cost (ld_cost (op1, offset2 < op2->size ? op2 : ASMOP_ZERO), ld_cycles (op1, offset2 < op2->size ? op2 : ASMOP_ZERO));
 }
 
 // Move, but try not to. Cannot use xor to zero, since xor resets the carry flag.
@@ -4376,7 +4567,7 @@ genIpush (const iCode *ic)
                         {
                           cheapMove (ASMOP_A, 0, AOP (IC_LEFT (ic)), offset, true);
                           if (!aopInReg (IC_LEFT (ic)->aop, 0, A_IDX))
-                            regalloc_dry_run_cost += ld_cost (ASMOP_A, AOP (IC_LEFT (ic)));
+                            cost (ld_cost (ASMOP_A, AOP (IC_LEFT (ic))), ld_cycles (ASMOP_A, AOP (IC_LEFT (ic))));
                         }
                       emit2 ("push af");
                       regalloc_dry_run_cost += 1;
@@ -4539,7 +4730,7 @@ static void genSend (const iCode *ic)
 static void
 emitCall (const iCode *ic, bool ispcall)
 {
-  bool SomethingReturned, bigreturn, z88dk_callee;
+  bool SomethingReturned, bigreturn, z88dk_callee, tailjump;
   sym_link *dtype = operandType (IC_LEFT (ic));
   sym_link *etype = getSpec (dtype);
   sym_link *ftype = IS_FUNCPTR (dtype) ? dtype->next : dtype;
@@ -4554,6 +4745,15 @@ emitCall (const iCode *ic, bool ispcall)
 
   /* Return value of big type or returning struct or union. */
   bigreturn = (getSize (ftype->next) > 4);
+
+  /* A call in tail position can be replaced by a jump if nothing has to be
+     cleaned up after it: no parameters on the stack, no frame, no saved
+     registers. The callee then returns directly to our caller. */
+  tailjump = isTailCall (ic) && !ic->parmBytes && !bigreturn && !z88dk_callee &&
+    !IFFUNC_ISBANKEDCALL (dtype) && !IFFUNC_ISZ88DK_SHORTCALL (ftype) &&
+    (IS_GB || _G.omitFramePtr) && !_G.stack.offset && !_G.stack.pushed &&
+    !_G.calleeSaves.pushedBC && !_G.calleeSaves.pushedDE && !IY_RESERVED;
+
   if (bigreturn)
     {
       PAIR_ID pair;
@@ -4600,20 +4800,26 @@ emitCall (const iCode *ic, bool ispcall)
 
       if (isLitWord (AOP (IC_LEFT (ic))))
         {
-          emit2 ("call %s", aopGetLitWordLong (AOP (IC_LEFT (ic)), 0, FALSE));
+          emit2 ("%s %s", tailjump ? "jp" : "call", aopGetLitWordLong (AOP (IC_LEFT (ic)), 0, FALSE));
           regalloc_dry_run_cost += 3;
         }
       else if (getPairId (AOP (IC_LEFT (ic))) != PAIR_IY && !IFFUNC_ISZ88DK_FASTCALL (ftype))
         {
           spillPair (PAIR_HL);
           fetchPairLong (PAIR_HL, AOP (IC_LEFT (ic)), ic, 0);
-          emit2 ("call ___sdcc_call_hl");
+          if (tailjump)
+            emit2 ("jp (hl)");
+          else
+            emit2 ("call ___sdcc_call_hl");
         }
       else if (!IS_GB && !IY_RESERVED)
         {
           spillPair (PAIR_IY);
           fetchPairLong (PAIR_IY, IC_LEFT (ic)->aop, ic, 0);
-          emit2 ("call ___sdcc_call_iy");
+          if (tailjump)
+            emit2 ("jp (iy)");
+          else
+            emit2 ("call ___sdcc_call_iy");
         }
       else // Use bc, since it is the only 16-bit register guarateed to be free even for __z88dk_fastcall with --reserve-regs-iy
         {
@@ -4656,7 +4862,7 @@ emitCall (const iCode *ic, bool ispcall)
         {
           if (IS_LITERAL (etype))
             {
-              emit2 ("call 0x%04X", ulFromVal (OP_VALUE (IC_LEFT (ic))));
+              emit2 ("%s 0x%04X", tailjump ? "jp" : "call", ulFromVal (OP_VALUE (IC_LEFT (ic))));
               regalloc_dry_run_cost += 3;
             }
           else if ( IFFUNC_ISZ88DK_SHORTCALL(ftype) ) 
@@ -4672,7 +4878,7 @@ emitCall (const iCode *ic, bool ispcall)
             }
           else
             {
-              bool jump = (!ic->parmBytes && IFFUNC_ISNORETURN (ftype));
+              bool jump = tailjump || (!ic->parmBytes && IFFUNC_ISNORETURN (ftype));
               emit2 ("%s %s", jump ? "jp" : "call",
                 (OP_SYMBOL (IC_LEFT (ic))->rname[0] ? OP_SYMBOL (IC_LEFT (ic))->rname : OP_SYMBOL (IC_LEFT (ic))->name));
               regalloc_dry_run_cost += 3;
@@ -4684,6 +4890,14 @@ emitCall (const iCode *ic, bool ispcall)
   /* Mark the registers as restored. */
   _G.saves.saved = FALSE;
 
+  /* The callee returns to our caller, the return is no longer needed. */
+  if (tailjump)
+    {
+      if (!regalloc_dry_run)
+        ic->next->generated = 1;
+      return;
+    }
+
   SomethingReturned = (IS_ITEMP (IC_RESULT (ic)) &&
                        (OP_SYMBOL (IC_RESULT (ic))->nRegs ||
                         OP_SYMBOL (IC_RESULT (ic))->spildir ||
@@ -7687,7 +7901,7 @@ gencjneshort (operand *left, operand *right, symbol *lbl, const iCode *ic)
           if (!regalloc_dry_run)
             _emitMove (_pairs[pair].l, aopGet (AOP (left), offset, FALSE));
           else
-            regalloc_dry_run_cost += ld_cost (ASMOP_E, AOP (left));
+            cost (ld_cost (ASMOP_E, AOP (left)), ld_cycles (ASMOP_E, AOP (left)));
           cheapMove (ASMOP_A, 0, AOP (right), offset, true);
           emit2 ("sub a,%s", _pairs[pair].l);
           regalloc_dry_run_cost += 1;
@@ -9837,7 +10051,7 @@ _moveFrom_tpair_ (asmop * aop, int offset, PAIR_ID pair)
     {
       if (!regalloc_dry_run)
         aopPut (aop, "!*hl", offset);
-      regalloc_dry_run_cost += ld_cost (aop, ASMOP_A);
+      cost (ld_cost (aop, ASMOP_A), ld_cycles (aop, ASMOP_A));
     }
   else
     {
@@ -9949,7 +10163,7 @@ genPointerGet (const iCode *ic)
               aopPut (AOP (result), dbuf_c_str (&dbuf), 0);
               dbuf_destroy (&dbuf);
             }
-          regalloc_dry_run_cost += ld_cost (AOP (result), ASMOP_A);
+          cost (ld_cost (AOP (result), ASMOP_A), ld_cycles (AOP (result), ASMOP_A));
         }
       else
         {
@@ -10295,7 +10509,7 @@ genPointerGet (const iCode *ic)
             {
               if (!regalloc_dry_run)
                 aopPut (AOP (result), "!*hl", offset++);
-              regalloc_dry_run_cost += ld_cost (AOP (result), ASMOP_A);
+              cost (ld_cost (AOP (result), ASMOP_A), ld_cycles (AOP (result), ASMOP_A));
             }
           else
             {
@@ -10364,7 +10578,10 @@ genPackBits (sym_link * etype, operand * right, int pair, const iCode * ic)
         {
           litval = (int) ulFromVal (AOP (right)->aopu.aop_lit);
           emit2 (litval & 1 ? "set %d, !*pair" : "res %d, !*pair", bstr, _pairs[pair].name);
-          regalloc_dry_run_cost = (pair == PAIR_IX || pair == PAIR_IY) ? 4 : 2;
+          if (pair == PAIR_IX || pair == PAIR_IY)
+            cost2 (4, 23, 19, 13, 0, 16, 7);
+          else
+            cost2 (2, 15, 13, 10, 16, 12, 5);
           return;
         }
       else if (AOP_TYPE (right) == AOP_LIT)
@@ -10705,7 +10922,7 @@ genPointerSet (iCode * ic)
             {
               if (!regalloc_dry_run)
                 emit2 ("ld !*pair, %s", _pairs[PAIR_HL].name, aopGet (right->aop, offset, FALSE));
-              regalloc_dry_run_cost += ld_cost (ASMOP_A, right->aop);
+              cost (ld_cost (ASMOP_A, right->aop), ld_cycles (ASMOP_A, right->aop));
               offset++;
             }
           else
@@ -10818,7 +11035,7 @@ genPointerSet (iCode * ic)
             {
               if (!regalloc_dry_run)
                 emit2 ("ld !*pair, %s", _pairs[pairId].name, aopGet (AOP (right), offset, FALSE));
-              regalloc_dry_run_cost += ld_cost (ASMOP_A, AOP (right));
+              cost (ld_cost (ASMOP_A, AOP (right)), ld_cycles (ASMOP_A, AOP (right)));
             }
           else
             {
@@ -12838,11 +13055,13 @@ genZ80iCode (iCode * ic)
     }
 }
 
-unsigned char
+float
 dryZ80iCode (iCode * ic)
 {
   regalloc_dry_run = TRUE;
   regalloc_dry_run_cost = 0;
+  regalloc_dry_run_cost_cycles = 0;
+  regalloc_dry_run_cost_timed = 0;
 
   initGenLineElement ();
   _G.omitFramePtr = should_omit_frame_ptr;
@@ -12858,7 +13077,11 @@ dryZ80iCode (iCode * ic)
       spillPair (pairId);
   }
 
-  return (regalloc_dry_run_cost);
+  if (regalloc_dry_run_cost > regalloc_dry_run_cost_timed)
+    regalloc_dry_run_cost_cycles += (regalloc_dry_run_cost - regalloc_dry_run_cost_timed) * TIMING->per_byte;
+
+  /* In bytes, which the heuristics in ralloc2.cc are tuned to. */
+  return (dryRunCost (regalloc_dry_run_cost, regalloc_dry_run_cost_cycles, ic) / dryRunByteWeight ());
 }
 
 #ifdef DEBUG_DRY_COST
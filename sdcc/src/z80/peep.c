@@ -39,57 +39,73 @@
 
 #define ISINST(l, i) (!STRNCASECMP((l), (i), sizeof(i) - 1) && (!(l)[sizeof(i) - 1] || isspace((unsigned char)((l)[sizeof(i) - 1]))))
 
+/* Registers tracked by the liveness analysis behind notUsed. */
+static const char *const liveRegs[] = {"a", "b", "c", "d", "e", "h", "l", "iyl", "iyh", "ixl", "ixh"};
+#define LIVE_REGS (sizeof (liveRegs) / sizeof (*liveRegs))
+#define LIVE_ALL ((1u << LIVE_REGS) - 1)
+
 typedef enum
 {
-  S4O_CONDJMP,
-  S4O_WR_OP,
-  S4O_RD_OP,
-  S4O_TERM,
-  S4O_VISITED,
-  S4O_ABORT,
-  S4O_CONTINUE
-} S4O_RET;
+  FLOW_SKIP,                    /* label, comment or debug line */
+  FLOW_ABORT,                   /* inline assembler, unknown jump target */
+  FLOW_NEXT,
+  FLOW_JUMP,
+  FLOW_CONDJUMP
+} FLOW_KIND;
+
+/* A line as seen by the liveness analysis. It is parsed once, when
+   the line is first met, and survives rule replacements elsewhere in
+   the function; only the liveness itself is recomputed then. */
+typedef struct z80AsmLineNode
+  {
+#ifdef UNNAMED_STRUCT_TAG
+  struct asmLineNodeBase;
+#else
+    /* exactly the same members as of struct asmLineNodeBase from SDCCgen.h */
+    int size;
+    bitVect *regsRead;
+    bitVect *regsWritten;
+#endif
+    FLOW_KIND flow;
+    unsigned int read;          /* registers the line might read */
+    unsigned int written;       /* registers the line surely overwrites */
+    const char *target;         /* label a jump goes to */
+    lineNode *targetLine;       /* line defining target */
+    unsigned int live;          /* registers that might be read from this line on */
+  }
+z80AsmLineNode;
 
 static struct
 {
   lineNode *head;
+  unsigned long version;        /* peepLineListVersion the liveness belongs to */
+  int returnSize;
 } _G;
 
 extern bool z80_regs_used_as_parms_in_calls_from_current_function[IYH_IDX + 1];
 extern bool z80_symmParm_in_calls_from_current_function;
 extern bool z80_regs_preserved_in_calls_from_current_function[IYH_IDX + 1];
 
-/*-----------------------------------------------------------------*/
-/* univisitLines - clear "visited" flag in all lines               */
-/*-----------------------------------------------------------------*/
-static void
-unvisitLines (lineNode *pl)
-{
-  for (; pl; pl = pl->next)
-    pl->visited = FALSE;
-}
-
 #define AOP(op) op->aop
 #define AOP_SIZE(op) AOP(op)->size
 
-static bool
-isReturned(const char *what)
+/* Size of the return value of the current function. */
+static int
+returnSize(void)
 {
   symbol *sym;
   sym_link *sym_lnk;
   int size;
   lineNode *l;
 
-  if(strncmp(what, "iy", 2) == 0)
-    return FALSE;
-  if(strlen(what) != 1)
-    return TRUE;
+  if(_G.returnSize >= 0)
+    return _G.returnSize;
 
-  l = _G.head;
-  do
-  {
-    l = l->next;
-  } while(l->isComment || l->ic == NULL || l->ic->op != FUNCTION);
+  for(l = _G.head->next; l; l = l->next)
+    if(!l->isComment && l->ic && l->ic->op == FUNCTION)
+      break;
+  if(!l) // Err on the safe side.
+    return(_G.returnSize = 4);
 
   sym = OP_SYMBOL(IC_LEFT(l->ic));
 
@@ -122,6 +138,21 @@ isReturned(const char *what)
       size = 4;
     }
 
+  return(_G.returnSize = size);
+}
+
+static bool
+isReturned(const char *what)
+{
+  int size;
+
+  if(strncmp(what, "iy", 2) == 0)
+    return FALSE;
+  if(strlen(what) != 1)
+    return TRUE;
+
+  size = returnSize();
+
   switch(*what)
     {
     case 'd':
@@ -138,34 +169,12 @@ isReturned(const char *what)
 }
 
 /*-----------------------------------------------------------------*/
-/* incLabelJmpToCount - increment counter "jmpToCount" in entry    */
-/* of the list labelHash                                           */
+/* jumpTarget - extracts the label of the jumping opcode pl        */
 /*-----------------------------------------------------------------*/
-static bool
-incLabelJmpToCount (const char *label)
+static const char *
+jumpTarget (const lineNode *pl)
 {
-  labelHashEntry *entry;
-
-  entry = getLabelRef (label, _G.head);
-  if (!entry)
-    return FALSE;
-  entry->jmpToCount++;
-  return TRUE;
-}
-
-/*-----------------------------------------------------------------*/
-/* findLabel -                                                     */
-/* 1. extracts label in the opcode pl                              */
-/* 2. increment "label jump-to count" in labelHash                 */
-/* 3. search lineNode with label definition and return it          */
-/*-----------------------------------------------------------------*/
-static lineNode *
-findLabel (const lineNode *pl)
-{
-  char *p;
-  lineNode *cpl;
-
-  /* 1. extract label in opcode */
+  const char *p;
 
   /* In each z80 jumping opcode the label is at the end of the opcode */
   p = strlen (pl->line) - 1 + pl->line;
@@ -183,22 +192,7 @@ findLabel (const lineNode *pl)
     }
 
   /* skip ',' resp. '\t' */
-  ++p;
-
-  /* 2. increment "label jump-to count" */
-  if (!incLabelJmpToCount (p))
-    return NULL;
-
-  /* 3. search lineNode with label definition and return it */
-  for (cpl = _G.head; cpl; cpl = cpl->next)
-    {
-      if (cpl->isLabel
-          && strncmp (p, cpl->line, strlen(p)) == 0)
-        {
-          return cpl;
-        }
-    }
-  return NULL;
+  return ++p;
 }
 
 /* Check if reading arg implies reading what. */
@@ -532,145 +526,158 @@ z80SurelyReturns(const lineNode *pl)
 }
 
 /*-----------------------------------------------------------------*/
-/* scan4op - "executes" and examines the assembler opcodes,        */
-/* follows conditional and un-conditional jumps.                   */
-/* Moreover it registers all passed labels.                        */
-/*                                                                 */
-/* Parameter:                                                      */
-/*    lineNode **pl                                                */
-/*       scanning starts from pl;                                  */
-/*       pl also returns the last scanned line                     */
-/*    const char *pReg                                             */
-/*       points to a register (e.g. "ar0"). scan4op() tests for    */
-/*       read or write operations with this register               */
-/*    const char *untilOp                                          */
-/*       points to NULL or a opcode (e.g. "push").                 */
-/*       scan4op() returns if it hits this opcode.                 */
-/*    lineNode **plCond                                            */
-/*       If a conditional branch is met plCond points to the       */
-/*       lineNode of the conditional branch                        */
-/*                                                                 */
-/* Returns:                                                        */
-/*    S4O_ABORT                                                    */
-/*       on error                                                  */
-/*    S4O_VISITED                                                  */
-/*       hit lineNode with "visited" flag set: scan4op() already   */
-/*       scanned this opcode.                                      */
-/*    S4O_FOUNDOPCODE                                              */
-/*       found opcode and operand, to which untilOp and pReg are   */
-/*       pointing to.                                              */
-/*    S4O_RD_OP, S4O_WR_OP                                         */
-/*       hit an opcode reading or writing from pReg                */
-/*    S4O_CONDJMP                                                  */
-/*       hit a conditional jump opcode. pl and plCond return the   */
-/*       two possible branches.                                    */
-/*    S4O_TERM                                                     */
-/*       acall, lcall, ret and reti "terminate" a scan.            */
+/* liveLine - returns what the liveness analysis needs to know     */
+/* about the line pl, parsing it on first use                      */
 /*-----------------------------------------------------------------*/
-static S4O_RET
-scan4op (lineNode **pl, const char *what, const char *untilOp,
-         lineNode **plCond)
+static z80AsmLineNode *
+liveLine (lineNode *pl)
 {
-  for (; *pl; *pl = (*pl)->next)
-    {
-      if (!(*pl)->line || (*pl)->isDebug || (*pl)->isComment || (*pl)->isLabel)
-        continue;
-      D(("Scanning %s for %s\n", (*pl)->line, what));
-      /* don't optimize across inline assembler,
-         e.g. isLabel doesn't work there */
-      if ((*pl)->isInline)
-        {
-          D(("S4O_RD_OP: Inline asm\n"));
-          return S4O_ABORT;
-        }
+  z80AsmLineNode *aln = (z80AsmLineNode *) pl->aln;
+  unsigned int i;
 
-      if ((*pl)->visited)
-        {
-          D(("S4O_VISITED\n"));
-          return S4O_VISITED;
-        }
+  if (aln)
+    return aln;
 
-      (*pl)->visited = TRUE;
+  aln = Safe_alloc (sizeof (z80AsmLineNode));
+  pl->aln = (asmLineNodeBase *) aln;
 
-      if(z80MightRead(*pl, what))
+  if (!pl->line || pl->isDebug || pl->isComment || pl->isLabel)
+    aln->flow = FLOW_SKIP;
+  /* don't optimize across inline assembler,
+     e.g. isLabel doesn't work there */
+  else if (pl->isInline)
+    aln->flow = FLOW_ABORT;
+  else
+    {
+      for (i = 0; i < LIVE_REGS; i++)
         {
-          D(("S4O_RD_OP\n"));
-          return S4O_RD_OP;
+          if (z80MightRead (pl, liveRegs[i]))
+            aln->read |= 1u << i;
+          if (z80SurelyWrites (pl, liveRegs[i]))
+            aln->written |= 1u << i;
         }
 
-      if(z80UncondJump(*pl))
+      if (z80UncondJump (pl) || z80CondJump (pl))
         {
-          *pl = findLabel (*pl);
-            if (!*pl)
-              {
-                D(("S4O_ABORT\n"));
-                return S4O_ABORT;
-              }
+          aln->flow = z80CondJump (pl) ? FLOW_CONDJUMP : FLOW_JUMP;
+          aln->target = jumpTarget (pl);
+          if (!aln->target)
+            aln->flow = FLOW_ABORT;
         }
-      if(z80CondJump(*pl))
+      else
         {
-          *plCond = findLabel (*pl);
-          if (!*plCond)
-            {
-              D(("S4O_ABORT\n"));
-              return S4O_ABORT;
-            }
-          D(("S4O_CONDJMP\n"));
-          return S4O_CONDJMP;
+          aln->flow = FLOW_NEXT;
+          /* Don't need to check for de, hl since z80MightRead() does that */
+          if (z80SurelyReturns (pl))
+            aln->written = LIVE_ALL;
         }
+    }
 
-      if(z80SurelyWrites(*pl, what))
+  return aln;
+}
+
+/*-----------------------------------------------------------------*/
+/* liveSolve - computes for each line of the function which        */
+/* registers might be read from there on, following jumps.         */
+/* Iterates to the least fixed point, so that loops don't keep a   */
+/* register alive that isn't read anywhere in or after them.       */
+/*-----------------------------------------------------------------*/
+static void
+liveSolve (lineNode *head)
+{
+  hTab *labels = newHashTable (HTAB_SIZE);
+  lineNode **lines = NULL;
+  int n = 0, alloc = 0, i;
+  lineNode *pl;
+  bool change;
+
+  _G.head = head;
+  _G.version = peepLineListVersion;
+  _G.returnSize = -1;
+
+  for (pl = head; pl; pl = pl->next)
+    {
+      const char *label;
+      int len;
+      char name[SDCC_NAME_MAX + 1];
+
+      if (n == alloc)
         {
-          D(("S4O_WR_OP\n"));
-          return S4O_WR_OP;
+          alloc = alloc ? alloc * 2 : 256;
+          lines = Safe_realloc (lines, alloc * sizeof (lineNode *));
         }
+      lines[n++] = pl;
+      liveLine (pl)->live = 0;
 
-      /* Don't need to check for de, hl since z80MightRead() does that */
-      if(z80SurelyReturns(*pl))
+      if (pl->isLabel && isLabelDefinition (pl->line, &label, &len, FALSE) && len <= SDCC_NAME_MAX)
         {
-          D(("S4O_TERM\n"));
-          return S4O_TERM;
+          memcpy (name, label, len);
+          name[len] = 0;
+          hTabAddItem (&labels, hashSymbolName (name), pl);
         }
     }
-  D(("S4O_ABORT\n"));
-  return S4O_ABORT;
-}
 
-/*-----------------------------------------------------------------*/
-/* doTermScan - scan through area 2. This small wrapper handles:   */
-/* - action required on different return values                    */
-/* - recursion in case of conditional branches                     */
-/*-----------------------------------------------------------------*/
-static bool
-doTermScan (lineNode **pl, const char *what)
-{
-  lineNode *plConditional;
+  for (i = 0; i < n; i++)
+    {
+      z80AsmLineNode *aln = (z80AsmLineNode *) lines[i]->aln;
+      const lineNode *cpl;
+
+      if (aln->flow != FLOW_JUMP && aln->flow != FLOW_CONDJUMP)
+        continue;
+
+      aln->targetLine = NULL;
+      if (!getLabelRef (aln->target, head))
+        continue;
+      for (cpl = hTabFirstItemWK (labels, hashSymbolName (aln->target)); cpl; cpl = hTabNextItemWK (labels))
+        if (strncmp (aln->target, cpl->line, strlen (aln->target)) == 0)
+          {
+            aln->targetLine = (lineNode *) cpl;
+            break;
+          }
+    }
 
-  for (;; *pl = (*pl)->next)
+  do
     {
-      switch (scan4op (pl, what, NULL, &plConditional))
+      change = FALSE;
+      for (i = n - 1; i >= 0; i--)
         {
-          case S4O_TERM:
-          case S4O_VISITED:
-          case S4O_WR_OP:
-            /* all these are terminating conditions */
-            return TRUE;
-          case S4O_CONDJMP:
-            /* two possible destinations: recurse */
-              {
-                lineNode *pl2 = plConditional;
-                D(("CONDJMP trying other branch first\n"));
-                if (!doTermScan (&pl2, what))
-                  return FALSE;
-                D(("Other branch OK.\n"));
-              }
-            continue;
-          case S4O_RD_OP:
-          default:
-            /* no go */
-            return FALSE;
+          z80AsmLineNode *aln = (z80AsmLineNode *) lines[i]->aln;
+          unsigned int next = i + 1 < n ? ((z80AsmLineNode *) lines[i + 1]->aln)->live : LIVE_ALL;
+          unsigned int target = aln->targetLine ? ((z80AsmLineNode *) aln->targetLine->aln)->live : LIVE_ALL;
+          unsigned int live;
+
+          switch (aln->flow)
+            {
+            case FLOW_SKIP:
+              live = next;
+              break;
+            case FLOW_NEXT:
+              live = aln->read | (next & ~aln->written);
+              break;
+            case FLOW_JUMP:
+              live = aln->read | target;
+              break;
+            case FLOW_CONDJUMP:
+              live = aln->read | next | target;
+              break;
+            case FLOW_ABORT:
+            default:
+              live = LIVE_ALL;
+              break;
+            }
+
+          if (live != aln->live)
+            {
+              aln->live = live;
+              change = TRUE;
+            }
         }
     }
+  while (change);
+
+  Safe_free (lines);
+  hTabDeleteAll (labels);
+  Safe_free (labels);
 }
 
 /* Regular 8 bit reg */
@@ -729,7 +736,7 @@ isRegPair(const char *what)
 bool
 z80notUsed (const char *what, lineNode *endPl, lineNode *head)
 {
-  lineNode *pl;
+  unsigned int i;
   D(("Checking for %s\n", what));
   if(isRegPair(what))
     {
@@ -756,15 +763,14 @@ z80notUsed (const char *what, lineNode *endPl, lineNode *head)
   if(!isReg(what) && !isUReg(what))
     return FALSE;
 
-  _G.head = head;
-
-  unvisitLines (_G.head);
+  if(_G.head != head || _G.version != peepLineListVersion)
+    liveSolve (head);
 
-  pl = endPl->next;
-  if (!doTermScan (&pl, what))
+  if(!endPl->next)
     return FALSE;
 
-  return TRUE;
+  for(i = 0; strcmp(what, liveRegs[i]); i++);
+  return !(liveLine (endPl->next)->live & (1u << i));
 }
 
 bool
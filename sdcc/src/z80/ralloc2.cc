@@ -27,7 +27,7 @@
 extern "C"
 {
   #include "z80.h"
-  unsigned char dryZ80iCode (iCode * ic);
+  float dryZ80iCode (iCode * ic);
   bool z80_assignment_optimal;
   bool should_omit_frame_ptr;
 }
@@ -1695,7 +1695,7 @@ iCode *z80_ralloc2_cc(ebbIndex *ebbi)
 
   tree_dec_t tree_decomposition;
 
-  get_nice_tree_decomposition(tree_decomposition, control_flow_graph);
+  get_nice_tree_decomposition(tree_decomposition, control_flow_graph, "register allocator");
 
   alive_tree_dec(tree_decomposition, control_flow_graph);
 
@@ -0,0 +1,280 @@
+/* Precompiled header implementation for sdcpp.
+   Copyright (C) 2000, 2002, 2003, 2004, 2005, 2007, 2008
+   Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+/* A PCH written by sdcpp --output-pch=FILE HEADER holds, after the
+   identification and the options below, the macros defined before the
+   header (see cpp_save_state), the dependencies of the header (see
+   cpp_write_pch_deps), the preprocessed text of the header and the
+   macros defined after it (see cpp_write_pch_state).
+
+   When HEADER is then included first by a source file and FILE is
+   found as HEADER.gch, the text is output in place of preprocessing
+   the header again, and the macros are defined as if it had been.  */
+
+#include "config.h"
+#include "system.h"
+#include "version.h"
+#include "cpplib.h"
+#include "sdcpp.h"
+
+/* This is the PCH file name, if one has been given.  */
+const char *pch_file;
+
+/* This structure is read very early when validating the PCH, and
+   might be read for a PCH which is for a completely different
+   version, so it must not change.  */
+
+static const char pch_ident[8] = "sdcpch1";
+
+/* The options which change the preprocessed text of a header.  */
+
+struct c_pch_validity
+{
+  unsigned char lang;
+  unsigned char traditional;
+  unsigned char discard_comments;
+  unsigned char discard_comments_in_macro_exp;
+  unsigned char trigraphs;
+  unsigned char dollars_in_ident;
+  unsigned char pedantic_parse_number;
+  unsigned char preproc_asm;
+  unsigned char allow_naked_hash;
+  char no_line_commands;
+  char dump_macros;
+  char dump_includes;
+};
+
+/* The PCH being written, and where the text of the header starts in
+   the output.  */
+
+static FILE *pch_outfile;
+static FILE *pch_text;
+static long pch_text_start;
+
+static void get_validity (struct c_pch_validity *);
+
+/* Fill in the options which must match for a PCH to be used.  */
+
+static void
+get_validity (struct c_pch_validity *v)
+{
+  cpp_options *opts = cpp_get_options (parse_in);
+
+  memset (v, 0, sizeof (*v));
+  v->lang = opts->lang;
+  v->traditional = opts->traditional;
+  v->discard_comments = opts->discard_comments;
+  v->discard_comments_in_macro_exp = opts->discard_comments_in_macro_exp;
+  v->trigraphs = opts->trigraphs;
+  v->dollars_in_ident = opts->dollars_in_ident;
+  v->pedantic_parse_number = opts->pedantic_parse_number;
+  v->preproc_asm = opts->preproc_asm;
+  v->allow_naked_hash = opts->allow_naked_hash;
+  v->no_line_commands = flag_no_line_commands;
+  v->dump_macros = flag_dump_macros;
+  v->dump_includes = flag_dump_includes;
+}
+
+/* Prepare to write a PCH file, if one is being written.  This is
+   called at the start of the header, after the command line macros
+   are defined; OUT is the stream the preprocessed text goes to,
+   which must be open for reading too.  */
+
+void
+pch_init (FILE *out)
+{
+  struct c_pch_validity v;
+  unsigned int len;
+
+  if (!pch_file)
+    return;
+
+  pch_outfile = fopen (pch_file, "w+b");
+  if (pch_outfile == NULL)
+    fatal_error ("can't create precompiled header %s: %s",
+                 pch_file, strerror (errno));
+
+  get_validity (&v);
+  len = strlen (version_string);
+  if (fwrite (pch_ident, sizeof (pch_ident), 1, pch_outfile) != 1
+      || fwrite (&len, sizeof (len), 1, pch_outfile) != 1
+      || fwrite (version_string, len, 1, pch_outfile) != 1
+      || fwrite (&v, sizeof (v), 1, pch_outfile) != 1)
+    fatal_error ("can't write %s: %s", pch_file, strerror (errno));
+
+  cpp_save_state (parse_in, pch_outfile);
+
+  pch_text = out;
+  fflush (out);
+  pch_text_start = ftell (out);
+  if (pch_text_start < 0)
+    fatal_error ("can't read the preprocessed output: %s",
+                 strerror (errno));
+}
+
+/* Write the PCH, at the end of the header.  The text of the header is
+   read back from the output stream.  */
+
+void
+c_common_write_pch (void)
+{
+  long end;
+  unsigned int len;
+  char *text;
+
+  if (!pch_outfile)
+    return;
+
+  if (errorcount)
+    {
+      fclose (pch_outfile);
+      unlink (pch_file);
+      return;
+    }
+
+  cpp_write_pch_deps (parse_in, pch_outfile);
+
+  fflush (pch_text);
+  end = ftell (pch_text);
+  len = end - pch_text_start;
+  text = XNEWVEC (char, len + 1);
+  if (end < 0
+      || fseek (pch_text, pch_text_start, SEEK_SET) != 0
+      || fread (text, 1, len, pch_text) != len)
+    fatal_error ("can't read the preprocessed output: %s",
+                 strerror (errno));
+  fseek (pch_text, 0, SEEK_END);
+
+  if (fwrite (&len, sizeof (len), 1, pch_outfile) != 1
+      || fwrite (text, 1, len, pch_outfile) != len)
+    fatal_error ("can't write %s: %s", pch_file, strerror (errno));
+  free (text);
+
+  cpp_write_pch_state (parse_in, pch_outfile);
+
+  if (ferror (pch_outfile) || fclose (pch_outfile) || errorcount)
+    {
+      unlink (pch_file);
+      if (!errorcount)
+        fatal_error ("can't write %s: %s", pch_file, strerror (errno));
+    }
+  pch_outfile = NULL;
+}
+
+/* Check the PCH file called NAME, open on FD, to see if it can be
+   used in this compilation.  Return 1 if valid, 0 if the file can't
+   be used now but might be if it's seen later in the compilation, and
+   2 if this file could never be used in the compilation.  */
+
+int
+c_common_valid_pch (cpp_reader *pfile, const char *name, int fd)
+{
+  char ident[sizeof (pch_ident)];
+  unsigned int len;
+  char *version;
+  struct c_pch_validity v, this_v;
+  int result;
+
+  if (read (fd, ident, sizeof (ident)) != sizeof (ident))
+    fatal_error ("can't read %s: %s", name, strerror (errno));
+  if (memcmp (ident, pch_ident, sizeof (pch_ident)) != 0)
+    {
+      if (cpp_get_options (pfile)->warn_invalid_pch)
+        cpp_error (pfile, CPP_DL_WARNING,
+                   "%s: not a PCH file", name);
+      return 2;
+    }
+
+  if (read (fd, &len, sizeof (len)) != sizeof (len) || len > 256)
+    fatal_error ("can't read %s: %s", name, strerror (errno));
+  version = XNEWVEC (char, len + 1);
+  if ((unsigned int) read (fd, version, len) != len)
+    fatal_error ("can't read %s: %s", name, strerror (errno));
+  version[len] = '\0';
+  if (strcmp (version, version_string) != 0)
+    {
+      if (cpp_get_options (pfile)->warn_invalid_pch)
+        cpp_error (pfile, CPP_DL_WARNING,
+                   "%s: created by a different sdcpp version", name);
+      free (version);
+      return 2;
+    }
+  free (version);
+
+  if (read (fd, &v, sizeof (v)) != sizeof (v))
+    fatal_error ("can't read %s: %s", name, strerror (errno));
+  get_validity (&this_v);
+  if (memcmp (&v, &this_v, sizeof (v)) != 0)
+    {
+      if (cpp_get_options (pfile)->warn_invalid_pch)
+        cpp_error (pfile, CPP_DL_WARNING,
+                   "%s: created with different options", name);
+      return 2;
+    }
+
+  /* Check the preprocessor macros are the same as when the PCH was
+     generated.  */
+  result = cpp_valid_state (pfile, name, fd);
+  if (result == -1)
+    return 2;
+  else
+    return result == 0;
+}
+
+/* Load in the PCH file NAME, open on FD.  It was originally searched
+   for by ORIG_NAME.  */
+
+void
+c_common_read_pch (cpp_reader *pfile, const char *name,
+                   int fd, const char *orig_name ATTRIBUTE_UNUSED)
+{
+  FILE *f;
+  unsigned int len;
+  char *text;
+
+  f = fdopen (fd, "rb");
+  if (f == NULL)
+    {
+      cpp_errno (pfile, CPP_DL_ERROR, "calling fdopen");
+      close (fd);
+      return;
+    }
+
+  if (fread (&len, sizeof (len), 1, f) != 1)
+    {
+      cpp_errno (pfile, CPP_DL_ERROR, "reading");
+      fclose (f);
+      return;
+    }
+  text = XNEWVEC (char, len);
+  if (fread (text, 1, len, f) != len)
+    {
+      cpp_errno (pfile, CPP_DL_ERROR, "reading");
+      free (text);
+      fclose (f);
+      return;
+    }
+
+  pp_pch_output (pfile, text, len);
+  free (text);
+
+  cpp_read_state (pfile, name, f);
+  fclose (f);
+}
@@ -52,10 +52,6 @@ static void cb_include (cpp_reader *, source_location, const unsigned char *,
                         const char *, int, const cpp_token **);
 static void cb_ident (cpp_reader *, source_location, const cpp_string *);
 static void cb_def_pragma (cpp_reader *, source_location);
-#if 0
-static void cb_read_pch (cpp_reader *pfile, const char *name,
-                         int fd, const char *orig_name);
-#endif
 
 /* Preprocess and output.  */
 void
@@ -105,13 +101,12 @@ init_pp_output (FILE *out_stream)
   if (flag_dump_includes)
     cb->include  = cb_include;
 
-#if 0
-  if (flag_pch_preprocess)
+  /* sdcpp specific: use precompiled headers, unless writing one.  */
+  if (!pch_file)
     {
       cb->valid_pch = c_common_valid_pch;
-      cb->read_pch = cb_read_pch;
+      cb->read_pch = c_common_read_pch;
     }
-#endif
 
   if (flag_dump_macros == 'N' || flag_dump_macros == 'D')
     {
@@ -452,18 +447,71 @@ dump_macro (cpp_reader *pfile, cpp_hashnode *node, void *v ATTRIBUTE_UNUSED)
   return 1;
 }
 
-#if 0
-/* Load in the PCH file NAME, open on FD.  It was originally searched for
-   by ORIG_NAME.  Also, print out a #include command so that the PCH
-   file can be loaded when the preprocessed output is compiled.  */
+/* sdcpp specific: output the preprocessed text TEXT of LEN bytes of a
+   precompiled header in place of the header.  Its line markers are
+   relocated to where the header is found now, and mark system headers
+   if the header is one now.  */
 
-static void
-cb_read_pch (cpp_reader *pfile, const char *name,
-             int fd, const char *orig_name ATTRIBUTE_UNUSED)
+void
+pp_pch_output (cpp_reader *pfile, const char *text, size_t len)
 {
-  c_common_read_pch (pfile, name, fd, orig_name);
+  const struct line_map *map = &line_table->maps[line_table->used - 1];
+  const char *end = text + len;
 
-  fprintf (print.outf, "#pragma GCC pch_preprocess \"%s\"\n", name);
-  print.src_line++;
+  while (text < end)
+    {
+      const char *eol = memchr (text, '\n', end - text);
+      const char *p = text + 2;
+      const char *flag = "";
+      unsigned int line = 0;
+      int sysp = map->sysp;
+      char *name, *q;
+
+      eol = eol ? eol + 1 : end;
+
+      /* A line marker is # LINE "FILE" FLAGS.  */
+      if (eol - text > 4 && text[0] == '#' && text[1] == ' ')
+        while (ISDIGIT (*p))
+          line = line * 10 + *p++ - '0';
+      if (p == text + 2 || p[0] != ' ' || p[1] != '"')
+        {
+          fwrite (text, 1, eol - text, print.outf);
+          if (eol[-1] == '\n')
+            print.src_line++;
+          text = eol;
+          continue;
+        }
+
+      /* Unquote FILE, see cpp_quote_string.  */
+      name = q = XNEWVEC (char, eol - p);
+      for (p += 2; p < eol && *p != '"'; p++)
+        *q++ = *p == '\\' && p + 1 < eol ? *++p : *p;
+      *q = '\0';
+      p++;
+
+      /* The flags are " 1" or " 2", then " 3" or " 3 4".  */
+      if (!strncmp (p, " 1", 2))
+        flag = " 1", p += 2;
+      else if (!strncmp (p, " 2", 2))
+        flag = " 2", p += 2;
+      if (!strncmp (p, " 3 4", 4))
+        sysp = 2;
+      else if (!strncmp (p, " 3", 2) && sysp < 1)
+        sysp = 1;
+
+      q = cpp_pch_path (pfile, name);
+      free (name);
+      name = XNEWVEC (char, strlen (q) * 4 + 1);
+      *cpp_quote_string ((unsigned char *) name, (unsigned char *) q,
+                         strlen (q)) = '\0';
+      free (q);
+      fprintf (print.outf, "# %u \"%s\"%s%s\n", line, name, flag,
+               sysp == 2 ? " 3 4" : sysp == 1 ? " 3" : "");
+      free (name);
+      print.src_line = line;
+      text = eol;
+    }
+
+  print.printed = 0;
+  print.prev = 0;
 }
-#endif
@@ -705,6 +705,11 @@ should_stack_file (cpp_reader *pfile, _cpp_file *file, bool import)
 	return false;
     }
 
+  /* sdcpp specific: a file read to build the precompiled header in
+     use has the header guard it had then.  */
+  if (!file->cmacro && pfile->pch)
+    file->cmacro = _cpp_pch_guard (pfile, file->path);
+
   /* Skip if the file had a header guard and the macro is defined.
      PCH relies on this appearing before the PCH handler below.  */
   if (file->cmacro && file->cmacro->type == NT_MACRO)
@@ -713,10 +718,21 @@ should_stack_file (cpp_reader *pfile, _cpp_file *file, bool import)
   /* Handle PCH files immediately; don't stack them.  */
   if (file->pchname)
     {
+      /* sdcpp specific: the preprocessed text of the header is output
+	 by the callback, so enter and leave the header around it.  */
+      int sysp = 0;
+
+      if (pfile->buffer && file->dir)
+	sysp = MAX (pfile->buffer->sysp, file->dir->sysp);
+      file->stack_count++;
+      _cpp_do_file_change (pfile, LC_ENTER, file->path, 1, sysp);
       pfile->cb.read_pch (pfile, file->pchname, file->fd, file->path);
+      _cpp_do_file_change (pfile, LC_LEAVE, 0, 0, 0);
       file->fd = -1;
       free ((void *) file->pchname);
       file->pchname = NULL;
+      if (!file->cmacro && pfile->pch)
+	file->cmacro = _cpp_pch_guard (pfile, file->path);
       return false;
     }
 
@@ -923,10 +939,8 @@ _cpp_stack_include (cpp_reader *pfile, const char *fname, int angle_brackets,
      currently at the start of the line *following* the #include.  A
      separate source_location for this location makes no sense (until
      we do the LC_LEAVE), and complicates LAST_SOURCE_LINE_LOCATION.
-     This does not apply if we found a PCH file (in which case
-     linemap_add is not called) or we were included from the
-     command-line.  */
-  if (file->pchname == NULL && file->err_no == 0 && type != IT_CMDLINE)
+     This does not apply if we were included from the command-line.  */
+  if (file->err_no == 0 && type != IT_CMDLINE)
     pfile->line_table->highest_location--;
 
   return _cpp_stack_file (pfile, file, type == IT_IMPORT);
@@ -1752,6 +1766,114 @@ _cpp_read_file_entries (cpp_reader *pfile ATTRIBUTE_UNUSED, FILE *f)
   return true;
 }
 
+/* sdcpp specific: a file read to build a PCH, on disk.  The path
+   and the name of the controlling macro follow.  */
+struct pch_file_entry
+{
+  unsigned int path_length;
+  unsigned int guard_length;
+  off_t size;
+  time_t mtime;
+  unsigned char sysp;
+};
+
+/* sdcpp specific: write to F the files read to build the PCH, with
+   their controlling macros, so that cpp_valid_state can check them
+   and guard lookup works for them.  */
+
+bool
+_cpp_save_file_list (cpp_reader *pfile, FILE *f)
+{
+  unsigned int count = 0;
+  _cpp_file *file;
+
+  for (file = pfile->all_files; file; file = file->next_file)
+    if (!file->dont_read && !file->err_no && file->stack_count)
+      ++count;
+  if (fwrite (&count, sizeof (count), 1, f) != 1)
+    return false;
+
+  for (file = pfile->all_files; file; file = file->next_file)
+    {
+      struct pch_file_entry e;
+
+      if (file->dont_read || file->err_no || !file->stack_count)
+	continue;
+
+      memset (&e, 0, sizeof (e));
+      e.path_length = strlen (file->path);
+      e.guard_length = file->cmacro ? NODE_LEN (file->cmacro) : 0;
+      e.size = file->st.st_size;
+      e.mtime = file->st.st_mtime;
+      e.sysp = file->dir ? file->dir->sysp : 0;
+      if (fwrite (&e, sizeof (e), 1, f) != 1
+	  || fwrite (file->path, 1, e.path_length, f) != e.path_length
+	  || (e.guard_length
+	      && fwrite (NODE_NAME (file->cmacro), 1, e.guard_length, f)
+		 != e.guard_length))
+	return false;
+    }
+  return true;
+}
+
+/* sdcpp specific: read the files written by _cpp_save_file_list from
+   the PCH file NAME open on FD into pfile->pch, relocating them to
+   the directory of the header.  Returns 0 if none of them changed
+   since, 1 otherwise and -1 on a read error.  */
+
+int
+_cpp_valid_file_list (cpp_reader *pfile, const char *name, int fd)
+{
+  struct cpp_pch_state *s = pfile->pch;
+  unsigned int count;
+
+  if (read (fd, &count, sizeof (count)) != sizeof (count))
+    return -1;
+  s->files = XCNEWVEC (struct cpp_pch_file, count);
+
+  for (s->n_files = 0; s->n_files < count; s->n_files++)
+    {
+      struct cpp_pch_file *pf = &s->files[s->n_files];
+      struct pch_file_entry e;
+      struct stat st;
+      char *path;
+
+      if (read (fd, &e, sizeof (e)) != sizeof (e))
+	return -1;
+      path = XNEWVEC (char, e.path_length + 1);
+      if ((size_t) read (fd, path, e.path_length) != e.path_length)
+	{
+	  free (path);
+	  return -1;
+	}
+      path[e.path_length] = '\0';
+      pf->path = cpp_pch_path (pfile, path);
+      free (path);
+      pf->sysp = e.sysp;
+      if (e.guard_length)
+	{
+	  pf->guard = XNEWVEC (char, e.guard_length + 1);
+	  if ((size_t) read (fd, pf->guard, e.guard_length) != e.guard_length)
+	    {
+	      s->n_files++;
+	      return -1;
+	    }
+	  pf->guard[e.guard_length] = '\0';
+	}
+
+      if (stat (pf->path, &st) != 0
+	  || st.st_size != e.size || st.st_mtime != e.mtime)
+	{
+	  if (CPP_OPTION (pfile, warn_invalid_pch))
+	    cpp_error (pfile, CPP_DL_WARNING_SYSHDR,
+		       "%s: not used because `%s' changed", name, pf->path);
+	  s->n_files++;
+	  return 1;
+	}
+    }
+  return 0;
+}
+
 /* The parameters for pchf_compare.  */
 
 struct pchf_compare_data
@@ -1000,13 +1000,11 @@ extern cpp_buffer *cpp_get_prev (cpp_buffer *);
 extern void cpp_clear_file_cache (cpp_reader *);
 
 /* In pch.c */
-struct save_macro_data;
 extern int cpp_save_state (cpp_reader *, FILE *);
 extern int cpp_write_pch_deps (cpp_reader *, FILE *);
 extern int cpp_write_pch_state (cpp_reader *, FILE *);
 extern int cpp_valid_state (cpp_reader *, const char *, int);
-extern void cpp_prepare_state (cpp_reader *, struct save_macro_data **);
-extern int cpp_read_state (cpp_reader *, const char *, FILE *,
-			   struct save_macro_data *);
+extern int cpp_read_state (cpp_reader *, const char *, FILE *);
+extern char *cpp_pch_path (cpp_reader *, const char *);
 
 #endif /* ! LIBCPP_CPPLIB_H */
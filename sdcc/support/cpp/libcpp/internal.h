@@ -329,6 +329,26 @@ struct def_pragma_macro {
   unsigned int is_undef : 1;
 };
 
+/* sdcpp specific: a file read to build the precompiled header in use.  */
+struct cpp_pch_file {
+  /* Its name, relocated to the directory of the header.  */
+  char *path;
+  /* Its controlling macro, or NULL.  */
+  char *guard;
+  /* Whether it is a system header.  */
+  unsigned char sysp;
+};
+
+/* sdcpp specific: the precompiled header in use.  */
+struct cpp_pch_state {
+  /* The name of the header when the PCH was written, and now.  */
+  char *from;
+  char *to;
+  /* The files it was built from.  */
+  struct cpp_pch_file *files;
+  size_t n_files;
+};
+
 /* A cpp_reader encapsulates the "state" of a pre-processor run.
    Applying cpp_get_token repeatedly yields a stream of pre-processor
    tokens.  Usually, there is only one cpp_reader object active.  */
@@ -494,6 +514,10 @@ struct cpp_reader
      of precompiled headers.  */
   struct cpp_savedstate *savedstate;
 
+  /* sdcpp specific: the precompiled header accepted by
+     cpp_valid_state, or NULL.  */
+  struct cpp_pch_state *pch;
+
   /* Next value of __COUNTER__ macro. */
   unsigned int counter;
 
@@ -586,6 +610,8 @@ extern void _cpp_cleanup_files (cpp_reader *);
 extern void _cpp_pop_file_buffer (cpp_reader *, struct _cpp_file *);
 extern bool _cpp_save_file_entries (cpp_reader *pfile, FILE *f);
 extern bool _cpp_read_file_entries (cpp_reader *, FILE *);
+extern bool _cpp_save_file_list (cpp_reader *, FILE *);
+extern int _cpp_valid_file_list (cpp_reader *, const char *, int);
 extern struct stat *_cpp_get_file_stat (_cpp_file *);
 
 /* In expr.c */
@@ -632,6 +658,9 @@ struct _cpp_dir_only_callbacks
 extern void _cpp_preprocess_dir_only (cpp_reader *,
 				      const struct _cpp_dir_only_callbacks *);
 
+/* In pch.c.  */
+extern const cpp_hashnode *_cpp_pch_guard (cpp_reader *, const char *);
+
 /* In traditional.c.  */
 extern bool _cpp_scan_out_logical_line (cpp_reader *, cpp_macro *);
 extern bool _cpp_read_logical_line_trad (cpp_reader *);
@@ -0,0 +1,944 @@
+/* Part of CPP library.  (Precompiled header reading/writing.)
+   Copyright (C) 2000, 2001, 2002, 2003, 2004, 2005, 2007, 2008, 2009
+   Free Software Foundation, Inc.
+
+This program is free software; you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by the
+Free Software Foundation; either version 3, or (at your option) any
+later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+/* sdcpp has no garbage collected heap to dump, unlike GCC.  The
+   macros are written as their definitions and defined again when the
+   PCH is read, and the preprocessed text of the header is kept by the
+   client (see c-pch.c).  The checks of cpp_valid_state are those of
+   GCC, plus the include chain and the files the header was built from.
+   These files are relocated when the header is found in another
+   directory than when the PCH was written.  */
+
+#include "config.h"
+#include "system.h"
+#include "cpplib.h"
+#include "internal.h"
+#include "hashtab.h"
+#include "mkdeps.h"
+
+static int write_macdef (cpp_reader *, cpp_hashnode *, void *);
+static int save_idents (cpp_reader *, cpp_hashnode *, void *);
+static hashval_t hashmem (const void *, size_t);
+static hashval_t cpp_string_hash (const void *);
+static int cpp_string_eq (const void *, const void *);
+static int count_defs (cpp_reader *, cpp_hashnode *, void *);
+static int comp_hashnodes (const void *, const void *);
+static int collect_ident_name (cpp_reader *, cpp_hashnode *, void *);
+static int write_defs (cpp_reader *, cpp_hashnode *, void *);
+static int write_final_macdef (cpp_reader *, cpp_hashnode *, void *);
+static int undef_missing (cpp_reader *, cpp_hashnode *, void *);
+static bool write_string (FILE *, const char *);
+static char *read_string (int);
+static void free_pch_state (struct cpp_pch_state *);
+
+/* This structure represents a macro definition on disk.  */
+struct macrodef_struct
+{
+  unsigned int definition_length;
+  unsigned short name_length;
+  unsigned short flags;
+};
+
+/* This is how we write out a macro definition.
+   Suitable for being called by cpp_forall_identifiers.  */
+
+static int
+write_macdef (cpp_reader *pfile, cpp_hashnode *hn, void *file_p)
+{
+  FILE *f = (FILE *) file_p;
+  switch (hn->type)
+    {
+    case NT_VOID:
+      if (! (hn->flags & NODE_POISONED))
+	return 1;
+
+    case NT_MACRO:
+      if ((hn->flags & NODE_BUILTIN)
+	  && (!pfile->cb.user_builtin_macro
+	      || !pfile->cb.user_builtin_macro (pfile, hn)))
+	return 1;
+
+      {
+	struct macrodef_struct s;
+	const unsigned char *defn;
+
+	s.name_length = NODE_LEN (hn);
+	s.flags = hn->flags & NODE_POISONED;
+
+	if (hn->type == NT_MACRO)
+	  {
+	    defn = cpp_macro_definition (pfile, hn);
+	    s.definition_length = ustrlen (defn);
+	  }
+	else
+	  {
+	    defn = NODE_NAME (hn);
+	    s.definition_length = s.name_length;
+	  }
+
+	if (fwrite (&s, sizeof (s), 1, f) != 1
+	    || fwrite (defn, 1, s.definition_length, f) != s.definition_length)
+	  {
+	    cpp_errno (pfile, CPP_DL_ERROR,
+		       "while writing precompiled header");
+	    return 0;
+	  }
+      }
+      return 1;
+
+    case NT_ASSERTION:
+      /* Not currently implemented.  */
+      return 1;
+
+    default:
+      abort ();
+    }
+}
+
+/* This structure records the names of the defined macros.
+   It's also used as a callback structure for size_initial_idents
+   and save_idents.  */
+
+struct cpp_savedstate
+{
+  /* A hash table of the defined identifiers.  */
+  htab_t definedhash;
+  /* The size of the definitions of those identifiers (the size of
+     'definedstrs').  */
+  size_t hashsize;
+  /* Number of definitions */
+  size_t n_defs;
+  /* Array of definitions.  In cpp_write_pch_deps it is used for sorting.  */
+  cpp_hashnode **defs;
+  /* Space for the next definition.  Definitions are null-terminated
+     strings.  */
+  unsigned char *definedstrs;
+};
+
+/* Save this identifier into the state: put it in the hash table,
+   put the definition in 'definedstrs'.  */
+
+static int
+save_idents (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *hn, void *ss_p)
+{
+  struct cpp_savedstate *const ss = (struct cpp_savedstate *)ss_p;
+
+  if (hn->type != NT_VOID)
+    {
+      struct cpp_string news;
+      void **slot;
+
+      news.len = NODE_LEN (hn);
+      news.text= NODE_NAME (hn);
+      slot = htab_find_slot (ss->definedhash, &news, INSERT);
+      if (*slot == NULL)
+	{
+	  struct cpp_string *sp;
+	  unsigned char *text;
+
+	  sp = XNEW (struct cpp_string);
+	  *slot = sp;
+
+	  sp->len = NODE_LEN (hn);
+	  sp->text = text = XNEWVEC (unsigned char, NODE_LEN (hn));
+	  memcpy (text, NODE_NAME (hn), NODE_LEN (hn));
+	}
+    }
+
+  return 1;
+}
+
+/* Hash some memory in a generic way.  */
+
+static hashval_t
+hashmem (const void *p_p, size_t sz)
+{
+  const unsigned char *p = (const unsigned char *)p_p;
+  size_t i;
+  hashval_t h;
+
+  h = 0;
+  for (i = 0; i < sz; i++)
+    h = h * 67 - (*p++ - 113);
+  return h;
+}
+
+/* Hash a cpp string for the hashtable machinery.  */
+
+static hashval_t
+cpp_string_hash (const void *a_p)
+{
+  const struct cpp_string *a = (const struct cpp_string *) a_p;
+  return hashmem (a->text, a->len);
+}
+
+/* Compare two cpp strings for the hashtable machinery.  */
+
+static int
+cpp_string_eq (const void *a_p, const void *b_p)
+{
+  const struct cpp_string *a = (const struct cpp_string *) a_p;
+  const struct cpp_string *b = (const struct cpp_string *) b_p;
+  return (a->len == b->len
+	  && memcmp (a->text, b->text, a->len) == 0);
+}
+
+/* Save the current definitions of the cpp_reader for dependency
+   checking purposes.  When writing a precompiled header, this should
+   be called at the same point in the compilation as cpp_valid_state
+   would be called when reading the precompiled header back in.  */
+
+int
+cpp_save_state (cpp_reader *r, FILE *f)
+{
+  /* Save the list of non-void identifiers for the dependency checking.  */
+  r->savedstate = XNEW (struct cpp_savedstate);
+  r->savedstate->definedhash = htab_create (100, cpp_string_hash,
+					    cpp_string_eq, NULL);
+  cpp_forall_identifiers (r, save_idents, r->savedstate);
+
+  /* Write out the list of defined identifiers.  */
+  cpp_forall_identifiers (r, write_macdef, f);
+
+  return 0;
+}
+
+/* Calculate the 'hashsize' field of the saved state.  */
+
+static int
+count_defs (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *hn, void *ss_p)
+{
+  struct cpp_savedstate *const ss = (struct cpp_savedstate *)ss_p;
+
+  switch (hn->type)
+    {
+    case NT_MACRO:
+      if (hn->flags & NODE_BUILTIN)
+	return 1;
+
+      /* else fall through.  */
+
+    case NT_VOID:
+      {
+	struct cpp_string news;
+	void **slot;
+
+	news.len = NODE_LEN (hn);
+	news.text = NODE_NAME (hn);
+	slot = (void **) htab_find (ss->definedhash, &news);
+	if (slot == NULL)
+	  {
+	    ss->hashsize += NODE_LEN (hn) + 1;
+	    ss->n_defs += 1;
+	  }
+      }
+      return 1;
+
+    case NT_ASSERTION:
+      /* Not currently implemented.  */
+      return 1;
+
+    default:
+      abort ();
+    }
+}
+
+/* Collect the identifiers into the state's string table.  */
+static int
+write_defs (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *hn, void *ss_p)
+{
+  struct cpp_savedstate *const ss = (struct cpp_savedstate *)ss_p;
+
+  switch (hn->type)
+    {
+    case NT_MACRO:
+      if (hn->flags & NODE_BUILTIN)
+	return 1;
+
+      /* else fall through.  */
+
+    case NT_VOID:
+      {
+	struct cpp_string news;
+	void **slot;
+
+	news.len = NODE_LEN (hn);
+	news.text = NODE_NAME (hn);
+	slot = (void **) htab_find (ss->definedhash, &news);
+	if (slot == NULL)
+	  {
+	    ss->defs[ss->n_defs] = hn;
+	    ss->n_defs += 1;
+	  }
+      }
+      return 1;
+
+    case NT_ASSERTION:
+      /* Not currently implemented.  */
+      return 1;
+
+    default:
+      abort ();
+    }
+}
+
+/* Comparison function for qsort.  The arguments point to pointers of
+   type ht_hashnode *.  */
+static int
+comp_hashnodes (const void *px, const void *py)
+{
+  cpp_hashnode *x = *(cpp_hashnode **) px;
+  cpp_hashnode *y = *(cpp_hashnode **) py;
+  return ustrcmp (NODE_NAME (x), NODE_NAME (y));
+}
+
+/* Write a string with its length.  */
+static bool
+write_string (FILE *f, const char *s)
+{
+  unsigned int len = strlen (s);
+
+  return (fwrite (&len, sizeof (len), 1, f) == 1
+	  && fwrite (s, 1, len, f) == len);
+}
+
+/* Read a string written by write_string, or return NULL.  */
+static char *
+read_string (int fd)
+{
+  unsigned int len;
+  char *s;
+
+  if (read (fd, &len, sizeof (len)) != sizeof (len))
+    return NULL;
+  s = XNEWVEC (char, len + 1);
+  if ((size_t) read (fd, s, len) != len)
+    {
+      free (s);
+      return NULL;
+    }
+  s[len] = '\0';
+  return s;
+}
+
+/* Write out the remainder of the dependency information.  This should be
+   called after the PCH is ready to be saved.  */
+
+int
+cpp_write_pch_deps (cpp_reader *r, FILE *f)
+{
+  struct macrodef_struct z;
+  struct cpp_savedstate *const ss = r->savedstate;
+  unsigned char *definedstrs;
+  struct cpp_dir *dir;
+  unsigned int n;
+  size_t i;
+
+  /* Collect the list of identifiers which have been seen and
+     weren't defined to anything previously.  */
+  ss->hashsize = 0;
+  ss->n_defs = 0;
+  cpp_forall_identifiers (r, count_defs, ss);
+
+  ss->defs = XNEWVEC (cpp_hashnode *, ss->n_defs);
+  ss->n_defs = 0;
+  cpp_forall_identifiers (r, write_defs, ss);
+
+  /* Sort the list, copy it into a buffer, and write it out.  */
+  qsort (ss->defs, ss->n_defs, sizeof (cpp_hashnode *), &comp_hashnodes);
+  definedstrs = ss->definedstrs = XNEWVEC (unsigned char, ss->hashsize);
+  for (i = 0; i < ss->n_defs; ++i)
+    {
+      size_t len = NODE_LEN (ss->defs[i]);
+      memcpy (definedstrs, NODE_NAME (ss->defs[i]), len + 1);
+      definedstrs += len + 1;
+    }
+
+  memset (&z, 0, sizeof (z));
+  z.definition_length = ss->hashsize;
+  if (fwrite (&z, sizeof (z), 1, f) != 1
+      || fwrite (ss->definedstrs, 1, ss->hashsize, f) != ss->hashsize)
+    {
+      cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+      return -1;
+    }
+  free (ss->definedstrs);
+  free (ss->defs);
+
+  /* Free the saved state.  */
+  htab_delete (ss->definedhash);
+  free (ss);
+  r->savedstate = NULL;
+
+  /* Write out the value of __COUNTER__.  */
+  if (fwrite (&r->counter, sizeof (r->counter), 1, f) != 1)
+    {
+      cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+      return -1;
+    }
+
+  /* sdcpp specific: the include chain, the header and the files it
+     was built from.  */
+  for (n = 0, dir = r->quote_include; dir; dir = dir->next)
+    n++;
+  if (fwrite (&n, sizeof (n), 1, f) != 1)
+    goto error;
+  for (dir = r->quote_include; dir; dir = dir->next)
+    if (!write_string (f, dir->name))
+      goto error;
+  if (!write_string (f, cpp_get_path (r->main_file))
+      || !_cpp_save_file_list (r, f))
+    goto error;
+
+  return 0;
+
+ error:
+  cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+  return -1;
+}
+
+/* Write out a macro definition of the final state, like write_macdef
+   but for every macro that is not builtin.  */
+
+static int
+write_final_macdef (cpp_reader *pfile, cpp_hashnode *hn, void *file_p)
+{
+  if (hn->type == NT_MACRO && (hn->flags & NODE_BUILTIN))
+    return 1;
+  return write_macdef (pfile, hn, file_p);
+}
+
+/* Write out the definitions of the preprocessor, in a form suitable for
+   cpp_read_state.  */
+
+int
+cpp_write_pch_state (cpp_reader *r, FILE *f)
+{
+  struct macrodef_struct z;
+
+  /* The macros defined at the end of the header.  */
+  cpp_forall_identifiers (r, write_final_macdef, f);
+  memset (&z, 0, sizeof (z));
+  if (fwrite (&z, sizeof (z), 1, f) != 1)
+    {
+      cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+      return -1;
+    }
+
+  if (! _cpp_save_file_entries (r, f))
+    {
+      cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+      return -1;
+    }
+
+  if (fwrite (&r->counter, sizeof (r->counter), 1, f) != 1)
+    {
+      cpp_errno (r, CPP_DL_ERROR, "while writing precompiled header");
+      return -1;
+    }
+
+  return 0;
+}
+
+
+/* Data structure to transform hash table nodes into a sorted list */
+
+struct ht_node_list
+{
+  /* Array of nodes */
+  cpp_hashnode **defs;
+  /* Number of nodes in the array */
+  size_t n_defs;
+  /* Size of the allocated array */
+  size_t asize;
+};
+
+/* Callback for collecting identifiers from hash table */
+
+static int
+collect_ident_name (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *hn,
+		    void *nl_p)
+{
+  struct ht_node_list *const nl = (struct ht_node_list *)nl_p;
+
+  if (hn->type != NT_VOID || hn->flags & NODE_POISONED)
+    {
+      if (nl->n_defs == nl->asize)
+        {
+          nl->asize *= 2;
+          nl->defs = XRESIZEVEC (cpp_hashnode *, nl->defs, nl->asize);
+        }
+
+      nl->defs[nl->n_defs] = hn;
+      ++nl->n_defs;
+    }
+  return 1;
+}
+
+/* Free the state of a PCH file.  */
+
+static void
+free_pch_state (struct cpp_pch_state *s)
+{
+  size_t i;
+
+  if (s == NULL)
+    return;
+  for (i = 0; i < s->n_files; i++)
+    {
+      free (s->files[i].path);
+      free (s->files[i].guard);
+    }
+  free (s->files);
+  free (s->from);
+  free (s->to);
+  free (s);
+}
+
+/* sdcpp specific: return the name of PATH, a file read to build the
+   PCH being used, in the directory of the header now.  The result
+   is allocated with xmalloc.  */
+
+char *
+cpp_pch_path (cpp_reader *r, const char *path)
+{
+  struct cpp_pch_state *s = r->pch;
+  size_t from_dir, to_dir;
+
+  if (s == NULL)
+    return xstrdup (path);
+  if (strcmp (path, s->from) == 0)
+    return xstrdup (s->to);
+
+  from_dir = lbasename (s->from) - s->from;
+  to_dir = lbasename (s->to) - s->to;
+  if (from_dir == to_dir && strncmp (s->from, s->to, from_dir) == 0)
+    return xstrdup (path);
+
+  if (from_dir
+      ? strncmp (path, s->from, from_dir) == 0
+      : !IS_ABSOLUTE_PATH (path))
+    {
+      size_t len = strlen (path + from_dir);
+      char *p = XNEWVEC (char, to_dir + len + 1);
+
+      memcpy (p, s->to, to_dir);
+      memcpy (p + to_dir, path + from_dir, len + 1);
+      return p;
+    }
+  return xstrdup (path);
+}
+
+/* sdcpp specific: return the controlling macro recorded for the file
+   PATH by the PCH in use, or NULL.  */
+
+const cpp_hashnode *
+_cpp_pch_guard (cpp_reader *r, const char *path)
+{
+  size_t i;
+
+  for (i = 0; i < r->pch->n_files; i++)
+    if (r->pch->files[i].guard && strcmp (path, r->pch->files[i].path) == 0)
+      return cpp_lookup (r, (const unsigned char *) r->pch->files[i].guard,
+			 strlen (r->pch->files[i].guard));
+  return NULL;
+}
+
+/* Return nonzero if FD is a precompiled header which is consistent
+   with the preprocessor's current definitions.  It will be consistent
+   when:
+
+   - anything that was defined just before the PCH was generated
+     is defined the same way now; and
+   - anything that was not defined then, but is defined now, was not
+     used by the PCH; and
+   - the include chain is the same, and the files the PCH was built
+     from, relocated to the directory of the header now, did not
+     change.
+
+   NAME is used to print warnings if `warn_invalid_pch' is set in the
+   reader's flags.
+*/
+
+int
+cpp_valid_state (cpp_reader *r, const char *name, int fd)
+{
+  struct macrodef_struct m;
+  size_t namebufsz = 256;
+  unsigned char *namebuf = XNEWVEC (unsigned char, namebufsz);
+  unsigned char *undeftab = NULL;
+  struct ht_node_list nl = { 0, 0, 0 };
+  unsigned char *first, *last;
+  unsigned int i;
+  unsigned int counter;
+  struct cpp_dir *dir;
+  struct cpp_pch_state *s;
+  char *str;
+
+  /* Read in the list of identifiers that must be defined
+     Check that they are defined in the same way.  */
+  for (;;)
+    {
+      cpp_hashnode *h;
+      const unsigned char *newdefn;
+
+      if (read (fd, &m, sizeof (m)) != sizeof (m))
+	goto error;
+
+      if (m.name_length == 0)
+	break;
+
+      /* If this file is already preprocessed, there won't be any
+	 macros defined, and that's OK.  */
+      if (CPP_OPTION (r, preprocessed))
+	{
+	  if (lseek (fd, m.definition_length, SEEK_CUR) == -1)
+	    goto error;
+	  continue;
+	}
+
+      if (m.definition_length > namebufsz)
+	{
+	  free (namebuf);
+	  namebufsz = m.definition_length + 256;
+	  namebuf = XNEWVEC (unsigned char, namebufsz);
+	}
+
+      if ((size_t)read (fd, namebuf, m.definition_length)
+	  != m.definition_length)
+	goto error;
+
+      h = cpp_lookup (r, namebuf, m.name_length);
+      if (m.flags & NODE_POISONED
+	  || h->flags & NODE_POISONED)
+	{
+	  if (CPP_OPTION (r, warn_invalid_pch))
+	    cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		       "%s: not used because `%.*s' is poisoned",
+		       name, m.name_length, namebuf);
+	  goto fail;
+	}
+
+      if (h->type != NT_MACRO)
+	{
+	  if (CPP_OPTION (r, warn_invalid_pch))
+	    cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		       "%s: not used because `%.*s' not defined",
+		       name, m.name_length, namebuf);
+	  goto fail;
+	}
+
+      newdefn = cpp_macro_definition (r, h);
+
+      if (m.definition_length != ustrlen (newdefn)
+	  || memcmp (namebuf, newdefn, m.definition_length) != 0)
+	{
+	  if (CPP_OPTION (r, warn_invalid_pch))
+	    cpp_error (r, CPP_DL_WARNING_SYSHDR,
+	       "%s: not used because `%.*s' defined as `%s' not `%.*s'",
+		       name, m.name_length, namebuf, newdefn + m.name_length,
+		       m.definition_length - m.name_length,
+		       namebuf +  m.name_length);
+	  goto fail;
+	}
+    }
+  free (namebuf);
+  namebuf = NULL;
+
+  /* Read in the list of identifiers that must not be defined.
+     Check that they are not defined.  */
+  undeftab = XNEWVEC (unsigned char, m.definition_length);
+  if ((size_t) read (fd, undeftab, m.definition_length) != m.definition_length)
+    goto error;
+
+  /* Collect identifiers from the current hash table.  */
+  nl.n_defs = 0;
+  nl.asize = 10;
+  nl.defs = XNEWVEC (cpp_hashnode *, nl.asize);
+  cpp_forall_identifiers (r, &collect_ident_name, &nl);
+  qsort (nl.defs, nl.n_defs, sizeof (cpp_hashnode *), &comp_hashnodes);
+
+  /* Loop through nl.defs and undeftab, both of which are sorted lists.
+     There should be no matches.  */
+  first = undeftab;
+  last = undeftab + m.definition_length;
+  i = 0;
+
+  while (first < last && i < nl.n_defs)
+    {
+      int cmp = ustrcmp (first, NODE_NAME (nl.defs[i]));
+
+      if (cmp < 0)
+ 	first += ustrlen (first) + 1;
+      else if (cmp > 0)
+ 	++i;
+      else
+	{
+	  if (CPP_OPTION (r, warn_invalid_pch))
+	    cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		       "%s: not used because `%s' is defined",
+		       name, first);
+	  goto fail;
+	}
+    }
+
+  free(nl.defs);
+  nl.defs = NULL;
+  free (undeftab);
+  undeftab = NULL;
+
+  /* Read in the next value of __COUNTER__.
+     Check that (a) __COUNTER__ was not used in the pch or (b) __COUNTER__
+     has not been used in this translation unit. */
+  if (read (fd, &counter, sizeof (counter)) != sizeof (counter))
+    goto error;
+  if (counter && r->counter)
+    {
+      if (CPP_OPTION (r, warn_invalid_pch))
+	cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		   "%s: not used because `__COUNTER__' is invalid",
+		   name);
+      goto fail;
+    }
+
+  /* sdcpp specific: the include chain must be the same.  */
+  if (read (fd, &counter, sizeof (counter)) != sizeof (counter))
+    goto error;
+  for (dir = r->quote_include; counter; counter--, dir = dir->next)
+    {
+      if ((str = read_string (fd)) == NULL)
+	goto error;
+      if (dir == NULL || strcmp (str, dir->name) != 0)
+	{
+	  if (CPP_OPTION (r, warn_invalid_pch))
+	    cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		       "%s: not used because the include path differs",
+		       name);
+	  free (str);
+	  goto fail;
+	}
+      free (str);
+    }
+  if (dir != NULL)
+    {
+      if (CPP_OPTION (r, warn_invalid_pch))
+	cpp_error (r, CPP_DL_WARNING_SYSHDR,
+		   "%s: not used because the include path differs", name);
+      goto fail;
+    }
+
+  /* The header now is the name of the PCH up to its .gch suffix.  */
+  free_pch_state (r->pch);
+  r->pch = s = XCNEW (struct cpp_pch_state);
+  if ((s->from = read_string (fd)) == NULL)
+    goto error;
+  s->to = xstrdup (name);
+  for (str = s->to + strlen (s->to) - 4; str > s->to; str--)
+    if (strncmp (str, ".gch", 4) == 0)
+      {
+	*str = '\0';
+	break;
+      }
+
+  switch (_cpp_valid_file_list (r, name, fd))
+    {
+    case -1:
+      goto error;
+    case 1:
+      goto fail;
+    }
+
+  /* We win!  */
+  return 0;
+
+ error:
+  cpp_errno (r, CPP_DL_ERROR, "while reading precompiled header");
+  free (namebuf);
+  free (undeftab);
+  free (nl.defs);
+  free_pch_state (r->pch);
+  r->pch = NULL;
+  return -1;
+
+ fail:
+  if (namebuf != NULL)
+    free (namebuf);
+  if (undeftab != NULL)
+    free (undeftab);
+  if (nl.defs != NULL)
+    free (nl.defs);
+  free_pch_state (r->pch);
+  r->pch = NULL;
+  return 1;
+}
+
+/* A macro definition read back by cpp_read_state.  */
+struct pch_macro
+{
+  /* The definition as cpp_macro_definition writes it, with a newline
+     at DEFINITION_LENGTH.  */
+  unsigned char *text;
+  unsigned int definition_length;
+  unsigned short name_length;
+  unsigned short flags;
+};
+
+/* Undefine the macros of the reader that the PCH does not define,
+   they were #undef-ed by the header.  */
+
+static int
+undef_missing (cpp_reader *pfile ATTRIBUTE_UNUSED, cpp_hashnode *hn,
+	       void *defined_p)
+{
+  htab_t defined = (htab_t) defined_p;
+  struct cpp_string news;
+
+  if (hn->type == NT_MACRO && !(hn->flags & NODE_BUILTIN))
+    {
+      news.len = NODE_LEN (hn);
+      news.text = NODE_NAME (hn);
+      if (htab_find (defined, &news) == NULL)
+	_cpp_free_definition (hn);
+    }
+  return 1;
+}
+
+/* Read the state of the preprocessor at the end of the header from F,
+   the PCH file NAME which cpp_valid_state accepted: define its macros
+   and note its once-only files and the controlling macros of its
+   files.  */
+
+int
+cpp_read_state (cpp_reader *r, const char *name ATTRIBUTE_UNUSED, FILE *f)
+{
+  struct macrodef_struct m;
+  struct lexer_state old_state;
+  struct pch_macro *defs = NULL;
+  struct cpp_string *names;
+  size_t n_defs = 0, a_defs = 0;
+  htab_t defined;
+  unsigned int counter;
+  size_t i;
+
+  for (;;)
+    {
+      if (fread (&m, sizeof (m), 1, f) != 1)
+	goto error;
+      if (m.name_length == 0)
+	break;
+
+      if (n_defs == a_defs)
+	{
+	  a_defs = a_defs ? 2 * a_defs : 256;
+	  defs = XRESIZEVEC (struct pch_macro, defs, a_defs);
+	}
+      defs[n_defs].text = XNEWVEC (unsigned char, m.definition_length + 1);
+      defs[n_defs].definition_length = m.definition_length;
+      defs[n_defs].name_length = m.name_length;
+      defs[n_defs].flags = m.flags;
+      n_defs++;
+      if (fread (defs[n_defs - 1].text, 1, m.definition_length, f)
+	  != m.definition_length)
+	goto error;
+      /* The buffer of a directive ends with a newline.  */
+      defs[n_defs - 1].text[m.definition_length] = '\n';
+    }
+
+  /* Names which are not defined at the end of the header were
+     #undef-ed by it.  */
+  names = XNEWVEC (struct cpp_string, n_defs);
+  defined = htab_create (n_defs + 1, cpp_string_hash, cpp_string_eq, NULL);
+  for (i = 0; i < n_defs; i++)
+    {
+      names[i].len = defs[i].name_length;
+      names[i].text = defs[i].text;
+      *htab_find_slot (defined, &names[i], INSERT) = &names[i];
+    }
+  cpp_forall_identifiers (r, undef_missing, defined);
+  htab_delete (defined);
+  free (names);
+
+  old_state = r->state;
+  r->state.in_directive = 1;
+  r->state.prevent_expansion = 1;
+  r->state.angled_headers = 0;
+
+  for (i = 0; i < n_defs; i++)
+    {
+      struct pch_macro *d = &defs[i];
+      cpp_hashnode *h = cpp_lookup (r, d->text, d->name_length);
+
+      if (d->flags & NODE_POISONED)
+	{
+	  if (h->type == NT_MACRO)
+	    _cpp_free_definition (h);
+	  h->flags |= NODE_POISONED | NODE_DIAGNOSTIC;
+	  continue;
+	}
+
+      if (h->type == NT_MACRO)
+	{
+	  const unsigned char *cur = cpp_macro_definition (r, h);
+
+	  if (ustrlen (cur) == d->definition_length
+	      && memcmp (cur, d->text, d->definition_length) == 0)
+	    continue;
+	  _cpp_free_definition (h);
+	}
+
+      if (cpp_push_buffer (r, d->text + d->name_length,
+			   d->definition_length - d->name_length, true)
+	  == NULL)
+	abort ();
+      _cpp_clean_line (r);
+      if (!_cpp_create_definition (r, h))
+	abort ();
+      _cpp_pop_buffer (r);
+    }
+
+  r->state = old_state;
+
+  for (i = 0; i < n_defs; i++)
+    free (defs[i].text);
+  free (defs);
+  defs = NULL;
+  n_defs = 0;
+
+  if (! _cpp_read_file_entries (r, f))
+    goto error;
+
+  if (fread (&counter, sizeof (counter), 1, f) != 1)
+    goto error;
+
+  if (!r->counter)
+    r->counter = counter;
+
+  /* The files of the header are dependencies now.  */
+  for (i = 0; i < r->pch->n_files; i++)
+    if (CPP_OPTION (r, deps.style) > !!r->pch->files[i].sysp)
+      deps_add_dep (r->deps, r->pch->files[i].path);
+
+  return 0;
+
+ error:
+  for (i = 0; i < n_defs; i++)
+    free (defs[i].text);
+  free (defs);
+  cpp_errno (r, CPP_DL_ERROR, "while reading precompiled header");
+  return -1;
+}
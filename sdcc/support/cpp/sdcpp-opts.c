@@ -207,11 +207,9 @@ sdcpp_common_handle_option (size_t scode, const char *arg, int value)
       result = 0;
       break;
 
-#if 0 /* pch not supported by sdcpp */
     case OPT__output_pch_:
       pch_file = arg;
       break;
-#endif
 
     case OPT_A:
       defer_opt (code, arg);
@@ -322,11 +320,9 @@ sdcpp_common_handle_option (size_t scode, const char *arg, int value)
       /* Silently ignore for now.  */
       break;
 
-#if 0 // pch not supported by sdcpp
     case OPT_Winvalid_pch:
       cpp_opts->warn_invalid_pch = value;
       break;
-#endif
 
     case OPT_Wtraditional:
       cpp_opts->cpp_warn_traditional = value;
@@ -558,10 +554,16 @@ sdcpp_common_post_options (const char **pfilename)
   /* Open the output now.  We must do so even if flag_no_output is
      on, because there may be other output than from the actual
      preprocessing (e.g. from -dM).  */
-  if (out_fname[0] == '\0')
+  if (pch_file && flag_dump_macros == 'M')
+    error ("-dM cannot be used with --output-pch");
+
+  /* The text of a precompiled header is read back from the output.  */
+  if (pch_file && out_fname[0] == '\0')
+    out_stream = tmpfile ();
+  else if (out_fname[0] == '\0')
     out_stream = stdout;
   else
-    out_stream = fopen (out_fname, "w");
+    out_stream = fopen (out_fname, pch_file ? "w+" : "w");
 
   if (out_stream == NULL)
     {
@@ -618,6 +620,7 @@ sdcpp_common_init (void)
 #endif
 
   finish_options ();
+  pch_init (out_stream);
   preprocess_file (parse_in);
   return true;
 }
@@ -646,6 +649,9 @@ sdcpp_common_finish (void)
      with cpp_destroy ().  */
   cpp_finish (parse_in, deps_stream);
 
+  /* The controlling macro of the header is known now.  */
+  c_common_write_pch ();
+
   if (deps_stream && deps_stream != out_stream
       && (ferror (deps_stream) || fclose (deps_stream)))
     fatal_error ("closing dependency file %s: %s", deps_file, strerror(errno));
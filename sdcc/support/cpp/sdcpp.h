@@ -202,6 +202,14 @@ extern void init_pp_output (FILE *);
 extern void preprocess_file (cpp_reader *);
 extern void pp_file_change (const struct line_map *);
 extern void pp_dir_change (cpp_reader *, const char *);
+extern void pp_pch_output (cpp_reader *, const char *, size_t);
+
+/* In c-pch.c  */
+extern const char *pch_file;
+extern void pch_init (FILE *);
+extern void c_common_write_pch (void);
+extern int c_common_valid_pch (cpp_reader *, const char *, int);
+extern void c_common_read_pch (cpp_reader *, const char *, int, const char *);
 
 /*
  * From c-pragma.h
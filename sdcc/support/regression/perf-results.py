@@ -0,0 +1,188 @@
+"""Code size and speed store of the regression tests.
+
+  perf-results.py store port outfile < results
+      Scans the test suite results of one port fed in through stdin and
+      saves bytes and ticks of each test case, together with the size of
+      each global function (taken from the linker map file of the case),
+      into outfile as JSON.
+
+  perf-results.py compare old.json new.json [threshold]
+      Compares two stores and lists test cases whose size or tick count
+      changed by more than threshold percent (default 1), and the changed
+      functions of them. Exit status is 1 if anything got worse."""
+
+from __future__ import print_function
+
+import sys, re, io
+import json
+
+def usage():
+    print("usage: perf-results.py store port outfile < results")
+    print("       perf-results.py compare old.json new.json [threshold]")
+    sys.exit(2)
+
+def map_functions(mapfile):
+    """Sizes of global symbols in the code areas of a linker map file.
+    A symbol is assumed to extend to the next one or to the end of
+    its area."""
+    functions = {}
+    try:
+        fp = io.open(mapfile, encoding="latin-1")
+    except IOError:
+        return functions
+    radix = 16
+    area = None
+    end = 0
+    symbols = []
+
+    def flush():
+        symbols.sort()
+        for i in range(len(symbols)):
+            (addr, name) = symbols[i]
+            if i + 1 < len(symbols):
+                size = symbols[i + 1][0] - addr
+            else:
+                size = end - addr
+            if size > 0:
+                functions[name] = size
+        del symbols[:]
+
+    for line in fp:
+        if (re.match(r'^Hexadecimal', line)):
+            radix = 16
+        elif (re.match(r'^Decimal', line)):
+            radix = 10
+        elif (re.match(r'^Octal', line)):
+            radix = 8
+
+        # CODE    0000812D    0000037E =         894. bytes (REL,CON)
+        m = re.match(r'^(\S+)\s+([0-9A-Fa-f]+)\s+([0-9A-Fa-f]+)\s+=', line)
+        if (m):
+            flush()
+            area = None
+            if (re.match(r'^(CODE|CSEG|HOME|.*_CODE|CODE_.*)$', m.group(1))):
+                area = m.group(1)
+                end = int(m.group(2), radix) + int(m.group(3), radix)
+            continue
+
+        # 0000812D  ___prints                          testfwk
+        # C:   00000096  ___prints                          testfwk
+        m = re.match(r'^(?:[A-Z]:)?\s+([0-9A-Fa-f]+)\s+(\S+)', line)
+        if (m and area):
+            symbols.append((int(m.group(1), radix), m.group(2)))
+    flush()
+    fp.close()
+    return functions
+
+def store(port, outfile):
+    if sys.version_info[0]<3:
+        safe_stdin = sys.stdin
+    else:
+        safe_stdin = io.TextIOWrapper(sys.stdin.buffer, encoding="latin-1")
+
+    cases = {}
+    name = ""
+    failures = 0
+    for line in safe_stdin:
+        # --- Running: gen/stm8/bp/bp
+        m = re.match(r'^--- Running: (.*)$', line)
+        if (m):
+            name = m.group(1).strip()
+
+        # in case the test program crashes before the "--- Running" message
+        m = re.match(r'^[0-9]+ words read from (.*)\.ihx$', line)
+        if (m):
+            name = m.group(1)
+
+        m = re.match(r'^--- Summary: *([0-9]+)/', line)
+        if (m):
+            failures = failures + int(m.group(1))
+
+        # '--- Simulator: b/t: ...', where b = # bytes, t = # ticks
+        m = re.match(r'^--- Simulator: *([0-9]+)/([0-9]+)', line)
+        if (m and name):
+            key = re.sub(r'^[^/]*/[^/]*/', '', name)
+            cases[key] = {
+                "bytes": int(m.group(1)),
+                "ticks": int(m.group(2)),
+                "failures": failures,
+                "functions": map_functions(name + ".map")
+                }
+            name = ""
+            failures = 0
+
+    fp = open(outfile, "w")
+    json.dump({"port": port, "cases": cases}, fp, indent=1, sort_keys=True)
+    fp.write("\n")
+    fp.close()
+
+def change(old, new):
+    if old == 0:
+        return 0.0
+    return 100.0 * (new - old) / old
+
+def compare(oldfile, newfile, threshold):
+    old = json.load(open(oldfile))["cases"]
+    new = json.load(open(newfile))["cases"]
+
+    worse = 0
+    better = 0
+    totals = {"bytes": [0, 0], "ticks": [0, 0]}
+    for case in sorted(new):
+        if case not in old:
+            print("New: %s" % case)
+            continue
+        o = old[case]
+        n = new[case]
+        if o["failures"] or n["failures"]:
+            print("Failing: %s" % case)
+            continue
+        marks = []
+        for what in ("bytes", "ticks"):
+            totals[what][0] += o[what]
+            totals[what][1] += n[what]
+            c = change(o[what], n[what])
+            if abs(c) > threshold:
+                marks.append("%s %d -> %d (%+.1f%%)" % (what, o[what], n[what], c))
+                if c > 0:
+                    worse += 1
+                else:
+                    better += 1
+        if not marks:
+            continue
+        print("%s: %s" % (case, ", ".join(marks)))
+        of = o["functions"]
+        nf = n["functions"]
+        for f in sorted(set(of) | set(nf)):
+            if f not in of:
+                print("    %-32s new, %d bytes" % (f, nf[f]))
+            elif f not in nf:
+                print("    %-32s gone, was %d bytes" % (f, of[f]))
+            elif of[f] != nf[f]:
+                print("    %-32s %d -> %d bytes (%+.1f%%)" %
+                      (f, of[f], nf[f], change(of[f], nf[f])))
+    for case in sorted(old):
+        if case not in new:
+            print("Missing: %s" % case)
+
+    print("Total bytes %d -> %d (%+.2f%%), ticks %d -> %d (%+.2f%%)" %
+          (totals["bytes"][0], totals["bytes"][1],
+           change(totals["bytes"][0], totals["bytes"][1]),
+           totals["ticks"][0], totals["ticks"][1],
+           change(totals["ticks"][0], totals["ticks"][1])))
+    print("%d figures worse, %d better by more than %g%%" %
+          (worse, better, threshold))
+    return worse
+
+if len(sys.argv) < 2:
+    usage()
+if sys.argv[1] == "store" and len(sys.argv) == 4:
+    store(sys.argv[2], sys.argv[3])
+elif sys.argv[1] == "compare" and len(sys.argv) in (4, 5):
+    threshold = 1.0
+    if len(sys.argv) == 5:
+        threshold = float(sys.argv[4])
+    if compare(sys.argv[2], sys.argv[3], threshold):
+        sys.exit(1)
+else:
+    usage()
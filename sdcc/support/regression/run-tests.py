@@ -0,0 +1,502 @@
+"""Parallel driver of the regression tests.
+
+  run-tests.py [-j jobs] [-t test]... [--timeout s] [--json] [VAR=value]...
+               [port...]
+
+Needs Python 3. Must be run in the build directory of the regression
+tests, it uses the rules of the Makefile and of ports/<port>/spec.mk for
+each step, with TIMEOUT set empty instead of fwk/lib/timeout.c, and the
+VAR=value arguments passed to make. The
+test cases of all ports are generated, compiled, linked and simulated as
+separate jobs in one pool of workers, later steps of a case are preferred,
+so results come as early as possible. Every job has its own timeout (the
+SIM_TIMEOUT of the port for simulation, --build-timeout for the others),
+the process group of the job is killed when it expires.
+
+As soon as a test case finishes, a JSON record of it is appended to
+results/<port>/results.jsonl (or printed with --json), when all cases of a
+test are done, the usual one line summary of compact-results.py is printed.
+At the end collate-results.py and perf-results.py are run on each port,
+as by "make test-port".
+
+Results are reused between runs: the identity of the compiler, the
+simulator, the libraries, the framework sources with the headers they
+include and the flags of a port is stored in gen/<port>/fwk.key (the
+framework objects are rebuilt if it changes), and the hash of it together
+with the source of a test case and all headers it includes (as listed by
+the compiler with -M) in gen/<port>/<test>/<case>.key. A case is not run
+again if its key is unchanged. If the included files can not be listed,
+nothing is reused. Use --no-cache to run everything."""
+
+import sys, os, re, io
+import json, time, signal, shutil, hashlib, argparse, subprocess
+import concurrent.futures
+
+STAGES = ("compile", "link", "simulate")
+
+def env_for_make():
+    env = dict(os.environ)
+    # jobs are scheduled here, not by the jobserver of a calling make, but
+    # its variables (PYTHON=...) are kept
+    for v in ("MAKEFLAGS", "MFLAGS"):
+        if v in env:
+            env[v] = " ".join(w for w in env[v].split()
+                              if not re.match(r'^-j[0-9]*$|^--jobserver', w))
+    return env
+
+def run_job(cmd, timeout):
+    """Run cmd in its own process group. Returns (status, output), where
+    status is None if the job was killed after timeout seconds."""
+    kw = {}
+    if hasattr(os, "setsid"):
+        kw["preexec_fn"] = os.setsid
+    p = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                         env=env_for_make(), **kw)
+    try:
+        out = p.communicate(timeout=timeout)[0]
+        status = p.returncode
+    except subprocess.TimeoutExpired:
+        if hasattr(os, "killpg"):
+            try:
+                os.killpg(p.pid, signal.SIGKILL)
+            except OSError:
+                pass
+        else:
+            p.kill()
+        out = p.communicate()[0]
+        status = None
+    return (status, out.decode("latin-1"))
+
+class Port:
+    def __init__(self, args, name):
+        self.args = args
+        self.name = name
+        self.vars = {}
+        self.key = ""
+        self.cacheable = True
+
+    def make(self, targets, timeout=None):
+        cmd = self.args.make.split() + ["-s", "PORT=" + self.name, "CASES=none",
+                                        "TIMEOUT="] + self.args.make_vars + targets
+        return run_job(cmd, timeout)
+
+    def read_vars(self):
+        (status, out) = self.make(["port-vars"], self.args.build_timeout)
+        if status != 0:
+            raise RuntimeError("can not get settings of port %s:\n%s" % (self.name, out))
+        for line in out.splitlines():
+            m = re.match(r'^([A-Za-z_]+)=(.*)$', line)
+            if m:
+                self.vars[m.group(1)] = m.group(2).strip()
+        self.cases_dir = os.path.join(self.vars["CASES_DIR"], self.name)
+        self.results_dir = os.path.join(self.args.results_dir, self.name)
+        t = self.vars.get("SIM_TIMEOUT")
+        self.sim_timeout = self.args.timeout or (int(t) if t else 300)
+
+    def identity(self):
+        """Hash of everything a test case of the port depends on, except of
+        its own source."""
+        h = hashlib.sha1()
+        v = self.vars
+        for k in ("SDCC", "EMU", "SDCCFLAGS", "LINKFLAGS"):
+            h.update((k + "=" + v.get(k, "") + "\n").encode())
+        files = []
+        for word in (v.get("SDCC", "") + " " + v.get("EMU", "")).split():
+            path = shutil.which(word)
+            if path:
+                # sdcc calls the preprocessor, assembler and linker next to it
+                files.extend(dir_files(os.path.dirname(os.path.realpath(path))))
+        for flag in v.get("LINKFLAGS", "").split():
+            if flag.startswith("-L"):
+                files.extend(dir_files(flag[2:]))
+        ports = v["PORTS_DIR"]
+        sources = dir_files(os.path.join(ports, self.name)) + \
+                  dir_files(os.path.join(v["srcdir"], "fwk/lib"))
+        for d in os.listdir(ports):
+            if d.endswith("-common"):
+                common = dir_files(os.path.join(ports, d))
+                files.extend(common)
+                if self.name.startswith(d[:-len("common")]):
+                    sources.extend(common)
+        files.extend(sources)
+        files.extend(dir_files(os.path.join(v["srcdir"], "fwk/include")))
+        for f in sorted(set(files)):
+            st = os.stat(f)
+            h.update(("%s %d %d\n" % (f, st.st_size, int(st.st_mtime))).encode())
+        # the headers of the framework sources of the port, by content
+        # (timeout.c is a program for the host)
+        for f in sorted(set(sources)):
+            if f.endswith(".c") and os.path.basename(f) != "timeout.c":
+                deps = self.dependencies(f)
+                if deps is None:
+                    self.cacheable = False
+                    break
+                hash_files(h, deps)
+        return h.hexdigest()
+
+    def dependencies(self, source):
+        """Files read when compiling source, from the -M output of the
+        compiler, or None if they can not be determined."""
+        v = self.vars
+        cmd = v.get("SDCC", "").split() + v.get("SDCCFLAGS", "").split() + ["-M", source]
+        try:
+            (status, out) = run_job(cmd, self.args.build_timeout)
+        except OSError:
+            return None
+        words = out.replace("\\\n", " ").split()
+        if status != 0 or not words or not words[0].endswith(":"):
+            return None
+        return words[1:]
+
+def hash_files(h, files):
+    for f in files:
+        try:
+            with open(f, "rb") as fp:
+                data = fp.read()
+        except IOError:
+            data = b""
+        h.update(("%s %d\n" % (f, len(data))).encode())
+        h.update(data)
+
+def dir_files(d, ext=""):
+    try:
+        names = os.listdir(d)
+    except OSError:
+        return []
+    return [os.path.join(d, n) for n in names
+            if n.endswith(ext) and os.path.isfile(os.path.join(d, n))]
+
+def read_file(name):
+    try:
+        with io.open(name, encoding="latin-1") as fp:
+            return fp.read()
+    except IOError:
+        return None
+
+def write_file(name, text, mode="w"):
+    with io.open(name, mode, encoding="latin-1") as fp:
+        fp.write(text)
+
+class Case:
+    def __init__(self, test, name):
+        self.test = test
+        self.port = test.port
+        self.name = name                        # gen/<port>/<test>/<case>
+        self.stage = 0
+        self.seconds = 0.0
+        self.log = ""
+        self.cached = False
+
+    def file(self, ext):
+        return self.name + ext
+
+    def key(self):
+        """Hash of the case with everything it depends on, None if that
+        can not be determined"""
+        if not self.port.cacheable:
+            return None
+        deps = self.port.dependencies(self.file(".c"))
+        if deps is None:
+            return None
+        h = hashlib.sha1(self.port.key.encode())
+        hash_files(h, deps)
+        return h.hexdigest()
+
+    def target(self):
+        v = self.port.vars
+        return self.file((v["OBJEXT"], v["BINEXT"], ".out")[self.stage])
+
+    def timeout(self):
+        if STAGES[self.stage] == "simulate":
+            return self.port.sim_timeout
+        return self.port.args.build_timeout
+
+    def run_stage(self):
+        start = time.time()
+        (status, out) = self.port.make([self.target()], self.timeout())
+        self.seconds += time.time() - start
+        self.log += out
+        return status
+
+class Test:
+    def __init__(self, port, name):
+        self.port = port
+        self.name = name
+        self.dir = os.path.join(port.cases_dir, name)
+        self.cases = []
+        self.pending = 0
+
+def summary(text):
+    """failures, tests, cases, bytes and ticks of a case from its .out"""
+    r = {"failures": 1, "tests": 0, "cases": 0, "bytes": 0, "ticks": 0}
+    m = re.search(r'^--- Summary: *([0-9]+)/([0-9]+)/([0-9]+)', text, re.M)
+    if m:
+        r["failures"] = int(m.group(1))
+        r["tests"] = int(m.group(2))
+        r["cases"] = int(m.group(3))
+    m = re.search(r'^--- Simulator: *([0-9]+)/([0-9]+)', text, re.M)
+    if m:
+        r["bytes"] = int(m.group(1))
+        r["ticks"] = int(m.group(2))
+    if re.search(r'Invalid instruction|unknown instruction', text):
+        r["failures"] = max(r["failures"], 1)
+    return r
+
+class Driver:
+    def __init__(self, args):
+        self.args = args
+        self.pool = concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs)
+        self.running = {}
+        self.ready = []         # (priority, serial, function, argument)
+        self.serial = 0
+        self.failed = False
+        self.summaries = []
+
+    def submit(self, priority, fn, arg):
+        self.serial += 1
+        self.ready.append((priority, self.serial, fn, arg))
+
+    def run(self):
+        while self.ready or self.running:
+            # later stages first, then in order of submission
+            self.ready.sort(key=lambda j: (-j[0], j[1]))
+            while self.ready and len(self.running) < self.args.jobs:
+                (priority, serial, fn, arg) = self.ready.pop(0)
+                work, done = fn(arg)
+                self.running[self.pool.submit(work)] = done
+            finished, _ = concurrent.futures.wait(
+                list(self.running), return_when=concurrent.futures.FIRST_COMPLETED)
+            for f in finished:
+                done = self.running.pop(f)
+                done(f.result())
+        self.pool.shutdown()
+
+    # setup of a port: settings, framework objects, then its tests
+    def port_job(self, port):
+        def work():
+            try:
+                port.read_vars()
+            except RuntimeError as e:
+                return (1, str(e))
+            port.key = port.identity()
+            fwk_key = os.path.join(port.cases_dir, "fwk.key")
+            if self.args.no_cache or read_file(fwk_key) != port.key:
+                for f in port.vars.get("FWK", "").split():
+                    if os.path.exists(f):
+                        os.remove(f)
+            (status, out) = port.make(["port-dirs", "port-fwklib"],
+                                      self.args.build_timeout)
+            if status == 0:
+                write_file(fwk_key, port.key)
+            return (status, out)
+        def done(result):
+            (status, out) = result
+            if status != 0:
+                print("--- %s: building the test framework failed" % port.name)
+                sys.stdout.write(out)
+                self.failed = True
+                return
+            sys.stdout.write(out)
+            sys.stdout.flush()
+            port.tests = []
+            port.jsonl = os.path.join(port.results_dir, "results.jsonl")
+            write_file(port.jsonl, u"")
+            for name in find_tests(self.args, port):
+                test = Test(port, name)
+                port.tests.append(test)
+                self.submit(1, self.generate_job, test)
+            port.pending = len(port.tests)
+            if not port.tests:
+                self.port_done(port)
+        return (work, done)
+
+    def generate_job(self, test):
+        port = test.port
+        stamp = os.path.join(test.dir, "iterations.stamp")
+        def work():
+            (status, out) = port.make([stamp], self.args.build_timeout)
+            cases = sorted(f[:-2] for f in os.listdir(test.dir) if f.endswith(".c")) \
+                    if os.path.isdir(test.dir) else []
+            cases = [Case(test, os.path.join(test.dir, c)) for c in cases]
+            # the keys need the preprocessor, run it here in the worker
+            keys = [None if self.args.no_cache else c.key() for c in cases]
+            return (status, out, cases, keys)
+        def done(result):
+            (status, out, cases, keys) = result
+            if status != 0:
+                sys.stdout.write(out)
+            test.cases = cases
+            test.pending = len(test.cases)
+            if not test.cases:
+                self.test_done(test)
+            for (case, key) in zip(test.cases, keys):
+                if key is not None and \
+                   read_file(case.file(".key")) == key and \
+                   os.path.exists(case.file(".out")):
+                    case.cached = True
+                    self.case_done(case, "cached")
+                    continue
+                # products of other compiler versions are not up to date
+                v = port.vars
+                for ext in (v["OBJEXT"], v["BINEXT"], ".out", ".key"):
+                    if os.path.exists(case.file(ext)):
+                        os.remove(case.file(ext))
+                case.key_value = key
+                self.submit(2, self.stage_job, case)
+        return (work, done)
+
+    def stage_job(self, case):
+        def work():
+            return case.run_stage()
+        def done(status):
+            stage = STAGES[case.stage]
+            if status is None and stage == "simulate":
+                # same as the message of the rules using timeout.c
+                write_file(case.file(".out"),
+                           u"--- FAIL: \"timeout, simulation killed\" in %s.c\n"
+                           u"--- Summary: 1/1/1: timeout\n" % case.name, "a")
+                self.case_done(case, "timeout")
+            elif status is None or (status != 0 and stage != "simulate"):
+                what = "timeout" if status is None else "failed"
+                write_file(case.file(".out"),
+                           u"--- Running: %s\n"
+                           u"--- FAIL: \"%s %s\" in %s.c\n"
+                           u"--- Summary: 1/1/1: %s %s\n"
+                           % (case.name, stage, what, case.name, stage, what))
+                self.case_done(case, "timeout" if status is None else "error")
+            elif stage == "simulate":
+                if case.key_value is not None:
+                    write_file(case.file(".key"), case.key_value)
+                self.case_done(case, None)
+            else:
+                case.stage += 1
+                self.submit(2 + case.stage, self.stage_job, case)
+        return (work, done)
+
+    def case_done(self, case, status):
+        text = read_file(case.file(".out")) or ""
+        r = summary(text)
+        if status is None or status == "cached":
+            result = "fail" if r["failures"] else "pass"
+        else:
+            result = status
+        rec = {"port": case.port.name,
+               "test": case.test.name,
+               "case": os.path.basename(case.name),
+               "result": result,
+               "cached": case.cached,
+               "seconds": round(case.seconds, 3)}
+        if result in ("error", "timeout"):
+            rec["stage"] = STAGES[case.stage]
+        rec.update(r)
+        line = json.dumps(rec, sort_keys=True)
+        write_file(case.port.jsonl, line + u"\n", "a")
+        if self.args.json:
+            print(line)
+        elif result != "pass" and self.args.verbose:
+            sys.stdout.write(case.log)
+        sys.stdout.flush()
+        test = case.test
+        test.pending -= 1
+        if test.pending == 0:
+            self.test_done(test)
+
+    def test_done(self, test):
+        port = test.port
+        out = os.path.join(port.results_dir, test.name + ".out")
+        text = u"".join(read_file(c.file(".out")) or u"" for c in test.cases)
+        write_file(out, text)
+        if not self.args.json:
+            sys.stdout.write(compact(port, out))
+            sys.stdout.flush()
+        port.pending -= 1
+        if port.pending == 0:
+            self.port_done(port)
+
+    def port_done(self, port):
+        outs = sorted(os.path.join(port.results_dir, t.name + ".out") for t in port.tests)
+        text = b"".join(open(f, "rb").read() for f in outs)
+        python = port.vars.get("PYTHON") or sys.executable
+        srcdir = port.vars["srcdir"]
+        collate = subprocess.Popen([python, os.path.join(srcdir, "collate-results.py"), port.name],
+                                   stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        res = collate.communicate(text)[0].decode("latin-1")
+        subprocess.Popen([python, os.path.join(srcdir, "perf-results.py"), "store", port.name,
+                          os.path.join(port.results_dir, "perf.json")],
+                         stdin=subprocess.PIPE).communicate(text)
+        if not self.args.json:
+            sys.stdout.write(res)
+        self.summaries.append(res)
+
+def compact(port, out):
+    python = port.vars.get("PYTHON") or sys.executable
+    p = subprocess.Popen([python, os.path.join(port.vars["srcdir"], "compact-results.py"), out],
+                         stdin=open(out, "rb"), stdout=subprocess.PIPE)
+    return p.communicate()[0].decode("latin-1")
+
+def find_tests(args, port):
+    """Names of the tests: tests/*.c and tests/*.m4, or the ones given"""
+    names = []
+    tests_dir = port.vars["TESTS_DIR"]
+    for root, dirs, files in os.walk(tests_dir):
+        for f in files:
+            if f.endswith(".c") or f.endswith(".m4"):
+                names.append(f[:-2] if f.endswith(".c") else f[:-3])
+    names = sorted(set(names))
+    if args.tests:
+        names = [n for n in names if n in args.tests]
+    return names
+
+def default_ports(args):
+    ports_dir = None
+    (status, out) = run_job(args.make.split() + ["-s", "CASES=none", "TIMEOUT="] +
+                            args.make_vars + ["port-vars"], args.build_timeout)
+    for line in out.splitlines():
+        if line.startswith("PORTS_DIR="):
+            ports_dir = line[10:].strip()
+    if not ports_dir:
+        return []
+    exclude = ("rrz80", "rrgbz80", "pic16", "pic14", "mcs51-common")
+    return sorted(d for d in os.listdir(ports_dir)
+                  if d not in exclude and not d.startswith("."))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Run the regression tests in parallel")
+    parser.add_argument("ports", nargs="*", metavar="port",
+                        help="ports to test (default: all), or VAR=value for make")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="number of jobs run at once")
+    parser.add_argument("-t", "--test", dest="tests", action="append",
+                        help="run only this test (may be repeated)")
+    parser.add_argument("--timeout", type=int, default=0,
+                        help="simulation timeout in seconds (default: SIM_TIMEOUT of the port)")
+    parser.add_argument("--build-timeout", type=int, default=600,
+                        help="timeout of the other jobs in seconds")
+    parser.add_argument("--results-dir", default="results")
+    parser.add_argument("--make", default="make")
+    parser.add_argument("--no-cache", action="store_true",
+                        help="run all cases, even if nothing changed")
+    parser.add_argument("--json", action="store_true",
+                        help="print a JSON record of each case instead of the summaries")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="print output of the jobs of failed cases")
+    args = parser.parse_args()
+    args.make_vars = [p for p in args.ports if "=" in p]
+    args.ports = [p for p in args.ports if "=" not in p]
+
+    # generated .m4 cases and the gen directory
+    (status, out) = run_job(args.make.split() + ["-s", "TIMEOUT="] + args.make_vars +
+                            ["test-common"], args.build_timeout)
+    sys.stdout.write(out)
+    if status != 0:
+        sys.exit(1)
+
+    driver = Driver(args)
+    for name in args.ports or default_ports(args):
+        driver.submit(0, driver.port_job, Port(args, name))
+    driver.run()
+    # summaries of the ports together, after the results of the tests
+    if not args.json and len(driver.summaries) > 1:
+        for s in driver.summaries:
+            sys.stdout.write(s)
+    sys.exit(1 if driver.failed else 0)
@@ -0,0 +1,169 @@
+/** Bit exact results of the float library routines.
+
+    The expected values are the results of the C versions of the routines
+    in device/lib. The ports which replace them by assembly must give the
+    same results, bit for bit.
+*/
+
+#include <testfwk.h>
+#include <stdint.h>
+
+#if defined(__SDCC_stm8) || defined(__SDCC_hc08) || defined(__SDCC_s08)
+#define TEST_FLOAT_BITS 1
+#endif
+
+#ifdef TEST_FLOAT_BITS
+union float_long
+{
+  float f;
+  uint32_t l;
+};
+
+/* a1, a2, a1 + a2, a1 - a2, a1 * a2, a1 / a2, comparisons:
+   1 for a1 < a2, 2 for a1 > a2, 4 for a1 == a2. */
+static const struct
+{
+  uint32_t a1, a2, add, sub, mul, div;
+  uint8_t cmp;
+} ops[] =
+{
+  {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xffc00000, 4},
+  {0x80000000, 0x00000000, 0x80000000, 0x80000000, 0x00000000, 0xffc00000, 4},
+  {0x00000000, 0x80000000, 0x80000000, 0x00800000, 0x00000000, 0xffc00000, 4},
+  {0x3f800000, 0x00000000, 0x3f800000, 0x3f800000, 0x00000000, 0x7f800000, 2},
+  {0x00000000, 0xbf800000, 0xbf800000, 0x3f800000, 0x00000000, 0x00000000, 2},
+  {0x80000000, 0x3f800000, 0x3f800000, 0xbf800000, 0x80000000, 0x80000000, 1},
+  {0x3f800000, 0x3f800000, 0x40000000, 0x80000000, 0x3f800000, 0x3f800000, 4},
+  {0x3f800000, 0xbf800000, 0x00000000, 0x40000000, 0xbf800000, 0xbf800000, 2},
+  {0x40400000, 0x3f800000, 0x40800000, 0x40000000, 0x40400000, 0x40400000, 2},
+  {0x7f7fffff, 0x7f7fffff, 0x7fffffff, 0x80000000, 0x7f800000, 0x3f800000, 4},
+  {0x7f7fffff, 0xff7fffff, 0x00000000, 0x7fffffff, 0xff800000, 0xbf800000, 2},
+  {0x00800000, 0x00800000, 0x01000000, 0x80000000, 0x00000000, 0x3f800000, 4},
+  {0x00800000, 0x3f000000, 0x3f000000, 0xbf000000, 0x00000000, 0x01000000, 1},
+  {0x4b7fffff, 0x3f800000, 0x4b800000, 0x4b7ffffe, 0x4b7fffff, 0x4b7fffff, 2},
+  {0x4b7fffff, 0x3f000000, 0x4b7fffff, 0x4b7ffffe, 0x4affffff, 0x4bffffff, 2},
+  {0x3f800001, 0x33800000, 0x3f800001, 0x3f800000, 0x33800001, 0x4b800001, 2},
+  {0x3f800000, 0x33ffffff, 0x3f800000, 0x3f7ffffe, 0x33ffffff, 0x4b000001, 2},
+  {0x3fffffff, 0x3fffffff, 0x407fffff, 0x80000000, 0x407ffffe, 0x3f800000, 4},
+  {0x7f000000, 0x40000000, 0x7f000000, 0x7f000000, 0x7f800000, 0x7e800000, 2},
+  {0x00ffffff, 0x3f000000, 0x3f000000, 0xbf000000, 0x007fffff, 0x017fffff, 1},
+  {0x3f800000, 0x7f800000, 0x7f800000, 0xff800000, 0x7f800000, 0x00000000, 1},
+  {0x7f800000, 0x7f800000, 0x7f800000, 0x80000000, 0x7f800000, 0x3f800000, 4},
+  {0xbf800000, 0x80000000, 0xbf800000, 0xbf800000, 0x00000000, 0xff800000, 1},
+  {0x00000001, 0x4b000000, 0x4b000000, 0xcb000000, 0x0b800001, 0x00000000, 1},
+  {0x2b1f4d63, 0x94dacb7a, 0x2b1f4d63, 0x2b1f4d63, 0x80882685, 0xd5ba6418, 2},
+  {0x3f0859a0, 0x3fb0567e, 0x3ff4834e, 0xbf58535c, 0x3f3bd75e, 0x3ec5f28a, 1},
+  {0xd28ab0e1, 0x164c87ea, 0xd28ab0e1, 0xd28ab0e1, 0xa95d9d2b, 0xfbad977d, 1},
+  {0x3f8112f2, 0x4032183d, 0x4072a1b6, 0xbfe31d88, 0x403396ca, 0x3eb9892c, 1},
+  {0x2c8429c7, 0x9e2f3e39, 0x2c8429c7, 0x2c8429c7, 0x8b34f15d, 0xcdc11156, 2},
+  {0x3fec7b6d, 0xc1b66b0d, 0xc1a7a356, 0x41c532c3, 0xc22882a3, 0xbda5ef94, 2},
+  {0xac29fca6, 0xe413da78, 0xe413da78, 0x6413da78, 0x50c45a48, 0x07932957, 2},
+  {0x3fce2f16, 0xbfba4780, 0x3e1f3cb0, 0x40443b4b, 0xc01607cc, 0xbf8dad62, 2},
+  {0x550f1d05, 0x63532c12, 0x63532c12, 0xe3532c12, 0x78ec1b1c, 0x312d7e5e, 1},
+  {0xbffc803a, 0xc0872ea7, 0xc0c64eb5, 0x40101d31, 0x410555a2, 0x3eef15e4, 2},
+  {0xfc29644e, 0xc4b94fde, 0xfc29644e, 0xfc29644e, 0x7f800000, 0x76ea01cc, 1},
+  {0x3f1dd69f, 0x41076678, 0x411143e1, 0xc0fb121c, 0x40a6f6b7, 0x3d953635, 1},
+  {0xb3ca709c, 0x46e84070, 0x46e84070, 0xc6e84070, 0xbb37a902, 0xac5f23cd, 1},
+  {0xbf2a8763, 0xbf164600, 0xbfa066b1, 0xbda20b18, 0x3ec833ea, 0x3f9140d0, 1},
+  {0x081b820b, 0x73011ae6, 0x73011ae6, 0xf3011ae6, 0x3b9cd9bd, 0x00000000, 1},
+  {0x3fe3abc8, 0xc0cd2c25, 0xc0944133, 0x41030b8b, 0xc13677d2, 0xbe8e093d, 2},
+  {0x517da021, 0x4a47a13d, 0x517da33f, 0x517d9d02, 0x5c45c738, 0x46a29f0e, 2},
+  {0x3f6b9fad, 0x4159d322, 0x41688d1c, 0xc14b1927, 0x41487cae, 0x3d8a758e, 1},
+  {0x0f8f70bc, 0xd2888e70, 0xd2888e70, 0x52888e70, 0xa2990766, 0x00000000, 2},
+  {0xbf9b15b3, 0xbf8f3585, 0xc015259c, 0xbdbe02e0, 0x3fad8316, 0x3f8a9d4f, 1},
+  {0x4dcd83da, 0x4b611d21, 0x4dd48cc3, 0x4dc67af1, 0x59b4b845, 0x41e9b657, 2},
+  {0x3f642123, 0x40475b63, 0x408031d5, 0xc00e531a, 0x4031a732, 0x3e927949, 1},
+  {0x72456e36, 0x2ffbff17, 0x72456e36, 0x72456e36, 0x62c257c9, 0x7f800000, 2},
+  {0x3f3fd47b, 0xc1acf4c3, 0xc1a6f61f, 0x41b2f366, 0xc1819a2b, 0xbd0df7d2, 2},
+};
+
+/* l, (float)(unsigned long)l, (float)(long)l, (unsigned long)f, (long)f,
+   where f has the bit pattern of l. */
+static const struct
+{
+  uint32_t l, ul2fs, sl2fs, fs2ul, fs2sl;
+} conv[] =
+{
+  {0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000},
+  {0x00000001, 0x3f800000, 0x3f800000, 0x00000000, 0x00000000},
+  {0x00ffffff, 0x4b7fffff, 0x4b7fffff, 0x00000000, 0x00000000},
+  {0x01000000, 0x4b800000, 0x4b800000, 0x00000000, 0x00000000},
+  {0x01000001, 0x4b800001, 0x4b800001, 0x00000000, 0x00000000},
+  {0x7fffffff, 0x4f000000, 0x4f000000, 0x00000000, 0x00000000},
+  {0x80000000, 0x4f000000, 0xcf000000, 0x00000000, 0x00000000},
+  {0xffffffff, 0x4b800000, 0xbf800000, 0x00000000, 0x00000000},
+  {0xfffffffe, 0x4f800000, 0xc0000000, 0x00000000, 0x00000000},
+  {0x3f800000, 0x4e7e0000, 0x4e7e0000, 0x00000001, 0x00000001},
+  {0xbf800000, 0x4f3f8000, 0xce810000, 0x00000000, 0xffffffff},
+  {0x3f7fffff, 0x4e7e0000, 0x4e7e0000, 0x00000000, 0x00000000},
+  {0x4b7fffff, 0x4e970000, 0x4e970000, 0x00ffffff, 0x00ffffff},
+  {0xcb7fffff, 0x4f4b8000, 0xce520001, 0x00000000, 0xff000001},
+  {0x4b800000, 0x4e970000, 0x4e970000, 0x00000000, 0x00000000},
+  {0x4effffff, 0x4e9e0000, 0x4e9e0000, 0x00000000, 0x00000000},
+  {0x4f000000, 0x4e9e0000, 0x4e9e0000, 0x00000000, 0x00000000},
+  {0xcf000000, 0x4f4f0000, 0xce440000, 0x00000000, 0x00000000},
+  {0x7f800000, 0x4eff0000, 0x4eff0000, 0x00000000, 0x00000000},
+  {0x80000001, 0x4f000001, 0xcf000000, 0x00000000, 0x00000000},
+  {0x27a61f79, 0x4e1e987e, 0x4e1e987e, 0x00000000, 0x00000000},
+  {0x36b0737e, 0x4e5ac1ce, 0x4e5ac1ce, 0x00000000, 0x00000000},
+  {0x11942e98, 0x4d8ca175, 0x4d8ca175, 0x00000000, 0x00000000},
+  {0x0e50d1ed, 0x4d650d1f, 0x4d650d1f, 0x00000000, 0x00000000},
+  {0x0ce0085f, 0x4d4e0086, 0x4d4e0086, 0x00000000, 0x00000000},
+  {0x004a34f3, 0x4a9469e6, 0x4a9469e6, 0x00000000, 0x00000000},
+  {0x022f315d, 0x4c0bcc58, 0x4c0bcc58, 0x00000000, 0x00000000},
+  {0x004b459b, 0x4a968b36, 0x4a968b36, 0x00000000, 0x00000000},
+  {0xff86ac1f, 0x4f7f86ad, 0xcaf2a7c2, 0x00000000, 0x00000000},
+  {0x35573d5e, 0x4e555cf6, 0x4e555cf6, 0x00000000, 0x00000000},
+  {0x06b22018, 0x4cd64403, 0x4cd64403, 0x00000000, 0x00000000},
+  {0x0a4a00ac, 0x4d24a00b, 0x4d24a00b, 0x00000000, 0x00000000},
+};
+#endif
+
+void
+testFloatOps (void)
+{
+#ifdef TEST_FLOAT_BITS
+  volatile union float_long a1, a2, r;
+  uint8_t i;
+
+  for (i = 0; i < sizeof ops / sizeof *ops; i++)
+    {
+      a1.l = ops[i].a1;
+      a2.l = ops[i].a2;
+      r.f = a1.f + a2.f;
+      ASSERT (r.l == ops[i].add);
+      r.f = a1.f - a2.f;
+      ASSERT (r.l == ops[i].sub);
+      r.f = a1.f * a2.f;
+      ASSERT (r.l == ops[i].mul);
+      r.f = a1.f / a2.f;
+      ASSERT (r.l == ops[i].div);
+      ASSERT ((a1.f < a2.f) == !!(ops[i].cmp & 1));
+      ASSERT ((a1.f > a2.f) == !!(ops[i].cmp & 2));
+      ASSERT ((a1.f == a2.f) == !!(ops[i].cmp & 4));
+      ASSERT ((a1.f != a2.f) == !(ops[i].cmp & 4));
+    }
+#endif
+}
+
+void
+testFloatConv (void)
+{
+#ifdef TEST_FLOAT_BITS
+  volatile union float_long f, r;
+  volatile uint32_t l;
+  uint8_t i;
+
+  for (i = 0; i < sizeof conv / sizeof *conv; i++)
+    {
+      l = conv[i].l;
+      f.l = conv[i].l;
+      r.f = (unsigned long)l;
+      ASSERT (r.l == conv[i].ul2fs);
+      r.f = (long)l;
+      ASSERT (r.l == conv[i].sl2fs);
+      ASSERT ((unsigned long)f.f == conv[i].fs2ul);
+      ASSERT ((long)f.f == (long)conv[i].fs2sl);
+    }
+#endif
+}
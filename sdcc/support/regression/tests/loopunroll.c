@@ -0,0 +1,184 @@
+/** loop unrolling tests, with --opt-code-speed
+    type: unsigned char, int
+*/
+#include <testfwk.h>
+#include <setjmp.h>
+
+#if defined(__SDCC_pic14)
+#define NO_SETJMP
+#endif
+
+#ifdef __SDCC
+#pragma opt_code_speed
+#endif
+
+unsigned char src[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+unsigned char dst[8];
+unsigned char big[40];
+
+/* Small constant trip count, unrolled completely. */
+void copy8 (void)
+{
+  {type} i;
+  for (i = 0; i < 8; i++)
+    dst[i] = src[i];
+}
+
+/* Bitwise CRC-8, four steps per call. */
+unsigned char crc4 (unsigned char crc)
+{
+  {type} i;
+  for (i = 0; i < 4; i++)
+    crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+  return crc;
+}
+
+/* Trip count too large for full unrolling, partially unrolled with remainder. */
+void fill (unsigned char c)
+{
+  {type} i;
+  for (i = 3; i < 38; i++)
+    big[i] = c + i;
+}
+
+/* The value of the counter after the loop has to match the loop bound. */
+{type} afterloop (void)
+{
+  {type} i;
+  unsigned char sum = 0;
+  for (i = 2; i <= 6; i++)
+    sum += i;
+  ASSERT (sum == 20);
+  return i;
+}
+
+/* Loops that must not be unrolled: the counter is modified in the body */
+unsigned char modified (void)
+{
+  {type} i;
+  unsigned char n = 0;
+  for (i = 0; i < 8; i++)
+    {
+      n++;
+      i++;
+    }
+  return n;
+}
+
+/* Bounds at the end of the range of the counter. The loops up to one past */
+/* the largest value never end, as the counter wraps around; they are left */
+/* through longjmp from the body.                                          */
+volatile unsigned int count;
+
+#ifndef NO_SETJMP
+jmp_buf escape;
+
+void tick (void)
+{
+  if (++count == 300)
+    longjmp (escape, 1);
+}
+#else
+void tick (void)
+{
+  count++;
+}
+#endif
+
+unsigned char uchar255 (void)
+{
+  unsigned char i;
+  count = 0;
+  for (i = 0; i < 255; i++)
+    tick ();
+  return i;
+}
+
+unsigned char uchar254le (void)
+{
+  unsigned char i;
+  count = 0;
+  for (i = 0; i <= 254; i++)
+    tick ();
+  return i;
+}
+
+signed char schar127 (void)
+{
+  signed char i;
+  count = 0;
+  for (i = -128; i < 127; i++)
+    tick ();
+  return i;
+}
+
+#ifndef NO_SETJMP
+void uchar256 (void)
+{
+  unsigned char i;
+  for (i = 0; i < 256; i++)
+    tick ();
+}
+
+void uchar255le (void)
+{
+  unsigned char i;
+  for (i = 0; i <= 255; i++)
+    tick ();
+}
+
+void schar128 (void)
+{
+  signed char i;
+  for (i = 0; i < 128; i++)
+    tick ();
+}
+
+unsigned int wrapping (void (*loop) (void))
+{
+  count = 0;
+  if (!setjmp (escape))
+    loop ();
+  return count;
+}
+#endif
+
+void testUnrollRange (void)
+{
+  ASSERT (uchar255 () == 255);
+  ASSERT (count == 255);
+  ASSERT (uchar254le () == 255);
+  ASSERT (count == 255);
+  ASSERT (schar127 () == 127);
+  ASSERT (count == 255);
+#ifndef NO_SETJMP
+  ASSERT (wrapping (uchar256) == 300);
+  ASSERT (wrapping (uchar255le) == 300);
+  ASSERT (wrapping (schar128) == 300);
+#endif
+}
+
+void testUnroll (void)
+{
+  {type} i;
+
+  copy8 ();
+  for (i = 0; i < 8; i++)
+    ASSERT (dst[i] == i + 1);
+
+  ASSERT (crc4 (0x00) == 0x00);
+  ASSERT (crc4 (0x01) == 0x10);
+  ASSERT (crc4 (0x80) == 0x38);
+
+  fill (0x40);
+  ASSERT (big[0] == 0);
+  ASSERT (big[2] == 0);
+  ASSERT (big[3] == 0x43);
+  ASSERT (big[20] == 0x54);
+  ASSERT (big[36] == 0x64);
+  ASSERT (big[37] == 0x65);
+  ASSERT (big[38] == 0);
+
+  ASSERT (afterloop () == 7);
+  ASSERT (modified () == 4);
+}
@@ -102,7 +102,201 @@ foo (unsigned char which)
 }
 
 
+/* The state at a loop head joins the entry with the back edge, along
+   which the values move to other registers */
+static unsigned char
+fib (unsigned char n)
+{
+  unsigned char a = 0, b = 1, c;
+
+  do
+    {
+      c = a;
+      a = b;
+      b = c + b;
+    }
+  while (--n);
+  return a;
+}
+
+/* The entries of jump tables are reached with unknown registers, both
+   from a table of ljmp (few cases) and from tables of .db (many cases) */
+static unsigned char
+jtsmall (unsigned char x)
+{
+  unsigned char r = 1;
+
+  t = 2;
+  switch (x)
+    {
+    case 0: r = 2; break;
+    case 1: r = 1; break;
+    case 2: t = 3; r = 3; break;
+    case 3: r = 0; break;
+    }
+  return r;
+}
+
+static unsigned char
+jtmedium (unsigned char x)
+{
+  unsigned char r = 0;
+
+  t = 0x10;
+  switch (x)
+    {
+    case 0: r = 0x10; break;
+    case 1: r = 0x11; break;
+    case 2: r = 0x12; break;
+    case 3: r = 0x13; break;
+    case 4: r = 0x10; t = 0x14; break;
+    case 5: r = 0x15; break;
+    case 6: r = 0x16; break;
+    case 7: r = 0x17; break;
+    case 8: r = 0x18; break;
+    case 9: r = 0x19; break;
+    }
+  return r;
+}
+
+#if !defined(__SDCC_pdk14) && !defined(__SDCC_pdk15) // Lack of memory
+#define CASE1(n) case (n): r = (n) ^ 0x5a; break;
+#define CASE2(n) CASE1(n) CASE1((n) + 1)
+#define CASE4(n) CASE2(n) CASE2((n) + 2)
+#define CASE8(n) CASE4(n) CASE4((n) + 4)
+#define CASE16(n) CASE8(n) CASE8((n) + 8)
+#define CASE32(n) CASE16(n) CASE16((n) + 16)
+#define CASE64(n) CASE32(n) CASE32((n) + 32)
+
+/* more than 125 cases need dptr to read the tables */
+static unsigned char
+jtlarge (unsigned char x)
+{
+  unsigned char r = 0x5a;
+
+  switch (x)
+    {
+    CASE64(0)
+    CASE64(64)
+    }
+  return r;
+}
+#endif
+
+/* After a cjne or djnz that falls through, the register is known;
+   not so where it jumps */
+static unsigned char
+cjnefall (unsigned char x)
+{
+  unsigned char r;
+
+  if (x == 0x33)
+    r = 0x33;
+  else
+    r = 0x44;
+  t = r;
+  return r;
+}
 
+static unsigned char
+djnzfall (unsigned char n, unsigned char stop)
+{
+  unsigned char i = n;
+
+  do
+    {
+      if (i == stop)
+        break;
+      t = i;
+    }
+  while (--i);
+  return i;
+}
+
+#if defined(__SDCC_mcs51)
+/* Writes to psw, through @r0/@r1 and to the direct addresses of the
+   register bank change registers */
+__sfr __at(0xd0) rt_psw;
+volatile __data __at(0x00) unsigned char rt_bank0[8];
+__idata unsigned char * volatile __data rt_bankptr[6] =
+  {(__idata unsigned char *)2, (__idata unsigned char *)3, (__idata unsigned char *)4,
+   (__idata unsigned char *)5, (__idata unsigned char *)6, (__idata unsigned char *)7};
+
+static unsigned char
+pswwrite (void)
+{
+  unsigned char i;
+
+  for (i = 0x12; i != 0x14; i++)
+    t = i;
+  rt_psw |= 0x08;       // register bank 1, no registers used until bank 0
+  t = 0x14;
+  rt_psw &= ~0x08;
+  return t;
+}
+
+static unsigned char
+directwrite (void)
+{
+  unsigned char i;
+
+  for (i = 0x12; i != 0x14; i++)
+    t = i;
+  rt_bank0[0] = 0x55; rt_bank0[1] = 0x55; rt_bank0[2] = 0x55; rt_bank0[3] = 0x55;
+  rt_bank0[4] = 0x55; rt_bank0[5] = 0x55; rt_bank0[6] = 0x55; rt_bank0[7] = 0x55;
+  t = 0x14;
+  return t;
+}
+
+static unsigned char
+indirectwrite (void)
+{
+  unsigned char i;
+
+  for (i = 0x12; i != 0x14; i++)
+    t = i;
+  *rt_bankptr[0] = 0x55; *rt_bankptr[1] = 0x55; *rt_bankptr[2] = 0x55;
+  *rt_bankptr[3] = 0x55; *rt_bankptr[4] = 0x55; *rt_bankptr[5] = 0x55;
+  t = 0x14;
+  return t;
+}
+#endif
+
+void
+testRegTrackFlow (void)
+{
+  unsigned char i;
+
+  ASSERT (fib (1) == 1);
+  ASSERT (fib (10) == 55);
+  ASSERT (fib (13) == 233);
+
+  ASSERT (jtsmall (0) == 2);
+  ASSERT (jtsmall (1) == 1);
+  ASSERT (jtsmall (2) == 3 && t == 3);
+  ASSERT (jtsmall (3) == 0);
+  ASSERT (jtsmall (4) == 1 && t == 2);
+  for (i = 0; i < 10; i++)
+    ASSERT (jtmedium (i) == (i == 4 ? 0x10 : 0x10 + i));
+  ASSERT (t == 0x10);
+  ASSERT (jtmedium (10) == 0);
+#if !defined(__SDCC_pdk14) && !defined(__SDCC_pdk15)
+  for (i = 0; i < 128; i++)
+    ASSERT (jtlarge (i) == (i ^ 0x5a));
+  ASSERT (jtlarge (128) == 0x5a);
+#endif
+
+  ASSERT (cjnefall (0x33) == 0x33);
+  ASSERT (cjnefall (0x32) == 0x44);
+  ASSERT (djnzfall (5, 9) == 0);
+  ASSERT (djnzfall (5, 3) == 3);
+
+#if defined(__SDCC_mcs51)
+  ASSERT (pswwrite () == 0);
+  ASSERT (directwrite () == 0x14);
+  ASSERT (indirectwrite () == 0x14);
+#endif
+}
 
 void 
 testRegTrack (void)
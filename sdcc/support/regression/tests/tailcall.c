@@ -0,0 +1,79 @@
+/** calls in tail position, which may be turned into jumps
+    type: unsigned char, int, long
+*/
+#include <testfwk.h>
+
+volatile {type} counter;
+
+{type} twice ({type} x)
+{
+  return x + x;
+}
+
+/* The result of the callee is returned unchanged. */
+{type} tail ({type} x)
+{
+  counter++;
+  return twice (x);
+}
+
+void bump (void)
+{
+  counter++;
+}
+
+/* Call of a void function at the end of a void function. */
+void tailvoid (void)
+{
+  counter++;
+  bump ();
+}
+
+/* Reentrant, as some ports need that for a long argument through a pointer. */
+{type} twiceptr ({type} x) __reentrant
+{
+  return x + x;
+}
+
+{type} (*volatile fp) ({type}) __reentrant = twiceptr;
+
+/* Tail call through a function pointer. */
+{type} tailptr ({type} x)
+{
+  return (*fp) (x);
+}
+
+/* Result converted before return: not a tail call. */
+long widen (unsigned char c)
+{
+  return twice (c);
+}
+
+/* Chain of tail calls on different paths, as in a state machine. */
+{type} dispatch ({type} state)
+{
+  if (state == 1)
+    return tail (state);
+  else if (state == 2)
+    return twice (state);
+  tailvoid ();
+  return 0;
+}
+
+void testTailCall (void)
+{
+  counter = 0;
+  ASSERT (tail (21) == 42);
+  ASSERT (counter == 1);
+
+  tailvoid ();
+  ASSERT (counter == 3);
+
+  ASSERT (tailptr (7) == 14);
+  ASSERT (widen (100) == 200);
+
+  ASSERT (dispatch (1) == 2);
+  ASSERT (dispatch (2) == 4);
+  ASSERT (dispatch (3) == 0);
+  ASSERT (counter == 6);
+}
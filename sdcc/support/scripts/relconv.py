@@ -0,0 +1,100 @@
+#!/usr/bin/env python
+
+# relconv - convert asxxxx object files between the text .rel format
+#           and the binary T/R/P records written by sdas -r
+#
+# This file is part of sdcc.
+#
+#  This software is provided 'as-is', without any express or implied
+#  warranty.  In no event will the authors be held liable for any damages
+#  arising from the use of this software.
+#
+#  Permission is granted to anyone to use this software for any purpose,
+#  including commercial applications, and to alter it and redistribute it
+#  freely, subject to the following restrictions:
+#
+#  1. The origin of this software must not be misrepresented; you must not
+#     claim that you wrote the original software. If you use this software
+#     in a product, an acknowledgment in the product documentation would be
+#     appreciated but is not required.
+#  2. Altered source versions must be plainly marked as such, and must not be
+#     misrepresented as being the original software.
+#  3. This notice may not be removed or altered from any source distribution.
+
+"""Usage: relconv.py -b|-t infile outfile
+
+  -b   write binary T/R/P records (as sdas -r does)
+  -t   write the text format (as sdas does by default)
+
+The input may be in either format.  All other records (header, module,
+area, symbol, option, ...) are always text and are copied unchanged."""
+
+from __future__ import print_function
+
+import sys
+
+RADIX = {ord('X'): (16, '%02X'), ord('Q'): (8, '%03o'), ord('D'): (10, '%03u')}
+BINARY = bytearray(b'trp')
+TEXT = bytearray(b'TRP')
+
+
+def records(data):
+    """Yields (type, values) for T/R/P records and (None, line) for
+    any other line, the line without its end of line characters."""
+    i = 0
+    radix = 16
+    while i < len(data):
+        c = data[i]
+        if c in BINARY:
+            n = data[i + 1]
+            if i + 2 + n > len(data):
+                raise ValueError('truncated binary record')
+            yield TEXT[BINARY.index(c)], bytearray(data[i + 2:i + 2 + n])
+            i += 2 + n
+            continue
+        j = data.find(b'\n', i)
+        if j < 0:
+            j = len(data)
+        line = data[i:j].rstrip(b'\r')
+        i = j + 1
+        if line[:1] and line[0] in RADIX and len(line) <= 3:
+            radix = RADIX[line[0]][0]
+        if line[:1] and line[0] in TEXT and line[1:2] in (b'', b' '):
+            yield line[0], bytearray(int(v, radix) for v in line[1:].split())
+        else:
+            yield None, line
+
+
+def convert(data, binary):
+    out = bytearray()
+    fmt = '%02X'
+    for t, v in records(data):
+        if t is None:
+            if v[:1] and v[0] in RADIX and len(v) <= 3:
+                fmt = RADIX[v[0]][1]
+            out += v + b'\n'
+        elif binary:
+            out.append(BINARY[TEXT.index(t)])
+            out.append(len(v))
+            out += v
+        else:
+            out.append(t)
+            out += b''.join((' ' + fmt % b).encode('ascii') for b in v)
+            out += b'\n'
+    return out
+
+
+def main(argv):
+    if len(argv) != 4 or argv[1] not in ('-b', '-t'):
+        print(__doc__, file=sys.stderr)
+        return 1
+    with open(argv[2], 'rb') as f:
+        data = bytearray(f.read())
+    out = convert(data, argv[1] == '-b')
+    with open(argv[3], 'wb') as f:
+        f.write(out)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -766,6 +766,30 @@ asxxxx_scan (bfd *abfd, unsigned int *p_lineno)
             goto error_return;
           break;
 
+        case 't':
+        case 'r':
+        case 'p':
+          /* binary T, R or P record written by sdas -r: count byte and data */
+          {
+            int n;
+
+            if ((n = asxxxx_get_byte (abfd, &error)) == EOF)
+              {
+                asxxxx_bad_byte (abfd, n, *p_lineno, error);
+                goto error_return;
+              }
+
+            while (n-- > 0)
+              {
+                if ((c = asxxxx_get_byte (abfd, &error)) == EOF)
+                  {
+                    asxxxx_bad_byte (abfd, c, *p_lineno, error);
+                    goto error_return;
+                  }
+              }
+          }
+          break;
+
         case 'S':
           /* S __ret3 Def0001 */
           {
@@ -0,0 +1,35 @@
+#!/usr/bin/env python3
+"""Generates mcs51 assembler sources with many absolute areas for timing sdld.
+
+Usage: genabs.py [modules [areas]]
+
+Writes abs0.asm ... absN.asm and main.asm.  Each module defines the given
+number of small absolute code and xdata areas, two bytes every eight bytes,
+like __at variables, and relocatable code and xdata of three bytes per area
+that the linker has to fit into the gaps left between them.
+"""
+
+import sys
+
+modules = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+areas = int(sys.argv[2]) if len(sys.argv) > 2 else 200
+
+for m in range(modules):
+    with open('abs%d.asm' % m, 'w') as f:
+        f.write('\t.module abs%d\n' % m)
+        for a in range(areas):
+            addr = 0x1000 + (m * areas + a) * 8
+            f.write('\t.area XABS%d_%dx (ABS,XDATA)\n' % (m, a))
+            f.write('\t.org 0x%04x\n_x%d_%d::\n\t.ds 2\n' % (addr, m, a))
+            f.write('\t.area CABS%d_%dc (ABS,CODE)\n' % (m, a))
+            f.write('\t.org 0x%04x\n_c%d_%d::\n\t.db 0, 0\n' % (addr, m, a))
+        f.write('\t.area XSEG (XDATA)\n')
+        for a in range(areas):
+            f.write('_v%d_%d::\n\t.ds 3\n' % (m, a))
+        f.write('\t.area CSEG (CODE)\n')
+        for a in range(areas):
+            f.write('_f%d_%d::\n\tret\n' % (m, a))
+
+with open('main.asm', 'w') as f:
+    f.write('\t.module main\n\t.area CSEG (CODE)\n\tsjmp .\n')
+    f.write('\t.area XSEG (XDATA)\n')
@@ -0,0 +1,76 @@
+/* Times one float library routine, selected by -DBENCH_<name>, by calling
+   it N times; the simulated ticks of a run with -DBENCH_none are the
+   overhead of the loop. */
+
+#include <stdint.h>
+
+#ifndef N
+#define N 1000
+#endif
+
+union float_long
+{
+  float f;
+  uint32_t l;
+};
+
+/* Operands of similar magnitude, as in a control loop. */
+static const uint32_t operands[16] =
+{
+  0x3f800000, 0x40490fdb, 0xbf3504f3, 0x42c80000,
+  0x3dcccccd, 0xc0a00000, 0x447a0000, 0x3eaaaaab,
+  0xbe4ccccd, 0x41200000, 0x3f19999a, 0xc2f60000,
+  0x40e00000, 0xbfc00000, 0x3c23d70a, 0x43480000,
+};
+
+volatile union float_long a, b, r;
+volatile uint32_t l;
+
+static void
+exit_emu (void)
+{
+  __asm
+#if defined(__SDCC_stm8)
+    .db 0x71, 0xec
+#else
+    .db 0x9e, 0xec
+#endif
+  __endasm;
+}
+
+void
+main (void)
+{
+  unsigned int n;
+
+  for (n = 0; n < N; n++)
+    {
+      a.l = operands[n & 15];
+      b.l = operands[(n + 5) & 15];
+      l = operands[n & 15] >> (n & 15);
+#if defined(BENCH_fsadd)
+      r.f = a.f + b.f;
+#elif defined(BENCH_fssub)
+      r.f = a.f - b.f;
+#elif defined(BENCH_fsmul)
+      r.f = a.f * b.f;
+#elif defined(BENCH_fsdiv)
+      r.f = a.f / b.f;
+#elif defined(BENCH_fslt)
+      r.l = a.f < b.f;
+#elif defined(BENCH_fseq)
+      r.l = a.f == b.f;
+#elif defined(BENCH_ulong2fs)
+      r.f = (unsigned long)l;
+#elif defined(BENCH_slong2fs)
+      r.f = (long)l;
+#elif defined(BENCH_fs2ulong)
+      r.l = (unsigned long)a.f;
+#elif defined(BENCH_fs2slong)
+      r.l = (long)a.f;
+#else
+      r.l = a.l;
+#endif
+    }
+  exit_emu ();
+}
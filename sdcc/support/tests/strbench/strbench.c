@@ -0,0 +1,65 @@
+/* Times one memory or string library routine, selected by -DBENCH_<name>,
+   by calling it N times on SIZE bytes; the simulated ticks of a run with
+   -DBENCH_none are the overhead of the loop. */
+
+#include <string.h>
+
+#ifndef N
+#define N 20
+#endif
+
+#ifndef SIZE
+#define SIZE 256
+#endif
+
+/* Keep the call, even where memset() is a builtin. */
+#undef memset
+
+char a[SIZE + 4], b[SIZE + 4];
+volatile int r;
+void *volatile p;
+
+static void
+exit_emu (void)
+{
+  __asm
+#if defined(__SDCC_stm8)
+    .db 0x71, 0xec
+#elif defined(__SDCC_pdk14) || defined(__SDCC_pdk15)
+    stopsys
+#else
+    .db 0x9e, 0xec
+#endif
+  __endasm;
+}
+
+void
+main (void)
+{
+  unsigned char n;
+
+  memset (a, 'a', SIZE);
+  memset (b, 'a', SIZE);
+  a[SIZE] = 0;
+  a[SIZE - 1] = 'b';
+
+  for (n = 0; n < N; n++)
+    {
+#if defined(BENCH_memset)
+      p = memset (b, n, SIZE);
+#elif defined(BENCH_memcpy)
+      p = memcpy (b, a, SIZE);
+#elif defined(BENCH_memmove)
+      p = memmove (a + 1, a, SIZE - 1);
+#elif defined(BENCH_memcmp)
+      r = memcmp (a, b, SIZE);
+#elif defined(BENCH_memchr)
+      p = memchr (a, 'b', SIZE);
+#elif defined(BENCH_strlen)
+      r = strlen (a);
+#else
+      p = a;
+#endif
+    }
+  exit_emu ();
+}
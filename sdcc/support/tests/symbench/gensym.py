@@ -0,0 +1,38 @@
+#!/usr/bin/env python3
+"""Generates symbol heavy z80 assembler sources for timing sdas and sdld.
+
+Usage: gensym.py [modules [symbols]]
+
+Writes sym0.asm ... symN.asm and main.asm.  Each module defines the given
+number of global routines with sdcc style local labels, and each routine
+calls a routine of the next module, so that the link has to resolve every
+global symbol.
+"""
+
+import sys
+
+modules = int(sys.argv[1]) if len(sys.argv) > 1 else 20
+symbols = int(sys.argv[2]) if len(sys.argv) > 2 else 1000
+
+for m in range(modules):
+    n = (m + 1) % modules
+    with open('sym%d.asm' % m, 'w') as f:
+        f.write('\t.module sym%d\n' % m)
+        for s in range(symbols):
+            f.write('\t.globl _m%d_f%d\n' % (m, s))
+        f.write('\t.area _DATA\n')
+        for s in range(symbols):
+            f.write('_m%d_v%d:\n\t.ds 2\n' % (m, s))
+        f.write('\t.area _CODE\n')
+        for s in range(symbols):
+            f.write('_m%d_f%d::\n' % (m, s))
+            f.write('\tld\thl, (_m%d_v%d)\n' % (m, s))
+            f.write('\tld\ta, h\n\tor\ta, l\n')
+            f.write('\tjr\tZ, %05d$\n' % (s * 2 + 1))
+            f.write('\tcall\t_m%d_f%d\n' % (n, s))
+            f.write('%05d$:\n' % (s * 2 + 1))
+            f.write('\tret\n')
+
+with open('main.asm', 'w') as f:
+    f.write('\t.module main\n\t.area _CODE\n')
+    f.write('\tcall\t_m0_f0\n\thalt\n')